@@ -61,6 +61,14 @@ size_t cmd_util::readNumber(const std::string& prompt, bool read_hex)
     return num;
 }
 
+std::string cmd_util::readString(const std::string& prompt)
+{
+    std::string str;
+    std::cout << prompt.c_str() << ": ";
+    std::cin >> str;
+    return str;
+}
+
 void cmd_util::fetch(Executable *peExe, offset_t offset, Executable::addr_type aType, bool hex)
 {
     offset = peExe->toRaw(offset, aType);
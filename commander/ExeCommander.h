@@ -20,6 +20,7 @@ namespace cmd_util {
 
     offset_t readOffset(Executable::addr_type aType);
     size_t readNumber(const std::string& prompt, bool read_hex=false);
+    std::string readString(const std::string& prompt);
 
     void fetch(Executable *exe, offset_t offset, Executable::addr_type aType, bool hex);
     void printWrapperNames(MappedExe *exe);
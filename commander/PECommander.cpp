@@ -89,6 +89,88 @@ void cmd_util::printStrings(PEFile *pe, size_t limit)
     std::cout << std::endl;
 }
 
+void cmd_util::printFoundStrings(PEFile *pe, AbstractByteBuffer *buf, offset_t bufOffset, std::vector<FoundString> &found, size_t limit)
+{
+    if (!pe || !buf) return;
+
+    for (size_t i = 0; i < found.size(); i++) {
+        if (limit != 0 && i >= limit) break;
+
+        const FoundString &str = found[i];
+        const offset_t raw = bufOffset + str.offset;
+        const offset_t rva = pe->convertAddr(raw, Executable::RAW, Executable::RVA);
+
+        OUT_PADDED_OFFSET(std::cout, raw);
+        std::cout << " ";
+        if (rva != INVALID_ADDR) {
+            OUT_PADDED_OFFSET(std::cout, rva);
+        } else {
+            std::cout << "[" << std::string(sizeof(offset_t), '-') << "]";
+        }
+        SectionHdrWrapper *sec = pe->getSecHdrAtOffset(raw, Executable::RAW, true);
+        QString secName = sec ? sec->getName() : "";
+        std::cout << " " << secName.leftJustified(8).toStdString()
+            << " " << (str.isWide ? 'W' : 'A')
+            << " : " << StringsExtractor::getString(buf, str).toStdString()
+            << "\n";
+    }
+    std::cout << std::endl;
+}
+
+void cmd_util::printSigHits(SignatureSet &sigSet, std::vector<SigHit> &hits)
+{
+    for (size_t i = 0; i < hits.size(); i++) {
+        const SigHit &hit = hits[i];
+        const ByteSignature *sig = sigSet.getSignature(hit.sigId);
+        if (!sig) continue;
+
+        OUT_PADDED_OFFSET(std::cout, hit.raw);
+        std::cout << " ";
+        if (hit.rva != INVALID_ADDR) {
+            OUT_PADDED_OFFSET(std::cout, hit.rva);
+            std::cout << " ";
+            OUT_PADDED_OFFSET(std::cout, hit.va);
+        } else {
+            std::cout << "[" << std::string(sizeof(offset_t), '-') << "] "
+                << "[" << std::string(sizeof(offset_t), '-') << "]";
+        }
+        std::cout << " " << sig->getName().toStdString() << "\n";
+    }
+    std::cout << std::endl;
+}
+
+void cmd_util::printSignedData(SignedDataWrapper *signedData, size_t level)
+{
+    if (!signedData) return;
+
+    const std::string indent(level * 4, ' ');
+    std::cout << indent << "[" << signedData->getName().toStdString() << "]\n";
+    for (size_t i = 0; i < signedData->getFieldsCount(); i++) {
+        std::cout << indent << "  " << signedData->getFieldName(i).toStdString()
+            << ": " << signedData->translateFieldContent(i).toStdString() << "\n";
+    }
+    for (size_t i = 0; i < signedData->getCertificatesCount(); i++) {
+        CertificateWrapper *cert = signedData->getCertificate(i);
+        std::cout << indent << "  [" << cert->getName().toStdString() << " #" << std::dec << i << "]\n";
+        for (size_t fId = 0; fId < cert->getFieldsCount(); fId++) {
+            std::cout << indent << "    " << cert->getFieldName(fId).toStdString()
+                << ": " << cert->translateFieldContent(fId).toStdString() << "\n";
+        }
+    }
+    for (size_t i = 0; i < signedData->getSignersCount(); i++) {
+        SignerInfoWrapper *signer = signedData->getSigner(i);
+        std::cout << indent << "  [" << signer->getName().toStdString() << " #" << std::dec << i << "]\n";
+        for (size_t fId = 0; fId < signer->getFieldsCount(); fId++) {
+            std::cout << indent << "    " << signer->getFieldName(fId).toStdString()
+                << ": " << signer->translateFieldContent(fId).toStdString() << "\n";
+        }
+    }
+    for (size_t i = 0; i < signedData->getNestedCount(); i++) {
+        printSignedData(signedData->getNested(i), level + 1);
+    }
+    if (level == 0) std::cout << std::endl;
+}
+
 void cmd_util::dumpResourcesInfo(PEFile *pe, pe::resource_type type, size_t wrapperId)
 {
     ResourcesContainer* wrappers = pe->getResourcesOfType(type);
@@ -136,8 +218,19 @@ void PECommander::initCommands()
     this->addCommand("secR", new SectionByAddrCommand(Executable::RAW, "Section by RAW"));
 
     this->addCommand("rstrings", new PrintStringsCommand("Print Strings from resources"));
+    this->addCommand("strings", new ExtractStringsCommand("Extract ASCII and UTF-16 strings from the image or a section"));
+    this->addCommand("sigscan", new SignatureScanCommand("Scan for the byte signatures"));
+    this->addCommand("authhash", new AuthenticodeDigestCommand("Compute the Authenticode digest"));
+    this->addCommand("fuzzy", new FuzzyHashCommand("Fuzzy hashes of the file, its sections and the overlay"));
+    this->addCommand("ovl", new OverlayInfoCommand("Print the overlay: its range and format"));
+    this->addCommand("sign", new SignatureInfoCommand("Print the Authenticode signature"));
+    this->addCommand("pdb", new DebugInfoCommand("Print the PDB key and the debug records: VC Feature, POGO, REPRO, Ex DLL Characteristics"));
+    this->addCommand("clr", new ClrMetadataCommand("Print the .NET metadata: streams, tables, types and methods"));
+    this->addCommand("sigbench", new SignatureBenchCommand("Benchmark the signature scanner against the naive search"));
     this->addCommand("rsl", new PrintWrapperTypesCommand("List Resource Types"));
     this->addCommand("rs", new WrapperInfoCommand("Resource Info"));
+    this->addCommand("rsdump", new ExtractResourcesCommand("Extract all the resources into a directory (icons, cursors and bitmaps with their headers)"));
+    this->addCommand("rsfind", new FindResourceCommand("Find a resource by its path in the flat index of the resources"));
 
     this->addCommand("dir_mv", new MoveDataDirEntryCommand("Move DataDirectory"));
     this->addCommand("secinfo", new SectionDumpCommand("Dump chosen Section info"));
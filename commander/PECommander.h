@@ -2,11 +2,16 @@
 
 #include "ExeCommander.h"
 
+#include <chrono>
+
 namespace cmd_util {
     PEFile* getPEFromContext(CmdContext *ctx);
     void printSectionMapping(SectionHdrWrapper *sec, Executable::addr_type aType);
     void printResourceTypes(PEFile *pe);
     void printStrings(PEFile *pe, size_t limit);
+    void printFoundStrings(PEFile *pe, AbstractByteBuffer *buf, offset_t bufOffset, std::vector<FoundString> &found, size_t limit);
+    void printSigHits(SignatureSet &sigSet, std::vector<SigHit> &hits);
+    void printSignedData(SignedDataWrapper *signedData, size_t level);
     void dumpResourcesInfo(PEFile *pe, pe::resource_type type, size_t wrapperId);
     void listDataDirs(PEFile *pe);
 };
@@ -103,6 +108,372 @@ public:
     }
 };
 
+class ExtractStringsCommand : public Command
+{
+public:
+    ExtractStringsCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        size_t minLen = cmd_util::readNumber("min length");
+        if (minLen == 0) minLen = STRINGS_DEFAULT_MIN_LEN;
+        StringsExtractor extractor(minLen);
+
+        const size_t sectCount = pe->getSectionsCount(true);
+        if (sectCount > 0) {
+            printf("Available indexes: %lu-%lu\n", 0UL, static_cast<unsigned long>(sectCount - 1));
+        }
+        size_t secId = cmd_util::readNumber("Chose the section by index (other: full image)");
+
+        std::vector<FoundString> found;
+        if (secId < sectCount) {
+            SectionHdrWrapper *sec = pe->getSecHdr(secId);
+            BufferView *secView = pe->createSectionView(secId);
+            if (!sec || !secView) {
+                std::cout << "Cannot fetch the section content\n";
+                delete secView;
+                return;
+            }
+            extractor.extract(secView, found);
+            std::cout << "Total: " << std::dec << found.size() << std::endl;
+            cmd_util::printFoundStrings(pe, secView, sec->getContentOffset(Executable::RAW, true), found, 0);
+            delete secView;
+            return;
+        }
+        extractor.extract(pe, found);
+        std::cout << "Total: " << std::dec << found.size() << std::endl;
+        cmd_util::printFoundStrings(pe, pe, 0, found, 0);
+    }
+};
+
+class SignatureScanCommand : public Command
+{
+public:
+    SignatureScanCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        SignatureSet sigSet;
+        const std::string dbName = cmd_util::readString("signatures file (PEiD format)");
+        if (sigSet.loadPeidDb(QString::fromStdString(dbName)) == 0) {
+            std::cout << "No signatures loaded\n";
+            return;
+        }
+        std::cout << "Loaded: " << std::dec << sigSet.size() << " signatures\n";
+
+        SignatureScanner scanner(sigSet);
+        std::vector<SigHit> hits;
+
+        size_t scope = cmd_util::readNumber("Scope (0: full image, 1: section, 2: entry point)");
+        if (scope == 1) {
+            size_t secId = cmd_util::readNumber("Chose the section by index");
+            scanner.scanSection(pe, secId, hits);
+        } else if (scope == 2) {
+            bufsize_t size = static_cast<bufsize_t>(cmd_util::readNumber("EP neighbourhood size (hex)", true));
+            scanner.scanEntryPoint(pe, size, hits);
+        } else {
+            scanner.scanExe(pe, hits);
+        }
+        std::cout << "Hits: " << std::dec << hits.size() << std::endl;
+        cmd_util::printSigHits(sigSet, hits);
+    }
+};
+
+class SignatureBenchCommand : public Command
+{
+public:
+    SignatureBenchCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        SignatureSet sigSet;
+        const std::string dbName = cmd_util::readString("signatures file (PEiD format)");
+        if (sigSet.loadPeidDb(QString::fromStdString(dbName)) == 0) {
+            std::cout << "No signatures loaded\n";
+            return;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        sigSet.compile();
+        std::chrono::steady_clock::time_point compiled = std::chrono::steady_clock::now();
+
+        std::vector<SigMatch> acMatches;
+        sigSet.scan(pe->getContent(), pe->getContentSize(), acMatches);
+        std::chrono::steady_clock::time_point scanned = std::chrono::steady_clock::now();
+
+        std::vector<SigMatch> naiveMatches;
+        sigSet.naiveScan(pe->getContent(), pe->getContentSize(), naiveMatches);
+        std::chrono::steady_clock::time_point naiveScanned = std::chrono::steady_clock::now();
+
+        std::cout << "Signatures: " << std::dec << sigSet.size()
+            << ", content size: " << pe->getContentSize() << "\n"
+            << "Compile: " << std::chrono::duration_cast<std::chrono::microseconds>(compiled - start).count() << " us\n"
+            << "Aho-Corasick: " << std::chrono::duration_cast<std::chrono::microseconds>(scanned - compiled).count() << " us, "
+            << acMatches.size() << " matches\n"
+            << "Naive: " << std::chrono::duration_cast<std::chrono::microseconds>(naiveScanned - scanned).count() << " us, "
+            << naiveMatches.size() << " matches\n"
+            << "Results " << ((acMatches == naiveMatches) ? "match" : "DIFFER") << std::endl;
+    }
+};
+
+class AuthenticodeDigestCommand : public Command
+{
+public:
+    AuthenticodeDigestCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        std::vector<DigestRange> ranges;
+        if (!AuthenticodeHasher::getDigestRanges(pe, ranges)) {
+            std::cout << "Cannot compute the digest\n";
+            return;
+        }
+        std::cout << "Hashed ranges:\n";
+        for (size_t i = 0; i < ranges.size(); i++) {
+            OUT_PADDED_OFFSET(std::cout, ranges[i].offset);
+            std::cout << " - ";
+            OUT_PADDED_OFFSET(std::cout, (ranges[i].offset + ranges[i].size));
+            std::cout << "\n";
+        }
+        std::cout << "SHA1:   " << AuthenticodeHasher::computeDigest(pe, QCryptographicHash::Sha1).toHex().data() << "\n";
+        std::cout << "SHA256: " << AuthenticodeHasher::computeDigest(pe, QCryptographicHash::Sha256).toHex().data() << std::endl;
+    }
+};
+
+class OverlayInfoCommand : public Command
+{
+public:
+    OverlayInfoCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        const size_t rangesCount = pe->getOverlayRangesCount();
+        if (rangesCount == 0) {
+            std::cout << "No overlay" << std::endl;
+            return;
+        }
+        for (size_t i = 0; i < rangesCount; i++) {
+            offset_t offset = 0;
+            bufsize_t size = 0;
+            if (!pe->getOverlayRange(offset, size, i)) break;
+
+            std::cout << "Overlay: ";
+            OUT_PADDED_OFFSET(std::cout, offset);
+            std::cout << " - ";
+            OUT_PADDED_OFFSET(std::cout, (offset + size));
+            std::cout << "\nSize:    " << std::hex << size << "\n";
+        }
+        if (rangesCount > 1) {
+            std::cout << "[INFO] The overlay is split by the certificates" << std::endl;
+        }
+        std::cout << "Format:  " << PEFile::translateOverlayFormat(pe->getOverlayFormat()).toStdString() << std::endl;
+        if (pe->isTruncated()) {
+            std::cout << "[WARNING] The file was not loaded entirely: the overlay is truncated" << std::endl;
+        }
+    }
+};
+
+class SignatureInfoCommand : public Command
+{
+public:
+    SignatureInfoCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        SecurityDirWrapper *securityDir = pe->getSecurityDir();
+        SignedDataWrapper *signedData = securityDir ? securityDir->getSignedData() : NULL;
+        if (!signedData) {
+            std::cout << "No PKCS#7 signature\n";
+            return;
+        }
+        cmd_util::printSignedData(signedData, 0);
+    }
+};
+
+class DebugInfoCommand : public Command
+{
+public:
+    DebugInfoCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        // the key first, in a single line: easy to collect from the batch output
+        const QString pdbKey = DebugDirWrapper::getPdbKey(pe);
+        std::cout << "PDB key: " << (pdbKey.length() ? pdbKey.toStdString() : "-") << "\n";
+
+        PdbInfo pdb;
+        if (DebugDirWrapper::getPdbInfo(pe, pdb)) {
+            std::cout << "PDB path: " << pdb.path << "\n";
+        }
+        VcFeatureInfo vcFeature;
+        if (DebugDirWrapper::getVcFeature(pe, vcFeature)) {
+            std::cout << std::dec << "VC Feature: Pre-VC++ 11.00: " << vcFeature.preVc11
+                << ", C/C++: " << vcFeature.cCpp
+                << ", /GS: " << vcFeature.gs
+                << ", /sdl: " << vcFeature.sdl
+                << ", guardN: " << vcFeature.guardN << "\n";
+        }
+        DWORD exFlags = 0;
+        if (DebugDirWrapper::getExDllCharacteristics(pe, exFlags)) {
+            std::cout << "Extended DLL Characteristics: " << std::hex << exFlags
+                << " " << DebugDirWrapper::translateExDllCharacteristics(exFlags).toStdString() << "\n";
+        }
+        const QByteArray reproHash = DebugDirWrapper::getReproHash(pe);
+        if (reproHash.size()) {
+            std::cout << "Repro hash: " << reproHash.toHex().data() << "\n";
+        }
+        std::vector<PogoEntry> pogo;
+        DWORD pogoSignature = 0;
+        if (DebugDirWrapper::getPogoEntries(pe, pogo, &pogoSignature)) {
+            std::cout << "POGO (" << std::string((const char*) &pogoSignature, 4).c_str() << "):\n";
+            for (size_t i = 0; i < pogo.size(); i++) {
+                std::cout << "  " << std::hex << pogo[i].rva << " size: " << pogo[i].size << " " << pogo[i].name << "\n";
+            }
+        }
+        std::cout << std::dec;
+    }
+};
+
+class ClrMetadataCommand : public Command
+{
+public:
+    ClrMetadataCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        ClrDirWrapper *clrDir = pe->getClsDir();
+        ClrMetadata *metadata = clrDir ? clrDir->getMetadata() : NULL;
+        if (!metadata) {
+            std::cout << "No .NET metadata\n";
+            return;
+        }
+        std::cout << "Version: " << metadata->getVersionString().toStdString() << "\n";
+        std::cout << "Streams:\n";
+        for (const ClrStream &stream : metadata->getStreams()) {
+            std::cout << "  " << stream.name << " offset: " << std::hex << stream.offset << " size: " << stream.size << "\n";
+        }
+        std::cout << "Tables:\n";
+        for (int i = 0; i < ClrMetadata::TABLES_COUNT; i++) {
+            const ClrMetadata::table_id table = static_cast<ClrMetadata::table_id>(i);
+            if (!metadata->getTable(table).isValid()) continue;
+            std::cout << "  " << ClrMetadata::getTableName(table).toStdString() << ": " << std::dec << metadata->getRowsCount(table) << "\n";
+        }
+        for (uint32_t rid = 1; rid <= metadata->getRowsCount(ClrMetadata::TABLE_ASSEMBLY_REF); rid++) {
+            std::cout << "AssemblyRef: " << metadata->getAssemblyRefName(rid) << " " << metadata->getAssemblyRefVersion(rid).toStdString() << "\n";
+        }
+        std::vector<ClrManagedResource> resources;
+        clrDir->getManagedResources(resources);
+        for (const ClrManagedResource &resource : resources) {
+            std::cout << "Resource: " << resource.name;
+            if (resource.raw != INVALID_ADDR) {
+                std::cout << " raw: " << std::hex << resource.raw << " size: " << resource.size;
+            } else {
+                std::cout << " (not embedded)";
+            }
+            std::cout << "\n";
+        }
+        const QByteArray strongNameHash = clrDir->computeStrongNameHash();
+        if (strongNameHash.size()) {
+            std::cout << "Strong name hash: " << strongNameHash.toHex().data() << "\n";
+        }
+
+        const size_t limit = cmd_util::readNumber("max types to list");
+        const uint32_t typesCount = metadata->getRowsCount(ClrMetadata::TABLE_TYPE_DEF);
+        for (uint32_t rid = 1; rid <= typesCount && rid <= limit; rid++) {
+            uint32_t firstIndex = 0;
+            const uint32_t methodsCount = metadata->getTypeMethods(rid, firstIndex);
+            std::cout << metadata->getTypeFullName(rid) << " (" << std::dec << methodsCount << " methods)\n";
+            for (uint32_t i = 0; i < methodsCount; i++) {
+                const uint32_t methodRid = metadata->resolveMethod(firstIndex + i);
+                std::cout << "    " << metadata->getMethodName(methodRid) << " RVA: " << std::hex << metadata->getMethodRva(methodRid) << "\n";
+            }
+        }
+        std::cout << std::endl;
+    }
+};
+
+class FuzzyHashCommand : public Command
+{
+public:
+    FuzzyHashCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        std::vector<AbstractByteBuffer*> bufs;
+        std::vector<std::string> names;
+        bufs.push_back(pe);
+        names.push_back("[file]");
+
+        const size_t sectCount = pe->getSectionsCount(true);
+        for (size_t i = 0; i < sectCount; i++) {
+            BufferView *secView = pe->createSectionView(i);
+            if (!secView) continue;
+            SectionHdrWrapper *sec = pe->getSecHdr(i);
+            bufs.push_back(secView);
+            names.push_back(sec ? sec->getName().toStdString() : "");
+        }
+        const size_t overlayRanges = pe->getOverlayRangesCount();
+        for (size_t i = 0; i < overlayRanges; i++) {
+            BufferView *overlay = pe->getOverlay(i);
+            if (!overlay) continue;
+            bufs.push_back(overlay);
+            names.push_back((i == 0) ? "[overlay]" : "[overlay" + std::to_string(i + 1) + "]");
+        }
+
+        std::vector<FuzzyDigest> digests;
+        FuzzyHasher::computeMany(bufs, digests);
+
+        for (size_t i = 0; i < bufs.size(); i++) {
+            std::cout << QString::fromStdString(names[i]).leftJustified(10).toStdString()
+                << " CTPH: " << digests[i].ctph.toStdString() << "\n"
+                << std::string(10, ' ')
+                << " TLSH: " << (digests[i].tlsh.length() ? digests[i].tlsh.toStdString() : "-") << "\n";
+        }
+        std::cout << std::endl;
+
+        // the first one is the PE itself
+        for (size_t i = 1; i < bufs.size(); i++) {
+            delete bufs[i];
+        }
+    }
+};
+
 class PrintWrapperTypesCommand : public Command
 {
 public:
@@ -161,6 +532,83 @@ public:
     }
 };
 
+class FindResourceCommand : public Command
+{
+public:
+    FindResourceCommand(const std::string& desc)
+        : Command(desc) {}
+
+    static void printRecord(const ResourceIndex &index, size_t i)
+    {
+        const ResourceRecord *record = index.getRecord(i);
+        if (!record) return;
+
+        QString typeName = index.getKeyName(record->type);
+        if (!ResourceIndex::isNamed(record->type)) {
+            const QString translated = ResourceEntryWrapper::translateType(static_cast<WORD>(record->type));
+            if (translated.length()) typeName += " (" + translated + ")";
+        }
+        std::cout << typeName.toStdString() << " / "
+            << index.getKeyName(record->name).toStdString() << " / "
+            << std::dec << record->lang
+            << " : RVA = " << std::hex << record->dataRva
+            << " size = " << record->size
+            << " codepage = " << std::dec << record->codepage << "\n";
+    }
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        ResourceIndex index(pe);
+        if (index.count() == 0) {
+            std::cout << "No resources!" << std::endl;
+            return;
+        }
+        std::cout << "Resources: " << std::dec << index.count() << "\n";
+
+        const QString path = QString::fromStdString(cmd_util::readString("path (type/name[/lang], i.e. RT_MANIFEST/1; *: all)"));
+        if (path == "*") {
+            for (size_t i = 0; i < index.count(); i++) {
+                printRecord(index, i);
+            }
+            std::cout << std::endl;
+            return;
+        }
+        const size_t found = index.findPath(path);
+        if (found == ResourceIndex::NOT_FOUND) {
+            std::cout << "Not found" << std::endl;
+            return;
+        }
+        printRecord(index, found);
+        std::cout << std::endl;
+    }
+};
+
+class ExtractResourcesCommand : public Command
+{
+public:
+    ExtractResourcesCommand(const std::string& desc)
+        : Command(desc) {}
+
+    virtual void execute(CmdParams *params, CmdContext  *context)
+    {
+        PEFile *pe = cmd_util::getPEFromContext(context);
+        if (!pe) return;
+
+        ResourceExtractor extractor(pe);
+        const size_t count = extractor.getIndex().count();
+        if (count == 0) {
+            std::cout << "No resources!" << std::endl;
+            return;
+        }
+        const QString dirPath = QString::fromStdString(cmd_util::readString("output directory"));
+        const size_t written = extractor.extractToDir(dirPath);
+        std::cout << "Extracted: " << std::dec << written << " of " << count << std::endl;
+    }
+};
+
 class MoveDataDirEntryCommand : public Command
 {
 public:
@@ -0,0 +1,390 @@
+#include "ArchiveReader.h"
+#include "ExeFactory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+    const char AR_MAGIC[] = "!<arch>\n";
+    const size_t AR_MAGIC_LEN = 8;
+
+    const char AR_FMAG[] = "`\n";
+    const char BSD_NAME_PREFIX[] = "#1/";
+    const char BSD_SYMDEF[] = "__.SYMDEF";
+    const char BSD_SYMDEF_64[] = "__.SYMDEF_64";
+
+    // struct ar_hdr (<ar.h>): the fields are ASCII, padded with spaces
+    struct ar_hdr {
+        char ar_name[16];
+        char ar_date[12];
+        char ar_uid[6];
+        char ar_gid[6];
+        char ar_mode[8];
+        char ar_size[10];
+        char ar_fmag[2];
+    };
+
+    bool readDecimal(const char *field, size_t fieldLen, uint64_t &value)
+    {
+        value = 0;
+        size_t i = 0;
+        for (; i < fieldLen && field[i] >= '0' && field[i] <= '9'; i++) {
+            value = value * 10 + (field[i] - '0');
+        }
+        if (i == 0) return false;
+        // only the padding may follow the digits
+        for (; i < fieldLen; i++) {
+            if (field[i] != ' ') return false;
+        }
+        return true;
+    }
+
+    std::string_view trimName(const char *name, size_t len)
+    {
+        while (len > 0 && name[len - 1] == ' ') len--;
+        return std::string_view(name, len);
+    }
+
+    uint32_t readBigEndian32(const BYTE *ptr)
+    {
+        return (uint32_t(ptr[0]) << 24) | (uint32_t(ptr[1]) << 16) | (uint32_t(ptr[2]) << 8) | uint32_t(ptr[3]);
+    }
+
+    uint64_t readBigEndian64(const BYTE *ptr)
+    {
+        return (uint64_t(readBigEndian32(ptr)) << 32) | readBigEndian32(ptr + sizeof(uint32_t));
+    }
+};
+
+bool ArchiveReader::isArchive(AbstractByteBuffer *buf)
+{
+    const BYTE *magic = buf ? buf->getContentAt(0, AR_MAGIC_LEN) : NULL;
+    return magic && memcmp(magic, AR_MAGIC, AR_MAGIC_LEN) == 0;
+}
+
+ArchiveReader::ArchiveReader(AbstractByteBuffer *v_buf)
+    : buf(v_buf), format(FORMAT_UNKNOWN)
+{
+    // the thin archives ("!<thin>\n") only refer to the files of the members
+    if (!isArchive(buf)) {
+        throw ArchiveException("Not an ar archive");
+    }
+    readMembers();
+}
+
+ArchiveReader::~ArchiveReader()
+{
+    // the executables refer to the views
+    for (Executable *exe : exes) {
+        delete exe;
+    }
+    for (BufferView *view : views) {
+        delete view;
+    }
+}
+
+void ArchiveReader::readMembers()
+{
+    const offset_t bufSize = buf->getContentSize();
+
+    // the special members are read after the others are known: they refer to their headers
+    offset_t symbolsRaw = INVALID_ADDR, secondLinkerRaw = INVALID_ADDR;
+    bufsize_t symbolsSize = 0, secondLinkerSize = 0;
+    bool isSymbols64 = false;
+    std::string_view longNames;
+
+    offset_t offset = AR_MAGIC_LEN;
+    while (offset + sizeof(ar_hdr) <= bufSize) {
+        const ar_hdr *hdr = (const ar_hdr*) buf->getContentAt(offset, sizeof(ar_hdr));
+        if (!hdr) break;
+
+        uint64_t size = 0;
+        if (memcmp(hdr->ar_fmag, AR_FMAG, sizeof(hdr->ar_fmag)) != 0 || !readDecimal(hdr->ar_size, sizeof(hdr->ar_size), size)) {
+            Logger::append(Logger::D_WARNING, "Invalid archive member header at: %llX", static_cast<unsigned long long>(offset));
+            break;
+        }
+        const offset_t headerOffset = offset;
+        offset_t dataOffset = offset + sizeof(ar_hdr);
+        if (size > bufSize - dataOffset) {
+            Logger::append(Logger::D_WARNING, "Truncated archive member at: %llX", static_cast<unsigned long long>(offset));
+            size = bufSize - dataOffset;
+        }
+        // the data is padded to an even size
+        offset = dataOffset + size + (size & 1);
+
+        const std::string_view rawName(hdr->ar_name, sizeof(hdr->ar_name));
+        std::string_view name = trimName(hdr->ar_name, sizeof(hdr->ar_name));
+
+        if (rawName.compare(0, strlen(BSD_NAME_PREFIX), BSD_NAME_PREFIX) == 0) {
+            // BSD: the name precedes the data
+            uint64_t nameLen = 0;
+            if (!readDecimal(hdr->ar_name + 3, sizeof(hdr->ar_name) - 3, nameLen) || nameLen > size) continue;
+
+            const char *namePtr = (const char*) buf->getContentAt(dataOffset, static_cast<bufsize_t>(nameLen));
+            if (!namePtr) continue;
+
+            name = std::string_view(namePtr, strnlen(namePtr, static_cast<size_t>(nameLen)));
+            dataOffset += nameLen;
+            size -= nameLen;
+            format = FORMAT_BSD;
+
+            if (name.compare(0, strlen(BSD_SYMDEF), BSD_SYMDEF) == 0) {
+                if (symbolsRaw == INVALID_ADDR) {
+                    symbolsRaw = dataOffset;
+                    symbolsSize = static_cast<bufsize_t>(size);
+                    isSymbols64 = (name.compare(0, strlen(BSD_SYMDEF_64), BSD_SYMDEF_64) == 0);
+                }
+                continue;
+            }
+        }
+        else if (name == BSD_SYMDEF || name == BSD_SYMDEF_64 || name == "__.SYMDEF SORTED") {
+            // BSD, with the short name
+            format = FORMAT_BSD;
+            if (symbolsRaw == INVALID_ADDR) {
+                symbolsRaw = dataOffset;
+                symbolsSize = static_cast<bufsize_t>(size);
+                isSymbols64 = (name == BSD_SYMDEF_64);
+            }
+            continue;
+        }
+        else if (name == "/" || name == "/SYM64/") {
+            // the first one: GNU, or the first linker member of COFF; the second one: the second linker member of COFF
+            if (symbolsRaw == INVALID_ADDR) {
+                format = FORMAT_GNU;
+                symbolsRaw = dataOffset;
+                symbolsSize = static_cast<bufsize_t>(size);
+                isSymbols64 = (name == "/SYM64/");
+            } else if (secondLinkerRaw == INVALID_ADDR) {
+                format = FORMAT_COFF;
+                secondLinkerRaw = dataOffset;
+                secondLinkerSize = static_cast<bufsize_t>(size);
+            }
+            continue;
+        }
+        else if (name == "//") {
+            const char *names = (const char*) buf->getContentAt(dataOffset, static_cast<bufsize_t>(size));
+            if (names) longNames = std::string_view(names, static_cast<size_t>(size));
+            continue;
+        }
+        else if (name.size() > 1 && name[0] == '/') {
+            uint64_t nameOffset = 0;
+            if (!readDecimal(name.data() + 1, name.size() - 1, nameOffset)) {
+                continue; // i.e. "/<ECSYMBOLS>/", "/<HYBRIDMAP>/"
+            }
+            // GNU: terminated by "/\n"; COFF: by NUL
+            if (nameOffset >= longNames.size()) {
+                Logger::append(Logger::D_WARNING, "Invalid long name of the archive member at: %llX", static_cast<unsigned long long>(headerOffset));
+                name = std::string_view();
+            } else {
+                name = longNames.substr(static_cast<size_t>(nameOffset));
+                name = name.substr(0, std::min(name.find('\n'), name.find('\0')));
+            }
+        }
+        // GNU: the short names are terminated by '/'
+        if (!name.empty() && name.back() == '/') {
+            name.remove_suffix(1);
+        }
+        members.push_back({ std::string(name), headerOffset, dataOffset, static_cast<bufsize_t>(size) });
+    }
+
+    views.reserve(members.size());
+    for (const ArchiveMember &member : members) {
+        views.push_back(new BufferView(buf, member.dataOffset, member.size));
+    }
+    exes.assign(members.size(), NULL);
+    std::vector<std::once_flag>(members.size()).swap(built);
+
+    if (secondLinkerRaw != INVALID_ADDR && readCoffSymbols(secondLinkerRaw, secondLinkerSize)) {
+        return;
+    }
+    if (symbolsRaw == INVALID_ADDR) return;
+
+    if (format == FORMAT_BSD) {
+        readBsdSymbols(symbolsRaw, symbolsSize, isSymbols64);
+    } else {
+        readGnuSymbols(symbolsRaw, symbolsSize, isSymbols64);
+    }
+}
+
+//---
+
+size_t ArchiveReader::memberAtHeader(offset_t headerOffset) const
+{
+    // the members are sorted by their offsets
+    auto itr = std::lower_bound(members.begin(), members.end(), headerOffset, [](const ArchiveMember &member, offset_t offset) {
+        return member.headerOffset < offset;
+    });
+    if (itr == members.end() || itr->headerOffset != headerOffset) return NOT_FOUND;
+    return static_cast<size_t>(itr - members.begin());
+}
+
+void ArchiveReader::addSymbol(std::string_view name, offset_t headerOffset)
+{
+    const size_t member = memberAtHeader(headerOffset);
+    if (member == NOT_FOUND || name.empty()) return;
+
+    symbols.push_back({ name, member });
+    symbolsByName.emplace(name, member); // keeps the first definition
+}
+
+bool ArchiveReader::readSymbolNames(offset_t raw, bufsize_t size, const std::vector<offset_t> &headerOffsets)
+{
+    const char *strings = (const char*) buf->getContentAt(raw, size);
+    if (!strings && size) return false;
+
+    size_t pos = 0;
+    for (offset_t headerOffset : headerOffsets) {
+        if (pos >= size) return false;
+
+        const char *end = (const char*) memchr(strings + pos, '\0', size - pos);
+        const size_t len = end ? static_cast<size_t>(end - (strings + pos)) : (size - pos);
+        addSymbol(std::string_view(strings + pos, len), headerOffset);
+        pos += len + 1;
+    }
+    return true;
+}
+
+bool ArchiveReader::readGnuSymbols(offset_t raw, bufsize_t size, bool is64)
+{
+    // big endian: the count, the offsets of the member headers, the names
+    const bufsize_t fieldSize = is64 ? sizeof(uint64_t) : sizeof(uint32_t);
+    const BYTE *table = buf->getContentAt(raw, size);
+    if (!table || size < fieldSize) return false;
+
+    const uint64_t count = is64 ? readBigEndian64(table) : readBigEndian32(table);
+    if (count > (size - fieldSize) / fieldSize) {
+        Logger::append(Logger::D_WARNING, "Invalid symbol table of the archive");
+        return false;
+    }
+    std::vector<offset_t> headerOffsets(static_cast<size_t>(count));
+    for (size_t i = 0; i < headerOffsets.size(); i++) {
+        const BYTE *field = table + fieldSize * (i + 1);
+        headerOffsets[i] = is64 ? readBigEndian64(field) : readBigEndian32(field);
+    }
+    symbols.reserve(headerOffsets.size());
+
+    const bufsize_t namesOffset = static_cast<bufsize_t>(fieldSize * (count + 1));
+    return readSymbolNames(raw + namesOffset, size - namesOffset, headerOffsets);
+}
+
+bool ArchiveReader::readCoffSymbols(offset_t raw, bufsize_t size)
+{
+    // little endian: the offsets of the members, then the symbols: the indices of the members (1-based), the names sorted
+    const BYTE *table = buf->getContentAt(raw, size);
+    // at least both counts
+    if (!table || size < 2 * sizeof(uint32_t)) return false;
+
+    uint32_t membersCount = 0;
+    memcpy(&membersCount, table, sizeof(uint32_t));
+    if (membersCount > (size - 2 * sizeof(uint32_t)) / sizeof(uint32_t)) return false;
+
+    const BYTE *offsets = table + sizeof(uint32_t);
+    const bufsize_t symbolsOffset = sizeof(uint32_t) * (membersCount + 1);
+    if (symbolsOffset + sizeof(uint32_t) > size) return false;
+
+    uint32_t symbolsCount = 0;
+    memcpy(&symbolsCount, table + symbolsOffset, sizeof(uint32_t));
+    if (symbolsCount > (size - symbolsOffset - sizeof(uint32_t)) / sizeof(uint16_t)) return false;
+
+    const BYTE *indices = table + symbolsOffset + sizeof(uint32_t);
+    std::vector<offset_t> headerOffsets(symbolsCount, INVALID_ADDR);
+    for (size_t i = 0; i < symbolsCount; i++) {
+        uint16_t index = 0;
+        memcpy(&index, indices + i * sizeof(uint16_t), sizeof(uint16_t));
+        if (index < 1 || index > membersCount) continue;
+
+        uint32_t headerOffset = 0;
+        memcpy(&headerOffset, offsets + (index - 1) * sizeof(uint32_t), sizeof(uint32_t));
+        headerOffsets[i] = headerOffset;
+    }
+    symbols.reserve(headerOffsets.size());
+
+    const bufsize_t namesOffset = symbolsOffset + sizeof(uint32_t) + symbolsCount * sizeof(uint16_t);
+    return readSymbolNames(raw + namesOffset, size - namesOffset, headerOffsets);
+}
+
+bool ArchiveReader::readBsdSymbols(offset_t raw, bufsize_t size, bool is64)
+{
+    // struct ranlib { strx; offset }, preceded by their size in bytes, followed by the size of the strings and the strings
+    const bufsize_t fieldSize = is64 ? sizeof(uint64_t) : sizeof(uint32_t);
+    const BYTE *table = buf->getContentAt(raw, size);
+    if (!table || size < 2 * fieldSize) return false;
+
+    uint64_t ranlibSize = 0;
+    memcpy(&ranlibSize, table, fieldSize);
+    if (ranlibSize > size - 2 * fieldSize) {
+        Logger::append(Logger::D_WARNING, "Invalid symbol table of the archive");
+        return false;
+    }
+    const BYTE *ranlibs = table + fieldSize;
+    const size_t count = static_cast<size_t>(ranlibSize / (2 * fieldSize));
+
+    uint64_t stringsSize = 0;
+    memcpy(&stringsSize, ranlibs + ranlibSize, fieldSize);
+    const bufsize_t stringsOffset = static_cast<bufsize_t>(2 * fieldSize + ranlibSize);
+    stringsSize = std::min<uint64_t>(stringsSize, size - stringsOffset);
+    const char *strings = (const char*) (table + stringsOffset);
+
+    symbols.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        uint64_t strx = 0, headerOffset = 0;
+        memcpy(&strx, ranlibs + i * 2 * fieldSize, fieldSize);
+        memcpy(&headerOffset, ranlibs + i * 2 * fieldSize + fieldSize, fieldSize);
+        if (strx >= stringsSize) continue;
+
+        const size_t maxLen = static_cast<size_t>(stringsSize - strx);
+        addSymbol(std::string_view(strings + strx, strnlen(strings + strx, maxLen)), headerOffset);
+    }
+    return true;
+}
+
+//---
+
+BufferView* ArchiveReader::getMemberBuffer(size_t index) const
+{
+    if (index >= views.size()) return NULL;
+    return views[index];
+}
+
+size_t ArchiveReader::findMember(std::string_view name) const
+{
+    for (size_t i = 0; i < members.size(); i++) {
+        if (members[i].name == name) return i;
+    }
+    return NOT_FOUND;
+}
+
+size_t ArchiveReader::findSymbol(std::string_view name) const
+{
+    auto itr = symbolsByName.find(name);
+    if (itr == symbolsByName.end()) return NOT_FOUND;
+    return itr->second;
+}
+
+Executable* ArchiveReader::getMember(size_t index)
+{
+    if (index >= views.size()) return NULL;
+
+    std::call_once(built[index], [this, index]() {
+        BufferView *view = views[index];
+        const ExeFactory::exe_type type = ExeFactory::findMatching(view);
+        if (type != ExeFactory::NONE) {
+            exes[index] = ExeFactory::build(view, type);
+        }
+    });
+    return exes[index];
+}
+
+size_t ArchiveReader::buildMembers(size_t threads)
+{
+    if (members.empty()) return 0;
+
+    ExeFactory::init(); // before the workers start: it is not thread-safe
+
+    std::atomic<size_t> builtCount(0);
+    pe_util::parallelFor(members.size(), threads, [&](size_t indx) {
+        if (getMember(indx)) builtCount++;
+    });
+    return builtCount;
+}
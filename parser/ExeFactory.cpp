@@ -4,17 +4,28 @@
 #include "pe/PEFile.h"
 
 #include "elf/ELFFile.h"
+#include "macho/MachOFile.h"
+
+#include <algorithm>
+#include <functional>
 
 std::map<ExeFactory::exe_type, ExeBuilder*> ExeFactory::builders;
+std::vector<ExeFactory::exe_type> ExeFactory::precedence;
+
+std::unordered_map<uint64_t, std::vector<ExeFactory::exe_type>> ExeFactory::byMagic;
+std::vector<size_t> ExeFactory::magicLengths;
+std::vector<ExeFactory::exe_type> ExeFactory::withoutMagic;
 
 void ExeFactory::init()
 {
     if (builders.size() > 0) {
         return; // already initialized
     }
-    builders[MZ] = new  DOSExeBuilder();
-    builders[PE] = new  PEFileBuilder();
-    builders[ELF] = new ELFFileBuilder();
+    // PE is registered after MZ, so it is checked first: every PE starts with the MZ header
+    addBuilder(new DOSExeBuilder(), MZ);
+    addBuilder(new PEFileBuilder(), PE);
+    addBuilder(new ELFFileBuilder(), ELF);
+    addBuilder(new MachOFileBuilder(), MACHO);
 }
 
 void ExeFactory::destroy()
@@ -25,6 +36,80 @@ void ExeFactory::destroy()
         delete builder;
     }
     builders.clear();
+    precedence.clear();
+    rebuildDispatch();
+}
+
+ExeFactory::exe_type ExeFactory::registerBuilder(ExeBuilder *builder, exe_type type)
+{
+    if (!builder) return NONE;
+
+    ExeFactory::init(); // the built-in builders go first, so that the custom ones take precedence
+    return addBuilder(builder, type);
+}
+
+ExeFactory::exe_type ExeFactory::addBuilder(ExeBuilder *builder, exe_type type)
+{
+    if (type == NONE) {
+        int nextType = TYPES_COUNT;
+        if (builders.size() > 0) {
+            nextType = std::max<int>(nextType, builders.rbegin()->first + 1);
+        }
+        type = static_cast<exe_type>(nextType);
+    }
+
+    std::map<exe_type, ExeBuilder*>::iterator found = builders.find(type);
+    if (found != builders.end()) {
+        if (found->second == builder) return type; // already registered
+        delete found->second;
+        precedence.erase(std::remove(precedence.begin(), precedence.end(), type), precedence.end());
+    }
+    builders[type] = builder;
+    precedence.insert(precedence.begin(), type);
+
+    rebuildDispatch();
+    return type;
+}
+
+uint64_t ExeFactory::magicKey(const BYTE *magic, size_t length)
+{
+    uint64_t key = uint64_t(length) << 32;
+    for (size_t i = 0; i < length; i++) {
+        key |= uint64_t(magic[i]) << (8 * i);
+    }
+    return key;
+}
+
+void ExeFactory::rebuildDispatch()
+{
+    byMagic.clear();
+    magicLengths.clear();
+    withoutMagic.clear();
+
+    for (exe_type type : precedence) {
+        ExeBuilder* builder = builders[type];
+        if (!builder) continue;
+
+        const std::vector<QByteArray> magics = builder->magics();
+        bool hasMagic = false;
+        for (const QByteArray &magic : magics) {
+            const size_t length = static_cast<size_t>(magic.size());
+            if (length == 0 || length > MAGIC_MAX) continue;
+
+            std::vector<exe_type> &candidates = byMagic[magicKey(reinterpret_cast<const BYTE*>(magic.constData()), length)];
+            if (std::find(candidates.begin(), candidates.end(), type) == candidates.end()) {
+                candidates.push_back(type);
+            }
+            if (std::find(magicLengths.begin(), magicLengths.end(), length) == magicLengths.end()) {
+                magicLengths.push_back(length);
+            }
+            hasMagic = true;
+        }
+        if (!hasMagic) {
+            withoutMagic.push_back(type);
+        }
+    }
+    std::sort(magicLengths.begin(), magicLengths.end(), std::greater<size_t>());
 }
 
 ExeFactory::exe_type ExeFactory::findMatching(AbstractByteBuffer *buf)
@@ -33,14 +118,29 @@ ExeFactory::exe_type ExeFactory::findMatching(AbstractByteBuffer *buf)
     
     ExeFactory::init(); //ensue that the builders are initialized
 
-    std::map<exe_type, ExeBuilder*>::iterator itr;
-    for (itr = builders.begin(); itr != builders.end(); ++itr) {
+    const size_t available = std::min<size_t>(size_t(MAGIC_MAX), buf->getContentSize());
+    const BYTE *magic = (available > 0) ? buf->getContentAt(0, static_cast<bufsize_t>(available)) : NULL;
 
-        ExeBuilder* builder = itr->second;
-        if (builder == NULL) continue;
+    if (magic) {
+        // the longest magic is the most specific one
+        for (size_t length : magicLengths) {
+            if (length > available) continue;
 
-        if (builder->signatureMatches(buf)) {
-            return itr->first;
+            std::unordered_map<uint64_t, std::vector<exe_type>>::const_iterator found = byMagic.find(magicKey(magic, length));
+            if (found == byMagic.end()) continue;
+
+            for (exe_type type : found->second) {
+                ExeBuilder* builder = builders[type];
+                if (builder && builder->signatureMatches(buf)) {
+                    return type;
+                }
+            }
+        }
+    }
+    for (exe_type type : withoutMagic) {
+        ExeBuilder* builder = builders[type];
+        if (builder && builder->signatureMatches(buf)) {
+            return type;
         }
     }
     return NONE;
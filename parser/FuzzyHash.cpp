@@ -0,0 +1,445 @@
+#include "FuzzyHash.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    const char BASE64_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    inline uint32_t sumHash(BYTE c, uint32_t h)
+    {
+        return (h * 0x01000193) ^ c;
+    }
+
+    // ssdeep: runs longer than 3 identical characters do not add any information
+    std::string eliminateSequences(const std::string &str)
+    {
+        std::string out;
+        for (size_t i = 0; i < str.length(); i++) {
+            if (i >= 3 && str[i] == str[i - 1] && str[i] == str[i - 2] && str[i] == str[i - 3]) continue;
+            out.push_back(str[i]);
+        }
+        return out;
+    }
+
+    bool hasCommonSubstring(const std::string &s1, const std::string &s2, size_t length)
+    {
+        if (s1.length() < length || s2.length() < length) return false;
+        for (size_t i = 0; i + length <= s1.length(); i++) {
+            if (s2.find(s1.c_str() + i, 0, length) != std::string::npos) return true;
+        }
+        return false;
+    }
+
+    // insertion and deletion cost 1, substitution costs 2
+    size_t editDistance(const std::string &s1, const std::string &s2)
+    {
+        std::vector<size_t> prev(s2.length() + 1);
+        std::vector<size_t> curr(s2.length() + 1);
+        for (size_t j = 0; j <= s2.length(); j++) prev[j] = j;
+
+        for (size_t i = 1; i <= s1.length(); i++) {
+            curr[0] = i;
+            for (size_t j = 1; j <= s2.length(); j++) {
+                const size_t replaceCost = (s1[i - 1] == s2[j - 1]) ? 0 : 2;
+                curr[j] = std::min(std::min(prev[j] + 1, curr[j - 1] + 1), prev[j - 1] + replaceCost);
+            }
+            prev.swap(curr);
+        }
+        return prev[s2.length()];
+    }
+
+    //---
+    // Pearson hashing used by the triplets histogram: a fixed permutation of 0-255
+
+    struct PearsonTable
+    {
+        constexpr PearsonTable() : values()
+        {
+            for (size_t i = 0; i < 256; i++) values[i] = static_cast<BYTE>(i);
+            // Fisher-Yates shuffle driven by a fixed LCG
+            uint32_t seed = 0x5EED1E55;
+            for (size_t i = 255; i > 0; i--) {
+                seed = seed * 1103515245 + 12345;
+                const size_t j = (seed >> 8) % (i + 1);
+                const BYTE tmp = values[i];
+                values[i] = values[j];
+                values[j] = tmp;
+            }
+        }
+        BYTE values[256];
+    };
+
+    constexpr PearsonTable PEARSON;
+
+    inline BYTE pearsonHash(BYTE salt, BYTE c1, BYTE c2, BYTE c3)
+    {
+        BYTE h = PEARSON.values[salt];
+        h = PEARSON.values[h ^ c1];
+        h = PEARSON.values[h ^ c2];
+        return PEARSON.values[h ^ c3];
+    }
+
+    BYTE lengthCapturing(uint64_t length)
+    {
+        double value = 0;
+        if (length <= 656) {
+            value = std::log(static_cast<double>(length)) / std::log(1.5);
+        } else if (length <= 3199) {
+            value = std::log(static_cast<double>(length)) / std::log(1.3) - 8.72777;
+        } else {
+            value = std::log(static_cast<double>(length)) / std::log(1.1) - 62.5472;
+        }
+        return static_cast<BYTE>(static_cast<uint64_t>(std::floor(value)) & 0xFF);
+    }
+
+    inline int modDiff(int a, int b, int range)
+    {
+        const int d = (a > b) ? (a - b) : (b - a);
+        return std::min(d, range - d);
+    }
+
+    bool hexToBytes(const std::string &str, std::vector<BYTE> &bytes)
+    {
+        if (str.length() % 2) return false;
+        for (size_t i = 0; i < str.length(); i += 2) {
+            const std::string byteStr = str.substr(i, 2);
+            char *end = NULL;
+            const unsigned long val = strtoul(byteStr.c_str(), &end, 16);
+            if (!end || *end != '\0') return false;
+            bytes.push_back(static_cast<BYTE>(val));
+        }
+        return true;
+    }
+
+}; //namespace
+
+//----
+
+void CtphHasher::reset()
+{
+    bhStart = 0;
+    bhEnd = 1;
+    totalSize = 0;
+
+    memset(blocks, 0, sizeof(blocks));
+    blocks[0].h = HASH_INIT;
+    blocks[0].halfH = HASH_INIT;
+
+    memset(window, 0, sizeof(window));
+    h1 = h2 = h3 = n = 0;
+}
+
+uint32_t CtphHasher::rollHash(BYTE c)
+{
+    h2 -= h1;
+    h2 += ROLLING_WINDOW * c;
+
+    h1 += c;
+    h1 -= window[n % ROLLING_WINDOW];
+
+    window[n % ROLLING_WINDOW] = c;
+    n++;
+
+    h3 <<= 5;
+    h3 ^= c;
+    return h1 + h2 + h3;
+}
+
+void CtphHasher::tryForkBlockhash()
+{
+    if (bhEnd >= NUM_BLOCKHASHES) return;
+
+    const BlockHash &last = blocks[bhEnd - 1];
+    BlockHash &next = blocks[bhEnd];
+    next.h = last.h;
+    next.halfH = last.halfH;
+    next.digest[0] = '\0';
+    next.halfDigest = '\0';
+    next.length = 0;
+    bhEnd++;
+}
+
+void CtphHasher::tryReduceBlockhash()
+{
+    if (bhEnd - bhStart < 2) return;
+    // the initial guess of the block size would select this one or a smaller one
+    if (static_cast<uint64_t>(blockSize(bhStart)) * SPAMSUM_LENGTH >= totalSize) return;
+    // the guess adjustment would select this one
+    if (blocks[bhStart + 1].length < SPAMSUM_LENGTH / 2) return;
+    bhStart++;
+}
+
+void CtphHasher::update(const BYTE *data, bufsize_t size)
+{
+    if (!data) return;
+
+    totalSize += size;
+    for (bufsize_t k = 0; k < size; k++) {
+        const BYTE c = data[k];
+        const uint32_t h = rollHash(c);
+
+        for (size_t i = bhStart; i < bhEnd; i++) {
+            blocks[i].h = sumHash(c, blocks[i].h);
+            blocks[i].halfH = sumHash(c, blocks[i].halfH);
+        }
+        for (size_t i = bhStart; i < bhEnd; i++) {
+            // if the trigger fails for this block size, it fails for all the bigger ones
+            if ((h % blockSize(i)) != (blockSize(i) - 1)) break;
+
+            BlockHash &block = blocks[i];
+            if (block.length == 0) tryForkBlockhash();
+
+            block.digest[block.length] = BASE64_CHARS[block.h % 64];
+            block.halfDigest = BASE64_CHARS[block.halfH % 64];
+            if (block.length < SPAMSUM_LENGTH - 1) {
+                block.length++;
+                block.digest[block.length] = '\0';
+                block.h = HASH_INIT;
+                if (block.length < SPAMSUM_LENGTH / 2) {
+                    block.halfH = HASH_INIT;
+                    block.halfDigest = '\0';
+                }
+            } else {
+                tryReduceBlockhash();
+            }
+        }
+    }
+}
+
+QString CtphHasher::digest() const
+{
+    size_t bi = bhStart;
+    const uint32_t h = h1 + h2 + h3;
+
+    // initial block size guess
+    while (static_cast<uint64_t>(blockSize(bi)) * SPAMSUM_LENGTH < totalSize) {
+        bi++;
+        if (bi >= NUM_BLOCKHASHES) return ""; // too big
+    }
+    // adapt the guess to the actual digest length
+    while (bi >= bhEnd) bi--;
+    while (bi > bhStart && blocks[bi].length < SPAMSUM_LENGTH / 2) bi--;
+
+    std::string result = std::to_string(blockSize(bi)) + ":";
+
+    const BlockHash &first = blocks[bi];
+    result.append(first.digest, first.length);
+    if (h != 0) {
+        result.push_back(BASE64_CHARS[first.h % 64]);
+    } else if (first.digest[first.length] != '\0') {
+        result.push_back(first.digest[first.length]);
+    }
+    result.push_back(':');
+
+    if (bi < bhEnd - 1) {
+        const BlockHash &second = blocks[bi + 1];
+        const size_t length = std::min(second.length, SPAMSUM_LENGTH / 2 - 1);
+        result.append(second.digest, length);
+        if (h != 0) {
+            result.push_back(BASE64_CHARS[second.halfH % 64]);
+        } else if (second.halfDigest != '\0') {
+            result.push_back(second.halfDigest);
+        }
+    } else if (h != 0) {
+        result.push_back(BASE64_CHARS[first.h % 64]);
+    }
+    return QString::fromLatin1(result.c_str(), static_cast<int>(result.length()));
+}
+
+int CtphHasher::compare(const QString &digest1, const QString &digest2)
+{
+    const QStringList parts1 = digest1.split(":");
+    const QStringList parts2 = digest2.split(":");
+    if (parts1.size() != 3 || parts2.size() != 3) return 0;
+
+    bool isOk1 = false, isOk2 = false;
+    const uint64_t bs1 = parts1[0].toULongLong(&isOk1);
+    const uint64_t bs2 = parts2[0].toULongLong(&isOk2);
+    if (!isOk1 || !isOk2) return 0;
+
+    // only the digests of the same or the neighbouring block sizes can be compared
+    if (bs1 != bs2 && (bs1 * 2) != bs2 && (bs2 * 2) != bs1) return 0;
+
+    const std::string s1b1 = eliminateSequences(parts1[1].toStdString());
+    const std::string s1b2 = eliminateSequences(parts1[2].toStdString());
+    const std::string s2b1 = eliminateSequences(parts2[1].toStdString());
+    const std::string s2b2 = eliminateSequences(parts2[2].toStdString());
+
+    if (bs1 == bs2 && s1b1 == s2b1 && s1b2 == s2b2) return 100;
+
+    struct Scorer {
+        static uint64_t score(const std::string &s1, const std::string &s2, uint64_t blockSize)
+        {
+            if (s1.length() > SPAMSUM_LENGTH || s2.length() > SPAMSUM_LENGTH) return 0;
+            if (!hasCommonSubstring(s1, s2, ROLLING_WINDOW)) return 0;
+
+            uint64_t score = editDistance(s1, s2);
+            score = (score * SPAMSUM_LENGTH) / (s1.length() + s2.length());
+            score = (100 * score) / SPAMSUM_LENGTH;
+            if (score >= 100) return 0;
+            score = 100 - score;
+
+            // the small block sizes would exaggerate the similarity of the short digests
+            if (blockSize >= (99 + ROLLING_WINDOW) / ROLLING_WINDOW * MIN_BLOCKSIZE) return score;
+            const uint64_t maxScore = blockSize / MIN_BLOCKSIZE * std::min(s1.length(), s2.length());
+            return std::min(score, maxScore);
+        }
+    };
+
+    uint64_t score = 0;
+    if (bs1 == bs2) {
+        score = std::max(Scorer::score(s1b1, s2b1, bs1), Scorer::score(s1b2, s2b2, bs1 * 2));
+    } else if ((bs1 * 2) == bs2) {
+        score = Scorer::score(s2b1, s1b2, bs2);
+    } else {
+        score = Scorer::score(s1b1, s2b2, bs1);
+    }
+    return static_cast<int>(score);
+}
+
+//----
+
+void TlshHasher::reset()
+{
+    memset(buckets, 0, sizeof(buckets));
+    memset(window, 0, sizeof(window));
+    checksum = 0;
+    dataLength = 0;
+}
+
+void TlshHasher::update(const BYTE *data, bufsize_t size)
+{
+    if (!data) return;
+
+    for (bufsize_t k = 0; k < size; k++) {
+        // window[0] is the newest byte
+        for (size_t i = WINDOW - 1; i > 0; i--) window[i] = window[i - 1];
+        window[0] = data[k];
+        dataLength++;
+        if (dataLength < WINDOW) continue;
+
+        const BYTE c0 = window[0], c1 = window[1], c2 = window[2], c3 = window[3], c4 = window[4];
+        checksum = pearsonHash(0, c0, c1, checksum);
+
+        buckets[pearsonHash(2, c0, c1, c2)]++;
+        buckets[pearsonHash(3, c0, c1, c3)]++;
+        buckets[pearsonHash(5, c0, c2, c3)]++;
+        buckets[pearsonHash(7, c0, c2, c4)]++;
+        buckets[pearsonHash(11, c0, c1, c4)]++;
+        buckets[pearsonHash(13, c0, c3, c4)]++;
+    }
+}
+
+QString TlshHasher::digest() const
+{
+    if (dataLength < MIN_DATA_LENGTH) return "";
+
+    std::vector<uint32_t> sorted(buckets, buckets + EFF_BUCKETS);
+    std::sort(sorted.begin(), sorted.end());
+    const uint32_t q1 = sorted[EFF_BUCKETS / 4 - 1];
+    const uint32_t q2 = sorted[EFF_BUCKETS / 2 - 1];
+    const uint32_t q3 = sorted[(EFF_BUCKETS * 3) / 4 - 1];
+    if (q3 == 0) return "";
+
+    size_t nonZero = 0;
+    for (size_t i = 0; i < EFF_BUCKETS; i++) {
+        if (buckets[i]) nonZero++;
+    }
+    if (nonZero <= (EFF_BUCKETS / 2)) return ""; // too little variety to be meaningful
+
+    std::vector<BYTE> code;
+    code.push_back(checksum);
+    code.push_back(lengthCapturing(dataLength));
+    const BYTE q1Ratio = static_cast<BYTE>((static_cast<uint64_t>(q1) * 100 / q3) % 16);
+    const BYTE q2Ratio = static_cast<BYTE>((static_cast<uint64_t>(q2) * 100 / q3) % 16);
+    code.push_back(static_cast<BYTE>((q1Ratio << 4) | q2Ratio));
+
+    for (size_t i = 0; i < EFF_BUCKETS; i += 4) {
+        BYTE packed = 0;
+        for (size_t j = 0; j < 4; j++) {
+            const uint32_t count = buckets[i + j];
+            BYTE quartile = 3;
+            if (count <= q1) quartile = 0;
+            else if (count <= q2) quartile = 1;
+            else if (count <= q3) quartile = 2;
+            packed |= static_cast<BYTE>(quartile << (j * 2));
+        }
+        code.push_back(packed);
+    }
+
+    static const char hexChars[] = "0123456789ABCDEF";
+    std::string result;
+    for (size_t i = 0; i < code.size(); i++) {
+        result.push_back(hexChars[code[i] >> 4]);
+        result.push_back(hexChars[code[i] & 0xF]);
+    }
+    return QString::fromLatin1(result.c_str(), static_cast<int>(result.length()));
+}
+
+int TlshHasher::distance(const QString &digest1, const QString &digest2)
+{
+    std::vector<BYTE> code1;
+    std::vector<BYTE> code2;
+    if (!hexToBytes(digest1.toStdString(), code1) || !hexToBytes(digest2.toStdString(), code2)) return -1;
+
+    const size_t codeSize = 3 + EFF_BUCKETS / 4;
+    if (code1.size() != codeSize || code2.size() != codeSize) return -1;
+
+    int diff = 0;
+    if (code1[0] != code2[0]) diff++; // checksum
+
+    const int lDiff = modDiff(code1[1], code2[1], 256);
+    diff += (lDiff <= 1) ? lDiff : (lDiff * 12);
+
+    const int q1Diff = modDiff(code1[2] >> 4, code2[2] >> 4, 16);
+    diff += (q1Diff <= 1) ? q1Diff : ((q1Diff - 1) * 12);
+    const int q2Diff = modDiff(code1[2] & 0xF, code2[2] & 0xF, 16);
+    diff += (q2Diff <= 1) ? q2Diff : ((q2Diff - 1) * 12);
+
+    for (size_t i = 3; i < codeSize; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            const int a = (code1[i] >> (j * 2)) & 3;
+            const int b = (code2[i] >> (j * 2)) & 3;
+            const int d = (a > b) ? (a - b) : (b - a);
+            diff += (d == 3) ? 6 : d;
+        }
+    }
+    return diff;
+}
+
+//----
+
+FuzzyDigest FuzzyHasher::compute(AbstractByteBuffer *buf)
+{
+    FuzzyDigest result;
+    if (!AbstractByteBuffer::isValid(buf)) return result;
+
+    const BYTE *content = buf->getContent();
+    const bufsize_t contentSize = buf->getContentSize();
+
+    CtphHasher ctph;
+    TlshHasher tlsh;
+    // both hashers are fed chunk by chunk, so that the content is read from memory only once
+    for (bufsize_t offset = 0; offset < contentSize; offset += CHUNK_SIZE) {
+        const bufsize_t chunkSize = std::min(CHUNK_SIZE, static_cast<bufsize_t>(contentSize - offset));
+        ctph.update(content + offset, chunkSize);
+        tlsh.update(content + offset, chunkSize);
+    }
+    result.ctph = ctph.digest();
+    result.tlsh = tlsh.digest();
+    return result;
+}
+
+void FuzzyHasher::computeMany(const std::vector<AbstractByteBuffer*> &bufs, std::vector<FuzzyDigest> &digests, size_t threads)
+{
+    digests.assign(bufs.size(), FuzzyDigest());
+    if (bufs.size() == 0) return;
+
+    pe_util::parallelFor(bufs.size(), threads, [&](size_t indx) {
+        digests[indx] = compute(bufs[indx]);
+    });
+}
@@ -0,0 +1,421 @@
+#include "SignatureScanner.h"
+#include "pe/PEFile.h"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+
+namespace {
+
+    inline int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+}; //namespace
+
+//----
+
+bool ByteSignature::parse(const QString &pattern, std::vector<BYTE> &bytes, std::vector<BYTE> &mask)
+{
+    bytes.clear();
+    mask.clear();
+
+    std::string nibbles;
+    const std::string str = pattern.toStdString();
+    for (size_t i = 0; i < str.length(); i++) {
+        const char c = str[i];
+        if (isspace(static_cast<unsigned char>(c))) continue;
+        if (c != '?' && hexValue(c) == -1) return false;
+        nibbles.push_back(c);
+    }
+    if (nibbles.length() == 0 || (nibbles.length() % 2) != 0) return false;
+
+    bool hasDefined = false;
+    for (size_t i = 0; i < nibbles.length(); i += 2) {
+        BYTE val = 0;
+        BYTE valMask = 0;
+        for (size_t k = 0; k < 2; k++) {
+            const int nibble = hexValue(nibbles[i + k]);
+            val <<= 4;
+            valMask <<= 4;
+            if (nibble == -1) continue; // wildcard
+            val |= static_cast<BYTE>(nibble);
+            valMask |= 0xF;
+        }
+        if (valMask) hasDefined = true;
+        bytes.push_back(val);
+        mask.push_back(valMask);
+    }
+    return hasDefined;
+}
+
+void ByteSignature::findLiteral()
+{
+    literalOffset = 0;
+    literalSize = 0;
+
+    offset_t start = 0;
+    for (size_t i = 0; i <= mask.size(); i++) {
+        if (i < mask.size() && mask[i] == 0xFF) continue;
+        const bufsize_t runSize = static_cast<bufsize_t>(i - start);
+        if (runSize > literalSize) {
+            literalOffset = start;
+            literalSize = runSize;
+        }
+        start = i + 1;
+    }
+}
+
+QString ByteSignature::toString() const
+{
+    static const char hexChars[] = "0123456789ABCDEF";
+
+    std::string str;
+    for (size_t i = 0; i < bytes.size(); i++) {
+        if (i > 0) str.push_back(' ');
+        str.push_back((mask[i] & 0xF0) ? hexChars[bytes[i] >> 4] : '?');
+        str.push_back((mask[i] & 0x0F) ? hexChars[bytes[i] & 0xF] : '?');
+    }
+    return QString::fromLatin1(str.c_str(), static_cast<int>(str.length()));
+}
+
+bool ByteSignature::matchesAt(const BYTE *content, bufsize_t contentSize, offset_t offset) const
+{
+    if (!content || offset >= contentSize) return false;
+    if (contentSize - offset < bytes.size()) return false;
+
+    const BYTE *ptr = content + offset;
+    for (size_t i = 0; i < bytes.size(); i++) {
+        if ((ptr[i] & mask[i]) != bytes[i]) return false;
+    }
+    return true;
+}
+
+//----
+
+int SignatureSet::addSignature(const QString &name, const QString &pattern, ByteSignature::sig_anchor anchor)
+{
+    std::vector<BYTE> bytes;
+    std::vector<BYTE> mask;
+    if (!ByteSignature::parse(pattern, bytes, mask)) {
+        Logger::append(Logger::D_WARNING, "Invalid signature: %s", name.toStdString().c_str());
+        return -1;
+    }
+    if (anchor >= ByteSignature::COUNT_ANCHORS) {
+        anchor = ByteSignature::ANCHOR_NONE;
+    }
+    signatures.push_back(ByteSignature(name, bytes, mask, anchor));
+    isCompiled = false;
+    return static_cast<int>(signatures.size() - 1);
+}
+
+size_t SignatureSet::loadPeidDb(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        Logger::append(Logger::D_ERROR, "Cannot open the signatures file: %s", fileName.toStdString().c_str());
+        return 0;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    const QStringList lines = QString::fromLatin1(data.constData(), data.size()).split("\n");
+
+    QString name;
+    QString pattern;
+    bool epOnly = false;
+    size_t loaded = 0;
+
+    for (int i = 0; i <= lines.size(); i++) {
+        const QString line = (i < lines.size()) ? lines[i].trimmed() : QString();
+        const bool isLast = (i == lines.size());
+
+        if (isLast || line.startsWith("[")) {
+            if (name.length() && pattern.length()) {
+                if (addSignature(name, pattern, epOnly ? ByteSignature::ANCHOR_EP : ByteSignature::ANCHOR_NONE) != -1) {
+                    loaded++;
+                }
+            }
+            if (isLast) break;
+
+            const int end = line.lastIndexOf(']');
+            name = (end > 0) ? line.mid(1, end - 1).trimmed() : line.mid(1).trimmed();
+            pattern = "";
+            epOnly = false;
+            continue;
+        }
+        if (line.length() == 0 || line.startsWith(";")) continue;
+
+        const int sep = line.indexOf('=');
+        if (sep == -1) continue;
+
+        const QString key = line.left(sep).trimmed().toLower();
+        const QString val = line.mid(sep + 1).trimmed();
+        if (key == "signature") {
+            pattern = val;
+        } else if (key == "ep_only") {
+            epOnly = (val.toLower() == "true");
+        }
+    }
+    return loaded;
+}
+
+void SignatureSet::compile()
+{
+    nodes.clear();
+    edgeBytes.clear();
+    edgeTargets.clear();
+    outSigs.clear();
+    noLiteralSigs.clear();
+    for (size_t i = 0; i < 256; i++) rootNext[i] = NO_NODE;
+
+    // build the trie of the literals
+    std::vector< std::map<BYTE, uint32_t> > children(1);
+    std::vector< std::vector<uint32_t> > outputs(1);
+
+    for (size_t sigId = 0; sigId < signatures.size(); sigId++) {
+        const ByteSignature &sig = signatures[sigId];
+        if (!isAutomatonSig(sig)) continue;
+        if (sig.getLiteralSize() == 0) {
+            // only half-byte masks: nothing to put in the trie
+            noLiteralSigs.push_back(static_cast<uint32_t>(sigId));
+            continue;
+        }
+
+        const BYTE *literal = sig.getLiteral();
+        uint32_t node = 0;
+        for (bufsize_t i = 0; i < sig.getLiteralSize(); i++) {
+            std::map<BYTE, uint32_t>::iterator found = children[node].find(literal[i]);
+            if (found != children[node].end()) {
+                node = found->second;
+                continue;
+            }
+            const uint32_t newNode = static_cast<uint32_t>(children.size());
+            children[node][literal[i]] = newNode;
+            children.push_back(std::map<BYTE, uint32_t>());
+            outputs.push_back(std::vector<uint32_t>());
+            node = newNode;
+        }
+        outputs[node].push_back(static_cast<uint32_t>(sigId));
+    }
+
+    // flatten the edges
+    nodes.resize(children.size());
+    for (size_t node = 0; node < children.size(); node++) {
+        nodes[node].edgesStart = static_cast<uint32_t>(edgeBytes.size());
+        nodes[node].edgesCount = static_cast<uint32_t>(children[node].size());
+        for (std::map<BYTE, uint32_t>::iterator itr = children[node].begin(); itr != children[node].end(); ++itr) {
+            edgeBytes.push_back(itr->first);
+            edgeTargets.push_back(itr->second);
+        }
+        nodes[node].outStart = static_cast<uint32_t>(outSigs.size());
+        nodes[node].outCount = static_cast<uint32_t>(outputs[node].size());
+        outSigs.insert(outSigs.end(), outputs[node].begin(), outputs[node].end());
+    }
+    for (std::map<BYTE, uint32_t>::iterator itr = children[0].begin(); itr != children[0].end(); ++itr) {
+        rootNext[itr->first] = itr->second;
+    }
+
+    // the failure links, in the BFS order
+    std::queue<uint32_t> toVisit;
+    for (size_t c = 0; c < 256; c++) {
+        if (rootNext[c] != NO_NODE) toVisit.push(rootNext[c]);
+    }
+    while (!toVisit.empty()) {
+        const uint32_t node = toVisit.front();
+        toVisit.pop();
+
+        for (std::map<BYTE, uint32_t>::iterator itr = children[node].begin(); itr != children[node].end(); ++itr) {
+            const uint32_t child = itr->second;
+            const uint32_t fail = nextNode(nodes[node].fail, itr->first);
+
+            nodes[child].fail = fail;
+            nodes[child].dictLink = (nodes[fail].outCount > 0) ? fail : nodes[fail].dictLink;
+            toVisit.push(child);
+        }
+    }
+    isCompiled = true;
+}
+
+uint32_t SignatureSet::nextNode(uint32_t node, BYTE c) const
+{
+    while (node != NO_NODE) {
+        const AcNode &n = nodes[node];
+        const BYTE *first = edgeBytes.data() + n.edgesStart;
+        const BYTE *last = first + n.edgesCount;
+        const BYTE *found = std::lower_bound(first, last, c);
+        if (found != last && *found == c) {
+            return edgeTargets[found - edgeBytes.data()];
+        }
+        node = n.fail;
+    }
+    return rootNext[c];
+}
+
+size_t SignatureSet::scan(const BYTE *content, bufsize_t contentSize, std::vector<SigMatch> &matches)
+{
+    if (!content || contentSize == 0) return 0;
+    if (!isCompiled) compile();
+
+    const size_t initialSize = matches.size();
+    uint32_t node = NO_NODE;
+    for (bufsize_t i = 0; i < contentSize; i++) {
+        node = nextNode(node, content[i]);
+
+        const uint32_t firstOut = (nodes[node].outCount > 0) ? node : nodes[node].dictLink;
+        for (uint32_t out = firstOut; out != NO_NODE; out = nodes[out].dictLink) {
+            const AcNode &n = nodes[out];
+            for (uint32_t k = n.outStart; k < n.outStart + n.outCount; k++) {
+                const ByteSignature &sig = signatures[outSigs[k]];
+                // i is the offset of the last byte of the literal
+                const offset_t literalEnd = static_cast<offset_t>(i) + 1;
+                const offset_t keyOffset = sig.getLiteralOffset() + sig.getLiteralSize();
+                if (literalEnd < keyOffset) continue;
+
+                const offset_t sigStart = literalEnd - keyOffset;
+                if (sig.matchesAt(content, contentSize, sigStart)) {
+                    matches.push_back(SigMatch(outSigs[k], sigStart));
+                }
+            }
+        }
+        for (size_t k = 0; k < noLiteralSigs.size(); k++) {
+            if (signatures[noLiteralSigs[k]].matchesAt(content, contentSize, i)) {
+                matches.push_back(SigMatch(noLiteralSigs[k], i));
+            }
+        }
+    }
+    std::sort(matches.begin() + initialSize, matches.end());
+    return matches.size() - initialSize;
+}
+
+size_t SignatureSet::naiveScan(const BYTE *content, bufsize_t contentSize, std::vector<SigMatch> &matches) const
+{
+    if (!content || contentSize == 0) return 0;
+
+    const size_t initialSize = matches.size();
+    for (bufsize_t i = 0; i < contentSize; i++) {
+        for (size_t sigId = 0; sigId < signatures.size(); sigId++) {
+            const ByteSignature &sig = signatures[sigId];
+            if (!isAutomatonSig(sig)) continue;
+            if (sig.matchesAt(content, contentSize, i)) {
+                matches.push_back(SigMatch(sigId, i));
+            }
+        }
+    }
+    return matches.size() - initialSize;
+}
+
+size_t SignatureSet::scanAnchored(const BYTE *content, bufsize_t contentSize, offset_t offset, ByteSignature::sig_anchor anchor, std::vector<SigMatch> &matches) const
+{
+    if (!content || offset >= contentSize) return 0;
+
+    const size_t initialSize = matches.size();
+    for (size_t sigId = 0; sigId < signatures.size(); sigId++) {
+        const ByteSignature &sig = signatures[sigId];
+        if (sig.getAnchor() != anchor) continue;
+        if (sig.matchesAt(content, contentSize, offset)) {
+            matches.push_back(SigMatch(sigId, offset));
+        }
+    }
+    return matches.size() - initialSize;
+}
+
+//----
+
+size_t SignatureScanner::toHits(Executable *exe, const std::vector<SigMatch> &matches, offset_t bufRaw, std::vector<SigHit> &hits)
+{
+    for (size_t i = 0; i < matches.size(); i++) {
+        const offset_t raw = bufRaw + matches[i].offset;
+        const offset_t rva = exe->convertAddr(raw, Executable::RAW, Executable::RVA);
+        const offset_t va = (rva != INVALID_ADDR) ? exe->convertAddr(rva, Executable::RVA, Executable::VA) : INVALID_ADDR;
+        hits.push_back(SigHit(matches[i].sigId, raw, rva, va));
+    }
+    return matches.size();
+}
+
+void SignatureScanner::sectionStarts(PEFile *pe, std::vector<offset_t> &starts)
+{
+    if (!pe) return;
+
+    const size_t secCount = pe->getSectionsCount(true);
+    for (size_t i = 0; i < secCount; i++) {
+        SectionHdrWrapper *sec = pe->getSecHdr(i);
+        if (!sec) continue;
+        const offset_t raw = sec->getContentOffset(Executable::RAW, true);
+        if (raw == INVALID_ADDR) continue;
+        if (sec->getContentSize(Executable::RAW, true) == 0) continue;
+        starts.push_back(raw);
+    }
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+}
+
+size_t SignatureScanner::scanBuffer(Executable *exe, AbstractByteBuffer *buf, offset_t bufRaw, std::vector<SigHit> &hits)
+{
+    if (!exe || !AbstractByteBuffer::isValid(buf)) return 0;
+
+    std::vector<SigMatch> matches;
+    sigSet.scan(buf->getContent(), buf->getContentSize(), matches);
+    return toHits(exe, matches, bufRaw, hits);
+}
+
+size_t SignatureScanner::scanExe(Executable *exe, std::vector<SigHit> &hits)
+{
+    if (!exe) return 0;
+
+    const BYTE *content = exe->getContent();
+    const bufsize_t contentSize = exe->getContentSize();
+
+    std::vector<SigMatch> matches;
+    const offset_t epRaw = exe->getEntryPoint(Executable::RAW);
+    if (epRaw != INVALID_ADDR) {
+        sigSet.scanAnchored(content, contentSize, epRaw, ByteSignature::ANCHOR_EP, matches);
+    }
+    std::vector<offset_t> starts;
+    sectionStarts(dynamic_cast<PEFile*>(exe), starts);
+    for (size_t i = 0; i < starts.size(); i++) {
+        sigSet.scanAnchored(content, contentSize, starts[i], ByteSignature::ANCHOR_SECTION, matches);
+    }
+    sigSet.scan(content, contentSize, matches);
+    return toHits(exe, matches, 0, hits);
+}
+
+size_t SignatureScanner::scanSection(PEFile *pe, size_t secId, std::vector<SigHit> &hits)
+{
+    if (!pe) return 0;
+
+    SectionHdrWrapper *sec = pe->getSecHdr(secId);
+    BufferView *secView = pe->createSectionView(secId);
+    if (!sec || !secView) {
+        delete secView;
+        return 0;
+    }
+    const offset_t secRaw = sec->getContentOffset(Executable::RAW, true);
+
+    std::vector<SigMatch> matches;
+    sigSet.scanAnchored(secView->getContent(), secView->getContentSize(), 0, ByteSignature::ANCHOR_SECTION, matches);
+    sigSet.scan(secView->getContent(), secView->getContentSize(), matches);
+    delete secView;
+
+    return toHits(pe, matches, secRaw, hits);
+}
+
+size_t SignatureScanner::scanEntryPoint(Executable *exe, bufsize_t neighbourhood, std::vector<SigHit> &hits)
+{
+    if (!exe) return 0;
+
+    const offset_t epRaw = exe->getEntryPoint(Executable::RAW);
+    if (epRaw == INVALID_ADDR || epRaw >= exe->getContentSize()) return 0;
+
+    const bufsize_t available = static_cast<bufsize_t>(exe->getContentSize() - epRaw);
+    BufferView epView(exe, epRaw, std::min(neighbourhood, available));
+
+    std::vector<SigMatch> matches;
+    sigSet.scanAnchored(epView.getContent(), epView.getContentSize(), 0, ByteSignature::ANCHOR_EP, matches);
+    sigSet.scan(epView.getContent(), epView.getContentSize(), matches);
+    return toHits(exe, matches, epRaw, hits);
+}
@@ -0,0 +1,305 @@
+#include "StringsExtractor.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define STRINGS_USE_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+namespace {
+
+    const bufsize_t BLOCK_SIZE = 64;
+
+    inline size_t countTrailingZeros(uint64_t x)
+    {
+        if (x == 0) return 64;
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long idx = 0;
+        _BitScanForward64(&idx, x);
+        return idx;
+#elif defined(__GNUC__)
+        return __builtin_ctzll(x);
+#else
+        size_t count = 0;
+        while ((x & 1) == 0) {
+            x >>= 1;
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    // packs the bits from the even positions into the lower half
+    inline uint64_t evenBits(uint64_t x)
+    {
+        x &= 0x5555555555555555ULL;
+        x = (x | (x >> 1)) & 0x3333333333333333ULL;
+        x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+        return x;
+    }
+
+    // bit N of the masks describes the byte N of the block
+    inline void classifyTail(const BYTE *ptr, bufsize_t size, uint64_t &printable, uint64_t &zeros)
+    {
+        printable = 0;
+        zeros = 0;
+        for (bufsize_t i = 0; i < size && i < BLOCK_SIZE; i++) {
+            if (StringsExtractor::isStringChar(ptr[i])) printable |= (uint64_t(1) << i);
+            else if (ptr[i] == 0) zeros |= (uint64_t(1) << i);
+        }
+    }
+
+    inline void classifyBlock(const BYTE *ptr, uint64_t &printable, uint64_t &zeros)
+    {
+#ifdef STRINGS_USE_SSE2
+        const __m128i lowBound = _mm_set1_epi8(0x1F);
+        const __m128i highBound = _mm_set1_epi8(0x7F);
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i zero = _mm_setzero_si128();
+
+        printable = 0;
+        zeros = 0;
+        for (size_t i = 0; i < 4; i++) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + (i * 16)));
+            // signed compare: bytes >= 0x80 are negative, so they fail the lower bound
+            __m128i isPrint = _mm_and_si128(_mm_cmpgt_epi8(v, lowBound), _mm_cmplt_epi8(v, highBound));
+            isPrint = _mm_or_si128(isPrint, _mm_cmpeq_epi8(v, tab));
+            const __m128i isZero = _mm_cmpeq_epi8(v, zero);
+
+            printable |= uint64_t(uint16_t(_mm_movemask_epi8(isPrint))) << (i * 16);
+            zeros |= uint64_t(uint16_t(_mm_movemask_epi8(isZero))) << (i * 16);
+        }
+#else
+        classifyTail(ptr, BLOCK_SIZE, printable, zeros);
+#endif
+    }
+
+    // collects runs of set bits from the consecutive masks
+    class RunTracker
+    {
+    public:
+        RunTracker(bufsize_t v_minLen, offset_t v_phase, bufsize_t v_unit, offset_t v_limit, std::vector<FoundString> &v_found)
+            : minLen(v_minLen), phase(v_phase), unit(v_unit), limit(v_limit),
+            inRun(false), discard(false), isDone(false), runStart(0), runLen(0), found(v_found)
+        {
+        }
+
+        // the run that started before the chunk belongs to the previous chunk
+        void skipContinued()
+        {
+            inRun = true;
+            discard = true;
+        }
+
+        bool isActive() const { return inRun || !isDone; }
+
+        void feed(uint64_t mask, size_t bitsCount, offset_t blockStart)
+        {
+            if (!inRun && (blockStart + phase) >= limit) {
+                isDone = true;
+                return;
+            }
+            size_t pos = 0;
+            while (pos < bitsCount) {
+                const uint64_t rest = mask >> pos;
+                if (inRun) {
+                    const size_t ones = std::min(countTrailingZeros(~rest), bitsCount - pos);
+                    runLen += ones;
+                    pos += ones;
+                    if (pos >= bitsCount) break; // continued in the next block
+                    closeRun();
+                    continue;
+                }
+                if (isDone || rest == 0) break;
+
+                pos += countTrailingZeros(rest);
+                if (pos >= bitsCount) break;
+
+                const offset_t start = blockStart + phase + (pos * unit);
+                if (start >= limit) {
+                    isDone = true; // the rest belongs to the next chunk
+                    break;
+                }
+                inRun = true;
+                runStart = start;
+                runLen = 0;
+            }
+        }
+
+        void finish()
+        {
+            if (inRun) closeRun();
+            isDone = true;
+        }
+
+    protected:
+        void closeRun()
+        {
+            if (!discard && runLen >= minLen) {
+                found.push_back(FoundString(runStart, runLen, (unit == sizeof(WORD))));
+            }
+            inRun = false;
+            discard = false;
+        }
+
+        const bufsize_t minLen;
+        const offset_t phase;
+        const bufsize_t unit;
+        const offset_t limit;
+
+        bool inRun;
+        bool discard;
+        bool isDone;
+        offset_t runStart;
+        bufsize_t runLen;
+
+        std::vector<FoundString> &found;
+    };
+
+    inline bool isWideCharAt(const BYTE *content, bufsize_t contentSize, offset_t offset)
+    {
+        if (offset + 1 >= contentSize) return false;
+        return StringsExtractor::isStringChar(content[offset]) && content[offset + 1] == 0;
+    }
+
+}; //namespace
+
+//----
+
+QString StringsExtractor::getString(AbstractByteBuffer *buf, const FoundString &str)
+{
+    if (!buf || !str.length) return "";
+
+    const BYTE *ptr = buf->getContentAt(str.offset, str.getSize());
+    if (!ptr) return "";
+
+    if (!str.isWide) {
+        return QString::fromLatin1(reinterpret_cast<const char*>(ptr), static_cast<int>(str.length));
+    }
+    // all the characters are printable ASCII, so the higher bytes can be skipped
+    std::string narrow(str.length, '\0');
+    for (bufsize_t i = 0; i < str.length; i++) {
+        narrow[i] = static_cast<char>(ptr[i * sizeof(WORD)]);
+    }
+    return QString::fromLatin1(narrow.c_str(), static_cast<int>(narrow.length()));
+}
+
+StringsExtractor::StringsExtractor(bufsize_t v_minLen, int v_types, size_t v_threads)
+    : minLen(1), types(v_types), threads(v_threads)
+{
+    setMinLength(v_minLen);
+}
+
+size_t StringsExtractor::threadsFor(bufsize_t contentSize) const
+{
+    size_t maxThreads = this->threads;
+    if (maxThreads == 0) {
+        maxThreads = std::thread::hardware_concurrency();
+    }
+    if (maxThreads == 0) maxThreads = 1;
+
+    const size_t chunks = static_cast<size_t>(contentSize / MIN_CHUNK_SIZE);
+    if (chunks < maxThreads) {
+        return (chunks > 0) ? chunks : 1;
+    }
+    return maxThreads;
+}
+
+void StringsExtractor::extractChunk(const BYTE *content, bufsize_t contentSize,
+    offset_t chunkStart, offset_t chunkEnd,
+    std::vector<FoundString> &found) const
+{
+    const bool useAscii = (types & STR_ASCII) != 0;
+    const bool useWide = (types & STR_WIDE) != 0;
+
+    RunTracker ascii(minLen, 0, sizeof(BYTE), chunkEnd, found);
+    RunTracker wideEven(minLen, 0, sizeof(WORD), chunkEnd, found);
+    RunTracker wideOdd(minLen, 1, sizeof(WORD), chunkEnd, found);
+
+    // chunks are aligned to the block size, so the parity of the wide trackers is preserved
+    if (chunkStart > 0) {
+        if (isStringChar(content[chunkStart - 1])) ascii.skipContinued();
+        if (chunkStart >= 2 && isWideCharAt(content, contentSize, chunkStart - 2)) wideEven.skipContinued();
+        if (isWideCharAt(content, contentSize, chunkStart - 1)) wideOdd.skipContinued();
+    }
+
+    for (offset_t blockStart = chunkStart; blockStart < contentSize; blockStart += BLOCK_SIZE) {
+        const bool asciiActive = useAscii && ascii.isActive();
+        const bool wideActive = useWide && (wideEven.isActive() || wideOdd.isActive());
+        if (!asciiActive && !wideActive) break;
+
+        const bufsize_t blockSize = std::min(BLOCK_SIZE, static_cast<bufsize_t>(contentSize - blockStart));
+        uint64_t printable = 0;
+        uint64_t zeros = 0;
+        if (blockSize == BLOCK_SIZE) {
+            classifyBlock(content + blockStart, printable, zeros);
+        } else {
+            classifyTail(content + blockStart, blockSize, printable, zeros);
+        }
+
+        if (asciiActive) {
+            ascii.feed(printable, blockSize, blockStart);
+        }
+        if (wideActive) {
+            // a wide char is a printable byte followed by a zero byte
+            const offset_t nextOffset = blockStart + BLOCK_SIZE;
+            const uint64_t nextZero = (nextOffset < contentSize && content[nextOffset] == 0) ? 1 : 0;
+            const uint64_t wide = printable & ((zeros >> 1) | (nextZero << 63));
+
+            wideEven.feed(evenBits(wide), BLOCK_SIZE / 2, blockStart);
+            wideOdd.feed(evenBits(wide >> 1), BLOCK_SIZE / 2, blockStart);
+        }
+    }
+    ascii.finish();
+    wideEven.finish();
+    wideOdd.finish();
+}
+
+size_t StringsExtractor::extract(AbstractByteBuffer *buf, std::vector<FoundString> &found)
+{
+    if (!AbstractByteBuffer::isValid(buf) || types == STR_NONE) return 0;
+
+    const BYTE *content = buf->getContent();
+    const bufsize_t contentSize = buf->getContentSize();
+
+    const size_t chunksCount = threadsFor(contentSize);
+    bufsize_t chunkSize = buf_util::roundupToUnit(pe_util::unitsCount(contentSize, chunksCount), BLOCK_SIZE);
+    if (chunkSize == 0) chunkSize = BLOCK_SIZE;
+
+    std::vector< std::vector<FoundString> > chunksFound(chunksCount);
+    if (chunksCount == 1) {
+        extractChunk(content, contentSize, 0, contentSize, chunksFound[0]);
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < chunksCount; i++) {
+            const offset_t start = static_cast<offset_t>(i) * chunkSize;
+            if (start >= contentSize) break;
+
+            const offset_t end = std::min(static_cast<offset_t>(start + chunkSize), static_cast<offset_t>(contentSize));
+            std::vector<FoundString> &chunkFound = chunksFound[i];
+            workers.push_back(std::thread([this, content, contentSize, start, end, &chunkFound]() {
+                extractChunk(content, contentSize, start, end, chunkFound);
+            }));
+        }
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+    }
+
+    const size_t initialSize = found.size();
+    for (size_t i = 0; i < chunksFound.size(); i++) {
+        std::vector<FoundString> &chunkFound = chunksFound[i];
+        std::sort(chunkFound.begin(), chunkFound.end());
+        found.insert(found.end(), chunkFound.begin(), chunkFound.end());
+    }
+    return found.size() - initialSize;
+}
@@ -1,6 +1,11 @@
 #include "Util.h"
 #include <stdarg.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 using namespace pe_util;
 
 #define MAX_LINE 255
@@ -200,3 +205,32 @@ bool pe_util::endsWith(std::string str, std::string endStr)
     }
     return false;
 }
+
+void pe_util::parallelFor(size_t count, size_t threads, const std::function<void(size_t)> &task)
+{
+    if (count == 0) return;
+
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    threads = std::max<size_t>(1, std::min(threads, count));
+    if (threads == 1) {
+        for (size_t indx = 0; indx < count; indx++) {
+            task(indx);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; i++) {
+        workers.push_back(std::thread([&]() {
+            for (size_t indx = nextIndex++; indx < count; indx = nextIndex++) {
+                task(indx);
+            }
+        }));
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
@@ -1,103 +1,15 @@
 #include "elf/ELFCore.h"
 
-template <typename... Ts>
-bool isVariantNullptr(const std::variant<Ts...>& var) {
-    return std::visit([](auto ptr) { return ptr == nullptr; }, var);
-}
-
-template <typename T>
-T* getStructAt(AbstractByteBuffer* buf, size_t offset, size_t count, bool allowThrow = true) {
-    return reinterpret_cast<T*>(buf->getContentAt(offset, count, allowThrow));
-}
-
-template<typename EhdrT>
-constexpr bool isValidElfHeaderType() {
-    return std::is_same_v<EhdrT, Elf32_Ehdr> || std::is_same_v<EhdrT, Elf64_Ehdr>;
-}
-
-template<typename PhdrT>
-constexpr bool isValidProgramHeaderType() {
-    return std::is_same_v<PhdrT, Elf32_Phdr> || std::is_same_v<PhdrT, Elf64_Phdr>;
-}
-
-template<typename ShdrT>
-constexpr bool isValidSectionHeaderType() {
-    return std::is_same_v<ShdrT, Elf32_Shdr> || std::is_same_v<ShdrT, Elf64_Shdr>;
-}
-
-template <typename EhdrT, typename PhdrT, typename ShdrT>
-bool ELFCore::wrapElfHeaders(AbstractByteBuffer* v_buf, bool allowExceptionsFromBuffer) {
-    // compile-time check to ensure proper types are passed
-    // shouldn't impact runtime performance.
-    static_assert(isValidElfHeaderType<EhdrT>(),     "Invalid type passed to wrapElfHeaders<EhdrT, PhdrT, ShdrT>() — EhdrT must be of type Elf32_Ehdr or Elf64_Ehdr");
-    static_assert(isValidProgramHeaderType<PhdrT>(), "Invalid type passed to wrapElfHeaders<EhdrT, PhdrT, ShdrT>() — PhdrT must be of type Elf32_Phdr or Elf64_Phdr");
-    static_assert(isValidSectionHeaderType<ShdrT>(), "Invalid type passed to wrapElfHeaders<EhdrT, PhdrT, ShdrT>() — ShdrT must be of type Elf32_Shdr or Elf64_Shdr");
-    
-    buf = v_buf;
-    ehdr = getStructAt<EhdrT>(buf, 0, sizeof(EhdrT), allowExceptionsFromBuffer);
-    
-    std::cout << sizeof(ehdr) << " bytes for ELF Header." << std::endl;
-    
-    if (isVariantNullptr(this->ehdr))
-        throw ExeException("Could not wrap ELFCore: invalid ELF Header!");
-
-    EhdrT *ehdrPtr = std::get<EhdrT*>(this->ehdr);
-
-    // this->phdrs = getStructAt<PhdrT>(buf, ehdrPtr->e_phoff, ehdrPtr->e_phnum, allowExceptionsFromBuffer);
-    // if (isVariantNullptr(this->phdrs))
-    //     throw ExeException("Could not wrap ELFCore: invalid Program Header!");
-
-    for (size_t i = 0; i < ehdrPtr->e_phnum; ++i) {
-        // less-safe one-liner:
-        // _phdrs.puch_back(getStructAt<PhdrT>(buf, ehdrPtr->e_phoff + i * sizeof(PhdrT), sizeof(PhdrT), allowExceptionsFromBuffer));
-        PhdrT *phdr = getStructAt<PhdrT>(buf, ehdrPtr->e_phoff + i * sizeof(PhdrT), 1, allowExceptionsFromBuffer);
-        if (!phdr)
-            throw ExeException("Could not wrap ELFCore: invalid Program Header at index " + QString::number(i) + "!");
-
-        phdrs.push_back(phdr);
-    }
-        
-    // if (ehdrPtr->e_shoff != 0 && ehdrPtr->e_shnum != 0)
-    //     this->shdrs = getStructAt<ShdrT>(buf, ehdrPtr->e_shoff, ehdrPtr->e_shnum, allowExceptionsFromBuffer);
-    // if (isVariantNullptr(this->shdrs))
-    //     throw ExeException("Could not wrap ELFCore: invalid Section Header!");
-
-    if (ehdrPtr->e_shoff != 0 && ehdrPtr->e_shnum != 0) {
-        for (size_t i = 0; i < ehdrPtr->e_shnum; ++i) {
-            // less-safe one-liner:
-            // _shdrs.push_back(getStructAt<ShdrT>(buf, ehdrPtr->e_shoff + i * sizeof(ShdrT), sizeof(ShdrT), allowExceptionsFromBuffer));
-            ShdrT *shdr = getStructAt<ShdrT>(buf, ehdrPtr->e_shoff + i * sizeof(ShdrT), 1, allowExceptionsFromBuffer);
-            if (!shdr)
-                throw ExeException("Could not wrap ELFCore: invalid Section Header at index " + QString::number(i) + "!");
-            
-            shdrs.push_back(shdr);
-        }
-    }
-
-    cacheSectionNames();
-
-    for (int i = 0; i < getSectionHdrsCount(); ++i)
-        qDebug() << "Section Header" << i << "has name:" << cachedSectionNames[i];
-    
-    return true;
-}
+#include <algorithm>
 
 void ELFCore::reset() {
     // Reset buf
     buf = nullptr;
 
-    // Reset the variants to their default state.
-    // This is necessary to ensure that the variant does not hold onto 
-    // any previous pointers and is ready for a new wrap operation
-    // ehdr.emplace<Elf64_Ehdr*>(nullptr);
-    // phdrs.emplace<Elf64_Phdr*>(nullptr);
-    // shdrs.emplace<Elf64_Shdr*>(nullptr);
-
-    // the following is equivalent to the above three lines.
-    // this results in faster resetting of the variants.
-    ehdr = {};
-    phdrs.clear();
-    shdrs.clear();
+    // the views only refer to the buffer, nothing to release
+    view32.reset();
+    view64.reset();
+    bits64 = false;
 
     // Uncache variables
     cachedImageSize = 0;
@@ -112,12 +24,16 @@ void ELFCore::reset() {
     cachedAlignment = 0;
     cachedAlignmentValid = false;
 
-    cachedSectionNames.clear();
-    cachedSectionNamesValid = false;
+    sectionNames = ElfStringTable();
+    sectionsByName.clear();
+
+    rvaRanges.clear();
+    rawRanges.clear();
+    loadedSize = 0;
 }
 
-bool ELFCore::wrap(AbstractByteBuffer *buf) {
-    if (!buf) throw ExeException("Could not wrap ELFCore: buffer is null!");
+bool ELFCore::wrap(AbstractByteBuffer *v_buf) {
+    if (!v_buf) throw ExeException("Could not wrap ELFCore: buffer is null!");
 
     const bool allowExceptionsFromBuffer = false;
 
@@ -126,45 +42,131 @@ bool ELFCore::wrap(AbstractByteBuffer *buf) {
 
     unsigned char e_ident[EI_NIDENT] = {0};
 
-    if (buf->getContentSize() < EI_NIDENT) {
+    if (v_buf->getContentSize() < EI_NIDENT) {
         throw ExeException("Could not wrap ELFCore: buffer too small for ELF Header!");
     }
 
-    std::memcpy(e_ident, buf->getContentAt(0, EI_NIDENT, allowExceptionsFromBuffer), EI_NIDENT);
+    std::memcpy(e_ident, v_buf->getContentAt(0, EI_NIDENT, allowExceptionsFromBuffer), EI_NIDENT);
 
     if (e_ident[EI_MAG0] != ELFMAG0 || e_ident[EI_MAG1] != ELFMAG1 ||
         e_ident[EI_MAG2] != ELFMAG2 || e_ident[EI_MAG3] != ELFMAG3)
         throw ExeException("Could not wrap ELFCore: not a valid ELF file!");
 
-    // this is the only check that determines the bitness of the ELF file.
-    // If the file is 64-bit, we use Elf64_Ehdr, otherwise Elf32_Ehdr.
-    return (e_ident[EI_CLASS] == ELFCLASS64)
-    ? wrapElfHeaders<Elf64_Ehdr, Elf64_Phdr, Elf64_Shdr>(buf, allowExceptionsFromBuffer)
-    : wrapElfHeaders<Elf32_Ehdr, Elf32_Phdr, Elf32_Shdr>(buf, allowExceptionsFromBuffer);
+    // this is the only check that determines the bitness of the ELF file:
+    // from now on, only the view of this class is used
+    bits64 = (e_ident[EI_CLASS] == ELFCLASS64);
+    if (bits64) {
+        view64.wrap(v_buf);
+    } else {
+        view32.wrap(v_buf);
+    }
+    buf = v_buf;
+
+    buildSectionNamesIndex();
+    buildLoadSegmentsMap();
+    return true;
 }
 
-// bufsize_t ELFCore::getAlignment() const {
-//     return std::visit([](auto phdrsPtr) -> bufsize_t {
-//         if (!phdrsPtr) return 0;
-//         return phdrsPtr->p_align;  // Often, alignment is uniform across all program headers
-//     }, phdrs);
-// }
+void ELFCore::buildLoadSegmentsMap() {
+    const offset_t imageBase = getImageBase();
 
-bufsize_t ELFCore::cacheAlignment() const {
-    cachedAlignment = 1;
+    withView([&](const auto &view) {
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_LOAD || phdr.p_vaddr < imageBase) continue;
 
-    for (const auto& variantPhdrPtr : phdrs) {
-        std::visit([&](auto phdrPtr) {
-            using PhdrT = std::remove_pointer_t<decltype(phdrPtr)>;
-            if (!phdrPtr) return;
+            const offset_t rva = static_cast<offset_t>(phdr.p_vaddr) - imageBase;
+            const offset_t raw = static_cast<offset_t>(phdr.p_offset);
+            const bufsize_t vSize = static_cast<bufsize_t>(phdr.p_memsz);
+            // the part of the segment that is backed by the file:
+            const bufsize_t rawSize = static_cast<bufsize_t>(std::min<uint64_t>(phdr.p_filesz, phdr.p_memsz));
 
-            const PhdrT &phdr = *phdrPtr;
-            if (phdr.p_type != PT_LOAD) return;
+            if (vSize) {
+                rvaRanges.push_back({ rva, vSize, raw, rawSize, 0 });
+                loadedSize = std::max<bufsize_t>(loadedSize, rva + vSize);
+            }
+            if (rawSize) {
+                rawRanges.push_back({ raw, rawSize, rva, rawSize, 0 });
+            }
+        }
+    });
+
+    for (QVector<ElfMappedRange>* ranges : { &rvaRanges, &rawRanges }) {
+        std::sort(ranges->begin(), ranges->end(), [](const ElfMappedRange &a, const ElfMappedRange &b) {
+            return a.start < b.start;
+        });
+        offset_t maxEnd = 0;
+        for (ElfMappedRange &range : *ranges) {
+            maxEnd = std::max<offset_t>(maxEnd, range.start + range.size);
+            range.maxEnd = maxEnd;
+        }
+    }
+}
 
-            cachedAlignment = std::max(cachedAlignment, static_cast<bufsize_t>(phdr.p_align));
-        }, variantPhdrPtr);
+offset_t ELFCore::translateAddr(const QVector<ElfMappedRange> &ranges, offset_t addr) {
+    if (addr == INVALID_ADDR) return INVALID_ADDR;
+
+    // the first range that starts after the address:
+    auto itr = std::upper_bound(ranges.constBegin(), ranges.constEnd(), addr,
+        [](offset_t a, const ElfMappedRange &range) { return a < range.start; });
+
+    // walk back only as long as some of the preceding ranges can still cover the address
+    while (itr != ranges.constBegin()) {
+        --itr;
+        if (itr->maxEnd <= addr) break;
+        if (addr >= itr->start + itr->size) continue;
+
+        const offset_t delta = addr - itr->start;
+        // e.g. .bss: mapped in the memory, but not backed by the file
+        if (delta >= itr->mappedSize) return INVALID_ADDR;
+        return itr->mapped + delta;
     }
-    
+    return INVALID_ADDR;
+}
+
+bool ELFCore::getDynamicSegment(offset_t &raw, bufsize_t &size) const {
+    return withView([&](const auto &view) -> bool {
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_DYNAMIC) continue;
+
+            raw = static_cast<offset_t>(phdr.p_offset);
+            size = static_cast<bufsize_t>(phdr.p_filesz);
+            return true;
+        }
+        return false;
+    });
+}
+
+bool ELFCore::getDynamicValue(int64_t tag, uint64_t &value) const {
+    offset_t dynRaw = 0;
+    bufsize_t dynSize = 0;
+    if (!buf || !getDynamicSegment(dynRaw, dynSize)) return false;
+
+    return withView([&](const auto &view) -> bool {
+        using DynT = typename std::decay_t<decltype(view)>::ElfTraits::Dyn;
+
+        const size_t count = static_cast<size_t>(dynSize / sizeof(DynT));
+        const DynT *dyn = reinterpret_cast<const DynT*>(buf->getContentAt(dynRaw, count * sizeof(DynT), false));
+        if (!dyn) return false;
+
+        for (size_t i = 0; i < count && dyn[i].d_tag != DT_NULL; ++i) {
+            if (static_cast<int64_t>(dyn[i].d_tag) != tag) continue;
+            value = static_cast<uint64_t>(dyn[i].d_un.d_val);
+            return true;
+        }
+        return false;
+    });
+}
+
+bufsize_t ELFCore::cacheAlignment() const {
+    cachedAlignment = 1;
+
+    withView([&](const auto &view) {
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_LOAD) continue;
+            cachedAlignment = std::max(cachedAlignment, static_cast<bufsize_t>(phdr.p_align));
+        }
+    });
+
     cachedAlignmentValid = true;
     return cachedAlignment;
 }
@@ -173,23 +175,17 @@ bufsize_t ELFCore::cacheImageSize() const {
     offset_t maxEnd = 0;
     offset_t minBase = UINT64_MAX;
 
-    for (const auto& variantPhdrPtr : phdrs) {
-        if (isVariantNullptr(variantPhdrPtr)) continue;
-
-        std::visit([&](auto phdrPtr) {
-            using PhdrT = std::remove_pointer_t<decltype(phdrPtr)>;
-            if (!phdrPtr) return;
-
-            const PhdrT &phdr = *phdrPtr;
-            if (phdr.p_type != PT_LOAD) return;
+    withView([&](const auto &view) {
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_LOAD) continue;
 
             offset_t start = static_cast<offset_t>(phdr.p_vaddr);
             offset_t end = static_cast<offset_t>(start + phdr.p_memsz);
 
             minBase = std::min(minBase, start);
             maxEnd = std::max(maxEnd, end);
-        }, variantPhdrPtr);
-    }
+        }
+    });
 
     if (minBase == UINT64_MAX || maxEnd == 0) {
         cachedImageSize = 0;
@@ -202,10 +198,10 @@ bufsize_t ELFCore::cacheImageSize() const {
 }
 
 offset_t ELFCore::getEntryPoint() const {
-    return std::visit([](auto ehdrPtr) -> offset_t {
-        if (!ehdrPtr) return INVALID_ADDR;
-        return static_cast<offset_t>(ehdrPtr->e_entry);
-    }, ehdr);
+    return withView([](const auto &view) -> offset_t {
+        if (!view.header()) return INVALID_ADDR;
+        return static_cast<offset_t>(view.header()->e_entry);
+    });
 }
 
 offset_t ELFCore::getRawSize() const {
@@ -232,23 +228,17 @@ offset_t ELFCore::getVirtualSize() const {
     return cacheVirtualSize();
 }
 
-offset_t ELFCore::cacheImageBase() const  { 
+offset_t ELFCore::cacheImageBase() const  {
     offset_t base = UINT64_MAX;
 
-    for (const auto& variantPhdrPtr : phdrs) {
-        std::visit([&](auto phdrPtr) {
-            using PhdrT = std::remove_pointer_t<decltype(phdrPtr)>;
-            if (!phdrPtr) return;
-
-            const PhdrT &phdr = *phdrPtr;
-
-            if (phdr.p_type != PT_LOAD || phdr.p_vaddr < phdr.p_offset) return;
+    withView([&](const auto &view) {
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_LOAD || phdr.p_vaddr < phdr.p_offset) continue;
 
             offset_t baseCandidate = static_cast<offset_t>(phdr.p_vaddr - phdr.p_offset);
             base = std::min(base, baseCandidate);
-
-        }, variantPhdrPtr);
-    }
+        }
+    });
 
     // we cache the image base so we don't have to loop again.
     cachedImageBase = (base == UINT64_MAX) ? 0 : base;
@@ -256,44 +246,21 @@ offset_t ELFCore::cacheImageBase() const  {
     return cachedImageBase;
 }
 
-// bufsize_t ELFCore::getRawSize() const {
-//     offset_t maxEnd = 0;
-
-//     std::visit([&](auto phdrsPtr) {
-//         using PhdrT = std::remove_pointer_t<decltype(phdrsPtr)>;
-//         if (!phdrsPtr) return;
-
-//         for (size_t i = 0; i < elfProgramHdrsCount(); ++i) {
-//             const PhdrT &phdr = phdrsPtr[i];
-//             if (phdr.p_type != PT_LOAD) continue;
-
-//             offset_t end = static_cast<offset_t>(phdr.p_offset + phdr.p_filesz);
-//             maxEnd = std::max(maxEnd, end);
-//         }
-//     }, getPhdrsVariant());
-
-//     return maxEnd;
-// } 
-
 bufsize_t ELFCore::cacheVirtualSize() const {
     offset_t maxEnd = 0;
     offset_t minBase = UINT64_MAX;
 
-    for (const auto& variantPhdrPtr : phdrs) {
-        std::visit([&](auto phdrPtr) {
-            using PhdrT = std::remove_pointer_t<decltype(phdrPtr)>;
-            if (!phdrPtr) return;
-
-            const PhdrT &phdr = *phdrPtr;
-            if (phdr.p_type != PT_LOAD) return;
+    withView([&](const auto &view) {
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_LOAD) continue;
 
             offset_t start = static_cast<offset_t>(phdr.p_vaddr);
             offset_t end = static_cast<offset_t>(start + phdr.p_memsz);
 
             minBase = std::min(minBase, start);
             maxEnd = std::max(maxEnd, end);
-        }, variantPhdrPtr);
-    }
+        }
+    });
 
     if (minBase == UINT64_MAX) {
         cachedVirtualSize = 0;
@@ -305,202 +272,114 @@ bufsize_t ELFCore::cacheVirtualSize() const {
 }
 
 Executable::exe_bits ELFCore::getHdrBitMode() const {
-    if (std::holds_alternative<Elf64_Ehdr*>(ehdr)) return Executable::BITS_64;
+    if (bits64) return Executable::BITS_64;
     return Executable::BITS_32; // Fallback or invalid state
 }
 
 Executable::exe_arch ELFCore::getHdrArch() const {
-    return std::visit([](auto ehdrPtr) -> Executable::exe_arch {
-        if (!ehdrPtr) return Executable::ARCH_UNKNOWN;
-
-        switch (ehdrPtr->e_machine) {
-            case EM_386:     return Executable::ARCH_INTEL;
-            case EM_X86_64:  return Executable::ARCH_INTEL;
-            case EM_ARM:     return Executable::ARCH_ARM;
-            case EM_AARCH64: return Executable::ARCH_ARM;
-            default:         return Executable::ARCH_UNKNOWN;
-        }
-    }, ehdr);
+    switch (getHdrMachine()) {
+        case EM_386:     return Executable::ARCH_INTEL;
+        case EM_X86_64:  return Executable::ARCH_INTEL;
+        case EM_ARM:     return Executable::ARCH_ARM;
+        case EM_AARCH64: return Executable::ARCH_ARM;
+        default:         return Executable::ARCH_UNKNOWN;
+    }
+}
+
+uint16_t ELFCore::getHdrMachine() const {
+    return withView([](const auto &view) -> uint16_t {
+        if (!view.header()) return EM_NONE;
+        return view.header()->e_machine;
+    });
 }
 
 offset_t ELFCore::getProgramHdrsOffset() const {
-    return std::visit([](auto ehdrPtr) -> offset_t {
-        if (!ehdrPtr) return 0;
-        return static_cast<offset_t>(ehdrPtr->e_phoff);
-    }, ehdr);
+    return withView([](const auto &view) -> offset_t {
+        if (!view.header()) return 0;
+        return static_cast<offset_t>(view.header()->e_phoff);
+    });
 }
 
 offset_t ELFCore::getSectionHdrsOffset() const {
-    return std::visit([](auto ehdrPtr) -> offset_t {
-        if (!ehdrPtr) return 0;
-        return static_cast<offset_t>(ehdrPtr->e_shoff);
-    }, ehdr);
+    return withView([](const auto &view) -> offset_t {
+        if (!view.header()) return 0;
+        return static_cast<offset_t>(view.header()->e_shoff);
+    });
 }
 
-offset_t ELFCore::getProgramHdrsSize() const {
-    return std::visit([](auto ehdrPtr) -> offset_t {
-        if (!ehdrPtr) return 0;
-        return static_cast<offset_t>(ehdrPtr->e_phentsize * ehdrPtr->e_phnum);
-    }, ehdr);
+bufsize_t ELFCore::getProgramHdrsSize() const {
+    return withView([](const auto &view) -> bufsize_t {
+        if (!view.header()) return 0;
+        return static_cast<bufsize_t>(view.header()->e_phentsize * view.header()->e_phnum);
+    });
 }
 
-offset_t ELFCore::getSectionHdrsSize() const {
-    return std::visit([](auto ehdrPtr) -> offset_t {
-        if (!ehdrPtr) return 0;
-        return static_cast<offset_t>(ehdrPtr->e_shentsize * ehdrPtr->e_shnum);
-    }, ehdr);
+bufsize_t ELFCore::getSectionHdrsSize() const {
+    return withView([](const auto &view) -> bufsize_t {
+        if (!view.header()) return 0;
+        return static_cast<bufsize_t>(view.header()->e_shentsize * view.sectionHeaders().size());
+    });
 }
 
-size_t ELFCore::getProgramHdrsCount() const { 
-    return std::visit([](auto ehdrPtr) -> size_t {
-        if (!ehdrPtr) return 0;
-        return static_cast<size_t>(ehdrPtr->e_phnum);      
-    }, ehdr);
+size_t ELFCore::getProgramHdrsCount() const {
+    return withView([](const auto &view) -> size_t { return view.programHeaders().size(); });
 }
 
 size_t ELFCore::getSectionHdrsCount() const {
-    return std::visit([](auto ehdrPtr) -> size_t {
-        if (!ehdrPtr) return 0;
-        return static_cast<size_t>(ehdrPtr->e_shnum);
-    }, ehdr);    
+    return withView([](const auto &view) -> size_t { return view.sectionHeaders().size(); });
 }
 
-QVector<std::variant<Elf32_Phdr*, Elf64_Phdr*>> ELFCore::getProgramHeaders() const {
-    return phdrs;
-} 
+void ELFCore::buildSectionNamesIndex() {
+    const size_t namesIdx = withView([](const auto &view) { return view.sectionNamesIndex(); });
+    if (namesIdx == SHN_UNDEF || namesIdx >= getSectionHdrsCount()) return;
 
-QVector<std::variant<Elf32_Shdr*, Elf64_Shdr*>> ELFCore::getSectionHeaders() const {
-    return shdrs;
+    sectionNames = getSectionStrings(static_cast<int>(namesIdx));
+    if (!sectionNames.isValid()) {
+        Logger::append(Logger::D_WARNING, "Invalid section names table: %u", static_cast<unsigned int>(namesIdx));
+        return;
+    }
+
+    const int count = static_cast<int>(getSectionHdrsCount());
+    sectionsByName.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const std::string_view name = getSectionName(i);
+        if (!name.empty()) sectionsByName.emplace(name, i); // doesn't replace: the first one is kept
+    }
 }
 
-std::variant<Elf32_Shdr*, Elf64_Shdr*> ELFCore::getSectionHdrByIndex(int idx) const {
-    if (idx < 0 || idx >= shdrs.size())
-        return {};
+std::string_view ELFCore::getSectionName(int idx) const {
+    if (idx < 0 || size_t(idx) >= getSectionHdrsCount()) return std::string_view();
 
-    return shdrs[idx];
+    return withView([&](const auto &view) {
+        return sectionNames.getString(view.sectionHeaders()[idx].sh_name);
+    });
 }
 
 QString ELFCore::getSectionNameByIndex(int idx) const {
-    if (idx < 0 || idx >= getSectionHdrsCount()) {
+    if (idx < 0 || size_t(idx) >= getSectionHdrsCount()) {
         throw ExeException("Invalid section index: " + QString::number(idx));
     }
-
-    int shstrndx = std::visit([](auto ehdrPtr) -> int {
-        if (!ehdrPtr) return -1; // Invalid header
-        return ehdrPtr->e_shstrndx;
-    }, ehdr);
-
-    if (shstrndx < 0 || shstrndx >= getSectionHdrsCount())
-        throw ExeException("Invalid section string table index: " + QString::number(shstrndx));
-
-    auto shstrtabVar = shdrs[shstrndx];
-    offset_t strtabOffset = std::visit([](auto shdrsPtr) -> offset_t {
-        if (!shdrsPtr) return 0;
-        return shdrsPtr->sh_offset; // Offset of the section string table
-    }, shstrtabVar);
-
-    return std::visit([&](auto shdrPtr) -> QString {
-        using ShdrT = std::remove_pointer_t<decltype(shdrPtr)>;
-        if (!shdrPtr) return QString(); // Invalid section header
-
-        offset_t nameOffset = strtabOffset + shdrPtr->sh_name;
-
-        const char* namePtr = reinterpret_cast<const char*>(buf->getContentAt(nameOffset, 256, false));
-        if (!namePtr) return QString();
-        return QString::fromUtf8(namePtr);
-    }, shdrs[idx]);
-}
-
-QVector<QString> ELFCore::cacheSectionNames() const {
-    if (cachedSectionNamesValid) return cachedSectionNames;
-
-    cachedSectionNames.clear();
-    for (int i = 0; i < getSectionHdrsCount(); ++i) {
-        try {
-            cachedSectionNames.append(getSectionNameByIndex(i));
-        } catch (const ExeException &e) {
-            qWarning() << "Failed to get section name for index" << i << ":" << e.what();
-            cachedSectionNames.append(QString("Unknown Section %1").arg(i));
-        }
-    }
-
-    cachedSectionNamesValid = true;
-    return cachedSectionNames;
+    const std::string_view name = getSectionName(idx);
+    return QString::fromUtf8(name.data(), static_cast<int>(name.size()));
 }
 
-int ELFCore::findSectionByName(const QString& name) const {
-    for (size_t i = 0; i < getSectionHdrsCount(); ++i) {
-        QString sectionName = getSectionNameByIndex(static_cast<int>(i));
-        if (sectionName == name) {
-            return static_cast<int>(i);
-        }
-    }
-
-    return -1; // Section not found
-}
+ElfStringTable ELFCore::getSectionStrings(int idx) const {
+    if (idx < 0 || size_t(idx) >= getSectionHdrsCount()) return ElfStringTable();
 
-std::variant<Elf32_Ehdr*, Elf64_Ehdr*> ELFCore::getEhdrVariant() const {
-    if (is64()) return getElfHeader<Elf64_Ehdr>();
-    return getElfHeader<Elf32_Ehdr>();
+    return withView([&](const auto &view) {
+        const auto &shdr = view.sectionHeaders()[idx];
+        if (shdr.sh_type != SHT_STRTAB) return ElfStringTable();
+        return ElfStringTable(buf, static_cast<offset_t>(shdr.sh_offset), static_cast<bufsize_t>(shdr.sh_size));
+    });
 }
 
-
-// std::variant<Elf32_Phdr*, Elf64_Phdr*> ELFCore::getPhdrsVariant() const {
-//     if (is64()) return getProgramHeaders<Elf64_Phdr>();
-//     return getProgramHeaders<Elf32_Phdr>();
-// }
-
-// std::variant<Elf32_Shdr*, Elf64_Shdr*> ELFCore::getShdrsVariant() const {
-//     if (is64()) return getSectionHeaders<Elf64_Shdr>();
-//     return getSectionHeaders<Elf32_Shdr>();
-// }
-
-template<typename EhdrT>
-std::variant<Elf32_Ehdr*, Elf64_Ehdr*> ELFCore::getEhdrVariantT() const {
-    return getElfHeader<EhdrT>();
+int ELFCore::findSectionByName(std::string_view name) const {
+    auto itr = sectionsByName.find(name);
+    if (itr == sectionsByName.end()) return -1; // Section not found
+    return itr->second;
 }
 
-// template<typename PhdrT>
-// std::variant<Elf32_Phdr*, Elf64_Phdr*> ELFCore::getPhdrsVariantT() const {
-//     return getProgramHeaders<PhdrT>();
-// }
-
-// template<typename ShdrT>
-// std::variant<Elf32_Shdr*, Elf64_Shdr*> ELFCore::getShdrsVariantT() const {
-//     return getSectionHeaders<ShdrT>();
-// }
-
-// templated getters for ELF structures
-template <typename T>
-T* ELFCore::getElfHeader() const {
-    // compile-time check to ensure T is either Elf32_Ehdr or Elf64_Ehdr
-    static_assert(std::is_same_v<T, Elf32_Ehdr> || std::is_same_v<T, Elf64_Ehdr>,
-                  "Invalid type passed to getElfHeader<T>() — must be Elf32_Ehdr or Elf64_Ehdr");
-    
-    // an even better way to achieve the preceding is using get_if.
-    auto ptr = std::get_if<T*>(&ehdr);
-    return ptr ? *ptr : nullptr;
+int ELFCore::findSectionByName(const QString& name) const {
+    const QByteArray utf8Name = name.toUtf8();
+    return findSectionByName(std::string_view(utf8Name.constData(), utf8Name.size()));
 }
-
-// templated getters for Program and Section headers
-// template <typename T>
-// T* ELFCore::getProgramHeaders() const {
-//     // compile-time check to ensure T is either Elf32_Phdr or Elf64_Phdr
-//     static_assert(std::is_same_v<T, Elf32_Phdr> || std::is_same_v<T, Elf64_Phdr>,
-//                   "Invalid type passed to getProgramHeaders<T>() — must be Elf32_Phdr or Elf64_Phdr");
-
-//     // an even better way to achieve the preceding is using get_if.
-//     auto ptr = std::get_if<T*>(&phdrs);
-//     return ptr ? *ptr : nullptr;
-// }
-
-// template <typename T>
-// T* ELFCore::getSectionHeaders() const {
-//     // compile-time check to ensure T is either Elf32_Shdr or Elf64_Shdr
-//     static_assert(std::is_same_v<T, Elf32_Shdr> || std::is_same_v<T, Elf64_Shdr>,
-//                   "Invalid type passed to getSectionHeaders<T>() — must be Elf32_Shdr or Elf64_Shdr");
-    
-//     // an even better way to achieve the preceding is using get_if.
-//     auto ptr = std::get_if<T*>(&shdrs);
-//     return ptr ? *ptr : nullptr;
-// }
\ No newline at end of file
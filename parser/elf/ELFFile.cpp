@@ -31,8 +31,9 @@ Executable* ELFFileBuilder::build(AbstractByteBuffer *buf)
 }
 
 ELFFile::ELFFile(AbstractByteBuffer *v_buf)
-    : MappedExe(v_buf, Executable::BITS_64) // default should be 64-bit.
+    : MappedExe(v_buf, Executable::BITS_64), // default should be 64-bit.
       // elfHdr(NULL), progHdrs(NULL), sectHdrs(NULL), symTab(NULL), dynTab(NULL)
+      functionIndex(NULL)
 {
     clearWrappers();
 
@@ -48,8 +49,139 @@ void ELFFile::_init(AbstractByteBuffer *v_buf)
     this->elfHdr = new ElfHdrWrapper(this);
     this->progHdrs = new ElfProgHdrWrapper(this);
     this->sectHdrs = new ElfSectHdrWrapper(this);
-    // this->symTab = new ElfSymTabWrapper(this);
-    // this->dynTab = new ElfDynWrapper(this);
+
+    this->symTab = new ElfSymTabWrapper(this, SHT_SYMTAB);
+    this->dynSymTab = new ElfSymTabWrapper(this, SHT_DYNSYM);
+    this->wrappers[WR_SYMBOL_TABLE] = this->symTab;
+    this->wrappers[WR_DYN_SYM_TABLE] = this->dynSymTab;
+    this->dynTab = new ElfDynWrapper(this);
+    this->wrappers[WR_DYNAMIC] = this->dynTab;
+
+    wrapRelocTables();
+    wrapNotes();
+
+    this->ehFrameHdr = new ElfEhFrameHdrWrapper(this);
+    this->wrappers[WR_EH_FRAME_HDR] = this->ehFrameHdr;
+}
+
+void ELFFile::wrapRelocTables()
+{
+    struct RelocTableDesc {
+        size_t wrapperId;
+        int64_t addrTag;
+        int64_t sizeTag;
+        ElfRelocWrapper::reloc_format format;
+        QString name;
+    };
+
+    uint64_t pltFormat = DT_RELA;
+    this->dynTab->findValue(DT_PLTREL, pltFormat);
+
+    const RelocTableDesc tables[] = {
+        { WR_RELA_DYN, DT_RELA, DT_RELASZ, ElfRelocWrapper::RELOC_RELA, "ELF Relocations (RELA)" },
+        { WR_REL_DYN, DT_REL, DT_RELSZ, ElfRelocWrapper::RELOC_REL, "ELF Relocations (REL)" },
+        { WR_PLT_RELOCS, DT_JMPREL, DT_PLTRELSZ,
+            (pltFormat == DT_REL) ? ElfRelocWrapper::RELOC_REL : ElfRelocWrapper::RELOC_RELA, "ELF PLT Relocations" },
+        { WR_RELR_DYN, DT_RELR, DT_RELRSZ, ElfRelocWrapper::RELOC_RELR, "ELF Relocations (RELR)" }
+    };
+
+    for (const RelocTableDesc &desc : tables) {
+        uint64_t va = 0, size = 0;
+        if (!this->dynTab->findValue(desc.addrTag, va) || !this->dynTab->findValue(desc.sizeTag, size) || !size) {
+            continue;
+        }
+        const offset_t raw = convertAddr(va, Executable::VA, Executable::RAW);
+        if (raw == INVALID_ADDR) {
+            Logger::append(Logger::D_WARNING, "Relocation table out of the file: %llX", static_cast<unsigned long long>(va));
+            continue;
+        }
+        this->wrappers[desc.wrapperId] = new ElfRelocWrapper(this, desc.format, raw, static_cast<bufsize_t>(size), desc.name);
+    }
+}
+
+std::vector<ElfRelocWrapper*> ELFFile::getRelocTables()
+{
+    std::vector<ElfRelocWrapper*> tables;
+    for (size_t id = WR_RELA_DYN; id <= WR_RELR_DYN; ++id) {
+        ElfRelocWrapper *table = dynamic_cast<ElfRelocWrapper*>(getWrapper(id));
+        if (table) tables.push_back(table);
+    }
+    return tables;
+}
+
+size_t ELFFile::applyRelocations(offset_t newBase)
+{
+    size_t applied = 0;
+    for (ElfRelocWrapper *table : getRelocTables()) {
+        applied += table->applyRelocations(newBase);
+    }
+    return applied;
+}
+
+void ELFFile::wrapNotes()
+{
+    withView([this](const auto &view) {
+        const auto &shdrs = view.sectionHeaders();
+        for (size_t i = 0; i < shdrs.size(); ++i) {
+            if (shdrs[i].sh_type != SHT_NOTE) continue;
+
+            const std::string_view name = core.getSectionName(static_cast<int>(i));
+            this->notes.push_back(new ElfNoteWrapper(this, static_cast<offset_t>(shdrs[i].sh_offset),
+                static_cast<bufsize_t>(shdrs[i].sh_size), static_cast<bufsize_t>(shdrs[i].sh_addralign),
+                QString::fromUtf8(name.data(), static_cast<int>(name.size()))));
+        }
+        if (!this->notes.empty()) return;
+
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_NOTE) continue;
+
+            this->notes.push_back(new ElfNoteWrapper(this, static_cast<offset_t>(phdr.p_offset),
+                static_cast<bufsize_t>(phdr.p_filesz), static_cast<bufsize_t>(phdr.p_align), "PT_NOTE"));
+        }
+    });
+}
+
+const ElfFunctionIndex& ELFFile::getFunctionIndex()
+{
+    if (!this->functionIndex) {
+        this->functionIndex = new ElfFunctionIndex(this);
+    }
+    return *this->functionIndex;
+}
+
+QByteArray ELFFile::getBuildId()
+{
+    ElfNote note;
+    for (ElfNoteWrapper *notesArea : this->notes) {
+        if (!notesArea->findNote(NT_GNU_BUILD_ID, "GNU", note)) continue;
+        return QByteArray(reinterpret_cast<const char*>(note.desc), static_cast<int>(note.descSize));
+    }
+    return QByteArray();
+}
+
+bool ELFFile::getAbiTag(ElfAbiTag &tag)
+{
+    ElfNote note;
+    for (ElfNoteWrapper *notesArea : this->notes) {
+        if (notesArea->findNote(NT_GNU_ABI_TAG, "GNU", note)) {
+            return ElfNoteWrapper::decodeAbiTag(note, tag);
+        }
+    }
+    return false;
+}
+
+size_t ELFFile::getGnuProperties(std::vector<ElfGnuProperty> &props)
+{
+    const bufsize_t propsAlign = (getBitMode() == Executable::BITS_64) ? 8 : 4;
+
+    size_t count = 0;
+    for (ElfNoteWrapper *notesArea : this->notes) {
+        notesArea->forEachNote([&](const ElfNote &note) {
+            count += ElfNoteWrapper::decodeGnuProperties(note, propsAlign, props);
+            return true;
+        });
+    }
+    return count;
 }
 
 void ELFFile::clearWrappers() {
@@ -57,18 +189,27 @@ void ELFFile::clearWrappers() {
     this->elfHdr   = NULL;
     this->progHdrs = NULL;
     // this->SectHdrs = NULL;
-    // this->symTab   = NULL;
-    // this->dynTab   = NULL;
+    this->symTab   = NULL;
+    this->dynSymTab = NULL;
+    this->dynTab   = NULL;
+    this->ehFrameHdr = NULL;
+
+    delete this->functionIndex;
+    this->functionIndex = NULL;
+
+    for (ElfNoteWrapper *notesArea : this->notes) {
+        delete notesArea;
+    }
+    this->notes.clear();
 }
 
 offset_t ELFFile::getEntryPoint(Executable::addr_type addrType) {
-    // need to do some verifications here.
-    // if (addrType != Executable::VA) {
-    //     Logger::append(Logger::D_ERROR, "ELF entry point must be VA.");
-    //     return INVALID_ADDR;
-    // }
+    // e_entry is stored as VA
+    const offset_t entryVA = core.getEntryPoint();
+    if (entryVA == INVALID_ADDR) return INVALID_ADDR;
 
-    return core.getEntryPoint();
+    if (addrType == Executable::VA) return entryVA;
+    return convertAddr(entryVA, Executable::VA, addrType);
 }
 
 bufsize_t ELFFile::getMappedSize(Executable::addr_type aType) {
@@ -81,7 +222,7 @@ bufsize_t ELFFile::getMappedSize(Executable::addr_type aType) {
     constexpr size_t unit_size = 0x1000;
 
     if (aType == Executable::VA || aType == Executable::RVA) {
-        bufsize_t vSize = core.cacheVirtualSize();
+        bufsize_t vSize = core.getLoadedSize();
         return (vSize < unit_size) ? unit_size : vSize;
     }
 
@@ -0,0 +1,218 @@
+#include "elf/ElfDynWrapper.h"
+#include "elf/ELFFile.h"
+
+const std::unordered_map<int64_t, QString> ElfDynWrapper::s_dynTags = {
+    {DT_NULL, "NULL"},
+    {DT_NEEDED, "NEEDED"},
+    {DT_PLTRELSZ, "PLTRELSZ"},
+    {DT_PLTGOT, "PLTGOT"},
+    {DT_HASH, "HASH"},
+    {DT_STRTAB, "STRTAB"},
+    {DT_SYMTAB, "SYMTAB"},
+    {DT_RELA, "RELA"},
+    {DT_RELASZ, "RELASZ"},
+    {DT_RELAENT, "RELAENT"},
+    {DT_STRSZ, "STRSZ"},
+    {DT_SYMENT, "SYMENT"},
+    {DT_INIT, "INIT"},
+    {DT_FINI, "FINI"},
+    {DT_SONAME, "SONAME"},
+    {DT_RPATH, "RPATH"},
+    {DT_SYMBOLIC, "SYMBOLIC"},
+    {DT_REL, "REL"},
+    {DT_RELSZ, "RELSZ"},
+    {DT_RELENT, "RELENT"},
+    {DT_PLTREL, "PLTREL"},
+    {DT_DEBUG, "DEBUG"},
+    {DT_TEXTREL, "TEXTREL"},
+    {DT_JMPREL, "JMPREL"},
+    {DT_BIND_NOW, "BIND_NOW"},
+    {DT_INIT_ARRAY, "INIT_ARRAY"},
+    {DT_FINI_ARRAY, "FINI_ARRAY"},
+    {DT_INIT_ARRAYSZ, "INIT_ARRAYSZ"},
+    {DT_FINI_ARRAYSZ, "FINI_ARRAYSZ"},
+    {DT_RUNPATH, "RUNPATH"},
+    {DT_FLAGS, "FLAGS"},
+    {DT_PREINIT_ARRAY, "PREINIT_ARRAY"},
+    {DT_PREINIT_ARRAYSZ, "PREINIT_ARRAYSZ"},
+    {DT_SYMTAB_SHNDX, "SYMTAB_SHNDX"},
+    {DT_RELRSZ, "RELRSZ"},
+    {DT_RELR, "RELR"},
+    {DT_RELRENT, "RELRENT"},
+    {DT_GNU_HASH, "GNU_HASH"},
+    {DT_VERSYM, "VERSYM"},
+    {DT_RELACOUNT, "RELACOUNT"},
+    {DT_RELCOUNT, "RELCOUNT"},
+    {DT_FLAGS_1, "FLAGS_1"},
+    {DT_VERDEF, "VERDEF"},
+    {DT_VERDEFNUM, "VERDEFNUM"},
+    {DT_VERNEED, "VERNEED"},
+    {DT_VERNEEDNUM, "VERNEEDNUM"},
+};
+
+QString ElfDynWrapper::translateTag(int64_t tag)
+{
+    auto itr = s_dynTags.find(tag);
+    if (itr != s_dynTags.end()) return itr->second;
+    return "0x" + QString::number(static_cast<qulonglong>(tag), 16);
+}
+
+bool ElfDynWrapper::isPointerTag(int64_t tag)
+{
+    switch (tag) {
+        case DT_PLTGOT: case DT_HASH: case DT_STRTAB: case DT_SYMTAB:
+        case DT_RELA: case DT_INIT: case DT_FINI: case DT_REL: case DT_JMPREL:
+        case DT_INIT_ARRAY: case DT_FINI_ARRAY: case DT_PREINIT_ARRAY: case DT_RELR:
+        case DT_GNU_HASH: case DT_VERSYM: case DT_VERDEF: case DT_VERNEED:
+            return true;
+    }
+    return false;
+}
+
+ElfDynWrapper::ElfDynWrapper(ELFFile *elfExe)
+    : ELFElementWrapper(elfExe),
+      dynRaw(INVALID_ADDR), entriesCount(0), entrySize(0)
+{
+    wrap();
+}
+
+bool ElfDynWrapper::wrap()
+{
+    dynRaw = INVALID_ADDR;
+    entriesCount = 0;
+    strings = ElfStringTable();
+    entrySize = m_ELF->withView([](const auto &view) -> bufsize_t {
+        return sizeof(typename std::decay_t<decltype(view)>::ElfTraits::Dyn);
+    });
+
+    bufsize_t dynSize = 0;
+    if (!m_ELF->elfDynamicSegment(dynRaw, dynSize)) return false;
+
+    const bufsize_t rawSize = m_ELF->getRawSize();
+    if (dynRaw >= rawSize) return false;
+    dynSize = std::min<bufsize_t>(dynSize, rawSize - dynRaw);
+
+    // count the entries up to the terminator
+    const size_t maxCount = dynSize / entrySize;
+    for (entriesCount = 0; entriesCount < maxCount; ++entriesCount) {
+        if (getTag(entriesCount) == DT_NULL) break;
+    }
+
+    uint64_t strtabVA = 0, strSize = 0;
+    if (findValue(DT_STRTAB, strtabVA)) {
+        findValue(DT_STRSZ, strSize);
+        strings = ElfStringTable(m_ELF, m_ELF->convertAddr(strtabVA, Executable::VA, Executable::RAW), static_cast<bufsize_t>(strSize));
+    }
+    return entriesCount > 0;
+}
+
+void* ElfDynWrapper::getPtr()
+{
+    if (entriesCount == 0) return NULL;
+    return m_ELF->getContentAt(dynRaw, getSize());
+}
+
+void* ElfDynWrapper::getEntryPtr(size_t index)
+{
+    if (dynRaw == INVALID_ADDR) return NULL;
+    return m_ELF->getContentAt(dynRaw + index * entrySize, entrySize);
+}
+
+template <typename Func>
+auto ElfDynWrapper::withEntry(size_t index, Func func)
+{
+    void *ptr = getEntryPtr(index);
+    return m_ELF->withView([&](const auto &view) {
+        using DynT = typename std::decay_t<decltype(view)>::ElfTraits::Dyn;
+        return func(static_cast<DynT*>(ptr));
+    });
+}
+
+int64_t ElfDynWrapper::getTag(size_t index)
+{
+    return withEntry(index, [](auto dyn) -> int64_t {
+        return dyn ? static_cast<int64_t>(dyn->d_tag) : DT_NULL;
+    });
+}
+
+uint64_t ElfDynWrapper::getValue(size_t index)
+{
+    return withEntry(index, [](auto dyn) -> uint64_t {
+        return dyn ? static_cast<uint64_t>(dyn->d_un.d_val) : 0;
+    });
+}
+
+bool ElfDynWrapper::findValue(int64_t tag, uint64_t &value)
+{
+    for (size_t i = 0; i < entriesCount; ++i) {
+        if (getTag(i) != tag) continue;
+        value = getValue(i);
+        return true;
+    }
+    return false;
+}
+
+QString ElfDynWrapper::getString(uint64_t strOffset)
+{
+    return strings.getQString(strOffset);
+}
+
+QStringList ElfDynWrapper::getNeededLibraries()
+{
+    QStringList libs;
+    for (size_t i = 0; i < entriesCount; ++i) {
+        if (getTag(i) == DT_NEEDED) libs.append(getString(getValue(i)));
+    }
+    return libs;
+}
+
+QString ElfDynWrapper::getSoName()
+{
+    uint64_t strOffset = 0;
+    if (!findValue(DT_SONAME, strOffset)) return "";
+    return getString(strOffset);
+}
+
+QString ElfDynWrapper::getRunPath()
+{
+    uint64_t strOffset = 0;
+    if (findValue(DT_RUNPATH, strOffset) || findValue(DT_RPATH, strOffset)) {
+        return getString(strOffset);
+    }
+    return "";
+}
+
+//---
+
+void* ElfDynWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+
+    return withEntry(index, [fieldId](auto dyn) -> void* {
+        if (!dyn) return NULL;
+        if (fieldId == D_VAL) return &dyn->d_un;
+        return dyn;
+    });
+}
+
+bufsize_t ElfDynWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    if (fieldId == D_TAG || fieldId == D_VAL) return entrySize / 2;
+    return entrySize;
+}
+
+QString ElfDynWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case D_TAG: return "Tag";
+        case D_VAL: return "Value";
+    }
+    return getName();
+}
+
+Executable::addr_type ElfDynWrapper::containsAddrType(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+    if (fieldId == D_VAL && isPointerTag(getTag(index))) return Executable::VA;
+    return Executable::NOT_ADDR;
+}
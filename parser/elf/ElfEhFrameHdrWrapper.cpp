@@ -0,0 +1,401 @@
+#include "elf/ElfEhFrameHdrWrapper.h"
+#include "elf/ELFFile.h"
+
+#include <cstring>
+#include <string_view>
+
+namespace {
+    // reads DWARF values from an area in the memory, mapped at the given VA
+    class DwarfReader
+    {
+    public:
+        DwarfReader(const BYTE *v_start, bufsize_t v_size, offset_t v_va, bool v_is64)
+            : start(v_start), pos(v_start), end(v_start + v_size), va(v_va), is64(v_is64)
+        {}
+
+        size_t getOffset() const { return static_cast<size_t>(pos - start); }
+
+        bool skip(uint64_t count)
+        {
+            if (count > static_cast<uint64_t>(end - pos)) return false;
+            pos += count;
+            return true;
+        }
+
+        template <typename T>
+        bool read(T &value)
+        {
+            if (static_cast<size_t>(end - pos) < sizeof(T)) return false;
+            memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+            return true;
+        }
+
+        bool readUleb(uint64_t &value)
+        {
+            value = 0;
+            for (unsigned int shift = 0; pos < end; shift += 7) {
+                const BYTE byte = *pos++;
+                if (shift < 64) value |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool readSleb(int64_t &value)
+        {
+            uint64_t result = 0;
+            unsigned int shift = 0;
+            BYTE byte = 0;
+            do {
+                if (pos >= end) return false;
+                byte = *pos++;
+                if (shift < 64) result |= uint64_t(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+
+            if (shift < 64 && (byte & 0x40)) result |= ~uint64_t(0) << shift;
+            value = static_cast<int64_t>(result);
+            return true;
+        }
+
+        bool readString(std::string_view &str)
+        {
+            const BYTE *terminator = static_cast<const BYTE*>(memchr(pos, 0, end - pos));
+            if (!terminator) return false;
+            str = std::string_view(reinterpret_cast<const char*>(pos), terminator - pos);
+            pos = terminator + 1;
+            return true;
+        }
+
+        // the pointer encoded with DW_EH_PE_*; the indirect pointers are not dereferenced
+        bool readEncoded(uint8_t encoding, offset_t dataRelVA, uint64_t &value)
+        {
+            if (encoding == DW_EH_PE_omit) return false;
+            const offset_t fieldVA = va + getOffset();
+
+            bool isOk = false;
+            switch (encoding & 0x0F) {
+                case DW_EH_PE_absptr:
+                    if (is64) {
+                        isOk = read(value);
+                    } else {
+                        uint32_t val32 = 0;
+                        isOk = read(val32);
+                        value = val32;
+                    }
+                    break;
+                case DW_EH_PE_uleb128: isOk = readUleb(value); break;
+                case DW_EH_PE_udata2: { uint16_t val = 0; isOk = read(val); value = val; break; }
+                case DW_EH_PE_udata4: { uint32_t val = 0; isOk = read(val); value = val; break; }
+                case DW_EH_PE_udata8: isOk = read(value); break;
+                case DW_EH_PE_sleb128: { int64_t val = 0; isOk = readSleb(val); value = static_cast<uint64_t>(val); break; }
+                case DW_EH_PE_sdata2: { int16_t val = 0; isOk = read(val); value = static_cast<uint64_t>(int64_t(val)); break; }
+                case DW_EH_PE_sdata4: { int32_t val = 0; isOk = read(val); value = static_cast<uint64_t>(int64_t(val)); break; }
+                case DW_EH_PE_sdata8: isOk = read(value); break;
+            }
+            if (!isOk) return false;
+
+            switch (encoding & 0x70) {
+                case 0: break;
+                case DW_EH_PE_pcrel: value += fieldVA; break;
+                case DW_EH_PE_datarel: value += dataRelVA; break;
+                default:
+                    return false; // not used by .eh_frame_hdr and the FDEs
+            }
+            if (!is64) value &= 0xFFFFFFFF;
+            return true;
+        }
+
+    private:
+        const BYTE *start;
+        const BYTE *pos;
+        const BYTE *end;
+        offset_t va;
+        bool is64;
+    };
+
+    // the length of a CIE or FDE, and the size of the length field (64-bit DWARF has the escape value first)
+    bool readEntryLength(Executable *exe, offset_t raw, uint64_t &length, bufsize_t &lengthSize)
+    {
+        const uint32_t *length32 = reinterpret_cast<const uint32_t*>(exe->getContentAt(raw, sizeof(uint32_t)));
+        if (!length32) return false;
+
+        if (*length32 != 0xFFFFFFFF) {
+            length = *length32;
+            lengthSize = sizeof(uint32_t);
+            return true;
+        }
+        const uint64_t *length64 = reinterpret_cast<const uint64_t*>(exe->getContentAt(raw + sizeof(uint32_t), sizeof(uint64_t)));
+        if (!length64) return false;
+
+        length = *length64;
+        lengthSize = sizeof(uint32_t) + sizeof(uint64_t);
+        return true;
+    }
+};
+
+bufsize_t ElfEhFrameHdrWrapper::encodedSize(uint8_t encoding, bool is64)
+{
+    switch (encoding & 0x0F) {
+        case DW_EH_PE_absptr: return is64 ? sizeof(uint64_t) : sizeof(uint32_t);
+        case DW_EH_PE_udata2: case DW_EH_PE_sdata2: return sizeof(uint16_t);
+        case DW_EH_PE_udata4: case DW_EH_PE_sdata4: return sizeof(uint32_t);
+        case DW_EH_PE_udata8: case DW_EH_PE_sdata8: return sizeof(uint64_t);
+    }
+    return 0;
+}
+
+ElfEhFrameHdrWrapper::ElfEhFrameHdrWrapper(ELFFile *elfExe)
+    : ELFElementWrapper(elfExe),
+      hdrRaw(INVALID_ADDR), hdrVA(INVALID_ADDR), hdrSize(0),
+      ehFrameVA(INVALID_ADDR), fdeCountOffset(0), entriesCount(0), tableOffset(0), tableEntrySize(0)
+{
+    wrap();
+}
+
+bool ElfEhFrameHdrWrapper::wrap()
+{
+    hdrRaw = hdrVA = ehFrameVA = INVALID_ADDR;
+    hdrSize = 0;
+    entriesCount = 0;
+    fdeEncodings.clear();
+
+    // the segment is present also in the stripped binaries
+    m_ELF->withView([this](const auto &view) {
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_GNU_EH_FRAME) continue;
+            hdrRaw = static_cast<offset_t>(phdr.p_offset);
+            hdrVA = static_cast<offset_t>(phdr.p_vaddr);
+            hdrSize = static_cast<bufsize_t>(phdr.p_filesz);
+            return;
+        }
+        const int sectionIdx = m_ELF->elfFindSection(".eh_frame_hdr");
+        if (sectionIdx < 0) return;
+
+        const auto &shdr = view.sectionHeaders()[sectionIdx];
+        hdrRaw = static_cast<offset_t>(shdr.sh_offset);
+        hdrVA = static_cast<offset_t>(shdr.sh_addr);
+        hdrSize = static_cast<bufsize_t>(shdr.sh_size);
+    });
+
+    const bufsize_t rawSize = m_ELF->getRawSize();
+    if (hdrRaw == INVALID_ADDR || hdrRaw >= rawSize) return false;
+    hdrSize = std::min<bufsize_t>(hdrSize, rawSize - hdrRaw);
+
+    const BYTE *hdr = m_ELF->getContentAt(hdrRaw, hdrSize);
+    if (!hdr || hdrSize < 4 || hdr[VERSION] != 1) return false;
+
+    const bool is64 = isBit64();
+    DwarfReader reader(hdr, hdrSize, hdrVA, is64);
+    reader.skip(4);
+
+    uint64_t value = 0;
+    if (!reader.readEncoded(hdr[EH_FRAME_PTR_ENC], hdrVA, value)) return false;
+    ehFrameVA = static_cast<offset_t>(value);
+
+    fdeCountOffset = reader.getOffset();
+    uint64_t fdeCount = 0;
+    if (!reader.readEncoded(hdr[FDE_COUNT_ENC], hdrVA, fdeCount)) return true; // no table
+
+    // the binary search table requires the entries of a fixed size
+    tableEntrySize = 2 * encodedSize(hdr[TABLE_ENC], is64);
+    if (tableEntrySize == 0 || hdr[TABLE_ENC] == DW_EH_PE_omit) {
+        Logger::append(Logger::D_WARNING, "Unsupported encoding of the .eh_frame_hdr table: %X", hdr[TABLE_ENC]);
+        return true;
+    }
+    tableOffset = reader.getOffset();
+    entriesCount = static_cast<size_t>(std::min<uint64_t>(fdeCount, (hdrSize - tableOffset) / tableEntrySize));
+    return true;
+}
+
+void* ElfEhFrameHdrWrapper::getPtr()
+{
+    if (hdrRaw == INVALID_ADDR || hdrSize == 0) return NULL;
+    return m_ELF->getContentAt(hdrRaw, getSize());
+}
+
+bufsize_t ElfEhFrameHdrWrapper::getSize()
+{
+    if (entriesCount == 0) return std::min<bufsize_t>(hdrSize, static_cast<bufsize_t>(fdeCountOffset));
+    return static_cast<bufsize_t>(tableOffset + entriesCount * tableEntrySize);
+}
+
+bool ElfEhFrameHdrWrapper::getEntry(size_t index, offset_t &startVA, offset_t &fdeVA)
+{
+    if (index >= entriesCount) return false;
+
+    const bufsize_t entryOffset = static_cast<bufsize_t>(tableOffset + index * tableEntrySize);
+    const BYTE *entry = m_ELF->getContentAt(hdrRaw + entryOffset, tableEntrySize);
+    const BYTE *tableEnc = m_ELF->getContentAt(hdrRaw + TABLE_ENC, sizeof(uint8_t));
+    if (!entry || !tableEnc) return false;
+
+    DwarfReader reader(entry, tableEntrySize, hdrVA + entryOffset, isBit64());
+    uint64_t start = 0, fde = 0;
+    if (!reader.readEncoded(*tableEnc, hdrVA, start) || !reader.readEncoded(*tableEnc, hdrVA, fde)) return false;
+
+    startVA = static_cast<offset_t>(start);
+    fdeVA = static_cast<offset_t>(fde);
+    return true;
+}
+
+uint8_t ElfEhFrameHdrWrapper::getFdeEncoding(offset_t cieRaw)
+{
+    auto itr = fdeEncodings.find(cieRaw);
+    if (itr != fdeEncodings.end()) return itr->second;
+
+    uint8_t encoding = DW_EH_PE_omit;
+    fdeEncodings[cieRaw] = encoding;
+
+    uint64_t length = 0;
+    bufsize_t lengthSize = 0;
+    if (!readEntryLength(m_ELF, cieRaw, length, lengthSize) || length == 0 || length > m_ELF->getRawSize()) {
+        return encoding;
+    }
+    const BYTE *cie = m_ELF->getContentAt(cieRaw + lengthSize, static_cast<bufsize_t>(length));
+    if (!cie) return encoding;
+
+    const bool is64 = isBit64();
+    DwarfReader reader(cie, static_cast<bufsize_t>(length), m_ELF->convertAddr(cieRaw + lengthSize, Executable::RAW, Executable::VA), is64);
+
+    // the CIE id is 0 in .eh_frame
+    uint64_t cieId = 1;
+    if (lengthSize == sizeof(uint32_t)) {
+        uint32_t cieId32 = 1;
+        reader.read(cieId32);
+        cieId = cieId32;
+    } else {
+        reader.read(cieId);
+    }
+    uint8_t version = 0;
+    std::string_view augmentation;
+    if (cieId != 0 || !reader.read(version) || !reader.readString(augmentation)) return encoding;
+
+    uint64_t codeAlign = 0, returnReg = 0;
+    int64_t dataAlign = 0;
+    if (augmentation.find("eh") != std::string_view::npos && !reader.skip(is64 ? sizeof(uint64_t) : sizeof(uint32_t))) return encoding;
+    if (!reader.readUleb(codeAlign) || !reader.readSleb(dataAlign)) return encoding;
+    if (version == 1) {
+        uint8_t returnReg8 = 0;
+        if (!reader.read(returnReg8)) return encoding;
+    } else if (!reader.readUleb(returnReg)) {
+        return encoding;
+    }
+
+    uint8_t fdeEncoding = DW_EH_PE_absptr;
+    if (!augmentation.empty() && augmentation[0] == 'z') {
+        uint64_t augmentationSize = 0;
+        if (!reader.readUleb(augmentationSize)) return encoding;
+
+        for (size_t i = 1; i < augmentation.size(); ++i) {
+            uint8_t dataEncoding = 0;
+            uint64_t personality = 0;
+
+            switch (augmentation[i]) {
+                case 'R':
+                    if (!reader.read(fdeEncoding)) return encoding;
+                    break;
+                case 'P':
+                    if (!reader.read(dataEncoding) || !reader.readEncoded(dataEncoding, 0, personality)) return encoding;
+                    break;
+                case 'L':
+                    if (!reader.read(dataEncoding)) return encoding;
+                    break;
+                case 'S': case 'B': case 'G':
+                    break;
+                default:
+                    i = augmentation.size(); // unknown: the rest of the data can't be interpreted
+                    break;
+            }
+        }
+    }
+    encoding = fdeEncoding;
+    fdeEncodings[cieRaw] = encoding;
+    return encoding;
+}
+
+bufsize_t ElfEhFrameHdrWrapper::getFunctionSize(offset_t fdeVA)
+{
+    const offset_t fdeRaw = m_ELF->convertAddr(fdeVA, Executable::VA, Executable::RAW);
+    if (fdeRaw == INVALID_ADDR) return 0;
+
+    uint64_t length = 0;
+    bufsize_t lengthSize = 0;
+    if (!readEntryLength(m_ELF, fdeRaw, length, lengthSize) || length == 0 || length > m_ELF->getRawSize()) return 0;
+
+    const BYTE *fde = m_ELF->getContentAt(fdeRaw + lengthSize, static_cast<bufsize_t>(length));
+    if (!fde) return 0;
+
+    DwarfReader reader(fde, static_cast<bufsize_t>(length), fdeVA + lengthSize, isBit64());
+
+    // the CIE pointer: the distance back from this field
+    uint64_t ciePtr = 0;
+    if (lengthSize == sizeof(uint32_t)) {
+        uint32_t ciePtr32 = 0;
+        reader.read(ciePtr32);
+        ciePtr = ciePtr32;
+    } else {
+        reader.read(ciePtr);
+    }
+    const offset_t ciePtrRaw = fdeRaw + lengthSize;
+    if (ciePtr == 0 || ciePtr > ciePtrRaw) return 0; // a CIE, not FDE
+
+    const uint8_t encoding = getFdeEncoding(ciePtrRaw - ciePtr);
+
+    // pc_range has the format of pc_begin, but it is not relative to anything
+    uint64_t pcBegin = 0, pcRange = 0;
+    if (!reader.readEncoded(encoding, 0, pcBegin) || !reader.readEncoded(encoding & 0x0F, 0, pcRange)) return 0;
+    return static_cast<bufsize_t>(pcRange);
+}
+
+//---
+
+void* ElfEhFrameHdrWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    BYTE *hdr = static_cast<BYTE*>(getPtr());
+    if (!hdr) return NULL;
+
+    switch (fieldId) {
+        case VERSION: case EH_FRAME_PTR_ENC: case FDE_COUNT_ENC: case TABLE_ENC:
+            return hdr + fieldId;
+        case EH_FRAME_PTR: return hdr + 4;
+        case FDE_COUNT: return hdr + fdeCountOffset;
+    }
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+    if (index >= entriesCount) return NULL;
+
+    BYTE *entry = hdr + tableOffset + index * tableEntrySize;
+    if (fieldId == TABLE_FDE) return entry + tableEntrySize / 2;
+    return entry;
+}
+
+bufsize_t ElfEhFrameHdrWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    const BYTE *hdr = static_cast<const BYTE*>(getPtr());
+    if (!hdr) return 0;
+
+    switch (fieldId) {
+        case VERSION: case EH_FRAME_PTR_ENC: case FDE_COUNT_ENC: case TABLE_ENC:
+            return sizeof(uint8_t);
+        case EH_FRAME_PTR: return encodedSize(hdr[EH_FRAME_PTR_ENC], isBit64());
+        case FDE_COUNT: return encodedSize(hdr[FDE_COUNT_ENC], isBit64());
+        case TABLE_INITIAL_LOC: case TABLE_FDE:
+            return tableEntrySize / 2;
+    }
+    return getSize();
+}
+
+QString ElfEhFrameHdrWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case VERSION: return "Version";
+        case EH_FRAME_PTR_ENC: return "eh_frame_ptr encoding";
+        case FDE_COUNT_ENC: return "fde_count encoding";
+        case TABLE_ENC: return "Table encoding";
+        case EH_FRAME_PTR: return "eh_frame_ptr";
+        case FDE_COUNT: return "fde_count";
+        case TABLE_INITIAL_LOC: return "Initial location";
+        case TABLE_FDE: return "FDE address";
+    }
+    return getName();
+}
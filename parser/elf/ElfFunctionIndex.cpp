@@ -0,0 +1,154 @@
+#include "elf/ElfFunctionIndex.h"
+#include "elf/ELFFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+void ElfAddressIndex::assign(std::vector<ElfAddressRange> &&v_ranges)
+{
+    ranges = std::move(v_ranges);
+    std::sort(ranges.begin(), ranges.end(), [](const ElfAddressRange &a, const ElfAddressRange &b) {
+        return a.start < b.start;
+    });
+}
+
+size_t ElfAddressIndex::find(offset_t va) const
+{
+    // the last range that starts at the address or before it:
+    auto itr = std::upper_bound(ranges.begin(), ranges.end(), va, [](offset_t a, const ElfAddressRange &range) {
+        return a < range.start;
+    });
+    if (itr == ranges.begin()) return NOT_FOUND;
+    --itr;
+
+    if (va - itr->start >= itr->size) return NOT_FOUND;
+    return static_cast<size_t>(itr - ranges.begin());
+}
+
+void ElfAddressIndex::find(const std::vector<offset_t> &addresses, std::vector<size_t> &results) const
+{
+    results.assign(addresses.size(), size_t(NOT_FOUND));
+    if (ranges.empty()) return;
+
+    std::vector<size_t> order(addresses.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&addresses](size_t a, size_t b) {
+        return addresses[a] < addresses[b];
+    });
+
+    // both are sorted: the range only moves forward
+    size_t rangeIdx = 0;
+    for (size_t queryIdx : order) {
+        const offset_t va = addresses[queryIdx];
+        while (rangeIdx + 1 < ranges.size() && ranges[rangeIdx + 1].start <= va) {
+            rangeIdx++;
+        }
+        const ElfAddressRange &range = ranges[rangeIdx];
+        if (va >= range.start && va - range.start < range.size) {
+            results[queryIdx] = rangeIdx;
+        }
+    }
+}
+
+//---
+
+ElfFunctionIndex::ElfFunctionIndex(ELFFile *elf)
+{
+    if (!elf) return;
+
+    loadEhFrameHdr(elf);
+    loadDebugAranges(elf);
+}
+
+void ElfFunctionIndex::loadEhFrameHdr(ELFFile *elf)
+{
+    ElfEhFrameHdrWrapper *ehFrameHdr = elf->getEhFrameHdr();
+    if (!ehFrameHdr) return;
+
+    const size_t count = ehFrameHdr->getEntriesCount();
+    std::vector<ElfAddressRange> ranges;
+    ranges.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        offset_t startVA = 0, fdeVA = 0;
+        if (!ehFrameHdr->getEntry(i, startVA, fdeVA)) break;
+        ranges.push_back({ startVA, ehFrameHdr->getFunctionSize(fdeVA), fdeVA });
+    }
+
+    // the FDE could not be read: the function is assumed to span till the next one
+    std::sort(ranges.begin(), ranges.end(), [](const ElfAddressRange &a, const ElfAddressRange &b) {
+        return a.start < b.start;
+    });
+    for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+        if (ranges[i].size == 0) ranges[i].size = static_cast<bufsize_t>(ranges[i + 1].start - ranges[i].start);
+    }
+    functions.assign(std::move(ranges));
+}
+
+void ElfFunctionIndex::loadDebugAranges(ELFFile *elf)
+{
+    const int sectionIdx = elf->elfFindSection(".debug_aranges");
+    if (sectionIdx < 0) return;
+
+    offset_t raw = INVALID_ADDR;
+    bufsize_t size = 0;
+    elf->withView([&](const auto &view) {
+        const auto &shdr = view.sectionHeaders()[sectionIdx];
+        if (shdr.sh_type == SHT_NOBITS) return;
+        raw = static_cast<offset_t>(shdr.sh_offset);
+        size = static_cast<bufsize_t>(shdr.sh_size);
+    });
+    if (raw == INVALID_ADDR || raw >= elf->getRawSize()) return;
+    size = std::min<bufsize_t>(size, elf->getRawSize() - raw);
+
+    const BYTE *section = elf->getContentAt(raw, size);
+    if (!section) return;
+
+    std::vector<ElfAddressRange> ranges;
+
+    // the sets of the ranges, one per compile unit
+    uint64_t unitOffset = 0;
+    while (unitOffset + sizeof(uint32_t) <= size) {
+        const BYTE *unit = section + unitOffset;
+
+        uint32_t length32 = 0;
+        memcpy(&length32, unit, sizeof(uint32_t));
+        const bool isDwarf64 = (length32 == 0xFFFFFFFF);
+        const uint64_t lengthSize = isDwarf64 ? 12 : 4;
+
+        uint64_t length = length32;
+        if (isDwarf64) {
+            if (unitOffset + lengthSize > size) break;
+            memcpy(&length, unit + sizeof(uint32_t), sizeof(uint64_t));
+        }
+        if (length == 0 || length > size - unitOffset - lengthSize) break;
+        const uint64_t unitEnd = lengthSize + length; // relative to the unit
+
+        // version (2), debug_info_offset, address_size, segment_selector_size
+        const uint64_t infoOffsetSize = isDwarf64 ? sizeof(uint64_t) : sizeof(uint32_t);
+        const uint64_t headerSize = lengthSize + sizeof(uint16_t) + infoOffsetSize + 2;
+        if (headerSize > unitEnd) break;
+
+        uint64_t infoOffset = 0;
+        memcpy(&infoOffset, unit + lengthSize + sizeof(uint16_t), static_cast<size_t>(infoOffsetSize));
+        const uint8_t addressSize = unit[headerSize - 2];
+        const uint8_t segmentSize = unit[headerSize - 1];
+
+        if ((addressSize == 4 || addressSize == 8) && segmentSize == 0) {
+            // the tuples are aligned to their size, from the start of the unit
+            const uint64_t tupleSize = 2 * addressSize;
+            uint64_t tupleOffset = ((headerSize + tupleSize - 1) / tupleSize) * tupleSize;
+
+            for (; tupleOffset + tupleSize <= unitEnd; tupleOffset += tupleSize) {
+                uint64_t start = 0, rangeSize = 0;
+                memcpy(&start, unit + tupleOffset, addressSize);
+                memcpy(&rangeSize, unit + tupleOffset + addressSize, addressSize);
+                if (start == 0 && rangeSize == 0) break; // the terminator
+
+                if (rangeSize) ranges.push_back({ static_cast<offset_t>(start), static_cast<bufsize_t>(rangeSize), static_cast<offset_t>(infoOffset) });
+            }
+        }
+        unitOffset += unitEnd;
+    }
+    compileUnits.assign(std::move(ranges));
+}
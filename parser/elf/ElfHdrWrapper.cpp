@@ -185,10 +185,25 @@ const std::unordered_map<uint16_t, QString> ElfHdrWrapper::s_machine = {
     {EM_LOONGARCH, "LoongArch"},
 };
 
-bool ElfHdrWrapper::wrap() { 
-        hdr = m_ELF->getEhdrVariant();
-        return std::visit([](auto *ptr){ return ptr != nullptr; }, hdr); 
-    }
+ElfHdrWrapper::ElfHdrWrapper(ELFFile *elfExe)
+        : ELFElementWrapper(elfExe)
+        {
+            qInfo() << "ELF Header Size:" << getSize();
+            if (!wrap()) {
+                qWarning() << "Unknown ELF header type!";
+            } else if (isBit64()) {
+                qInfo() << "ELF64 Header is used.";
+            } else {
+                qInfo() << "ELF32 Header is used.";
+            }
+
+            void *ptr = getPtr();
+            qInfo() << "ELF Header is located at:" << ptr;
+        }
+
+bool ElfHdrWrapper::wrap() {
+    return m_ELF->withView([](const auto &view) { return view.isValid(); });
+}
 
 void* ElfHdrWrapper::getPtr() {
     return m_ELF->getContent();
@@ -199,13 +214,7 @@ void* ElfHdrWrapper::getFieldPtr(size_t fieldId, size_t subField) {
 }
 
 bufsize_t ElfHdrWrapper::getSize() {
-    auto hdr = m_ELF->getEhdrVariant();
-    
-    return std::visit([](auto *ptr) {
-        using T = std::remove_pointer_t<decltype(ptr)>;
-        return sizeof(T);
-    }, hdr);
-
-    // return sizeof(std::remove_pointer_t<decltype(m_ELF->getEhdrVariant())>);
-    // return m_ELF->isBit64() ? sizeof(Elf64_Ehdr) : sizeof(Elf32_Ehdr);
+    return m_ELF->withView([](const auto &view) -> bufsize_t {
+        return sizeof(typename std::decay_t<decltype(view)>::Ehdr);
+    });
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "elf/ElfNoteWrapper.h"
+#include "elf/ELFFile.h"
+
+#include <cstring>
+
+namespace {
+    template <typename Traits>
+    QByteArray readBuildIdFromView(AbstractByteBuffer *buf)
+    {
+        ELFView<Traits> view;
+        view.wrap(buf);
+
+        QByteArray buildId;
+        auto findBuildId = [&buildId](const ElfNote &note) {
+            if (note.type != NT_GNU_BUILD_ID || note.owner != "GNU") return true;
+            buildId = QByteArray(reinterpret_cast<const char*>(note.desc), static_cast<int>(note.descSize));
+            return false;
+        };
+
+        // linked binaries: the notes are in the first pages, covered by PT_NOTE
+        for (const auto &phdr : view.programHeaders()) {
+            if (phdr.p_type != PT_NOTE) continue;
+            ElfNoteWrapper::forEachNote(buf, phdr.p_offset, static_cast<bufsize_t>(phdr.p_filesz), static_cast<bufsize_t>(phdr.p_align), findBuildId);
+            if (!buildId.isEmpty()) return buildId;
+        }
+        // relocatable objects have no segments
+        for (const auto &shdr : view.sectionHeaders()) {
+            if (shdr.sh_type != SHT_NOTE) continue;
+            ElfNoteWrapper::forEachNote(buf, shdr.sh_offset, static_cast<bufsize_t>(shdr.sh_size), static_cast<bufsize_t>(shdr.sh_addralign), findBuildId);
+            if (!buildId.isEmpty()) return buildId;
+        }
+        return buildId;
+    }
+};
+
+QByteArray ElfNoteWrapper::readBuildId(AbstractByteBuffer *buf)
+{
+    const unsigned char *ident = buf ? buf->getContentAt(0, EI_NIDENT) : NULL;
+    if (!ident || memcmp(ident, ELFMAG, SELFMAG) != 0) return QByteArray();
+
+    try {
+        if (ident[EI_CLASS] == ELFCLASS64) return readBuildIdFromView<Elf64Traits>(buf);
+        return readBuildIdFromView<Elf32Traits>(buf);
+    } catch (const ExeException &) {
+        // the headers don't fit in the buffer
+    }
+    return QByteArray();
+}
+
+bool ElfNoteWrapper::decodeAbiTag(const ElfNote &note, ElfAbiTag &tag)
+{
+    if (note.type != NT_GNU_ABI_TAG || note.owner != "GNU" || note.descSize < sizeof(ElfAbiTag)) return false;
+
+    memcpy(&tag, note.desc, sizeof(ElfAbiTag));
+    return true;
+}
+
+size_t ElfNoteWrapper::decodeGnuProperties(const ElfNote &note, bufsize_t propsAlign, std::vector<ElfGnuProperty> &props)
+{
+    if (note.type != NT_GNU_PROPERTY_TYPE_0 || note.owner != "GNU") return 0;
+
+    const size_t initialCount = props.size();
+    const uint64_t alignMask = (propsAlign == 8) ? 7 : 3;
+
+    // pr_type, pr_datasz, and the data, padded to the alignment
+    uint64_t offset = 0;
+    while (offset + 2 * sizeof(uint32_t) <= note.descSize) {
+        const uint32_t *prop = reinterpret_cast<const uint32_t*>(note.desc + offset);
+        const uint64_t dataOffset = offset + 2 * sizeof(uint32_t);
+        if (dataOffset + prop[1] > note.descSize) break;
+
+        props.push_back({ prop[0], prop[1], note.desc + dataOffset });
+        offset = (dataOffset + prop[1] + alignMask) & ~alignMask;
+    }
+    return props.size() - initialCount;
+}
+
+ElfNoteWrapper::ElfNoteWrapper(ELFFile *elfExe, offset_t v_raw, bufsize_t v_size, bufsize_t v_align, const QString &v_name)
+    : ELFElementWrapper(elfExe), raw(v_raw), size(v_size), align(v_align), name(v_name)
+{
+    wrap();
+}
+
+bool ElfNoteWrapper::wrap()
+{
+    notesOffsets.clear();
+
+    const bufsize_t rawSize = m_ELF->getRawSize();
+    if (raw == INVALID_ADDR || raw >= rawSize) {
+        size = 0;
+        return false;
+    }
+    size = std::min<bufsize_t>(size, rawSize - raw);
+
+    forEachNote([this](const ElfNote &note) {
+        notesOffsets.push_back(note.raw - raw);
+        return true;
+    });
+    return notesOffsets.size() > 0;
+}
+
+void* ElfNoteWrapper::getPtr()
+{
+    if (size == 0) return NULL;
+    return m_ELF->getContentAt(raw, size);
+}
+
+bool ElfNoteWrapper::getNote(size_t index, ElfNote &note)
+{
+    if (index >= notesOffsets.size()) return false;
+
+    const offset_t noteOffset = notesOffsets[index];
+    // the notes are validated in wrap(), so the first one visited from its offset is the note
+    return forEachNote(m_ELF, raw + noteOffset, size - static_cast<bufsize_t>(noteOffset), align, [&note](const ElfNote &found) {
+        note = found;
+        return false;
+    }) > 0;
+}
+
+bool ElfNoteWrapper::findNote(uint32_t type, std::string_view owner, ElfNote &note)
+{
+    bool isFound = false;
+    forEachNote([&](const ElfNote &current) {
+        if (current.type != type || current.owner != owner) return true;
+        note = current;
+        isFound = true;
+        return false;
+    });
+    return isFound;
+}
+
+//---
+
+void* ElfNoteWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+
+    ElfNote note;
+    if (!getNote(index, note)) return NULL;
+
+    BYTE *hdr = m_ELF->getContentAt(note.raw, sizeof(Elf32_Nhdr));
+    if (!hdr) return NULL;
+
+    switch (fieldId) {
+        case N_NAMESZ: return hdr + offsetof(Elf32_Nhdr, n_namesz);
+        case N_DESCSZ: return hdr + offsetof(Elf32_Nhdr, n_descsz);
+        case N_TYPE: return hdr + offsetof(Elf32_Nhdr, n_type);
+        case N_NAME: return hdr + sizeof(Elf32_Nhdr);
+        case N_DESC: return const_cast<BYTE*>(note.desc);
+    }
+    return hdr;
+}
+
+bufsize_t ElfNoteWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+
+    ElfNote note;
+    if (!getNote(index, note)) return 0;
+
+    switch (fieldId) {
+        case N_NAMESZ: case N_DESCSZ: case N_TYPE:
+            return sizeof(uint32_t);
+        case N_NAME: {
+            const uint32_t *nameSize = reinterpret_cast<const uint32_t*>(getFieldPtr(N_NAMESZ, index));
+            return nameSize ? *nameSize : 0;
+        }
+        case N_DESC: return note.descSize;
+    }
+    return sizeof(Elf32_Nhdr);
+}
+
+QString ElfNoteWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case N_NAMESZ: return "Name size";
+        case N_DESCSZ: return "Descriptor size";
+        case N_TYPE: return "Type";
+        case N_NAME: return "Owner";
+        case N_DESC: return "Descriptor";
+    }
+    return getName();
+}
@@ -2,7 +2,7 @@
 #include "elf/ELFFile.h"
 
 ElfProgHdrWrapper::ElfProgHdrWrapper(ELFFile *elfExe) 
-        : ELFElementWrapper(elfExe), phdrs {}
+        : ELFElementWrapper(elfExe)
         {
             wrap();
             qInfo() << "Program Headers Entry Size:" << getEntrySize();
@@ -13,10 +13,7 @@ ElfProgHdrWrapper::ElfProgHdrWrapper(ELFFile *elfExe)
         }
 
 bool ElfProgHdrWrapper::wrap() {
-    // phdrs = m_ELF->getPhdrsVariant();
-    // return std::visit([](auto *ptr){ return ptr != nullptr; }, phdrs);
-    phdrs = m_ELF->getProgramHeaders();
-    return phdrs.size() > 0;
+    return m_ELF->withView([](const auto &view) { return !view.programHeaders().empty(); });
 }
 
 void *ElfProgHdrWrapper::getPtr() {
@@ -24,11 +21,10 @@ void *ElfProgHdrWrapper::getPtr() {
 }
 
 bufsize_t ElfProgHdrWrapper::getEntrySize() {
-    if (phdrs.isEmpty()) return 0;
-    return std::visit([](auto *ptr) {
-        using T = std::remove_pointer_t<decltype(ptr)>;
-        return sizeof(T);
-    }, phdrs[0]);
+    return m_ELF->withView([](const auto &view) -> bufsize_t {
+        if (view.programHeaders().empty()) return 0;
+        return sizeof(typename std::decay_t<decltype(view)>::Phdr);
+    });
 }
 
 bufsize_t ElfProgHdrWrapper::getSize() {
@@ -0,0 +1,250 @@
+#include "elf/ElfRelocWrapper.h"
+#include "elf/ELFFile.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    inline unsigned int lowestBitIndex(uint64_t bits)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_WIN64)
+        unsigned long index = 0;
+        _BitScanForward64(&index, bits);
+        return static_cast<unsigned int>(index);
+#else
+        unsigned int index = 0;
+        for (; !(bits & 1); bits >>= 1) index++;
+        return index;
+#endif
+    }
+};
+
+uint32_t ElfRelocWrapper::relativeType(uint16_t machine)
+{
+    switch (machine) {
+        case EM_386: return R_386_RELATIVE;
+        case EM_X86_64: return R_X86_64_RELATIVE;
+        case EM_ARM: return R_ARM_RELATIVE;
+        case EM_AARCH64: return R_AARCH64_RELATIVE;
+        case EM_RISCV: return R_RISCV_RELATIVE;
+        case EM_PPC: return R_PPC_RELATIVE;
+        case EM_PPC64: return R_PPC64_RELATIVE;
+    }
+    return 0;
+}
+
+ElfRelocWrapper::ElfRelocWrapper(ELFFile *elfExe, reloc_format v_format, offset_t v_raw, bufsize_t v_size, const QString &v_name)
+    : ELFElementWrapper(elfExe), format(v_format), raw(v_raw), size(v_size), name(v_name),
+      entrySize(0), entriesCount(0), appliedBase(INVALID_ADDR)
+{
+    wrap();
+}
+
+bool ElfRelocWrapper::wrap()
+{
+    entrySize = m_ELF->withView([this](const auto &view) -> bufsize_t {
+        using Traits = typename std::decay_t<decltype(view)>::ElfTraits;
+        switch (format) {
+            case RELOC_REL: return sizeof(typename Traits::Rel);
+            case RELOC_RELA: return sizeof(typename Traits::Rela);
+            case RELOC_RELR: return sizeof(typename Traits::Word);
+        }
+        return 0;
+    });
+    entriesCount = 0;
+    if (entrySize == 0) return false;
+
+    const bufsize_t rawSize = m_ELF->getRawSize();
+    if (raw == INVALID_ADDR || raw >= rawSize) return false;
+
+    entriesCount = std::min<bufsize_t>(size, rawSize - raw) / entrySize;
+    return entriesCount > 0;
+}
+
+void* ElfRelocWrapper::getPtr()
+{
+    if (entriesCount == 0) return NULL;
+    return m_ELF->getContentAt(raw, getSize());
+}
+
+bool ElfRelocWrapper::getRelocation(size_t index, ElfRelocation &reloc)
+{
+    if (format == RELOC_RELR || index >= entriesCount) return false;
+
+    const BYTE *ptr = m_ELF->getContentAt(raw + index * entrySize, entrySize);
+    if (!ptr) return false;
+
+    reloc.hasAddend = (format == RELOC_RELA);
+    reloc.addend = 0;
+    m_ELF->withView([&](const auto &view) {
+        using Traits = typename std::decay_t<decltype(view)>::ElfTraits;
+
+        const typename Traits::Rela *rel = reinterpret_cast<const typename Traits::Rela*>(ptr); // Rel is its prefix
+        reloc.offset = static_cast<offset_t>(rel->r_offset);
+        reloc.type = Traits::relocType(rel->r_info);
+        reloc.symbol = Traits::relocSymbol(rel->r_info);
+        if (reloc.hasAddend) reloc.addend = static_cast<int64_t>(rel->r_addend);
+    });
+    return true;
+}
+
+template <typename Func>
+void ElfRelocWrapper::forEachRelr(Func func)
+{
+    void *ptr = getPtr();
+    if (!ptr) return;
+
+    m_ELF->withView([&](const auto &view) {
+        using WordT = typename std::decay_t<decltype(view)>::ElfTraits::Word;
+
+        const WordT *words = static_cast<const WordT*>(ptr);
+        const unsigned int wordBits = static_cast<unsigned int>(sizeof(WordT) * 8);
+        offset_t where = 0;
+
+        for (size_t i = 0; i < entriesCount; ++i) {
+            const WordT word = words[i];
+
+            if ((word & 1) == 0) {
+                // an address: relocates the word at it, the bitmaps that follow are relative to the next one
+                func(static_cast<offset_t>(word));
+                where = static_cast<offset_t>(word) + sizeof(WordT);
+                continue;
+            }
+            // a bitmap: bit N (N >= 1) relocates the word at where + (N - 1) * wordSize;
+            // only the set bits are visited
+            for (uint64_t bits = word >> 1; bits; bits &= bits - 1) {
+                func(where + offset_t(lowestBitIndex(bits)) * sizeof(WordT));
+            }
+            where += offset_t(wordBits - 1) * sizeof(WordT);
+        }
+    });
+}
+
+size_t ElfRelocWrapper::getRelocations(std::vector<ElfRelocation> &relocs)
+{
+    const size_t initialCount = relocs.size();
+
+    if (format == RELOC_RELR) {
+        const uint32_t type = relativeType(m_ELF->elfMachine());
+        forEachRelr([&](offset_t va) {
+            relocs.push_back({ va, type, 0, 0, false });
+        });
+        return relocs.size() - initialCount;
+    }
+
+    relocs.reserve(initialCount + entriesCount);
+    for (size_t i = 0; i < entriesCount; ++i) {
+        ElfRelocation reloc;
+        if (!getRelocation(i, reloc)) break;
+        relocs.push_back(reloc);
+    }
+    return relocs.size() - initialCount;
+}
+
+bool ElfRelocWrapper::applyRelative(offset_t va, const int64_t *addend, uint64_t delta)
+{
+    const offset_t target = m_ELF->convertAddr(va, Executable::VA, Executable::RAW);
+    if (target == INVALID_ADDR) return false; // i.e. not backed by the file
+
+    const bufsize_t wordSize = getWordSize();
+
+    // RELA: the addend is in the entry, REL and RELR: the addend is the current content
+    uint64_t value = 0;
+    if (addend) {
+        value = static_cast<uint64_t>(*addend);
+    } else {
+        bool isOk = false;
+        value = m_ELF->getNumValue(target, wordSize, &isOk);
+        if (!isOk) return false;
+    }
+    return m_ELF->setNumValue(target, wordSize, value + delta);
+}
+
+size_t ElfRelocWrapper::applyRelocations(offset_t newBase)
+{
+    const uint32_t relType = relativeType(m_ELF->elfMachine());
+    if (relType == 0) {
+        Logger::append(Logger::D_WARNING, "Relative relocations are not supported for this machine");
+        return 0;
+    }
+    // RELA: the value is computed from the addend, so from the link-time base;
+    // REL and RELR: the content already holds the previously applied base, only the difference is added
+    const offset_t linkBase = m_ELF->getImageBase();
+    const offset_t currentBase = (format == RELOC_RELA || appliedBase == INVALID_ADDR) ? linkBase : appliedBase;
+    const uint64_t delta = static_cast<uint64_t>(newBase - currentBase);
+    appliedBase = newBase;
+
+    size_t applied = 0;
+    if (format == RELOC_RELR) {
+        forEachRelr([&](offset_t va) {
+            if (applyRelative(va, NULL, delta)) applied++;
+        });
+        return applied;
+    }
+
+    for (size_t i = 0; i < entriesCount; ++i) {
+        ElfRelocation reloc;
+        if (!getRelocation(i, reloc)) break;
+        if (reloc.type != relType || reloc.symbol != 0) continue;
+
+        if (applyRelative(reloc.offset, reloc.hasAddend ? &reloc.addend : NULL, delta)) applied++;
+    }
+    return applied;
+}
+
+//---
+
+bufsize_t ElfRelocWrapper::getWordSize()
+{
+    return m_ELF->withView([](const auto &view) -> bufsize_t {
+        return sizeof(typename std::decay_t<decltype(view)>::ElfTraits::Word);
+    });
+}
+
+size_t ElfRelocWrapper::getFieldsCount()
+{
+    switch (format) {
+        case RELOC_REL: return R_ADDEND;
+        case RELOC_RELA: return FIELD_COUNTER;
+        case RELOC_RELR: return R_INFO;
+    }
+    return 0;
+}
+
+void* ElfRelocWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+    if (index >= entriesCount || fieldId >= getFieldsCount()) return NULL;
+
+    BYTE *ptr = m_ELF->getContentAt(raw + index * entrySize, entrySize);
+    if (!ptr) return NULL;
+
+    const bufsize_t wordSize = getWordSize();
+    return ptr + fieldId * wordSize;
+}
+
+bufsize_t ElfRelocWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    if (fieldId >= getFieldsCount()) return entrySize;
+    return getWordSize();
+}
+
+QString ElfRelocWrapper::getFieldName(size_t fieldId)
+{
+    if (format == RELOC_RELR && fieldId == R_OFFSET) return "Address/Bitmap";
+    switch (fieldId) {
+        case R_OFFSET: return "Offset";
+        case R_INFO: return "Info";
+        case R_ADDEND: return "Addend";
+    }
+    return getName();
+}
+
+Executable::addr_type ElfRelocWrapper::containsAddrType(size_t fieldId, size_t subField)
+{
+    if (format != RELOC_RELR && fieldId == R_OFFSET) return Executable::VA;
+    return Executable::NOT_ADDR;
+}
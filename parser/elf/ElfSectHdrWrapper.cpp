@@ -2,7 +2,7 @@
 #include "elf/ELFFile.h"
 
 ElfSectHdrWrapper::ElfSectHdrWrapper(ELFFile *elfExe)
-    : ELFElementWrapper(elfExe), shdrs {} 
+    : ELFElementWrapper(elfExe) 
     {
         wrap();
         qInfo() << "Section Headers Entry Size:" << getEntrySize();
@@ -13,10 +13,7 @@ ElfSectHdrWrapper::ElfSectHdrWrapper(ELFFile *elfExe)
     } 
 
 bool ElfSectHdrWrapper::wrap() {
-    // shdrs = m_ELF->getShdrsVariant();
-    // return std::visit([](auto *ptr){ return ptr != nullptr; }, shdrs);
-    shdrs = m_ELF->getSectionHeaders();
-    return shdrs.size() > 0;
+    return m_ELF->withView([](const auto &view) { return !view.sectionHeaders().empty(); });
 }
 
 void *ElfSectHdrWrapper::getPtr() {
@@ -24,11 +21,10 @@ void *ElfSectHdrWrapper::getPtr() {
 }
 
 bufsize_t ElfSectHdrWrapper::getEntrySize() {
-    if (shdrs.isEmpty()) return 0;
-    return std::visit([](auto *ptr) {
-        using T = std::remove_pointer_t<decltype(ptr)>;
-        return sizeof(T);
-    }, shdrs[0]);
+    return m_ELF->withView([](const auto &view) -> bufsize_t {
+        if (view.sectionHeaders().empty()) return 0;
+        return sizeof(typename std::decay_t<decltype(view)>::Shdr);
+    });
 }
 
 bufsize_t ElfSectHdrWrapper::getSize() {
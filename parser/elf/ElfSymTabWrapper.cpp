@@ -0,0 +1,440 @@
+#include "elf/ElfSymTabWrapper.h"
+#include "elf/ELFFile.h"
+
+ElfSymTabWrapper::ElfSymTabWrapper(ELFFile *elfExe, uint32_t v_tableType)
+    : ELFElementWrapper(elfExe), tableType(v_tableType),
+      symbolsRaw(INVALID_ADDR), symbolsCount(0), entrySize(0),
+      hashType(HASH_NONE), hashRaw(INVALID_ADDR), bucketsCount(0), symOffset(0), hashedEnd(0), bloomSize(0), bloomShift(0),
+      bloomRaw(INVALID_ADDR), bucketsRaw(INVALID_ADDR), chainsRaw(INVALID_ADDR),
+      namesIndexValid(false)
+{
+    wrap();
+}
+
+bool ElfSymTabWrapper::wrap()
+{
+    symbolsRaw = INVALID_ADDR;
+    symbolsCount = 0;
+    strings = ElfStringTable();
+    hashType = HASH_NONE;
+    namesIndex.clear();
+    namesIndexValid = false;
+
+    entrySize = isBit64() ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym);
+
+    bool isOk = wrapFromSections();
+    if (!isOk && tableType == SHT_DYNSYM) {
+        isOk = wrapFromDynamic();
+    }
+    if (!isOk) {
+        symbolsCount = 0;
+        return false;
+    }
+
+    // clamp the table to the file content (the strings are clamped by ElfStringTable):
+    const bufsize_t rawSize = m_ELF->getRawSize();
+    if (symbolsRaw >= rawSize) {
+        symbolsCount = 0;
+    } else {
+        symbolsCount = std::min<size_t>(symbolsCount, (rawSize - symbolsRaw) / entrySize);
+    }
+    return symbolsCount > 0;
+}
+
+bool ElfSymTabWrapper::wrapFromSections()
+{
+    int tableIndex = -1;
+    uint32_t stringsIndex = SHN_UNDEF;
+    offset_t gnuHashRaw = INVALID_ADDR;
+    offset_t sysvHashRaw = INVALID_ADDR;
+
+    const bool isFound = m_ELF->withView([&](const auto &view) -> bool {
+        const auto &shdrs = view.sectionHeaders();
+
+        for (size_t i = 0; i < shdrs.size(); ++i) {
+            if (shdrs[i].sh_type != tableType) continue;
+
+            tableIndex = static_cast<int>(i);
+            symbolsRaw = static_cast<offset_t>(shdrs[i].sh_offset);
+            symbolsCount = static_cast<size_t>(shdrs[i].sh_size / entrySize);
+            stringsIndex = shdrs[i].sh_link;
+            break;
+        }
+        if (tableIndex == -1) return false;
+        if (stringsIndex == SHN_UNDEF || stringsIndex >= shdrs.size()) return false;
+
+        if (tableType != SHT_DYNSYM) return true;
+
+        // find the hash table that refers to this symbol table, GNU hash preferred:
+        for (const auto &shdr : shdrs) {
+            if (shdr.sh_link != static_cast<uint32_t>(tableIndex)) continue;
+
+            if (shdr.sh_type == SHT_GNU_HASH) gnuHashRaw = static_cast<offset_t>(shdr.sh_offset);
+            else if (shdr.sh_type == SHT_HASH) sysvHashRaw = static_cast<offset_t>(shdr.sh_offset);
+        }
+        return true;
+    });
+    if (!isFound) return false;
+
+    strings = m_ELF->elfSectionStrings(static_cast<int>(stringsIndex));
+
+    if (gnuHashRaw != INVALID_ADDR && wrapGnuHash(gnuHashRaw)) return true;
+    if (sysvHashRaw != INVALID_ADDR) wrapSysvHash(sysvHashRaw);
+    return true;
+}
+
+bool ElfSymTabWrapper::wrapFromDynamic()
+{
+    uint64_t symtabVA = 0, strtabVA = 0, strSize = 0, hashVA = 0;
+    if (!m_ELF->elfDynamicValue(DT_SYMTAB, symtabVA) || !m_ELF->elfDynamicValue(DT_STRTAB, strtabVA)) {
+        return false;
+    }
+    m_ELF->elfDynamicValue(DT_STRSZ, strSize);
+
+    symbolsRaw = m_ELF->convertAddr(symtabVA, Executable::VA, Executable::RAW);
+    strings = ElfStringTable(m_ELF, m_ELF->convertAddr(strtabVA, Executable::VA, Executable::RAW), static_cast<bufsize_t>(strSize));
+    if (symbolsRaw == INVALID_ADDR || !strings.isValid()) return false;
+
+    // without the section headers, the number of symbols is known only from the hash table
+    if (m_ELF->elfDynamicValue(DT_GNU_HASH, hashVA)
+        && wrapGnuHash(m_ELF->convertAddr(hashVA, Executable::VA, Executable::RAW)))
+    {
+        return true;
+    }
+    if (m_ELF->elfDynamicValue(DT_HASH, hashVA)
+        && wrapSysvHash(m_ELF->convertAddr(hashVA, Executable::VA, Executable::RAW)))
+    {
+        return true;
+    }
+    return false;
+}
+
+bool ElfSymTabWrapper::wrapGnuHash(offset_t raw)
+{
+    // header: nbuckets, symoffset, bloom_size, bloom_shift
+    const uint32_t *hdr = getWords(raw, 4);
+    if (!hdr || hdr[0] == 0) return false;
+
+    const bufsize_t bloomWordSize = isBit64() ? sizeof(uint64_t) : sizeof(uint32_t);
+
+    bucketsCount = hdr[0];
+    symOffset = hdr[1];
+    bloomSize = hdr[2];
+    bloomShift = hdr[3];
+    bloomRaw = raw + 4 * sizeof(uint32_t);
+    bucketsRaw = bloomRaw + bufsize_t(bloomSize) * bloomWordSize;
+    chainsRaw = bucketsRaw + bufsize_t(bucketsCount) * sizeof(uint32_t);
+
+    const uint32_t *buckets = getWords(bucketsRaw, bucketsCount);
+    if (!buckets) return false;
+
+    // the symbols count: the end of the longest chain
+    uint32_t maxSym = 0;
+    for (uint32_t i = 0; i < bucketsCount; ++i) {
+        maxSym = std::max(maxSym, buckets[i]);
+    }
+    size_t count = symOffset;
+    if (maxSym >= symOffset) {
+        const bufsize_t rawSize = m_ELF->getRawSize();
+        for (size_t sym = maxSym; ; ++sym) {
+            const offset_t chainRaw = chainsRaw + (sym - symOffset) * sizeof(uint32_t);
+            if (chainRaw + sizeof(uint32_t) > rawSize) return false;
+
+            const uint32_t *chain = getWords(chainRaw, 1);
+            if (!chain) return false;
+            if (*chain & 1) {
+                count = sym + 1;
+                break;
+            }
+        }
+    }
+    if (symbolsCount == 0) {
+        symbolsCount = count;
+    }
+    hashedEnd = count;
+    hashRaw = raw;
+    hashType = HASH_GNU;
+    return true;
+}
+
+bool ElfSymTabWrapper::wrapSysvHash(offset_t raw)
+{
+    // header: nbucket, nchain
+    const uint32_t *hdr = getWords(raw, 2);
+    if (!hdr || hdr[0] == 0) return false;
+
+    bucketsCount = hdr[0];
+    bucketsRaw = raw + 2 * sizeof(uint32_t);
+    chainsRaw = bucketsRaw + bufsize_t(bucketsCount) * sizeof(uint32_t);
+    if (!getWords(bucketsRaw, bucketsCount) || !getWords(chainsRaw, hdr[1])) return false;
+
+    // nchain is equal to the number of symbols
+    if (symbolsCount == 0) {
+        symbolsCount = hdr[1];
+    }
+    hashRaw = raw;
+    hashType = HASH_SYSV;
+    return true;
+}
+
+//---
+
+uint32_t ElfSymTabWrapper::sysvHash(const char *name)
+{
+    uint32_t h = 0;
+    for (const BYTE *c = reinterpret_cast<const BYTE*>(name); *c; ++c) {
+        h = (h << 4) + *c;
+        const uint32_t g = h & 0xf0000000;
+        if (g) h ^= g >> 24;
+        h &= ~g;
+    }
+    return h;
+}
+
+uint32_t ElfSymTabWrapper::gnuHash(const char *name)
+{
+    uint32_t h = 5381;
+    for (const BYTE *c = reinterpret_cast<const BYTE*>(name); *c; ++c) {
+        h = (h << 5) + h + *c;
+    }
+    return h;
+}
+
+size_t ElfSymTabWrapper::findSymbol(const char *name)
+{
+    if (!name || !*name || symbolsCount == 0) return SYMBOL_NOT_FOUND;
+
+    if (hashType == HASH_GNU) {
+        const size_t found = findInGnuHash(name);
+        if (found != SYMBOL_NOT_FOUND) return found;
+
+        // the undefined symbols (imports) are not hashed: they are kept below symoffset or past the last chain
+        return findInIndex(name);
+    }
+    if (hashType == HASH_SYSV) {
+        return findInSysvHash(name);
+    }
+    return findInIndex(name);
+}
+
+size_t ElfSymTabWrapper::findInGnuHash(const char *name)
+{
+    const uint32_t h = gnuHash(name);
+
+    // Bloom filter: rejects most of the missing names without touching the buckets
+    if (bloomSize) {
+        const uint32_t bits = isBit64() ? 64 : 32;
+        const offset_t wordRaw = bloomRaw + offset_t((h / bits) % bloomSize) * (bits / 8);
+        const uint64_t mask = (uint64_t(1) << (h % bits)) | (uint64_t(1) << ((h >> bloomShift) % bits));
+
+        const BYTE *wordPtr = m_ELF->getContentAt(wordRaw, bits / 8);
+        if (!wordPtr) return SYMBOL_NOT_FOUND;
+        const uint64_t word = isBit64() ? *reinterpret_cast<const uint64_t*>(wordPtr) : *reinterpret_cast<const uint32_t*>(wordPtr);
+        if ((word & mask) != mask) return SYMBOL_NOT_FOUND;
+    }
+
+    const uint32_t *bucket = getWords(bucketsRaw + offset_t(h % bucketsCount) * sizeof(uint32_t), 1);
+    if (!bucket || *bucket < symOffset) return SYMBOL_NOT_FOUND;
+
+    for (size_t sym = *bucket; sym < symbolsCount; ++sym) {
+        const uint32_t *chain = getWords(chainsRaw + (sym - symOffset) * sizeof(uint32_t), 1);
+        if (!chain) break;
+
+        // the lowest bit marks the end of the chain, the rest is the hash
+        if ((*chain | 1) == (h | 1) && nameEquals(sym, name)) {
+            return sym;
+        }
+        if (*chain & 1) break;
+    }
+    return SYMBOL_NOT_FOUND;
+}
+
+size_t ElfSymTabWrapper::findInSysvHash(const char *name)
+{
+    const uint32_t h = sysvHash(name);
+
+    const uint32_t *bucket = getWords(bucketsRaw + offset_t(h % bucketsCount) * sizeof(uint32_t), 1);
+    if (!bucket) return SYMBOL_NOT_FOUND;
+
+    // the chain can't be longer than the table: protects from loops in malformed files
+    size_t sym = *bucket;
+    for (size_t steps = 0; sym != STN_UNDEF && sym < symbolsCount && steps < symbolsCount; ++steps) {
+        if (nameEquals(sym, name)) return sym;
+
+        const uint32_t *chain = getWords(chainsRaw + sym * sizeof(uint32_t), 1);
+        if (!chain) break;
+        sym = *chain;
+    }
+    return SYMBOL_NOT_FOUND;
+}
+
+size_t ElfSymTabWrapper::findInIndex(const char *name)
+{
+    if (!namesIndexValid) {
+        namesIndex.clear();
+        namesIndex.reserve(symbolsCount);
+
+        for (size_t i = 1; i < symbolsCount; ++i) {
+            // with the GNU hash: only the symbols that it does not cover
+            if (hashType == HASH_GNU && i >= symOffset && i < hashedEnd) {
+                i = hashedEnd - 1;
+                continue;
+            }
+            const std::string_view symName = getSymbolNameView(i);
+            if (symName.empty()) continue;
+
+            // keep the first definition; a definition overrides an undefined reference
+            auto itr = namesIndex.find(symName);
+            if (itr == namesIndex.end()) {
+                namesIndex[symName] = i;
+            } else if (getSymbolSection(itr->second) == SHN_UNDEF && getSymbolSection(i) != SHN_UNDEF) {
+                itr->second = i;
+            }
+        }
+        namesIndexValid = true;
+    }
+    auto itr = namesIndex.find(std::string_view(name));
+    if (itr == namesIndex.end()) return SYMBOL_NOT_FOUND;
+    return itr->second;
+}
+
+//---
+
+const uint32_t* ElfSymTabWrapper::getWords(offset_t raw, size_t count)
+{
+    if (raw == INVALID_ADDR) return NULL;
+    return reinterpret_cast<const uint32_t*>(m_ELF->getContentAt(raw, count * sizeof(uint32_t)));
+}
+
+BYTE* ElfSymTabWrapper::getSymbolPtr(size_t index)
+{
+    if (index >= symbolsCount) return NULL;
+    return m_ELF->getContentAt(symbolsRaw + index * entrySize, entrySize);
+}
+
+template <typename Func>
+auto ElfSymTabWrapper::withSymbol(size_t index, Func func)
+{
+    BYTE *ptr = getSymbolPtr(index);
+    return m_ELF->withView([&](const auto &view) {
+        using SymT = typename std::decay_t<decltype(view)>::ElfTraits::Sym;
+        return func(reinterpret_cast<SymT*>(ptr));
+    });
+}
+
+std::string_view ElfSymTabWrapper::getSymbolNameView(size_t index)
+{
+    return withSymbol(index, [this](auto symPtr) {
+        return symPtr ? strings.getString(symPtr->st_name) : std::string_view();
+    });
+}
+
+bool ElfSymTabWrapper::nameEquals(size_t index, const char *name)
+{
+    return getSymbolNameView(index) == std::string_view(name);
+}
+
+QString ElfSymTabWrapper::getSymbolName(size_t index)
+{
+    const std::string_view name = getSymbolNameView(index);
+    return QString::fromUtf8(name.data(), static_cast<int>(name.size()));
+}
+
+offset_t ElfSymTabWrapper::getSymbolValue(size_t index)
+{
+    return withSymbol(index, [](auto symPtr) -> offset_t {
+        return symPtr ? static_cast<offset_t>(symPtr->st_value) : INVALID_ADDR;
+    });
+}
+
+bufsize_t ElfSymTabWrapper::getSymbolSize(size_t index)
+{
+    return withSymbol(index, [](auto symPtr) -> bufsize_t {
+        return symPtr ? static_cast<bufsize_t>(symPtr->st_size) : 0;
+    });
+}
+
+uint8_t ElfSymTabWrapper::getSymbolType(size_t index)
+{
+    return withSymbol(index, [](auto symPtr) -> uint8_t {
+        return symPtr ? ELF64_ST_TYPE(symPtr->st_info) : STT_NOTYPE;
+    });
+}
+
+uint8_t ElfSymTabWrapper::getSymbolBinding(size_t index)
+{
+    return withSymbol(index, [](auto symPtr) -> uint8_t {
+        return symPtr ? ELF64_ST_BIND(symPtr->st_info) : STB_LOCAL;
+    });
+}
+
+uint16_t ElfSymTabWrapper::getSymbolSection(size_t index)
+{
+    return withSymbol(index, [](auto symPtr) -> uint16_t {
+        return symPtr ? symPtr->st_shndx : SHN_UNDEF;
+    });
+}
+
+//---
+
+void* ElfSymTabWrapper::getPtr()
+{
+    if (symbolsCount == 0) return NULL;
+    return m_ELF->getContentAt(symbolsRaw, getSize());
+}
+
+bufsize_t ElfSymTabWrapper::getSize()
+{
+    return static_cast<bufsize_t>(symbolsCount * entrySize);
+}
+
+void* ElfSymTabWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+
+    return withSymbol(index, [fieldId](auto symPtr) -> void* {
+        if (!symPtr) return NULL;
+        switch (fieldId) {
+            case ST_NAME: return &symPtr->st_name;
+            case ST_INFO: return &symPtr->st_info;
+            case ST_OTHER: return &symPtr->st_other;
+            case ST_SHNDX: return &symPtr->st_shndx;
+            case ST_VALUE: return &symPtr->st_value;
+            case ST_SIZE: return &symPtr->st_size;
+        }
+        return symPtr;
+    });
+}
+
+bufsize_t ElfSymTabWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    const bool is64 = isBit64();
+    switch (fieldId) {
+        case ST_NAME: return sizeof(uint32_t);
+        case ST_INFO: return sizeof(uint8_t);
+        case ST_OTHER: return sizeof(uint8_t);
+        case ST_SHNDX: return sizeof(uint16_t);
+        case ST_VALUE: return is64 ? sizeof(Elf64_Addr) : sizeof(Elf32_Addr);
+        case ST_SIZE: return is64 ? sizeof(Elf64_Xword) : sizeof(Elf32_Word);
+    }
+    return entrySize;
+}
+
+QString ElfSymTabWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case ST_NAME: return "Name";
+        case ST_INFO: return "Info";
+        case ST_OTHER: return "Other";
+        case ST_SHNDX: return "Section Index";
+        case ST_VALUE: return "Value";
+        case ST_SIZE: return "Size";
+    }
+    return getName();
+}
+
+Executable::addr_type ElfSymTabWrapper::containsAddrType(size_t fieldId, size_t subField)
+{
+    if (fieldId == ST_VALUE) return Executable::VA;
+    return Executable::NOT_ADDR;
+}
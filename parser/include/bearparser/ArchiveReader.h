@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Executable.h"
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class ArchiveException : public CustomException
+{
+public:
+    ArchiveException(const QString info) : CustomException(info) {}
+};
+
+struct ArchiveMember
+{
+    std::string name;       // resolved from the long names table, if needed
+    offset_t headerOffset;  // the offset of the member header: the symbol tables refer to it
+    offset_t dataOffset;
+    bufsize_t size;
+};
+
+struct ArchiveSymbol
+{
+    std::string_view name;  // points into the symbol table of the archive
+    size_t member;          // the index of the member that defines it
+};
+
+/*
+The "ar" archive (static library): GNU/SysV (.a), BSD/Darwin (.a), and COFF (.lib).
+The member headers are read once; each member is exposed as a BufferView on the archive buffer, nothing is copied.
+The executables of the members are built with the first use, by the ExeFactory.
+The symbol index is read from the symbol table of the archive (the linker member), without parsing the members.
+*/
+class ArchiveReader
+{
+public:
+    static const size_t NOT_FOUND = size_t(-1);
+
+    enum archive_format {
+        FORMAT_UNKNOWN = 0,
+        FORMAT_GNU,     // "/" symbol table, "//" long names
+        FORMAT_BSD,     // "#1/<len>" names, "__.SYMDEF" symbol table
+        FORMAT_COFF,    // GNU-like, with the second linker member
+        FORMAT_COUNT
+    };
+
+    static bool isArchive(AbstractByteBuffer *buf);
+
+    ArchiveReader(AbstractByteBuffer *v_buf); //throws ArchiveException
+    virtual ~ArchiveReader();
+
+    AbstractByteBuffer* getBuffer() const { return buf; }
+    archive_format getFormat() const { return format; }
+
+    // the regular members, in the order of the archive (the symbol tables and the long names are not included)
+    size_t getMembersCount() const { return members.size(); }
+    const ArchiveMember& getMemberInfo(size_t index) const { return members.at(index); }
+    BufferView* getMemberBuffer(size_t index) const;
+    size_t findMember(std::string_view name) const; // the first one with the name
+
+    // The executable of the member, built with the first use; NULL if its format is not supported.
+    // Owned by the ArchiveReader; can be called from many threads.
+    Executable* getMember(size_t index);
+
+    // Builds the executables of all the members, in parallel (threads = 0: as many as the CPU cores).
+    // Returns the number of the members that are built.
+    size_t buildMembers(size_t threads = 0);
+
+    // the symbol index, from the symbol table of the archive
+    const std::vector<ArchiveSymbol>& getSymbols() const { return symbols; }
+    size_t findSymbol(std::string_view name) const; // the index of the member that defines it, or NOT_FOUND
+
+protected:
+    // an offset in the symbol table, that points to a member header
+    size_t memberAtHeader(offset_t headerOffset) const;
+
+    void readMembers();
+    bool readGnuSymbols(offset_t raw, bufsize_t size, bool is64);
+    bool readCoffSymbols(offset_t raw, bufsize_t size);
+    bool readBsdSymbols(offset_t raw, bufsize_t size, bool is64);
+    // the NUL-terminated names, one per offset; false if the table is truncated
+    bool readSymbolNames(offset_t raw, bufsize_t size, const std::vector<offset_t> &headerOffsets);
+    void addSymbol(std::string_view name, offset_t headerOffset);
+
+    AbstractByteBuffer *buf;
+    archive_format format;
+
+    std::vector<ArchiveMember> members;
+    std::vector<BufferView*> views;
+    std::vector<Executable*> exes;
+    std::vector<std::once_flag> built;
+
+    std::vector<ArchiveSymbol> symbols;
+    std::unordered_map<std::string_view, size_t> symbolsByName;
+
+private:
+    ArchiveReader(const ArchiveReader&);
+    ArchiveReader& operator=(const ArchiveReader&);
+};
@@ -2,6 +2,9 @@
 
 #include "Executable.h"
 
+#include <unordered_map>
+#include <vector>
+
 class ExeFactoryException : public CustomException
 {
 public:
@@ -12,21 +15,40 @@ public:
 class ExeFactory
 {
 public:
-    enum exe_type {
+    enum exe_type : int {
         NONE = 0,
         PE = 1,
         MZ,
         ELF,
+        MACHO,
         TYPES_COUNT
     };
 
     static void init();
     static void destroy();
 
+    // Registers the builder (the factory takes the ownership) under the given type, replacing the previous one.
+    // With the type NONE, a new type is allocated. Returns the type, or NONE on failure.
+    // The builders registered later take precedence over the earlier ones with the same magic.
+    static exe_type registerBuilder(ExeBuilder *builder, exe_type type = NONE);
+
     static exe_type findMatching(AbstractByteBuffer *buf);
     static Executable* build(AbstractByteBuffer *buf, exe_type type);
     static QString getTypeName(exe_type type);
 
 protected:
+    static const size_t MAGIC_MAX = 4;
+
+    // the magic (up to 4 bytes, little endian) with its length in the top bits
+    static uint64_t magicKey(const BYTE *magic, size_t length);
+    static exe_type addBuilder(ExeBuilder *builder, exe_type type);
+    static void rebuildDispatch();
+
     static std::map<exe_type, ExeBuilder*> builders;
+    static std::vector<exe_type> precedence; // the most recently registered first
+
+    // the first bytes of the file => the candidate types, in the order of the precedence
+    static std::unordered_map<uint64_t, std::vector<exe_type>> byMagic;
+    static std::vector<size_t> magicLengths; // the distinct lengths of the magics, the longest first
+    static std::vector<exe_type> withoutMagic;
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include <map>
+#include <vector>
 #include <QMap>
 
 #include "AbstractByteBuffer.h"
@@ -19,6 +20,10 @@ public:
     virtual bool signatureMatches(AbstractByteBuffer *buf) = 0;
     virtual Executable* build(AbstractByteBuffer *buf) = 0;
     virtual QString typeName() = 0;
+
+    // The magic bytes at the start of the file (1 to 4 bytes each), used by ExeFactory to preselect the builder.
+    // A builder without the magics is checked only if none of the preselected ones matched.
+    virtual std::vector<QByteArray> magics() { return std::vector<QByteArray>(); }
 };
 
 //-------------------------------------------------------------
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "AbstractByteBuffer.h"
+#include <vector>
+
+/*
+Context Triggered Piecewise Hashing, compatible with ssdeep ("blocksize:hash1:hash2").
+All the block sizes are tracked at once, so the content is processed in a single pass.
+*/
+class CtphHasher
+{
+public:
+    static constexpr size_t SPAMSUM_LENGTH = 64;
+
+    // similarity of two digests: 0 (unrelated) to 100 (identical)
+    static int compare(const QString &digest1, const QString &digest2);
+
+    CtphHasher() { reset(); }
+
+    void reset();
+    void update(const BYTE *data, bufsize_t size);
+    QString digest() const;
+
+protected:
+    static constexpr size_t ROLLING_WINDOW = 7;
+    static constexpr size_t NUM_BLOCKHASHES = 31;
+    static constexpr uint32_t MIN_BLOCKSIZE = 3;
+    static constexpr uint32_t HASH_INIT = 0x28021967;
+
+    static uint32_t blockSize(size_t index) { return MIN_BLOCKSIZE << index; }
+
+    struct BlockHash
+    {
+        uint32_t h;
+        uint32_t halfH;
+        char digest[SPAMSUM_LENGTH];
+        char halfDigest;
+        size_t length;
+    };
+
+    inline uint32_t rollHash(BYTE c);
+    void tryForkBlockhash();
+    void tryReduceBlockhash();
+
+    BlockHash blocks[NUM_BLOCKHASHES];
+    size_t bhStart;
+    size_t bhEnd;
+    uint64_t totalSize;
+
+    // rolling hash
+    BYTE window[ROLLING_WINDOW];
+    uint32_t h1, h2, h3, n;
+};
+
+/*
+Locality-sensitive hash built on the histogram of the byte triplets (the TLSH construction:
+sliding window of 5 bytes, 128 buckets, quartile-coded body).
+The digests are not interchangeable with the ones of the reference TLSH library.
+*/
+class TlshHasher
+{
+public:
+    static constexpr bufsize_t MIN_DATA_LENGTH = 50;
+
+    // 0 means identical; the bigger the value, the less similar the content
+    static int distance(const QString &digest1, const QString &digest2);
+
+    TlshHasher() { reset(); }
+
+    void reset();
+    void update(const BYTE *data, bufsize_t size);
+    QString digest() const; // empty if there is too little data or too little variety
+
+protected:
+    static constexpr size_t BUCKETS = 256;
+    static constexpr size_t EFF_BUCKETS = 128;
+    static constexpr size_t WINDOW = 5;
+
+    uint32_t buckets[BUCKETS];
+    BYTE window[WINDOW];
+    BYTE checksum;
+    uint64_t dataLength;
+};
+
+struct FuzzyDigest
+{
+    QString ctph;
+    QString tlsh;
+};
+
+class FuzzyHasher
+{
+public:
+    // both hashes, computed in one pass over the buffer
+    static FuzzyDigest compute(AbstractByteBuffer *buf);
+
+    // hashes the buffers in parallel (each buffer by a single thread); the results are stored at the indexes of the buffers
+    static void computeMany(const std::vector<AbstractByteBuffer*> &bufs, std::vector<FuzzyDigest> &digests, size_t threads = 0);
+
+protected:
+    static constexpr bufsize_t CHUNK_SIZE = 0x10000;
+};
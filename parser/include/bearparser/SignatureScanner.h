@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Executable.h"
+#include <vector>
+
+class PEFile;
+
+/*
+Byte signature in the hex form, i.e. "55 8B EC ?? ?? 6A FF".
+The wildcard "??" matches any byte; a half-byte wildcard ("5?", "?5") is also accepted.
+*/
+class ByteSignature
+{
+public:
+    enum sig_anchor {
+        ANCHOR_NONE = 0,    // can match anywhere in the scanned content
+        ANCHOR_EP,          // must match exactly at the entry point
+        ANCHOR_SECTION,     // must match exactly at the beginning of a section
+        COUNT_ANCHORS
+    };
+
+    // returns false if the pattern is malformed or contains no defined bytes
+    static bool parse(const QString &pattern, std::vector<BYTE> &bytes, std::vector<BYTE> &mask);
+
+    ByteSignature(const QString &v_name, const std::vector<BYTE> &v_bytes, const std::vector<BYTE> &v_mask, sig_anchor v_anchor)
+        : name(v_name), bytes(v_bytes), mask(v_mask), anchor(v_anchor)
+    {
+        findLiteral();
+    }
+
+    QString getName() const { return name; }
+    sig_anchor getAnchor() const { return anchor; }
+    bufsize_t size() const { return static_cast<bufsize_t>(bytes.size()); }
+    QString toString() const;
+
+    bool matchesAt(const BYTE *content, bufsize_t contentSize, offset_t offset) const;
+
+    // the longest run of fully defined bytes: used as the key of the multi-pattern search
+    offset_t getLiteralOffset() const { return literalOffset; }
+    bufsize_t getLiteralSize() const { return literalSize; }
+    const BYTE* getLiteral() const { return bytes.data() + literalOffset; }
+
+protected:
+    void findLiteral();
+
+    QString name;
+    std::vector<BYTE> bytes;
+    std::vector<BYTE> mask;
+    sig_anchor anchor;
+
+    offset_t literalOffset;
+    bufsize_t literalSize;
+};
+
+struct SigMatch
+{
+    SigMatch(size_t v_sigId = 0, offset_t v_offset = INVALID_ADDR)
+        : sigId(v_sigId), offset(v_offset) {}
+
+    bool operator<(const SigMatch &other) const
+    {
+        if (offset != other.offset) return offset < other.offset;
+        return sigId < other.sigId;
+    }
+
+    bool operator==(const SigMatch &other) const
+    {
+        return offset == other.offset && sigId == other.sigId;
+    }
+
+    size_t sigId;
+    offset_t offset; // relative to the beginning of the scanned buffer
+};
+
+/*
+A set of signatures compiled into the Aho-Corasick automaton.
+Only the literal anchor of each signature goes to the automaton, the full pattern
+(with the wildcards) is verified at every candidate.
+The signatures without a fully defined byte (i.e. "5? ?5") have no literal: they are verified at every offset.
+*/
+class SignatureSet
+{
+public:
+    SignatureSet() : isCompiled(false)
+    {
+        for (size_t i = 0; i < 256; i++) rootNext[i] = NO_NODE;
+    }
+
+    // returns the ID of the added signature or -1 if the pattern is invalid
+    int addSignature(const QString &name, const QString &pattern, ByteSignature::sig_anchor anchor = ByteSignature::ANCHOR_NONE);
+
+    // loads the database in the PEiD format ("[name]", "signature = ...", "ep_only = true/false"),
+    // returns the number of the loaded signatures
+    size_t loadPeidDb(const QString &fileName);
+
+    size_t size() const { return signatures.size(); }
+    const ByteSignature* getSignature(size_t sigId) const { return (sigId < signatures.size()) ? &signatures[sigId] : NULL; }
+
+    void compile();
+
+    // matches the unanchored signatures in the content (compiles the set if needed), returns the number of the added matches
+    size_t scan(const BYTE *content, bufsize_t contentSize, std::vector<SigMatch> &matches);
+
+    // reference implementation: verifies every unanchored signature at every offset
+    size_t naiveScan(const BYTE *content, bufsize_t contentSize, std::vector<SigMatch> &matches) const;
+
+    // verifies the signatures with the given anchor at the given offset
+    size_t scanAnchored(const BYTE *content, bufsize_t contentSize, offset_t offset, ByteSignature::sig_anchor anchor, std::vector<SigMatch> &matches) const;
+
+protected:
+    static const uint32_t NO_NODE = 0; // the root is never a target of the links
+
+    struct AcNode
+    {
+        AcNode() : fail(NO_NODE), dictLink(NO_NODE), edgesStart(0), edgesCount(0), outStart(0), outCount(0) {}
+
+        uint32_t fail;
+        uint32_t dictLink;   // the closest node on the failure path that has own outputs
+        uint32_t edgesStart; // the edges are sorted by the byte
+        uint32_t edgesCount;
+        uint32_t outStart;   // signatures whose literal ends in this node
+        uint32_t outCount;
+    };
+
+    bool isAutomatonSig(const ByteSignature &sig) const { return sig.getAnchor() == ByteSignature::ANCHOR_NONE; }
+    inline uint32_t nextNode(uint32_t node, BYTE c) const;
+
+    std::vector<ByteSignature> signatures;
+
+    // the trie is kept compact: the root has the full table, other nodes have sorted lists of edges
+    uint32_t rootNext[256];
+    std::vector<AcNode> nodes;
+    std::vector<BYTE> edgeBytes;
+    std::vector<uint32_t> edgeTargets;
+    std::vector<uint32_t> outSigs;
+    std::vector<uint32_t> noLiteralSigs; // unanchored, without a literal
+    bool isCompiled;
+};
+
+struct SigHit
+{
+    SigHit(size_t v_sigId = 0, offset_t v_raw = INVALID_ADDR, offset_t v_rva = INVALID_ADDR, offset_t v_va = INVALID_ADDR)
+        : sigId(v_sigId), raw(v_raw), rva(v_rva), va(v_va) {}
+
+    size_t sigId;
+    offset_t raw;
+    offset_t rva;
+    offset_t va;
+};
+
+class SignatureScanner
+{
+public:
+    SignatureScanner(SignatureSet &v_sigSet) : sigSet(v_sigSet) {}
+
+    // the whole file: unanchored signatures anywhere, anchored ones at the EP and the section starts
+    size_t scanExe(Executable *exe, std::vector<SigHit> &hits);
+
+    // any buffer being a part of the exe (i.e. BufferView), starting at the given raw offset
+    size_t scanBuffer(Executable *exe, AbstractByteBuffer *buf, offset_t bufRaw, std::vector<SigHit> &hits);
+
+    size_t scanSection(PEFile *pe, size_t secId, std::vector<SigHit> &hits);
+
+    // the neighbourhood of the entry point: the EP-anchored signatures and the unanchored ones found in the given number of bytes
+    size_t scanEntryPoint(Executable *exe, bufsize_t neighbourhood, std::vector<SigHit> &hits);
+
+protected:
+    size_t toHits(Executable *exe, const std::vector<SigMatch> &matches, offset_t bufRaw, std::vector<SigHit> &hits);
+    void sectionStarts(PEFile *pe, std::vector<offset_t> &starts);
+
+    SignatureSet &sigSet;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "AbstractByteBuffer.h"
+#include <vector>
+
+#define STRINGS_DEFAULT_MIN_LEN 4
+
+struct FoundString
+{
+    FoundString(offset_t v_offset = INVALID_ADDR, bufsize_t v_length = 0, bool v_isWide = false)
+        : offset(v_offset), length(v_length), isWide(v_isWide) {}
+
+    // size in bytes (UTF-16LE chars take two bytes each)
+    bufsize_t getSize() const { return isWide ? (length * sizeof(WORD)) : length; }
+
+    bool operator<(const FoundString &other) const
+    {
+        if (offset != other.offset) return offset < other.offset;
+        return (!isWide && other.isWide);
+    }
+
+    offset_t offset; // relative to the beginning of the scanned buffer
+    bufsize_t length; // in characters
+    bool isWide;
+};
+
+/*
+strings-style extractor: finds runs of printable ASCII and UTF-16LE characters.
+The content is classified in blocks of 64 bytes (with SSE2 where available)
+and big buffers are split into chunks that are scanned in parallel.
+*/
+class StringsExtractor
+{
+public:
+    enum str_type {
+        STR_NONE = 0,
+        STR_ASCII = 1,
+        STR_WIDE = 2,
+        STR_ALL = STR_ASCII | STR_WIDE
+    };
+
+    static inline bool isStringChar(BYTE c) { return IS_PRINTABLE(c) || c == '\t'; }
+
+    // fetches the text of the string found in the given buffer
+    static QString getString(AbstractByteBuffer *buf, const FoundString &str);
+
+    StringsExtractor(bufsize_t v_minLen = STRINGS_DEFAULT_MIN_LEN, int v_types = STR_ALL, size_t v_threads = 0);
+
+    void setMinLength(bufsize_t v_minLen) { minLen = (v_minLen > 0) ? v_minLen : 1; }
+    void setTypes(int v_types) { types = v_types; }
+    void setThreadsCount(size_t v_threads) { threads = v_threads; } // 0: autodetect
+
+    bufsize_t getMinLength() const { return minLen; }
+    int getTypes() const { return types; }
+
+    // appends strings found in the buffer, sorted by offset; returns the number of added strings
+    size_t extract(AbstractByteBuffer *buf, std::vector<FoundString> &found);
+
+protected:
+    static const bufsize_t MIN_CHUNK_SIZE = 0x100000;
+
+    size_t threadsFor(bufsize_t contentSize) const;
+    void extractChunk(const BYTE *content, bufsize_t contentSize, offset_t chunkStart, offset_t chunkEnd, std::vector<FoundString> &found) const;
+
+    bufsize_t minLen;
+    int types;
+    size_t threads;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <functional>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -64,5 +65,9 @@ namespace pe_util {
     bool isHexChar(char c);
 
     bool endsWith(std::string string, std::string endStr);
+
+    // Calls the task for each index in [0, count), from a pool of threads taking the indices in turn (0: as many as the cores).
+    // Returns when all the tasks are done; a single thread runs them in the caller's one.
+    void parallelFor(size_t count, size_t threads, const std::function<void(size_t)> &task);
 };
 
@@ -11,7 +11,11 @@
 #include <bearparser/ExeElementWrapper.h>
 #include <bearparser/ExeNodeWrapper.h>
 #include <bearparser/Formatter.h>
+#include <bearparser/StringsExtractor.h>
+#include <bearparser/SignatureScanner.h>
+#include <bearparser/FuzzyHash.h>
 #include <bearparser/ExeFactory.h>
+#include <bearparser/ArchiveReader.h>
 
 #endif //BEARPARSER_CORE_H
 
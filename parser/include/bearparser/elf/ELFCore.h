@@ -1,10 +1,22 @@
 #pragma once
 
 #include "../Executable.h"
-#include "elf.h"
-#include <variant>
+#include "ELFView.h"
+#include "ElfStringTable.h"
+#include <string_view>
+#include <unordered_map>
 #include <QVector>
 
+// PT_LOAD segment projected into one of the address spaces, used for the address translation
+struct ElfMappedRange
+{
+    offset_t start;         // the start in the source address space
+    bufsize_t size;         // the size in the source address space
+    offset_t mapped;        // the start in the target address space
+    bufsize_t mappedSize;   // how much of the range (from its start) has a counterpart in the target address space
+    offset_t maxEnd;        // the biggest end of the ranges up to this one, in the order of sorting (covers overlapping ranges)
+};
+
 // Class for internal use of ELFFile
 class ELFCore
 {
@@ -12,13 +24,16 @@ public:
 
     ELFCore() :
         buf(nullptr),
-        ehdr{}, 
-        phdrs{}, 
-        shdrs{} 
+        bits64(false)
     {}
 
     virtual ~ELFCore() { reset(); }
 
+    // Calls func with the view of the class of the wrapped ELF (ELFView<Elf32Traits> or ELFView<Elf64Traits>).
+    // The class is checked once per call, the code of func is specialised for each of them.
+    template <typename Func>
+    auto withView(Func func) const { return bits64 ? func(view64) : func(view32); }
+
 protected:
     bool wrap(AbstractByteBuffer *v_buf);
 
@@ -31,6 +46,7 @@ protected:
     virtual bufsize_t getAlignment() const;
     Executable::exe_bits getHdrBitMode() const;
     Executable::exe_arch getHdrArch() const;
+    uint16_t getHdrMachine() const; // EM_*
 
     // Header counts
     size_t getProgramHdrsCount()    const;
@@ -43,63 +59,58 @@ protected:
     bufsize_t getSectionHdrsSize()  const;
 
     // Headers access by index
-    std::variant<Elf32_Phdr*, Elf64_Phdr*> getProgramHdrByIndex(int idx) const;
-    std::variant<Elf32_Shdr*, Elf64_Shdr*> getSectionHdrByIndex(int idx) const;
     bufsize_t getSectionHdrSizeByIndex(int idx)  const;
     bufsize_t getProgramHdrSizeByIndex(int idx)  const;
 
-    // High-level querying
-    QVector<std::variant<Elf32_Phdr*, Elf64_Phdr*>> getProgramHeaders() const;
-    QVector<std::variant<Elf32_Shdr*, Elf64_Shdr*>> getSectionHeaders() const;
-
+    // Section names: looked up in the index built in wrap(), -1 if not found
+    int findSectionByName(std::string_view name) const;
     int findSectionByName(const QString& name) const;
     int findSegmentByType(uint32_t type) const;
     int findSectionByType(uint32_t type) const;
+    std::string_view getSectionName(int idx) const; // points into .shstrtab, empty if no such section
     QString getSectionNameByIndex(int idx) const;
 
+    // the string table stored in the given section (i.e. .strtab, .dynstr); invalid if it is not SHT_STRTAB
+    ElfStringTable getSectionStrings(int idx) const;
+
     // Flags
     bool isLoadableSegment(int idx) const;
     bool isExecutableSegment(int idx) const;
     bool sectionHasFlag(int idx, uint32_t flag) const;
     bool segmentHasFlag(int idx, uint32_t flag) const;
 
+    // Address translation over the PT_LOAD segments (RVA is relative to the image base).
+    // The tables are built once, in wrap(), so the lookups are read-only and need no locking.
+    offset_t rawToRva(offset_t raw) const { return translateAddr(rawRanges, raw); }
+    offset_t rvaToRaw(offset_t rva) const { return translateAddr(rvaRanges, rva); }
+    bufsize_t getLoadedSize() const { return loadedSize; } // the end of the last loadable segment, as RVA
+
+    // the value of the first entry with the given tag in the PT_DYNAMIC segment
+    bool getDynamicValue(int64_t tag, uint64_t &value) const;
+    bool getDynamicSegment(offset_t &raw, bufsize_t &size) const;
+
 private:
-    // Internal helpers
-    template <typename EhdrT, typename PhdrT, typename ShdrT>
-    bool wrapElfHeaders(AbstractByteBuffer* buf, bool allowExceptionsFromBuffer);
-
-    template <typename T> T* getElfHeader() const;
-    // template <typename T> T* getProgramHeaders() const;
-    // template <typename T> T* getSectionHeaders() const;
-    
     // Cache
     offset_t cacheImageBase()    const;
     bufsize_t cacheVirtualSize() const;
     bufsize_t cacheImageSize()   const;
     bufsize_t cacheAlignment()   const;
-    QVector<QString> cacheSectionNames() const;
+    void buildSectionNamesIndex();
+
+    void buildLoadSegmentsMap();
+    static offset_t translateAddr(const QVector<ElfMappedRange> &ranges, offset_t addr);
 
 protected:
     void reset();
-    // this field has become almost useless, since we templated everything.
-    bool is64() const { return std::holds_alternative<Elf64_Ehdr*>(ehdr); }
+    bool is64() const { return bits64; }
 
 private:
     AbstractByteBuffer *buf;
 
-    std::variant<Elf32_Ehdr*, Elf64_Ehdr*> ehdr;
-    QVector<std::variant<Elf32_Phdr*, Elf64_Phdr*>> phdrs;
-    QVector<std::variant<Elf32_Shdr*, Elf64_Shdr*>> shdrs;
-
-    // Variant helpers
-    std::variant<Elf32_Ehdr*, Elf64_Ehdr*> getEhdrVariant() const;
-    template<typename EhdrT> std::variant<Elf32_Ehdr*, Elf64_Ehdr*> getEhdrVariantT() const;
-    
-    // std::variant<Elf32_Phdr*, Elf64_Phdr*> getPhdrsVariant() const;
-    // template<typename PhdrT> std::variant<Elf32_Phdr*, Elf64_Phdr*> getPhdrsVariantT() const;
-
-    // std::variant<Elf32_Shdr*, Elf64_Shdr*> getShdrsVariant() const;
-    // template<typename ShdrT> std::variant<Elf32_Shdr*, Elf64_Shdr*> getShdrsVariantT() const;
+    // only the view of the class of the wrapped ELF is valid
+    ELFView<Elf32Traits> view32;
+    ELFView<Elf64Traits> view64;
+    bool bits64;
 
     // Caching
     mutable offset_t cachedImageSize  = 0;
@@ -107,15 +118,21 @@ private:
 
     mutable offset_t cachedImageBase  = UINT64_MAX;
     mutable bool cachedImageBaseValid = false;
-    
+
     mutable bufsize_t cachedVirtualSize = 0;
     mutable bool cachedVirtualSizeValid = false;
 
     mutable bufsize_t cachedAlignment = 0;
     mutable bool cachedAlignmentValid = false;
 
-    mutable QVector<QString> cachedSectionNames;
-    mutable bool cachedSectionNamesValid = false;
+    // .shstrtab, and the section index by name (the first of the sections with the same name)
+    ElfStringTable sectionNames;
+    std::unordered_map<std::string_view, int> sectionsByName;
+
+    // PT_LOAD segments: sorted by RVA, and by raw offset
+    QVector<ElfMappedRange> rvaRanges;
+    QVector<ElfMappedRange> rawRanges;
+    bufsize_t loadedSize = 0;
 
 friend class ELFFile;
-};
\ No newline at end of file
+};
@@ -7,6 +7,10 @@
 #include "ElfSectHdrWrapper.h"
 #include "ElfSymTabWrapper.h"
 #include "ElfDynWrapper.h"
+#include "ElfRelocWrapper.h"
+#include "ElfNoteWrapper.h"
+#include "ElfEhFrameHdrWrapper.h"
+#include "ElfFunctionIndex.h"
 
 #include "../MappedExe.h"
 #include <QDebug>
@@ -24,6 +28,7 @@ public:
     virtual bool signatureMatches(AbstractByteBuffer *buf);
     virtual Executable* build(AbstractByteBuffer *buf);
     QString typeName() { return "ELF"; }
+    std::vector<QByteArray> magics() { return { QByteArray(ELFMAG, SELFMAG) }; }
 };
 
 class ELFFile : public MappedExe
@@ -36,40 +41,31 @@ public:
         WR_SECTION_HDRS,
         WR_SYMBOL_TABLE,
         WR_DYN_SYM_TABLE,
+        WR_DYNAMIC,
+        WR_RELA_DYN,
+        WR_REL_DYN,
+        WR_PLT_RELOCS,
+        WR_RELR_DYN,
+        WR_EH_FRAME_HDR,
         FIELD_COUNTER
     };
 
     ELFFile(AbstractByteBuffer *v_buf);
+    virtual ~ELFFile() { clearWrappers(); }
 
     virtual void wrap() { return; }  // inherited from Executable
     
     virtual bufsize_t getMappedSize(Executable::addr_type aType);
     virtual bufsize_t getAlignment(Executable::addr_type aType) const { return core.cacheAlignment(); }
-    virtual offset_t getImageBase(bool recalculate = false) { return core.cacheImageBase(); }
+    virtual offset_t getImageBase(bool recalculate = false) { return core.getImageBase(); }
     virtual offset_t getEntryPoint(Executable::addr_type addrType = Executable::RVA); // returns INVALID_ADDR if failed
-    virtual offset_t rawToRva(offset_t raw) { return 0; }
-    virtual offset_t rvaToRaw(offset_t rva) { return 0; }
+    virtual offset_t rawToRva(offset_t raw) { return core.rawToRva(raw); }
+    virtual offset_t rvaToRaw(offset_t rva) { return core.rvaToRaw(rva); }
     
 
-    std::variant<Elf32_Ehdr*, Elf64_Ehdr*> getEhdrVariant() const {
-        return core.getEhdrVariant();
-    }
-
-    QVector<std::variant<Elf32_Phdr*, Elf64_Phdr*>> getProgramHeaders() const {
-        return core.getProgramHeaders();
-    }
-
-    QVector<std::variant<Elf32_Shdr*, Elf64_Shdr*>> getSectionHeaders() const {
-        return core.getSectionHeaders();
-    }
-    
-    // std::variant<Elf32_Phdr*, Elf64_Phdr*> getPhdrsVariant() const {
-    //     return core.getPhdrsVariant();
-    // }
-
-    // std::variant<Elf32_Shdr*, Elf64_Shdr*> getShdrsVariant() const {
-    //     return core.getShdrsVariant();
-    // }
+    // Calls func with the typed view of the headers: ELFView<Elf32Traits> or ELFView<Elf64Traits>
+    template <typename Func>
+    auto withView(Func func) const { return core.withView(func); }
 
     virtual exe_bits getHdrBitMode() { return core.getHdrBitMode(); }
     virtual exe_arch getArch() { return ARCH_UNKNOWN; }
@@ -83,8 +79,46 @@ public:
     offset_t elfSectHdrOffset() const { return core.getSectionHdrsOffset(); }
     bufsize_t elfSectHdrSize()  const { return core.getSectionHdrsSize(); }
 
+    uint16_t elfMachine() const { return core.getHdrMachine(); }
+
+    // section names, from .shstrtab
+    std::string_view elfSectionName(int idx) const { return core.getSectionName(idx); }
+    int elfFindSection(std::string_view name) const { return core.findSectionByName(name); } // -1 if not found
+
+    // the string table stored in the section; i.e. .strtab, .dynstr
+    ElfStringTable elfSectionStrings(int idx) const { return core.getSectionStrings(idx); }
+    ElfStringTable elfSectionStrings(std::string_view name) const { return core.getSectionStrings(core.findSectionByName(name)); }
+
+    bool elfDynamicValue(int64_t tag, uint64_t &value) const { return core.getDynamicValue(tag, value); }
+    bool elfDynamicSegment(offset_t &raw, bufsize_t &size) const { return core.getDynamicSegment(raw, size); }
+
+    ElfSymTabWrapper* getSymTab() { return symTab; }
+    ElfSymTabWrapper* getDynSymTab() { return dynSymTab; }
+    ElfDynWrapper* getDynamic() { return dynTab; }
+    ElfEhFrameHdrWrapper* getEhFrameHdr() { return ehFrameHdr; }
+
+    // the address to function lookup, built with the first use
+    const ElfFunctionIndex& getFunctionIndex();
+
+    // the dynamic relocation tables present in the file
+    std::vector<ElfRelocWrapper*> getRelocTables();
+
+    // patches the relative relocations of all the tables, as if the image was loaded at newBase
+    // (again: from the previously applied base); returns the number of the applied relocations
+    size_t applyRelocations(offset_t newBase);
+
+    // the notes: one wrapper per SHT_NOTE section, or per PT_NOTE segment if there are no section headers
+    const std::vector<ElfNoteWrapper*>& getNotes() { return notes; }
+
+    // NT_GNU_BUILD_ID, empty if none; ElfNoteWrapper::readBuildId gives the same without wrapping the file
+    QByteArray getBuildId();
+    bool getAbiTag(ElfAbiTag &tag); // NT_GNU_ABI_TAG (.note.ABI-tag)
+    size_t getGnuProperties(std::vector<ElfGnuProperty> &props); // NT_GNU_PROPERTY_TYPE_0 (.note.gnu.property)
+
 protected:
     void _init(AbstractByteBuffer *v_buf);
+    void wrapRelocTables();
+    void wrapNotes();
     virtual void clearWrappers();
 
     ELFCore core;
@@ -92,8 +126,12 @@ protected:
     ElfHdrWrapper *elfHdr;
     ElfProgHdrWrapper *progHdrs;
     ElfSectHdrWrapper *sectHdrs;
-    // ElfSymTabWrapper *symTab;
-    // ElfDynWrapper *dynTab;
+    ElfSymTabWrapper *symTab;
+    ElfSymTabWrapper *dynSymTab;
+    ElfDynWrapper *dynTab;
+    ElfEhFrameHdrWrapper *ehFrameHdr;
+    std::vector<ElfNoteWrapper*> notes;
+    ElfFunctionIndex *functionIndex;
 };
 
 // class ELFFile : public MappedExe {
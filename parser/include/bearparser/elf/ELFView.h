@@ -0,0 +1,148 @@
+#pragma once
+
+#include "../Executable.h"
+#include "elf.h"
+
+#include <cstddef>
+
+// ELF structures of the given class, resolved at compile time
+struct Elf32Traits
+{
+    using Ehdr = Elf32_Ehdr;
+    using Phdr = Elf32_Phdr;
+    using Shdr = Elf32_Shdr;
+    using Sym = Elf32_Sym;
+    using Dyn = Elf32_Dyn;
+    using Rel = Elf32_Rel;
+    using Rela = Elf32_Rela;
+    using Nhdr = Elf32_Nhdr;
+    using Word = uint32_t; // the native word (Elf32_Addr/Elf32_Off)
+
+    static constexpr unsigned char ELF_CLASS = ELFCLASS32;
+    static constexpr bool IS_64 = false;
+
+    // r_info of Rel/Rela
+    static uint32_t relocType(Word info) { return ELF32_R_TYPE(info); }
+    static uint32_t relocSymbol(Word info) { return ELF32_R_SYM(info); }
+};
+
+struct Elf64Traits
+{
+    using Ehdr = Elf64_Ehdr;
+    using Phdr = Elf64_Phdr;
+    using Shdr = Elf64_Shdr;
+    using Sym = Elf64_Sym;
+    using Dyn = Elf64_Dyn;
+    using Rel = Elf64_Rel;
+    using Rela = Elf64_Rela;
+    using Nhdr = Elf64_Nhdr;
+    using Word = uint64_t;
+
+    static constexpr unsigned char ELF_CLASS = ELFCLASS64;
+    static constexpr bool IS_64 = true;
+
+    static uint32_t relocType(Word info) { return static_cast<uint32_t>(ELF64_R_TYPE(info)); }
+    static uint32_t relocSymbol(Word info) { return static_cast<uint32_t>(ELF64_R_SYM(info)); }
+};
+
+// non-owning view of an array of structures inside the buffer
+template <typename T>
+class ElfSpan
+{
+public:
+    ElfSpan() : ptr(nullptr), count(0) {}
+    ElfSpan(T *v_ptr, size_t v_count) : ptr(v_ptr), count(v_ptr ? v_count : 0) {}
+
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + count; }
+    T& operator[](size_t index) const { return ptr[index]; }
+    T* at(size_t index) const { return (index < count) ? (ptr + index) : nullptr; }
+
+    T* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    T *ptr;
+    size_t count;
+};
+
+/*
+The headers of an ELF of the given class: the ELF header and the spans of the program and section headers.
+All refer to the buffer in place. Wrapped once, then read only.
+*/
+template <typename Traits>
+class ELFView
+{
+public:
+    using ElfTraits = Traits;
+    using Ehdr = typename Traits::Ehdr;
+    using Phdr = typename Traits::Phdr;
+    using Shdr = typename Traits::Shdr;
+
+    ELFView() : ehdr(nullptr) {}
+
+    // throws ExeException if the headers don't fit in the buffer
+    void wrap(AbstractByteBuffer *buf);
+    void reset() { ehdr = nullptr; phdrs = ElfSpan<Phdr>(); shdrs = ElfSpan<Shdr>(); }
+
+    bool isValid() const { return ehdr != nullptr; }
+
+    Ehdr* header() const { return ehdr; }
+    const ElfSpan<Phdr>& programHeaders() const { return phdrs; }
+    const ElfSpan<Shdr>& sectionHeaders() const { return shdrs; }
+
+    // the index of the section with the section names (.shstrtab); SHN_UNDEF if none
+    size_t sectionNamesIndex() const
+    {
+        if (!ehdr) return SHN_UNDEF;
+        if (ehdr->e_shstrndx != SHN_XINDEX) return ehdr->e_shstrndx;
+        return shdrs.empty() ? SHN_UNDEF : shdrs[0].sh_link;
+    }
+
+private:
+    Ehdr *ehdr;
+    ElfSpan<Phdr> phdrs;
+    ElfSpan<Shdr> shdrs;
+};
+
+template <typename Traits>
+void ELFView<Traits>::wrap(AbstractByteBuffer *buf)
+{
+    const bool allowExceptionsFromBuffer = false;
+    reset();
+
+    ehdr = reinterpret_cast<Ehdr*>(buf->getContentAt(0, sizeof(Ehdr), allowExceptionsFromBuffer));
+    if (!ehdr) {
+        throw ExeException("Could not wrap ELFCore: invalid ELF Header!");
+    }
+
+    if (ehdr->e_phnum) {
+        Phdr *phdrPtr = reinterpret_cast<Phdr*>(buf->getContentAt(ehdr->e_phoff, bufsize_t(ehdr->e_phnum) * sizeof(Phdr), allowExceptionsFromBuffer));
+        if (!phdrPtr) {
+            reset();
+            throw ExeException("Could not wrap ELFCore: invalid Program Headers!");
+        }
+        phdrs = ElfSpan<Phdr>(phdrPtr, ehdr->e_phnum);
+    }
+
+    if (ehdr->e_shoff == 0) return;
+
+    // with SHN_LORESERVE sections or more, e_shnum is 0 and the count is in the first section header
+    size_t shnum = ehdr->e_shnum;
+    if (shnum == 0) {
+        const Shdr *firstShdr = reinterpret_cast<Shdr*>(buf->getContentAt(ehdr->e_shoff, sizeof(Shdr), allowExceptionsFromBuffer));
+        if (firstShdr) shnum = static_cast<size_t>(firstShdr->sh_size);
+    }
+    if (shnum == 0) return;
+
+    Shdr *shdrPtr = nullptr;
+    if (shnum <= buf->getContentSize() / sizeof(Shdr)) {
+        shdrPtr = reinterpret_cast<Shdr*>(buf->getContentAt(ehdr->e_shoff, bufsize_t(shnum * sizeof(Shdr)), allowExceptionsFromBuffer));
+    }
+    if (!shdrPtr) {
+        reset();
+        throw ExeException("Could not wrap ELFCore: invalid Section Headers!");
+    }
+    shdrs = ElfSpan<Shdr>(shdrPtr, shnum);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "elf/ELFNodeWrapper.h"
+#include "elf/ElfStringTable.h"
+#include "elf.h"
+
+#include <unordered_map>
+
+// not defined by the older versions of elf.h:
+#ifndef DT_RELR
+#define DT_RELRSZ   35
+#define DT_RELR     36
+#define DT_RELRENT  37
+#endif
+#ifndef DT_SYMTAB_SHNDX
+#define DT_SYMTAB_SHNDX 34
+#endif
+
+class ELFFile; // forward declaration
+
+/*
+The dynamic section (PT_DYNAMIC): an array of Elf32_Dyn/Elf64_Dyn, terminated by DT_NULL.
+The entries are read in place.
+*/
+class ElfDynWrapper : public ELFElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        D_TAG = 0,
+        D_VAL,
+        FIELD_COUNTER
+    };
+
+    static const std::unordered_map<int64_t, QString> s_dynTags;
+    static QString translateTag(int64_t tag);
+    static bool isPointerTag(int64_t tag); // the value is a VA
+
+    ElfDynWrapper(ELFFile *elfExe);
+
+    bool wrap();
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize() { return static_cast<bufsize_t>(entriesCount * entrySize); }
+    virtual QString getName() { return "ELF Dynamic Section"; }
+
+    // the fields describe a single entry, selected by the subField (the entry index, 0 by default)
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual size_t getSubFieldsCount() { return entriesCount; }
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE);
+
+    size_t getEntriesCount() { return entriesCount; } // without the terminator
+    int64_t getTag(size_t index);
+    uint64_t getValue(size_t index);
+
+    // the value of the first entry with the given tag
+    bool findValue(int64_t tag, uint64_t &value);
+
+    // strings referenced by the entries (offsets in DT_STRTAB)
+    QString getString(uint64_t strOffset);
+    QStringList getNeededLibraries();
+    QString getSoName();
+    QString getRunPath(); // DT_RUNPATH, or DT_RPATH if there is no DT_RUNPATH
+    const ElfStringTable& getStringTable() { return strings; } // .dynstr, located by DT_STRTAB and DT_STRSZ
+
+protected:
+    void* getEntryPtr(size_t index);
+
+    // calls func with the entry of the class of the ELF (Traits::Dyn*, NULL if out of the file)
+    template <typename Func>
+    auto withEntry(size_t index, Func func);
+
+    offset_t dynRaw;
+    size_t entriesCount;
+    bufsize_t entrySize;
+
+    ElfStringTable strings;
+};
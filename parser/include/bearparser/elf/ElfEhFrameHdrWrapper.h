@@ -0,0 +1,94 @@
+#pragma once
+
+#include "elf/ELFNodeWrapper.h"
+#include "elf.h"
+
+#include <unordered_map>
+
+// the encodings of the pointers in .eh_frame and .eh_frame_hdr (LSB: DWARF Extensions)
+#ifndef DW_EH_PE_omit
+#define DW_EH_PE_absptr     0x00
+#define DW_EH_PE_uleb128    0x01
+#define DW_EH_PE_udata2     0x02
+#define DW_EH_PE_udata4     0x03
+#define DW_EH_PE_udata8     0x04
+#define DW_EH_PE_sleb128    0x09
+#define DW_EH_PE_sdata2     0x0A
+#define DW_EH_PE_sdata4     0x0B
+#define DW_EH_PE_sdata8     0x0C
+
+#define DW_EH_PE_pcrel      0x10
+#define DW_EH_PE_textrel    0x20
+#define DW_EH_PE_datarel    0x30
+#define DW_EH_PE_funcrel    0x40
+#define DW_EH_PE_aligned    0x50
+#define DW_EH_PE_indirect   0x80
+
+#define DW_EH_PE_omit       0xFF
+#endif
+
+class ELFFile; // forward declaration
+
+/*
+.eh_frame_hdr (PT_GNU_EH_FRAME): the header, followed by the table of the functions, sorted by the start address.
+Each entry of the table refers to the FDE of the function in .eh_frame, which gives the size of the function.
+*/
+class ElfEhFrameHdrWrapper : public ELFElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        VERSION = 0,
+        EH_FRAME_PTR_ENC,
+        FDE_COUNT_ENC,
+        TABLE_ENC,
+        EH_FRAME_PTR,
+        FDE_COUNT,
+        TABLE_INITIAL_LOC, // the entry of the table, selected by the subField
+        TABLE_FDE,
+        FIELD_COUNTER
+    };
+
+    ElfEhFrameHdrWrapper(ELFFile *elfExe);
+
+    bool wrap();
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize();
+    virtual QString getName() { return "ELF Exception Frame Hdr"; }
+
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual size_t getSubFieldsCount() { return entriesCount; }
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    // the pointers are encoded, usually relative to the header
+    virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE) { return Executable::NOT_ADDR; }
+
+    size_t getEntriesCount() { return entriesCount; }
+    offset_t getEhFrameVA() { return ehFrameVA; }
+
+    // the entry of the binary search table: the start of the function and its FDE, both as VA
+    bool getEntry(size_t index, offset_t &startVA, offset_t &fdeVA);
+
+    // the size of the function described by the FDE (pc_range); 0 if the FDE can't be read
+    bufsize_t getFunctionSize(offset_t fdeVA);
+
+protected:
+    static bufsize_t encodedSize(uint8_t encoding, bool is64); // 0 if the size is not fixed
+
+    // the encoding of the pointers in the FDEs that refer to the CIE; DW_EH_PE_omit if invalid
+    uint8_t getFdeEncoding(offset_t cieRaw);
+
+    offset_t hdrRaw;
+    offset_t hdrVA;
+    bufsize_t hdrSize;
+
+    offset_t ehFrameVA;
+    offset_t fdeCountOffset; // relative to the header
+    size_t entriesCount;
+    offset_t tableOffset;    // relative to the header
+    bufsize_t tableEntrySize; // 0 if the encoding has no fixed size
+
+    std::unordered_map<offset_t, uint8_t> fdeEncodings; // by the raw offset of the CIE
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../Executable.h"
+
+#include <vector>
+
+class ELFFile; // forward declaration
+
+struct ElfAddressRange
+{
+    offset_t start; // VA
+    bufsize_t size;
+    offset_t info;  // functions: the VA of the FDE; compile units: the offset of the unit in .debug_info
+};
+
+// ranges sorted by the start address, searched with the binary search
+class ElfAddressIndex
+{
+public:
+    static const size_t NOT_FOUND = size_t(-1);
+
+    // takes the ranges in any order
+    void assign(std::vector<ElfAddressRange> &&v_ranges);
+
+    size_t size() const { return ranges.size(); }
+    bool empty() const { return ranges.empty(); }
+    const ElfAddressRange& at(size_t index) const { return ranges.at(index); }
+
+    // the index of the range that contains the address, or NOT_FOUND
+    size_t find(offset_t va) const;
+
+    // Looks up all the addresses at once: sorts them, and walks the ranges once.
+    // results[i] is the index of the range that contains addresses[i], or NOT_FOUND.
+    void find(const std::vector<offset_t> &addresses, std::vector<size_t> &results) const;
+
+protected:
+    std::vector<ElfAddressRange> ranges;
+};
+
+/*
+Address to function lookup, for the stripped binaries as well:
+the functions come from the binary search table of .eh_frame_hdr, with the sizes from their FDEs in .eh_frame;
+the compile units come from .debug_aranges (if present).
+Built once, then read only.
+*/
+class ElfFunctionIndex
+{
+public:
+    static const size_t NOT_FOUND = ElfAddressIndex::NOT_FOUND;
+
+    ElfFunctionIndex(ELFFile *elf);
+
+    const ElfAddressIndex& getFunctions() const { return functions; }
+    const ElfAddressIndex& getCompileUnits() const { return compileUnits; }
+
+    // the function that contains the VA: the index in getFunctions(), or NOT_FOUND
+    size_t findFunction(offset_t va) const { return functions.find(va); }
+    void findFunctions(const std::vector<offset_t> &addresses, std::vector<size_t> &results) const { functions.find(addresses, results); }
+
+    // the compile unit that contains the VA: the index in getCompileUnits(), or NOT_FOUND
+    size_t findCompileUnit(offset_t va) const { return compileUnits.find(va); }
+
+protected:
+    void loadEhFrameHdr(ELFFile *elf);
+    void loadDebugAranges(ELFFile *elf);
+
+    ElfAddressIndex functions;
+    ElfAddressIndex compileUnits;
+};
@@ -24,23 +24,7 @@ public:
 
     static const std::unordered_map<uint16_t, QString> s_machine;
 
-    ElfHdrWrapper(ELFFile *elfExe) 
-        : ELFElementWrapper(elfExe), 
-          hdr(static_cast<Elf64_Ehdr*>(nullptr)) {
-            qInfo() << "ELF Header Size:" << getSize();
-            wrap();
-            
-            if (std::holds_alternative<Elf64_Ehdr*>(hdr)) {
-                qInfo() << "ELF64 Header is used.";
-            } else if (std::holds_alternative<Elf32_Ehdr*>(hdr)) {
-                qInfo() << "ELF32 Header is used.";
-            } else {
-                qWarning() << "Unknown ELF header type!";
-            }
-
-            void *ptr = getPtr();
-            qInfo() << "ELF Header is located at:" << ptr;
-    }
+    ElfHdrWrapper(ELFFile *elfExe);
 
     bool wrap();
 
@@ -55,7 +39,4 @@ public:
     virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
     virtual QString getFieldName(size_t fieldId) { }
     virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE) { }
-private:
-    std::variant<Elf32_Ehdr*, Elf64_Ehdr*> hdr;
-
 };
\ No newline at end of file
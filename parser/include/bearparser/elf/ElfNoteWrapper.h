@@ -0,0 +1,151 @@
+#pragma once
+
+#include "elf/ELFNodeWrapper.h"
+#include "elf.h"
+
+#include <string_view>
+#include <vector>
+#include <QByteArray>
+
+// not defined by the older versions of elf.h:
+#ifndef NT_GNU_PROPERTY_TYPE_0
+#define NT_GNU_PROPERTY_TYPE_0 5
+#endif
+#ifndef GNU_PROPERTY_X86_FEATURE_1_AND
+#define GNU_PROPERTY_X86_FEATURE_1_AND 0xc0000002
+#endif
+#ifndef GNU_PROPERTY_AARCH64_FEATURE_1_AND
+#define GNU_PROPERTY_AARCH64_FEATURE_1_AND 0xc0000000
+#endif
+
+class ELFFile; // forward declaration
+
+// a note, referring to the buffer in place
+struct ElfNote
+{
+    offset_t raw;           // of the note header
+    uint32_t type;          // NT_*, the meaning depends on the owner
+    std::string_view owner; // the name, without the terminator, e.g. "GNU"
+    const BYTE *desc;
+    uint32_t descSize;
+};
+
+// NT_GNU_ABI_TAG: the minimal kernel version
+struct ElfAbiTag
+{
+    uint32_t os; // ELF_NOTE_OS_*
+    uint32_t major;
+    uint32_t minor;
+    uint32_t subminor;
+};
+
+// an entry of NT_GNU_PROPERTY_TYPE_0
+struct ElfGnuProperty
+{
+    uint32_t type; // GNU_PROPERTY_*
+    uint32_t dataSize;
+    const BYTE *data;
+};
+
+/*
+Notes stored in a SHT_NOTE section or a PT_NOTE segment: each note is Elf_Nhdr, followed by the owner name and the descriptor,
+both padded to the alignment of the section (4, or 8 for .note.gnu.property on 64-bit).
+The notes are read in place.
+*/
+class ElfNoteWrapper : public ELFElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        N_NAMESZ = 0,
+        N_DESCSZ,
+        N_TYPE,
+        N_NAME,
+        N_DESC,
+        FIELD_COUNTER
+    };
+
+    // Iterates over the notes in the given area of the buffer, stops at the first malformed one.
+    // func: bool(const ElfNote&), returns false to stop. Returns the number of the visited notes.
+    template <typename Func>
+    static size_t forEachNote(AbstractByteBuffer *buf, offset_t raw, bufsize_t size, bufsize_t align, Func func);
+
+    // the fast path, without wrapping the ELFFile: only the headers are read;
+    // returns the descriptor of NT_GNU_BUILD_ID, empty if there is none
+    static QByteArray readBuildId(AbstractByteBuffer *buf);
+
+    static bool decodeAbiTag(const ElfNote &note, ElfAbiTag &tag);
+    // propsAlign: 8 for ELFCLASS64, 4 for ELFCLASS32; returns the number of the appended properties
+    static size_t decodeGnuProperties(const ElfNote &note, bufsize_t propsAlign, std::vector<ElfGnuProperty> &props);
+
+    ElfNoteWrapper(ELFFile *elfExe, offset_t v_raw, bufsize_t v_size, bufsize_t v_align, const QString &v_name);
+
+    bool wrap();
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize() { return size; }
+    virtual QString getName() { return name; }
+
+    // the fields describe a single note, selected by the subField (the note index, 0 by default)
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual size_t getSubFieldsCount() { return notesOffsets.size(); }
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE) { return Executable::NOT_ADDR; }
+
+    size_t getNotesCount() { return notesOffsets.size(); }
+    bool getNote(size_t index, ElfNote &note);
+
+    // the first note of the given type and owner
+    bool findNote(uint32_t type, std::string_view owner, ElfNote &note);
+
+    template <typename Func>
+    size_t forEachNote(Func func) { return forEachNote(m_ELF, raw, size, align, func); }
+
+protected:
+    offset_t raw;
+    bufsize_t size;
+    bufsize_t align;
+    QString name;
+
+    std::vector<offset_t> notesOffsets; // relative to the start of the area
+};
+
+template <typename Func>
+size_t ElfNoteWrapper::forEachNote(AbstractByteBuffer *buf, offset_t raw, bufsize_t size, bufsize_t align, Func func)
+{
+    if (!buf || raw == INVALID_ADDR || raw >= buf->getContentSize()) return 0;
+
+    size = std::min<bufsize_t>(size, buf->getContentSize() - static_cast<bufsize_t>(raw));
+    const BYTE *area = buf->getContentAt(raw, size);
+    if (!area) return 0;
+
+    // the alignment is 4, unless 8 is set explicitly
+    const uint64_t alignMask = (align == 8) ? 7 : 3;
+    auto alignUp = [alignMask](uint64_t val) { return (val + alignMask) & ~alignMask; };
+
+    size_t count = 0;
+    uint64_t offset = 0;
+    while (offset + sizeof(Elf32_Nhdr) <= size) {
+        // the note header is the same for both classes
+        const Elf32_Nhdr *nhdr = reinterpret_cast<const Elf32_Nhdr*>(area + offset);
+
+        const uint64_t nameOffset = offset + sizeof(Elf32_Nhdr);
+        // the padding is relative to the start of the area (aligned itself)
+        const uint64_t descOffset = alignUp(nameOffset + nhdr->n_namesz);
+        if (descOffset + nhdr->n_descsz > size) break;
+
+        // the terminator(s) are not a part of the name
+        const char *ownerPtr = reinterpret_cast<const char*>(area + nameOffset);
+        size_t ownerLen = nhdr->n_namesz;
+        while (ownerLen > 0 && ownerPtr[ownerLen - 1] == '\0') ownerLen--;
+
+        const ElfNote note = { raw + offset, nhdr->n_type, std::string_view(ownerPtr, ownerLen), area + descOffset, nhdr->n_descsz };
+        count++;
+        if (!func(note)) break;
+
+        offset = alignUp(descOffset + nhdr->n_descsz);
+    }
+    return count;
+}
@@ -40,7 +40,5 @@ public:
     virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE) { }
     virtual QString getFieldName(size_t fieldId) { }
     virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE) { }
-protected:
-    QVector<std::variant<Elf32_Phdr*, Elf64_Phdr*>> phdrs;
 
 };
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "elf/ELFNodeWrapper.h"
+#include "elf.h"
+
+#include <vector>
+
+class ELFFile; // forward declaration
+
+struct ElfRelocation
+{
+    offset_t offset;    // r_offset: VA of the relocated location
+    uint32_t type;      // R_*, depends on the machine
+    uint32_t symbol;    // index in the dynamic symbol table
+    int64_t addend;
+    bool hasAddend;     // RELA
+};
+
+/*
+A table of the dynamic relocations: DT_REL, DT_RELA, DT_JMPREL (.rel[a].plt) or DT_RELR.
+RELR is the packed format of the relative relocations: an address word is followed by the bitmap words,
+each covering the next (wordBits - 1) words after the previous ones.
+*/
+class ElfRelocWrapper : public ELFElementWrapper
+{
+public:
+    enum reloc_format {
+        RELOC_REL = 0,
+        RELOC_RELA,
+        RELOC_RELR
+    };
+
+    enum FieldID {
+        NONE = FIELD_NONE,
+        R_OFFSET = 0,   // RELR: the address or the bitmap
+        R_INFO,
+        R_ADDEND,
+        FIELD_COUNTER
+    };
+
+    // the type of the relocation that is adjusted by the load base only, for the given machine (EM_*); 0 if unknown
+    static uint32_t relativeType(uint16_t machine);
+
+    ElfRelocWrapper(ELFFile *elfExe, reloc_format v_format, offset_t v_raw, bufsize_t v_size, const QString &v_name);
+
+    bool wrap();
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize() { return static_cast<bufsize_t>(entriesCount * entrySize); }
+    virtual QString getName() { return name; }
+
+    // the fields describe a single entry, selected by the subField (the entry index, 0 by default)
+    virtual size_t getFieldsCount();
+    virtual size_t getSubFieldsCount() { return entriesCount; }
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE);
+
+    reloc_format getFormat() { return format; }
+    size_t getEntriesCount() { return entriesCount; } // RELR: the number of words, not the relocations
+
+    // REL and RELA only
+    bool getRelocation(size_t index, ElfRelocation &reloc);
+
+    // all the relocations of the table (RELR decoded); returns the number of the appended ones
+    size_t getRelocations(std::vector<ElfRelocation> &relocs);
+
+    // Patches the relative relocations as if the image was loaded at newBase (the headers are not changed).
+    // The other relocations need symbols resolution, so they are skipped.
+    // The buffer must be writable. Can be called again: the relocations are moved from the previously applied base.
+    // Returns the number of the applied relocations.
+    size_t applyRelocations(offset_t newBase);
+
+protected:
+    template <typename Func> void forEachRelr(Func func);
+
+    bool applyRelative(offset_t va, const int64_t *addend, uint64_t delta);
+
+    bufsize_t getWordSize(); // of the class of the ELF: the size of the fields
+
+    reloc_format format;
+    offset_t raw;
+    bufsize_t size;
+    QString name;
+
+    bufsize_t entrySize;
+    size_t entriesCount;
+    offset_t appliedBase; // INVALID_ADDR: not relocated yet
+};
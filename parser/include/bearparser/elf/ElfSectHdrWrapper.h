@@ -44,6 +44,4 @@ public:
     virtual void *getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE) { }
     virtual QString getFieldName(size_t fieldId) { }
     virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE) { }
-protected:
-    QVector<std::variant<Elf32_Shdr*, Elf64_Shdr*>> shdrs;
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../AbstractByteBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <QString>
+
+/*
+A string table of ELF (SHT_STRTAB: .shstrtab, .strtab, .dynstr): NUL-terminated strings, referenced by offsets.
+Refers to the buffer in place: the returned views are valid as long as the content of the buffer is.
+*/
+class ElfStringTable
+{
+public:
+    ElfStringTable() : data(nullptr), size(0) {}
+
+    // the table is clamped to the content of the buffer
+    ElfStringTable(AbstractByteBuffer *buf, offset_t raw, bufsize_t v_size)
+        : data(nullptr), size(0)
+    {
+        if (!buf || raw == INVALID_ADDR || raw >= buf->getContentSize()) return;
+
+        const bufsize_t clamped = std::min<bufsize_t>(v_size, buf->getContentSize() - static_cast<bufsize_t>(raw));
+        data = reinterpret_cast<const char*>(buf->getContentAt(raw, clamped));
+        if (data) size = clamped;
+    }
+
+    bool isValid() const { return data != nullptr; }
+    bufsize_t getSize() const { return size; }
+
+    // the string at the offset, up to the terminator or the end of the table; empty if out of the table
+    std::string_view getString(uint64_t offset) const
+    {
+        if (!data || offset >= size) return std::string_view();
+
+        const char *str = data + offset;
+        const size_t maxLen = static_cast<size_t>(size - offset);
+        const char *end = static_cast<const char*>(memchr(str, 0, maxLen));
+        return std::string_view(str, end ? static_cast<size_t>(end - str) : maxLen);
+    }
+
+    QString getQString(uint64_t offset) const
+    {
+        const std::string_view str = getString(offset);
+        return QString::fromUtf8(str.data(), static_cast<int>(str.size()));
+    }
+
+private:
+    const char *data;
+    bufsize_t size;
+};
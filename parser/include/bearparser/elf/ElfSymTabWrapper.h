@@ -0,0 +1,118 @@
+#pragma once
+
+#include "elf/ELFNodeWrapper.h"
+#include "elf/ElfStringTable.h"
+#include "elf.h"
+
+#include <string_view>
+#include <unordered_map>
+
+class ELFFile; // forward declaration
+
+/*
+Symbol table of ELF: .symtab or .dynsym.
+The symbols are read in place (Elf32_Sym/Elf64_Sym), nothing is copied.
+Lookups by name go through the hash table of the binary (DT_GNU_HASH or DT_HASH), if it covers the wrapped table.
+*/
+class ElfSymTabWrapper : public ELFElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        ST_NAME = 0,
+        ST_INFO,
+        ST_OTHER,
+        ST_SHNDX,
+        ST_VALUE,
+        ST_SIZE,
+        FIELD_COUNTER
+    };
+
+    enum hash_type {
+        HASH_NONE = 0,
+        HASH_SYSV,
+        HASH_GNU
+    };
+
+    static const size_t SYMBOL_NOT_FOUND = size_t(-1);
+
+    // tableType: SHT_SYMTAB or SHT_DYNSYM
+    ElfSymTabWrapper(ELFFile *elfExe, uint32_t tableType);
+
+    bool wrap();
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize();
+    virtual QString getName() { return (tableType == SHT_DYNSYM) ? "ELF Dynamic Symbol Table" : "ELF Symbol Table"; }
+
+    // the fields describe a single symbol, selected by the subField (the symbol index, 0 by default)
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual size_t getSubFieldsCount() { return getSymbolsCount(); }
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE);
+
+    size_t getSymbolsCount() { return symbolsCount; }
+    bufsize_t getEntrySize() { return entrySize; }
+
+    BYTE* getSymbolPtr(size_t index); // Elf32_Sym or Elf64_Sym, by the class of the ELF; NULL if out of the table
+    QString getSymbolName(size_t index);
+    std::string_view getSymbolNameView(size_t index); // points into the string table
+    offset_t getSymbolValue(size_t index); // VA (for executables and shared objects)
+    bufsize_t getSymbolSize(size_t index);
+    uint8_t getSymbolType(size_t index);    // STT_*
+    uint8_t getSymbolBinding(size_t index); // STB_*
+    uint16_t getSymbolSection(size_t index);
+
+    // returns SYMBOL_NOT_FOUND if there is no such symbol
+    size_t findSymbol(const QString &name) { return findSymbol(name.toUtf8().constData()); }
+    size_t findSymbol(const char *name);
+
+    hash_type getHashType() { return hashType; }
+    const ElfStringTable& getStringTable() { return strings; } // .strtab or .dynstr
+
+protected:
+    static uint32_t sysvHash(const char *name);
+    static uint32_t gnuHash(const char *name);
+
+    bool wrapFromSections();
+    bool wrapFromDynamic(); // for .dynsym, when there are no section headers
+    bool wrapGnuHash(offset_t hashRaw);
+    bool wrapSysvHash(offset_t hashRaw);
+
+    size_t findInGnuHash(const char *name);
+    size_t findInSysvHash(const char *name);
+    size_t findInIndex(const char *name);
+
+    // calls func with the symbol of the class of the ELF (Traits::Sym*, NULL if out of the table)
+    template <typename Func>
+    auto withSymbol(size_t index, Func func);
+
+    bool nameEquals(size_t index, const char *name);
+    const uint32_t* getWords(offset_t raw, size_t count);
+
+    uint32_t tableType;
+
+    offset_t symbolsRaw;
+    size_t symbolsCount;
+    bufsize_t entrySize;
+
+    ElfStringTable strings;
+
+    // the hash table of the binary:
+    hash_type hashType;
+    offset_t hashRaw;
+    uint32_t bucketsCount;
+    uint32_t symOffset;     // GNU: the index of the first hashed symbol
+    size_t hashedEnd;       // GNU: the end of the last chain
+    uint32_t bloomSize;     // GNU: in words of the ELF class
+    uint32_t bloomShift;    // GNU
+    offset_t bloomRaw;
+    offset_t bucketsRaw;
+    offset_t chainsRaw;
+
+    // for the tables not covered by the hash table (i.e. .symtab), or the symbols out of the GNU hash; built with the first lookup
+    std::unordered_map<std::string_view, size_t> namesIndex;
+    bool namesIndexValid;
+};
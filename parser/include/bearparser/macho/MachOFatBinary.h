@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../Executable.h"
+#include "macho_formats.h"
+
+#include <vector>
+
+struct MachOFatSlice
+{
+    int32_t cpuType;
+    int32_t cpuSubtype;
+    offset_t offset;    // in the fat binary
+    bufsize_t size;
+    uint32_t align;     // the power of 2
+};
+
+/*
+Universal (fat) binary: the big endian table of the architectures, followed by the thin Mach-O of each of them.
+Each slice is exposed as a BufferView on the parent buffer: nothing is copied.
+*/
+class MachOFatBinary
+{
+public:
+    static const size_t NOT_FOUND = size_t(-1);
+
+    // the table of the architectures is valid (this is also what tells it apart from a Java class: both start with 0xCAFEBABE)
+    static bool isFat(AbstractByteBuffer *buf);
+
+    MachOFatBinary(AbstractByteBuffer *v_buf); //throws ExeException
+    virtual ~MachOFatBinary();
+
+    AbstractByteBuffer* getBuffer() const { return buf; }
+    bool is64() const { return isFat64; }
+
+    size_t getSlicesCount() const { return slices.size(); }
+    const MachOFatSlice& getSliceInfo(size_t index) const { return slices.at(index); }
+
+    // the slice as a view on the parent buffer, owned by the MachOFatBinary; NULL if no such slice
+    BufferView* getSlice(size_t index) const;
+
+    // the first slice for the given CPU type (CPU_TYPE_*), or NOT_FOUND
+    size_t findSlice(int32_t cpuType) const;
+
+    // the slice that is wrapped by default: the first 64-bit one, if any
+    size_t getPreferredSlice() const;
+
+protected:
+    // reads the table; returns the number of the valid slices
+    static size_t readSlices(AbstractByteBuffer *buf, std::vector<MachOFatSlice> &slices, bool &isFat64);
+
+    AbstractByteBuffer *buf;
+    bool isFat64;
+    std::vector<MachOFatSlice> slices;
+    std::vector<BufferView*> views;
+
+private:
+    MachOFatBinary(const MachOFatBinary&);
+    MachOFatBinary& operator=(const MachOFatBinary&);
+};
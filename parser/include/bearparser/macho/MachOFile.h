@@ -0,0 +1,145 @@
+#pragma once
+
+#include "macho_formats.h"
+#include "MachOFatBinary.h"
+
+#include "MachOHdrWrapper.h"
+#include "MachOLoadCmdsWrapper.h"
+#include "MachOSegmentsWrapper.h"
+#include "MachOSectionsWrapper.h"
+
+#include "../MappedExe.h"
+
+#include <string>
+#include <vector>
+
+class MachOFileBuilder: public ExeBuilder {
+public:
+    MachOFileBuilder() : ExeBuilder() {}
+    virtual bool signatureMatches(AbstractByteBuffer *buf);
+    virtual Executable* build(AbstractByteBuffer *buf);
+    QString typeName() { return "Mach-O"; }
+    std::vector<QByteArray> magics();
+};
+
+//-------------------------------------------------------------
+
+struct MachOLoadCommand
+{
+    offset_t raw;
+    uint32_t cmd;       // LC_*
+    uint32_t cmdSize;
+};
+
+struct MachOSegment
+{
+    offset_t cmdRaw;    // the raw offset of LC_SEGMENT/LC_SEGMENT_64
+    std::string name;
+    uint64_t vmAddr;
+    uint64_t vmSize;
+    uint64_t fileOffset;
+    uint64_t fileSize;
+    size_t firstSection; // the index in MachOFile::getSections()
+    size_t sectionsCount;
+};
+
+struct MachOSection
+{
+    offset_t hdrRaw;    // the raw offset of section/section_64
+    size_t segment;     // the index in MachOFile::getSegments()
+    std::string segmentName;
+    std::string name;
+    uint64_t addr;
+    uint64_t size;
+    uint32_t offset;
+    uint32_t flags;
+};
+
+// a segment projected into one of the address spaces, used for the address translation
+struct MachOMappedRange
+{
+    offset_t start;         // the start in the source address space
+    bufsize_t size;         // the size in the source address space
+    offset_t mapped;        // the start in the target address space
+    bufsize_t mappedSize;   // how much of the range (from its start) has a counterpart in the target address space
+};
+
+/*
+Thin Mach-O, little endian (x86, x86-64, ARM, ARM64).
+Built on a fat binary, it wraps one of its slices (zero-copy): the raw offsets are then relative to the slice.
+*/
+class MachOFile : public MappedExe
+{
+public:
+    enum WRAPPERS {
+        WR_NONE = MappedExe::WR_NONE,
+        WR_MACHO_HDR = 0,
+        WR_LOAD_CMDS,
+        WR_SEGMENTS,
+        WR_SECTIONS,
+        COUNT_WRAPPERS
+    };
+
+    static const size_t NOT_FOUND = size_t(-1);
+    static const size_t PREFERRED_SLICE = size_t(-1);
+
+    // the buffer may be a thin Mach-O or a fat binary; sliceIndex selects the slice of the fat binary
+    MachOFile(AbstractByteBuffer *v_buf, size_t sliceIndex = PREFERRED_SLICE); //throws ExeException
+    virtual ~MachOFile();
+
+    virtual void wrap();
+
+    virtual bufsize_t getMappedSize(Executable::addr_type aType);
+    virtual bufsize_t getAlignment(Executable::addr_type aType) const;
+    virtual offset_t getImageBase(bool recalculate = false) { return imageBase; }
+    virtual offset_t getEntryPoint(Executable::addr_type addrType = Executable::RVA); // returns INVALID_ADDR if failed
+
+    virtual offset_t rawToRva(offset_t raw) { return translateAddr(rawRanges, raw); }
+    virtual offset_t rvaToRaw(offset_t rva) { return translateAddr(rvaRanges, rva); }
+
+    virtual exe_arch getArch();
+
+    //---
+    // MachOFile only:
+    int32_t machoCpuType() const { return cpuType; }
+    uint32_t machoFileType() const { return fileType; }
+    bufsize_t machoHdrSize() const { return bitMode == Executable::BITS_64 ? sizeof(macho::mach_header_64) : sizeof(macho::mach_header); }
+
+    // the fat binary that contains the wrapped slice; NULL if the file is thin
+    MachOFatBinary* getFatBinary() { return fat; }
+    size_t getSliceIndex() const { return sliceIndex; }
+
+    const std::vector<MachOLoadCommand>& getLoadCommands() const { return loadCommands; }
+    size_t findLoadCommand(uint32_t cmd) const; // the first one; NOT_FOUND if none
+
+    const std::vector<MachOSegment>& getSegments() const { return segments; }
+    const std::vector<MachOSection>& getSections() const { return sections; }
+    size_t findSegment(const std::string &name) const;
+    size_t findSection(const std::string &segmentName, const std::string &name) const;
+
+protected:
+    static offset_t translateAddr(const std::vector<MachOMappedRange> &ranges, offset_t addr);
+
+    void parseLoadCommands();
+    void parseSegment(const MachOLoadCommand &command);
+    void buildSegmentsMap();
+    offset_t readThreadEntryPoint(const MachOLoadCommand &command); // VA
+
+    virtual void clearWrappers();
+
+    MachOFatBinary *fat;
+    size_t sliceIndex;
+
+    int32_t cpuType;
+    uint32_t fileType;
+    offset_t imageBase;
+    bufsize_t loadedSize;
+
+    std::vector<MachOLoadCommand> loadCommands;
+    std::vector<MachOSegment> segments;
+    std::vector<MachOSection> sections;
+
+    // sorted by the start
+    std::vector<MachOMappedRange> rvaRanges;
+    std::vector<MachOMappedRange> rawRanges;
+};
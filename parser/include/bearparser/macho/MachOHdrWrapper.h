@@ -0,0 +1,39 @@
+#pragma once
+
+#include "macho/MachONodeWrapper.h"
+#include "macho/macho_formats.h"
+
+class MachOFile; // forward declaration
+
+// mach_header or mach_header_64, at the start of the (thin) file
+class MachOHdrWrapper : public MachOElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        MAGIC = 0,
+        CPU_TYPE,
+        CPU_SUBTYPE,
+        FILE_TYPE,
+        NCMDS,
+        SIZEOF_CMDS,
+        FLAGS,
+        RESERVED, // 64-bit only
+        FIELD_COUNTER
+    };
+
+    static QString translateCpuType(int32_t cpuType);
+    static QString translateFileType(uint32_t fileType);
+
+    MachOHdrWrapper(MachOFile *machoExe) : MachOElementWrapper(machoExe) {}
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize();
+    virtual QString getName() { return "Mach-O Hdr"; }
+
+    virtual size_t getFieldsCount() { return isBit64() ? FIELD_COUNTER : RESERVED; }
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    virtual QString translateFieldContent(size_t fieldId);
+};
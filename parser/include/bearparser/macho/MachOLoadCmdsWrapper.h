@@ -0,0 +1,38 @@
+#pragma once
+
+#include "macho/MachONodeWrapper.h"
+#include "macho/macho_formats.h"
+
+#include <unordered_map>
+
+class MachOFile; // forward declaration
+
+/*
+The load commands, following the Mach-O header: each starts with the command type and its size.
+The fields describe a single command, selected by the subField (the command index, 0 by default).
+*/
+class MachOLoadCmdsWrapper : public MachOElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        CMD = 0,
+        CMD_SIZE,
+        FIELD_COUNTER
+    };
+
+    static const std::unordered_map<uint32_t, QString> s_commands;
+    static QString translateCommand(uint32_t cmd);
+
+    MachOLoadCmdsWrapper(MachOFile *machoExe) : MachOElementWrapper(machoExe) {}
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize();
+    virtual QString getName() { return "Mach-O Load Commands"; }
+
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual size_t getSubFieldsCount();
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+};
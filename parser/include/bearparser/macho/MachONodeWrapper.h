@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../ExeNodeWrapper.h"
+
+class MachOFile;
+
+class MachOElementWrapper : public ExeElementWrapper
+{
+public:
+    MachOElementWrapper(MachOFile* macho);
+    virtual ~MachOElementWrapper() {}
+
+    MachOFile *getMachO() { return m_MachO; }
+
+protected:
+    MachOFile *m_MachO;
+
+friend class MachOFile;
+};
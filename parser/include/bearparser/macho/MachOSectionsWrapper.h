@@ -0,0 +1,49 @@
+#pragma once
+
+#include "macho/MachONodeWrapper.h"
+#include "macho/macho_formats.h"
+
+class MachOFile; // forward declaration
+
+/*
+The section headers of all the segments, in the order of the segments.
+The fields describe a single section, selected by the subField (the index in MachOFile::getSections(), 0 by default).
+*/
+class MachOSectionsWrapper : public MachOElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        SECT_NAME = 0,
+        SEG_NAME,
+        ADDR,
+        SIZE,
+        OFFSET,
+        ALIGN,
+        REL_OFFSET,
+        NRELOC,
+        FLAGS,
+        RESERVED1,
+        RESERVED2,
+        RESERVED3, // 64-bit only
+        FIELD_COUNTER
+    };
+
+    MachOSectionsWrapper(MachOFile *machoExe) : MachOElementWrapper(machoExe) {}
+
+    // the whole load commands area: the section headers are within the segment commands
+    virtual void* getPtr();
+    virtual bufsize_t getSize();
+    virtual QString getName() { return "Mach-O Sections"; }
+
+    virtual size_t getFieldsCount() { return isBit64() ? FIELD_COUNTER : RESERVED3; }
+    virtual size_t getSubFieldsCount();
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual WrappedValue::data_type containsDataType(size_t fieldId, size_t subField = FIELD_NONE);
+
+protected:
+    bool is64(size_t index);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "macho/MachONodeWrapper.h"
+#include "macho/macho_formats.h"
+
+class MachOFile; // forward declaration
+
+/*
+The segment commands (LC_SEGMENT, LC_SEGMENT_64).
+The fields describe a single segment, selected by the subField (the segment index, 0 by default).
+*/
+class MachOSegmentsWrapper : public MachOElementWrapper
+{
+public:
+    enum FieldID {
+        NONE = FIELD_NONE,
+        SEG_NAME = 0,
+        VM_ADDR,
+        VM_SIZE,
+        FILE_OFFSET,
+        FILE_SIZE,
+        MAX_PROT,
+        INIT_PROT,
+        NSECTS,
+        FLAGS,
+        FIELD_COUNTER
+    };
+
+    MachOSegmentsWrapper(MachOFile *machoExe) : MachOElementWrapper(machoExe) {}
+
+    // the whole load commands area: the segments are interleaved with the other commands
+    virtual void* getPtr();
+    virtual bufsize_t getSize();
+    virtual QString getName() { return "Mach-O Segments"; }
+
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual size_t getSubFieldsCount();
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual QString getFieldName(size_t fieldId);
+    virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual WrappedValue::data_type containsDataType(size_t fieldId, size_t subField = FIELD_NONE);
+
+protected:
+    bool is64(size_t index);
+};
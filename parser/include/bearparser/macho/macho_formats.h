@@ -0,0 +1,251 @@
+#pragma once
+
+#include <stdint.h>
+
+// Mach-O structures and constants (<mach-o/loader.h>, <mach-o/fat.h>), defined here as they are not available outside of macOS.
+// The structures are in the namespace, so that they don't clash with the system headers if those are included as well.
+
+#ifndef MH_MAGIC
+#define MH_MAGIC        0xFEEDFACE
+#define MH_CIGAM        0xCEFAEDFE
+#define MH_MAGIC_64     0xFEEDFACF
+#define MH_CIGAM_64     0xCFFAEDFE
+#endif
+
+#ifndef FAT_MAGIC
+#define FAT_MAGIC       0xCAFEBABE
+#define FAT_CIGAM       0xBEBAFECA
+#endif
+#ifndef FAT_MAGIC_64
+#define FAT_MAGIC_64    0xCAFEBABF
+#define FAT_CIGAM_64    0xBFBAFECA
+#endif
+
+// file types
+#ifndef MH_OBJECT
+#define MH_OBJECT       0x1
+#define MH_EXECUTE      0x2
+#define MH_FVMLIB       0x3
+#define MH_CORE         0x4
+#define MH_PRELOAD      0x5
+#define MH_DYLIB        0x6
+#define MH_DYLINKER     0x7
+#define MH_BUNDLE       0x8
+#define MH_DYLIB_STUB   0x9
+#define MH_DSYM         0xA
+#define MH_KEXT_BUNDLE  0xB
+#endif
+#ifndef MH_FILESET
+#define MH_FILESET      0xC
+#endif
+
+// CPU types
+#ifndef CPU_ARCH_ABI64
+#define CPU_ARCH_ABI64      0x01000000
+#define CPU_ARCH_ABI64_32   0x02000000
+#endif
+#ifndef CPU_TYPE_X86
+#define CPU_TYPE_VAX        1
+#define CPU_TYPE_MC680x0    6
+#define CPU_TYPE_X86        7
+#define CPU_TYPE_I386       CPU_TYPE_X86
+#define CPU_TYPE_X86_64     (CPU_TYPE_X86 | CPU_ARCH_ABI64)
+#define CPU_TYPE_MC98000    10
+#define CPU_TYPE_HPPA       11
+#define CPU_TYPE_ARM        12
+#define CPU_TYPE_ARM64      (CPU_TYPE_ARM | CPU_ARCH_ABI64)
+#define CPU_TYPE_ARM64_32   (CPU_TYPE_ARM | CPU_ARCH_ABI64_32)
+#define CPU_TYPE_MC88000    13
+#define CPU_TYPE_SPARC      14
+#define CPU_TYPE_I860       15
+#define CPU_TYPE_POWERPC    18
+#define CPU_TYPE_POWERPC64  (CPU_TYPE_POWERPC | CPU_ARCH_ABI64)
+#endif
+
+// load commands
+#ifndef LC_SEGMENT
+#define LC_REQ_DYLD                 0x80000000
+#define LC_SEGMENT                  0x1
+#define LC_SYMTAB                   0x2
+#define LC_SYMSEG                   0x3
+#define LC_THREAD                   0x4
+#define LC_UNIXTHREAD               0x5
+#define LC_DYSYMTAB                 0xB
+#define LC_LOAD_DYLIB               0xC
+#define LC_ID_DYLIB                 0xD
+#define LC_LOAD_DYLINKER            0xE
+#define LC_ID_DYLINKER              0xF
+#define LC_PREBOUND_DYLIB           0x10
+#define LC_ROUTINES                 0x11
+#define LC_SUB_FRAMEWORK            0x12
+#define LC_SUB_UMBRELLA             0x13
+#define LC_SUB_CLIENT               0x14
+#define LC_SUB_LIBRARY              0x15
+#define LC_TWOLEVEL_HINTS           0x16
+#define LC_PREBIND_CKSUM            0x17
+#define LC_LOAD_WEAK_DYLIB          (0x18 | LC_REQ_DYLD)
+#define LC_SEGMENT_64               0x19
+#define LC_ROUTINES_64              0x1A
+#define LC_UUID                     0x1B
+#define LC_RPATH                    (0x1C | LC_REQ_DYLD)
+#define LC_CODE_SIGNATURE           0x1D
+#define LC_SEGMENT_SPLIT_INFO       0x1E
+#define LC_REEXPORT_DYLIB           (0x1F | LC_REQ_DYLD)
+#define LC_LAZY_LOAD_DYLIB          0x20
+#define LC_ENCRYPTION_INFO          0x21
+#define LC_DYLD_INFO                0x22
+#define LC_DYLD_INFO_ONLY           (0x22 | LC_REQ_DYLD)
+#define LC_LOAD_UPWARD_DYLIB        (0x23 | LC_REQ_DYLD)
+#define LC_VERSION_MIN_MACOSX       0x24
+#define LC_VERSION_MIN_IPHONEOS     0x25
+#define LC_FUNCTION_STARTS          0x26
+#define LC_DYLD_ENVIRONMENT         0x27
+#define LC_MAIN                     (0x28 | LC_REQ_DYLD)
+#define LC_DATA_IN_CODE             0x29
+#define LC_SOURCE_VERSION           0x2A
+#define LC_DYLIB_CODE_SIGN_DRS      0x2B
+#define LC_ENCRYPTION_INFO_64       0x2C
+#define LC_LINKER_OPTION            0x2D
+#define LC_LINKER_OPTIMIZATION_HINT 0x2E
+#define LC_VERSION_MIN_TVOS         0x2F
+#define LC_VERSION_MIN_WATCHOS      0x30
+#define LC_NOTE                     0x31
+#define LC_BUILD_VERSION            0x32
+#endif
+#ifndef LC_DYLD_EXPORTS_TRIE
+#define LC_DYLD_EXPORTS_TRIE        (0x33 | LC_REQ_DYLD)
+#define LC_DYLD_CHAINED_FIXUPS      (0x34 | LC_REQ_DYLD)
+#endif
+#ifndef LC_FILESET_ENTRY
+#define LC_FILESET_ENTRY            (0x35 | LC_REQ_DYLD)
+#endif
+
+// the flavors of the thread states in LC_UNIXTHREAD (they depend on the CPU type)
+#define MACHO_x86_THREAD_STATE32    1
+#define MACHO_x86_THREAD_STATE64    4
+#define MACHO_ARM_THREAD_STATE      1
+#define MACHO_ARM_THREAD_STATE64    6
+
+namespace macho {
+
+    struct mach_header {
+        uint32_t magic;
+        int32_t  cputype;
+        int32_t  cpusubtype;
+        uint32_t filetype;
+        uint32_t ncmds;
+        uint32_t sizeofcmds;
+        uint32_t flags;
+    };
+
+    struct mach_header_64 {
+        uint32_t magic;
+        int32_t  cputype;
+        int32_t  cpusubtype;
+        uint32_t filetype;
+        uint32_t ncmds;
+        uint32_t sizeofcmds;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+
+    struct load_command {
+        uint32_t cmd;
+        uint32_t cmdsize;
+    };
+
+    struct segment_command {
+        uint32_t cmd;
+        uint32_t cmdsize;
+        char     segname[16];
+        uint32_t vmaddr;
+        uint32_t vmsize;
+        uint32_t fileoff;
+        uint32_t filesize;
+        int32_t  maxprot;
+        int32_t  initprot;
+        uint32_t nsects;
+        uint32_t flags;
+    };
+
+    struct segment_command_64 {
+        uint32_t cmd;
+        uint32_t cmdsize;
+        char     segname[16];
+        uint64_t vmaddr;
+        uint64_t vmsize;
+        uint64_t fileoff;
+        uint64_t filesize;
+        int32_t  maxprot;
+        int32_t  initprot;
+        uint32_t nsects;
+        uint32_t flags;
+    };
+
+    struct section {
+        char     sectname[16];
+        char     segname[16];
+        uint32_t addr;
+        uint32_t size;
+        uint32_t offset;
+        uint32_t align;
+        uint32_t reloff;
+        uint32_t nreloc;
+        uint32_t flags;
+        uint32_t reserved1;
+        uint32_t reserved2;
+    };
+
+    struct section_64 {
+        char     sectname[16];
+        char     segname[16];
+        uint64_t addr;
+        uint64_t size;
+        uint32_t offset;
+        uint32_t align;
+        uint32_t reloff;
+        uint32_t nreloc;
+        uint32_t flags;
+        uint32_t reserved1;
+        uint32_t reserved2;
+        uint32_t reserved3;
+    };
+
+    struct entry_point_command {
+        uint32_t cmd;       // LC_MAIN
+        uint32_t cmdsize;
+        uint64_t entryoff;  // the file offset of main()
+        uint64_t stacksize;
+    };
+
+    struct thread_command {
+        uint32_t cmd;       // LC_THREAD or LC_UNIXTHREAD
+        uint32_t cmdsize;
+        // followed by: uint32_t flavor, uint32_t count (in uint32_t), and the state
+    };
+
+    // the fat headers are big endian
+
+    struct fat_header {
+        uint32_t magic;
+        uint32_t nfat_arch;
+    };
+
+    struct fat_arch {
+        int32_t  cputype;
+        int32_t  cpusubtype;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t align;
+    };
+
+    struct fat_arch_64 {
+        int32_t  cputype;
+        int32_t  cpusubtype;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t align;
+        uint32_t reserved;
+    };
+
+}; //namespace macho
@@ -5,6 +5,10 @@
 #include <bearparser/win_hdrs/win_types.h>
 //supported formats:
 #include <bearparser/pe/PEFile.h>
+#include <bearparser/pe/AuthenticodeHasher.h>
+#include <bearparser/pe/StrongNameHasher.h>
+#include <bearparser/pe/ResourceIndex.h>
+#include <bearparser/pe/ResourceExtractor.h>
 #include <bearparser/pe/rsrc/pe_rsrc.h>
 
 #endif //BEARPARSER_PEFILE_H
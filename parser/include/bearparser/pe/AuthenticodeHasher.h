@@ -0,0 +1,42 @@
+#pragma once
+
+#include "PEFile.h"
+#include <vector>
+
+struct DigestRange
+{
+    DigestRange(offset_t v_offset = 0, bufsize_t v_size = 0, bool v_zeroed = false)
+        : offset(v_offset), size(v_size), zeroed(v_zeroed) {}
+
+    offset_t offset; // raw
+    bufsize_t size;
+    bool zeroed; // hashed as zeros, as if the field was cleared
+};
+
+/*
+Authenticode digest: the hash of the file content excluding the checksum,
+the Security entry of the Data Directory and the certificate table itself.
+The ranges are hashed directly from the file buffer (no copies).
+*/
+class AuthenticodeHasher
+{
+public:
+    // the raw ranges covered by the digest, in the order of hashing
+    static bool getDigestRanges(PEFile *pe, std::vector<DigestRange> &ranges);
+
+    // hashes the ranges in the given order; returns an empty array if failed
+    static QByteArray hashRanges(PEFile *pe, const std::vector<DigestRange> &ranges, QCryptographicHash::Algorithm algo);
+
+    // returns an empty array if failed
+    static QByteArray computeDigest(PEFile *pe, QCryptographicHash::Algorithm algo = QCryptographicHash::Sha256);
+
+    // computes the digests of several files in parallel (each file by a single thread),
+    // the results are stored at the indexes of the corresponding files; returns the number of the computed digests
+    static size_t computeDigests(const std::vector<PEFile*> &pes, QCryptographicHash::Algorithm algo,
+        std::vector<QByteArray> &digests, size_t threads = 0);
+
+protected:
+    static constexpr bufsize_t MAX_HASHED_CHUNK = 0x10000000;
+
+    static bool addExcluded(PEFile *pe, std::vector<DigestRange> &excluded);
+};
@@ -1,7 +1,20 @@
 #pragma once
 
 #include "DataDirEntryWrapper.h"
+#include "ClrMetadata.h"
 #include <set>
+#include <string_view>
+#include <vector>
+
+// a manifest resource of the assembly (ECMA-335 II.22.24)
+struct ClrManagedResource
+{
+    std::string_view name;      // points into the #Strings heap
+    DWORD flags;                // ManifestResourceAttributes: 1 = public, 2 = private
+    uint32_t implementation;    // CI_IMPLEMENTATION: the File or AssemblyRef that contains it; 0 if embedded
+    offset_t raw;               // the payload (after its length) in the Resources blob; INVALID_ADDR if not embedded or invalid
+    bufsize_t size;
+};
 
 class ClrDirWrapper : public DataDirEntryWrapper
 {
@@ -35,7 +48,7 @@ public:
     static std::set<DWORD> getFlagsSet(DWORD flags);
 //---
     ClrDirWrapper(PEFile *pe)
-        : DataDirEntryWrapper(pe, pe::DIR_COM_DESCRIPTOR) { wrap(); }
+        : DataDirEntryWrapper(pe, pe::DIR_COM_DESCRIPTOR), metadata(NULL) { wrap(); }
 
     ~ClrDirWrapper() { clear(); }
 
@@ -52,10 +65,23 @@ public:
     virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE);
     
     QString translateFieldContent(size_t fieldId);
-    
+
+    // the metadata pointed by MetaData; NULL if it is invalid
+    ClrMetadata* getMetadata() { return metadata; }
+
+    // the manifest resources; the payloads are located, not copied
+    size_t getManagedResources(std::vector<ClrManagedResource> &resources);
+    // a view on the payload of the embedded resource, to be deleted by the caller; NULL if not embedded
+    BufferView* createResourceView(const ClrManagedResource &resource);
+
+    // the hash of the region signed by the strong name (see: StrongNameHasher), with the algorithm of the public key
+    QByteArray computeStrongNameHash();
+
 private:
     pe::IMAGE_COR20_HEADER* clrDir();
 
-    void clear() {}
+    void clear() { delete metadata; metadata = NULL; }
+
+    ClrMetadata *metadata;
 };
 
@@ -0,0 +1,294 @@
+#pragma once
+
+#include "../Executable.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <QString>
+
+/*
+.NET metadata (ECMA-335, II.24): the metadata root, its streams and the tables of the "#~" (or "#-") stream.
+Refers to the image in place: the tables are fixed-stride views, their row sizes are computed once from the heap sizes and the row counts.
+Nothing is allocated per row; the returned views are valid as long as the content of the image is.
+The rows are addressed by their RIDs (1-based), as in the index columns of the tables; RID 0 is the null reference.
+*/
+
+struct ClrStream
+{
+    std::string name;
+    offset_t offset;    // from the metadata root
+    bufsize_t size;     // clamped to the metadata
+};
+
+struct ClrBlob
+{
+    const BYTE *data;
+    bufsize_t size;
+};
+
+class ClrTable
+{
+public:
+    static const size_t MAX_COLUMNS = 9;
+
+    ClrTable() : data(NULL), rows(0), rowSize(0), columnsCount(0) {}
+
+    bool isValid() const { return data != NULL; }
+    uint32_t getRowsCount() const { return rows; }
+    bufsize_t getRowSize() const { return rowSize; }
+    size_t getColumnsCount() const { return columnsCount; }
+    bufsize_t getColumnSize(size_t column) const { return (column < columnsCount) ? columnSizes[column] : 0; }
+
+    // NULL if the RID is out of the table
+    const BYTE* getRow(uint32_t rid) const
+    {
+        if (rid == 0 || rid > rows) return NULL;
+        return data + static_cast<size_t>(rid - 1) * rowSize;
+    }
+
+    // the value of the column, zero-extended; 0 if out of the table
+    uint32_t getValue(uint32_t rid, size_t column) const
+    {
+        const BYTE *row = getRow(rid);
+        if (!row || column >= columnsCount) return 0;
+
+        const BYTE *ptr = row + columnOffsets[column];
+        if (columnSizes[column] == sizeof(WORD)) {
+            return uint32_t(ptr[0]) | (uint32_t(ptr[1]) << 8);
+        }
+        return uint32_t(ptr[0]) | (uint32_t(ptr[1]) << 8) | (uint32_t(ptr[2]) << 16) | (uint32_t(ptr[3]) << 24);
+    }
+
+protected:
+    const BYTE *data;
+    uint32_t rows;
+    bufsize_t rowSize;
+    size_t columnsCount;
+    BYTE columnOffsets[MAX_COLUMNS];
+    BYTE columnSizes[MAX_COLUMNS];
+
+friend class ClrMetadata;
+};
+
+class ClrMetadata
+{
+public:
+    static const DWORD SIGNATURE = 0x424A5342; // "BSJB"
+    static const size_t NOT_FOUND = size_t(-1);
+
+    enum table_id {
+        TABLE_MODULE = 0x00,
+        TABLE_TYPE_REF,
+        TABLE_TYPE_DEF,
+        TABLE_FIELD_PTR,
+        TABLE_FIELD,
+        TABLE_METHOD_PTR,
+        TABLE_METHOD_DEF,
+        TABLE_PARAM_PTR,
+        TABLE_PARAM,
+        TABLE_INTERFACE_IMPL,
+        TABLE_MEMBER_REF,
+        TABLE_CONSTANT,
+        TABLE_CUSTOM_ATTRIBUTE,
+        TABLE_FIELD_MARSHAL,
+        TABLE_DECL_SECURITY,
+        TABLE_CLASS_LAYOUT,
+        TABLE_FIELD_LAYOUT,
+        TABLE_STANDALONE_SIG,
+        TABLE_EVENT_MAP,
+        TABLE_EVENT_PTR,
+        TABLE_EVENT,
+        TABLE_PROPERTY_MAP,
+        TABLE_PROPERTY_PTR,
+        TABLE_PROPERTY,
+        TABLE_METHOD_SEMANTICS,
+        TABLE_METHOD_IMPL,
+        TABLE_MODULE_REF,
+        TABLE_TYPE_SPEC,
+        TABLE_IMPL_MAP,
+        TABLE_FIELD_RVA,
+        TABLE_ENC_LOG,
+        TABLE_ENC_MAP,
+        TABLE_ASSEMBLY,
+        TABLE_ASSEMBLY_PROCESSOR,
+        TABLE_ASSEMBLY_OS,
+        TABLE_ASSEMBLY_REF,
+        TABLE_ASSEMBLY_REF_PROCESSOR,
+        TABLE_ASSEMBLY_REF_OS,
+        TABLE_FILE,
+        TABLE_EXPORTED_TYPE,
+        TABLE_MANIFEST_RESOURCE,
+        TABLE_NESTED_CLASS,
+        TABLE_GENERIC_PARAM,
+        TABLE_METHOD_SPEC,
+        TABLE_GENERIC_PARAM_CONSTRAINT,
+        TABLES_COUNT
+    };
+
+    enum coded_index {
+        CI_TYPE_DEF_OR_REF = 0,
+        CI_HAS_CONSTANT,
+        CI_HAS_CUSTOM_ATTRIBUTE,
+        CI_HAS_FIELD_MARSHAL,
+        CI_HAS_DECL_SECURITY,
+        CI_MEMBER_REF_PARENT,
+        CI_HAS_SEMANTICS,
+        CI_METHOD_DEF_OR_REF,
+        CI_MEMBER_FORWARDED,
+        CI_IMPLEMENTATION,
+        CI_CUSTOM_ATTRIBUTE_TYPE,
+        CI_RESOLUTION_SCOPE,
+        CI_TYPE_OR_METHOD_DEF,
+        CI_COUNT
+    };
+
+    // the columns of the most used tables:
+    enum TypeDefColumn {
+        TYPEDEF_FLAGS = 0,
+        TYPEDEF_NAME,
+        TYPEDEF_NAMESPACE,
+        TYPEDEF_EXTENDS,
+        TYPEDEF_FIELD_LIST,
+        TYPEDEF_METHOD_LIST
+    };
+
+    enum MethodDefColumn {
+        METHODDEF_RVA = 0,
+        METHODDEF_IMPL_FLAGS,
+        METHODDEF_FLAGS,
+        METHODDEF_NAME,
+        METHODDEF_SIGNATURE,
+        METHODDEF_PARAM_LIST
+    };
+
+    enum MemberRefColumn {
+        MEMBERREF_CLASS = 0,
+        MEMBERREF_NAME,
+        MEMBERREF_SIGNATURE
+    };
+
+    enum AssemblyColumn {
+        ASSEMBLY_HASH_ALG = 0,
+        ASSEMBLY_MAJOR_VER,
+        ASSEMBLY_MINOR_VER,
+        ASSEMBLY_BUILD_NUM,
+        ASSEMBLY_REVISION_NUM,
+        ASSEMBLY_FLAGS,
+        ASSEMBLY_PUBLIC_KEY,
+        ASSEMBLY_NAME,
+        ASSEMBLY_CULTURE
+    };
+
+    enum AssemblyRefColumn {
+        ASSEMBLYREF_MAJOR_VER = 0,
+        ASSEMBLYREF_MINOR_VER,
+        ASSEMBLYREF_BUILD_NUM,
+        ASSEMBLYREF_REVISION_NUM,
+        ASSEMBLYREF_FLAGS,
+        ASSEMBLYREF_PUBLIC_KEY,
+        ASSEMBLYREF_NAME,
+        ASSEMBLYREF_CULTURE,
+        ASSEMBLYREF_HASH_VALUE
+    };
+
+    enum ManifestResourceColumn {
+        MANIFESTRES_OFFSET = 0,     // in the Resources of the CLR header, if embedded
+        MANIFESTRES_FLAGS,
+        MANIFESTRES_NAME,
+        MANIFESTRES_IMPLEMENTATION  // CI_IMPLEMENTATION; 0 if embedded
+    };
+
+    static QString getTableName(table_id table);
+
+    // decodes the value of a coded index column; false if its tag is invalid
+    static bool decodeCodedIndex(coded_index kind, uint32_t value, table_id &table, uint32_t &rid);
+
+    // ECMA-335 II.23.2: the compressed unsigned integer; returns the count of the bytes read, 0 if invalid
+    static bufsize_t readCompressedUInt(const BYTE *ptr, bufsize_t available, uint32_t &value);
+
+    // rva, size: the MetaData entry of IMAGE_COR20_HEADER
+    ClrMetadata(Executable *exe, offset_t rva, bufsize_t size);
+
+    bool isValid() const { return root != NULL; }
+    offset_t getRva() const { return rootRva; }
+    bufsize_t getSize() const { return rootSize; }
+
+    WORD getMajorVersion() const { return majorVersion; }
+    WORD getMinorVersion() const { return minorVersion; }
+    QString getVersionString() const { return versionString; }
+
+    const std::vector<ClrStream>& getStreams() const { return streams; }
+    size_t findStream(const std::string &name) const; // the index of the first one with the name
+
+    // the tables stream is "#-" (uncompressed: with the *Ptr indirection tables) instead of "#~"
+    bool isUncompressed() const { return uncompressed; }
+    BYTE getHeapSizes() const { return heapSizes; }
+    uint64_t getValidMask() const { return validMask; }
+    uint64_t getSortedMask() const { return sortedMask; }
+
+    const ClrTable& getTable(table_id table) const { return tables[(table < TABLES_COUNT) ? table : TABLE_MODULE]; }
+    uint32_t getRowsCount(table_id table) const { return (table < TABLES_COUNT) ? tables[table].getRowsCount() : 0; }
+
+    // heaps:
+    std::string_view getString(uint32_t index) const;   // #Strings
+    QString getUserString(uint32_t index) const;        // #US
+    ClrBlob getBlob(uint32_t index) const;              // #Blob; {NULL, 0} if invalid
+    const BYTE* getGuid(uint32_t index) const;          // #GUID: 16 bytes, 1-based; NULL if invalid
+
+    // TypeDef:
+    std::string_view getTypeName(uint32_t typeRid) const { return getString(tables[TABLE_TYPE_DEF].getValue(typeRid, TYPEDEF_NAME)); }
+    std::string_view getTypeNamespace(uint32_t typeRid) const { return getString(tables[TABLE_TYPE_DEF].getValue(typeRid, TYPEDEF_NAMESPACE)); }
+    std::string getTypeFullName(uint32_t typeRid) const;
+
+    // The methods of the type: the count, and the index of the first one in the method list.
+    // The method list is MethodDef, or MethodPtr if present: see resolveMethod().
+    uint32_t getTypeMethods(uint32_t typeRid, uint32_t &firstIndex) const;
+    // the type that owns the method at the index in the method list; 0 if none
+    uint32_t findMethodOwner(uint32_t methodIndex) const;
+    // the index in the method list to the MethodDef RID
+    uint32_t resolveMethod(uint32_t methodIndex) const;
+
+    // MethodDef:
+    std::string_view getMethodName(uint32_t methodRid) const { return getString(tables[TABLE_METHOD_DEF].getValue(methodRid, METHODDEF_NAME)); }
+    DWORD getMethodRva(uint32_t methodRid) const { return tables[TABLE_METHOD_DEF].getValue(methodRid, METHODDEF_RVA); }
+
+    // MemberRef:
+    std::string_view getMemberRefName(uint32_t memberRid) const { return getString(tables[TABLE_MEMBER_REF].getValue(memberRid, MEMBERREF_NAME)); }
+    bool getMemberRefParent(uint32_t memberRid, table_id &table, uint32_t &rid) const;
+
+    // AssemblyRef:
+    std::string_view getAssemblyRefName(uint32_t assemblyRid) const { return getString(tables[TABLE_ASSEMBLY_REF].getValue(assemblyRid, ASSEMBLYREF_NAME)); }
+    QString getAssemblyRefVersion(uint32_t assemblyRid) const;
+
+protected:
+    bool parseRoot(Executable *exe);
+    bool parseTables();
+
+    // the stream clamped to the metadata; NULL if absent
+    const BYTE* getStream(size_t index, bufsize_t &size) const;
+
+    const BYTE *root;
+    offset_t rootRva;
+    bufsize_t rootSize;
+
+    WORD majorVersion;
+    WORD minorVersion;
+    QString versionString;
+    std::vector<ClrStream> streams;
+
+    const BYTE *stringsHeap;
+    bufsize_t stringsSize;
+    const BYTE *usHeap;
+    bufsize_t usSize;
+    const BYTE *blobHeap;
+    bufsize_t blobSize;
+    const BYTE *guidHeap;
+    bufsize_t guidSize;
+
+    bool uncompressed;
+    BYTE heapSizes;
+    uint64_t validMask;
+    uint64_t sortedMask;
+    ClrTable tables[TABLES_COUNT];
+};
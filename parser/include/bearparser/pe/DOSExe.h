@@ -11,6 +11,7 @@ public:
     virtual bool signatureMatches(AbstractByteBuffer *buf);
     virtual Executable* build(AbstractByteBuffer *buf);
     QString typeName() { return "MZ"; }
+    std::vector<QByteArray> magics() { return { QByteArray("MZ"), QByteArray("ZM") }; }
 };
 
 //-------------------------------------------------------------
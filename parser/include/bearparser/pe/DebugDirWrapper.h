@@ -3,6 +3,43 @@
 #include "DataDirEntryWrapper.h"
 #include "pe_undoc.h"
 
+#include <string>
+#include <vector>
+
+// CodeView record (RSDS or NB10): identifies the PDB on a symbol server
+struct PdbInfo
+{
+    DWORD cvSignature;  // CV_SIGNATURE_RSDS or CV_SIGNATURE_NB10
+    BYTE guid[16];      // RSDS: the GUID, as stored; NB10: the signature in the first 4 bytes
+    DWORD age;
+    std::string path;   // as stored
+
+    // the symbol server ID: the GUID (or the NB10 signature) in upper-case hex, followed by the age
+    QString getId() const;
+    // the file name from the path, lower-cased
+    QString getName() const;
+    // normalized key: "<name>/<ID>"
+    QString getKey() const { return getName() + "/" + getId(); }
+};
+
+// an entry of the POGO record: the contribution of the section (i.e. ".text$mn")
+struct PogoEntry
+{
+    DWORD rva;
+    DWORD size;
+    std::string name;
+};
+
+// the VC_FEATURE record: the counts of the objects
+struct VcFeatureInfo
+{
+    DWORD preVc11;
+    DWORD cCpp;
+    DWORD gs;
+    DWORD sdl;
+    DWORD guardN;
+};
+
 
 class DebugDirWrapper : public DataDirEntryWrapper
 {
@@ -31,6 +68,23 @@ public:
 
     // debug dir only
     bool isRepro();
+
+    /* Fast path: the records are read straight from the Data Directory, without the wrappers
+    (so they work regardless of the wrapping state of the directory).
+    */
+    // the content of the first record of the type; NULL if absent
+    static const BYTE* getRecordData(PEFile *pe, DWORD type, bufsize_t &size);
+
+    static bool getPdbInfo(PEFile *pe, PdbInfo &info);
+    static QString getPdbKey(PEFile *pe); // empty if there is no CodeView record
+
+    // returns the count of the added entries; signature: 'PGI', 'PGU' or 'LTCG'
+    static size_t getPogoEntries(PEFile *pe, std::vector<PogoEntry> &entries, DWORD *signature = NULL);
+    static bool getVcFeature(PEFile *pe, VcFeatureInfo &info);
+    static bool getExDllCharacteristics(PEFile *pe, DWORD &flags);
+    static QString translateExDllCharacteristics(DWORD flags);
+    // the hash stored in the REPRO record; empty if absent (or if only the timestamps hold it)
+    static QByteArray getReproHash(PEFile *pe);
     
 protected:
     bool wrap()
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QtCore>
+#include "../win_hdrs/win_types.h"
+#include "../AbstractByteBuffer.h"
+
+namespace der {
+    enum der_tag {
+        TAG_BOOLEAN = 0x01,
+        TAG_INTEGER = 0x02,
+        TAG_BIT_STRING = 0x03,
+        TAG_OCTET_STRING = 0x04,
+        TAG_NULL = 0x05,
+        TAG_OID = 0x06,
+        TAG_UTF8_STRING = 0x0C,
+        TAG_PRINTABLE_STRING = 0x13,
+        TAG_T61_STRING = 0x14,
+        TAG_IA5_STRING = 0x16,
+        TAG_UTC_TIME = 0x17,
+        TAG_GENERALIZED_TIME = 0x18,
+        TAG_BMP_STRING = 0x1E,
+        TAG_SEQUENCE = 0x30,
+        TAG_SET = 0x31,
+        TAG_CONTEXT_0 = 0xA0, // [0] constructed
+        TAG_CONTEXT_1 = 0xA1, // [1] constructed
+        TAG_CONTEXT_PRIM_0 = 0x80, // [0] primitive
+    };
+
+    // OIDs used by Authenticode: the encoded content of TAG_OID, compared without decoding
+    constexpr BYTE OID_SIGNED_DATA[] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02 };             // 1.2.840.113549.1.7.2
+    constexpr BYTE OID_SPC_INDIRECT_DATA[] = { 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x01, 0x04 };  // 1.3.6.1.4.1.311.2.1.4
+    constexpr BYTE OID_SPC_NESTED_SIGNATURE[] = { 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x04, 0x01 }; // 1.3.6.1.4.1.311.2.4.1
+    constexpr BYTE OID_MESSAGE_DIGEST[] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x09, 0x04 };          // 1.2.840.113549.1.9.4
+    constexpr BYTE OID_SIGNING_TIME[] = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x09, 0x05 };            // 1.2.840.113549.1.9.5
+};
+
+/*
+A node of the DER encoded ASN.1 structure: a view on the buffer, nothing is copied.
+Walking through the tree does not allocate: the children are fetched on demand.
+*/
+class DerNode
+{
+public:
+    // reads the node at the beginning of the given range; returns an invalid node if the encoding is malformed
+    static DerNode read(const BYTE *ptr, const BYTE *limit);
+
+    DerNode() : ptr(NULL), limit(NULL), tag(0), hdrSize(0), contentSize(0) {}
+
+    bool isValid() const { return ptr != NULL; }
+    bool isConstructed() const { return (tag & 0x20) != 0; }
+
+    BYTE getTag() const { return tag; }
+    const BYTE* getPtr() const { return ptr; }
+    const BYTE* getContent() const { return ptr ? (ptr + hdrSize) : NULL; }
+    bufsize_t getContentSize() const { return contentSize; }
+    bufsize_t getSize() const { return hdrSize + contentSize; }
+
+    DerNode firstChild() const;
+    DerNode next() const; // the next sibling, within the same parent
+    DerNode child(size_t index) const;
+    size_t childrenCount() const;
+
+    // the first child having the given tag, starting from the given index
+    DerNode findChild(BYTE childTag, size_t startIndex = 0) const;
+
+    // oid: the encoded content, i.e. der::OID_SIGNED_DATA
+    bool isOid(const BYTE *oid, bufsize_t oidSize) const;
+
+    template <size_t N>
+    bool isOid(const BYTE (&oid)[N]) const { return isOid(oid, static_cast<bufsize_t>(N)); }
+
+protected:
+    const BYTE *ptr;
+    const BYTE *limit; // end of the parent
+    BYTE tag;
+    bufsize_t hdrSize;
+    bufsize_t contentSize;
+};
+
+namespace der_util {
+    QString oidToString(const DerNode &node);
+    QString getOidName(const QString &oid); // returns an empty string if the OID is unknown
+    QString algorithmToString(const DerNode &algId); // AlgorithmIdentifier ::= SEQUENCE { OID, params }
+
+    QString toHex(const DerNode &node);
+    QString stringToText(const DerNode &node);
+    QString timeToText(const DerNode &node);
+    QString nameToText(const DerNode &name); // X.500 Name, i.e. "CN=..., O=..."
+
+    // readable form of any primitive node
+    QString toText(const DerNode &node);
+};
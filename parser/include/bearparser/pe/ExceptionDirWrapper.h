@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DataDirEntryWrapper.h"
+#include "LdConfigDirWrapper.h"
 
 class ExceptionEntryWrapper;
 class ExceptionDirWrapper;
@@ -8,11 +9,24 @@ class ExceptionDirWrapper;
 class ExceptionDirWrapper : public DataDirEntryWrapper
 {
 public:
-    ExceptionDirWrapper(PEFile* pe)
-        : DataDirEntryWrapper(pe, pe::DIR_EXCEPTION), parsedSize(0) { wrap(); }
+    enum RecordFormat {
+        RECORD_NONE = 0,
+        RECORD_INTEL,   // IMAGE_RUNTIME_FUNCTION_ENTRY
+        RECORD_ARM64    // IMAGE_ARM64_RUNTIME_FUNCTION_ENTRY
+    };
+
+    // ldConfig: supplies the code map of a hybrid image (optional)
+    ExceptionDirWrapper(PEFile* pe, LdConfigDirWrapper *ldConfig = NULL)
+        : DataDirEntryWrapper(pe, pe::DIR_EXCEPTION), parsedSize(0), recordFormat(RECORD_NONE), ldConfig(ldConfig) { wrap(); }
 
     bool wrap();
 
+    /* The format of the records: by the Machine, or, in a hybrid image (CHPE, ARM64EC),
+    by the code range of the function described by the first record: the ARM64 code has ARM64 unwind records.
+    */
+    RecordFormat getRecordFormat() const { return recordFormat; }
+    bufsize_t getRecordSize() const;
+
     virtual void* getPtr();
     virtual bufsize_t getSize() { return parsedSize; }
 
@@ -24,7 +38,11 @@ public:
     virtual QString getFieldName(size_t fieldId, size_t subField) { return getSubfieldName(fieldId, subField); }
 
 private:
+    RecordFormat findRecordFormat();
+
     bufsize_t parsedSize;
+    RecordFormat recordFormat;
+    LdConfigDirWrapper *ldConfig;
 
 friend class ExceptionEntryWrapper;
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include "DataDirEntryWrapper.h"
 #include <set>
+#include <vector>
 
 class LdConfigDirWrapper : public DataDirEntryWrapper
 {
@@ -67,11 +68,37 @@ public:
         FIELD_COUNTER //end of LoadConfigDir Win10
     };
 
+    // the tables of the Control Flow Guard, indexed as compact arrays of RVAs
+    enum GuardTable {
+        GUARD_TABLE_FUNCTIONS = 0, // GuardCFFunctionTable: the valid call targets
+        GUARD_TABLE_IAT,           // GuardAddressTakenIatEntryTable
+        GUARD_TABLE_LONG_JUMP,     // GuardLongJumpTargetTable
+        GUARD_TABLE_EH_CONT,       // GuardEHContinuationTable
+        GUARD_TABLES_COUNT
+    };
+
+    // the kind of the code in the range of a hybrid image (CHPE or ARM64EC/ARM64X)
+    enum CodeRangeType {
+        CODE_RANGE_NONE = 0, // not in the code map (or not a hybrid image)
+        CODE_RANGE_ARM64,    // native
+        CODE_RANGE_ARM64EC,  // native, in the emulation compatible ABI
+        CODE_RANGE_AMD64,    // emulated
+        CODE_RANGE_X86       // emulated (CHPE)
+    };
+
+    // an entry of the code map: [start, end)
+    struct CodeRange
+    {
+        DWORD start;
+        DWORD end;
+        CodeRangeType type;
+    };
+
     static std::set<DWORD> getGuardFlagsSet(DWORD flags);
     static QString translateGuardFlag(DWORD flags);
 
     LdConfigDirWrapper(PEFile* pe)
-        : DataDirEntryWrapper(pe, pe::DIR_LOAD_CONFIG) { wrap(); }
+        : DataDirEntryWrapper(pe, pe::DIR_LOAD_CONFIG), extraRfeRva(0), extraRfeSize(0) { wrap(); }
 
     bool wrap();
 
@@ -151,6 +178,36 @@ public:
     QString translateGuardFlagsContent(const QString &delim);
     virtual QString translateFieldContent(size_t fieldId);
 
+    // the RVAs of the table, sorted and unique (the metadata bytes of the entries are skipped)
+    const std::vector<DWORD>& getGuardRvas(GuardTable table) const
+    {
+        return guardRvas[(table < GUARD_TABLES_COUNT) ? table : GUARD_TABLE_FUNCTIONS];
+    }
+
+    bool isInGuardTable(GuardTable table, offset_t rva) const;
+
+    // is the RVA listed in the GuardCFFunctionTable; false if the table is absent
+    bool isValidCallTarget(offset_t rva) const { return isInGuardTable(GUARD_TABLE_FUNCTIONS, rva); }
+
+    // Checks the candidates against the table in a single pass: the candidates don't need to be sorted.
+    // Fills the ones listed in the table (sorted and unique) and returns their count.
+    size_t intersectGuardTable(GuardTable table, const std::vector<offset_t> &candidates, std::vector<offset_t> &listed) const;
+    size_t filterValidCallTargets(const std::vector<offset_t> &candidates, std::vector<offset_t> &valid) const
+    {
+        return intersectGuardTable(GUARD_TABLE_FUNCTIONS, candidates, valid);
+    }
+
+    // the code map of the hybrid metadata (CHPEMetadataPointer), sorted by the start; empty if not a hybrid image
+    const std::vector<CodeRange>& getCodeRanges() const { return codeRanges; }
+    bool isHybrid() const { return !codeRanges.empty(); }
+    CodeRangeType getCodeRangeType(offset_t rva) const;
+    static QString translateCodeRangeType(CodeRangeType type);
+
+    /* The ExtraRFETable of the ARM64EC metadata: the x64 (IMAGE_RUNTIME_FUNCTION_ENTRY) records of the AMD64 ranges,
+    while the Exception directory holds the ARM64 ones. Returns false if the image has none.
+    */
+    bool getExtraRfeTable(offset_t &rva, bufsize_t &size) const;
+
 protected:
     virtual void clear();
     void* firstSubEntryPtr(size_t parentId);
@@ -169,6 +226,8 @@ private:
     static offset_t  _getFieldDelta(bool is32b, size_t fId);
     
     bool wrapSubentriesTable(size_t parentFieldId, size_t counterFieldId);
+    bool indexGuardTable(GuardTable table, size_t parentFieldId, size_t counterFieldId);
+    bool wrapCodeRanges();
     
     // get the size of the structure
     inline bufsize_t getLdConfigDirSize();
@@ -188,6 +247,10 @@ private:
     } 
     
     std::map<uint32_t, std::vector<ExeNodeWrapper*> > subEntriesMap;
+    std::vector<DWORD> guardRvas[GUARD_TABLES_COUNT];
+    std::vector<CodeRange> codeRanges;
+    DWORD extraRfeRva;
+    DWORD extraRfeSize;
     friend class LdConfigEntryWrapper;
 };
 
@@ -37,6 +37,7 @@ public:
     virtual bool signatureMatches(AbstractByteBuffer *buf);
     virtual Executable* build(AbstractByteBuffer *buf);
     QString typeName() { return "PE"; }
+    std::vector<QByteArray> magics() { return { QByteArray("MZ") }; }
 };
 
 //-------------------------------------------------------------
@@ -57,6 +58,21 @@ public:
         COUNT_WRAPPERS
     };
 
+    // the formats of the overlay recognized by their magic:
+    enum overlay_format {
+        OVL_NONE = 0,   // no overlay
+        OVL_UNKNOWN,
+        OVL_ZIP,
+        OVL_7Z,
+        OVL_RAR,
+        OVL_CAB,
+        OVL_NSIS,
+        OVL_INNO,
+        OVL_FORMATS_COUNT
+    };
+
+    static QString translateOverlayFormat(overlay_format format);
+
     static long computeChecksum(const BYTE *buffer, size_t bufferSize, offset_t checksumOffset);
 
     PEFile(AbstractByteBuffer *v_buf);
@@ -164,6 +180,23 @@ public:
     // mutex protected
     BufferView* createSectionView(size_t secNum);
     //---
+
+/* overlay: the content past the raw end of the last section, without the certificates of Authenticode */
+
+    // the certificates may be in the middle of the overlay: then it is split in the range before and the one after them
+    static const size_t MAX_OVERLAY_RANGES = 2;
+
+    size_t getOverlayRangesCount();
+
+    // the raw range of the overlay, by its index in the order of the offsets; false if there is none
+    bool getOverlayRange(offset_t &offset, bufsize_t &size, size_t rangeIndex = 0);
+
+    // A view on the range of the overlay (no copy is made); NULL if there is none. The caller deletes it.
+    // It covers only what was loaded: see isTruncated() of the buffer.
+    BufferView* getOverlay(size_t rangeIndex = 0);
+
+    // checks only the leading bytes of the overlay
+    overlay_format getOverlayFormat();
     
     // mutex protected
     bool clearContent(SectionHdrWrapper *sec)
@@ -318,6 +351,7 @@ public:
         
         Executable::getAllEntryPoints(entrypoints, aType);
         this->getExportsMap(entrypoints, aType);
+        this->getTlsCallbacksMap(entrypoints, aType);
         
         return entrypoints.size() - initialSize;
     }
@@ -373,6 +407,9 @@ protected:
     SectionHdrWrapper* _getLastSection();
     bool _canAddNewSection();
 
+    // fills the [start, end) of the ranges of the overlay, returns their count
+    size_t findOverlayRanges(offset_t starts[MAX_OVERLAY_RANGES], offset_t ends[MAX_OVERLAY_RANGES]);
+
     offset_t _secHdrsEndOffset()
     {
         const offset_t offset = secHdrsOffset();
@@ -405,6 +442,7 @@ protected:
     BufferView* _createSectionView(SectionHdrWrapper *sec);
     
     size_t getExportsMap(QMap<offset_t,QString> &entrypoints, Executable::addr_type aType = Executable::RVA);
+    size_t getTlsCallbacksMap(QMap<offset_t,QString> &entrypoints, Executable::addr_type aType = Executable::RVA);
 
     virtual void clearWrappers();
 
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ResourceIndex.h"
+
+#include <functional>
+#include <vector>
+#include <QString>
+
+/*
+Bulk extraction of the resources, over the leaves of ResourceIndex (no wrappers are created).
+A payload is streamed as views on the image (no copies), preceded by a header reconstructed on the fly
+for the resources that are stored without it:
+- RT_ICON, RT_CURSOR: a single image .ico / .cur,
+- RT_GROUP_ICON, RT_GROUP_CURSOR: a complete .ico / .cur, with the images referred by the group,
+- RT_BITMAP: a .bmp (the BITMAPFILEHEADER).
+*/
+
+struct ResourcePayload
+{
+    size_t index;           // in the ResourceIndex
+    QString fileName;       // suggested: <index>_<type>_<name>_<lang>.<ext>
+    QByteArray header;      // reconstructed; empty if not needed
+    std::vector<BufferView> parts;
+
+    bufsize_t getSize() const;
+};
+
+class ResourceExtractor
+{
+public:
+    // false: stop the extraction
+    typedef std::function<bool(ResourcePayload &payload)> PayloadCallback;
+
+    static const size_t DEFAULT_QUEUE_DEPTH = 4;
+
+    // the extension of the extracted file, i.e. "ico"; "bin" if the type has no specific format
+    static QString getExtension(DWORD type);
+
+    ResourceExtractor(PEFile *pe);
+
+    const ResourceIndex& getIndex() const { return index; }
+
+    // prepares the payload of the record at the index; false if its content is out of the file
+    bool getPayload(size_t recordIndex, ResourcePayload &payload);
+
+    // streams the payloads to the callback, in the order of the index, from the calling thread; returns the count of the ones given
+    size_t extract(const PayloadCallback &callback);
+
+    // Writes the payloads as files in the directory (created if needed), with at most queueDepth files written at once.
+    // Returns the count of the files written entirely.
+    size_t extractToDir(const QString &dirPath, size_t queueDepth = DEFAULT_QUEUE_DEPTH);
+
+protected:
+    bool makeViews(const ResourceRecord &record, bufsize_t skip, std::vector<BufferView> &parts);
+
+    bool makeImage(const ResourceRecord &record, ResourcePayload &payload);
+    bool makeGroup(const ResourceRecord &record, ResourcePayload &payload);
+    bool makeBitmap(const ResourceRecord &record, ResourcePayload &payload);
+
+    QString makeFileName(size_t recordIndex) const;
+
+    PEFile *pe;
+    ResourceIndex index;
+};
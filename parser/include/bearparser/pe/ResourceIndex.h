@@ -0,0 +1,83 @@
+#pragma once
+
+#include "PEFile.h"
+
+#include <vector>
+#include <QString>
+
+/*
+A flat index of the resource tree: one record per leaf, built in a single iterative pass over the directories
+(without creating the wrappers of the tree, and without the MAX_ENTRIES limit of ResourceDirWrapper).
+The records are sorted by (type, name, lang), so that a lookup is a binary search, and all the resources
+of a type are a continuous range.
+The keys are the Name fields of the directory entries: an ID, or RESOURCE_NAME_IS_STRING with the offset of the name
+(so the named entries follow the ones with IDs, in the order of their offsets).
+*/
+
+struct ResourceRecord
+{
+    DWORD type;
+    DWORD name;
+    DWORD lang;
+    DWORD dataRva;
+    DWORD size;
+    DWORD codepage;
+};
+
+class ResourceIndex
+{
+public:
+    static const size_t NOT_FOUND = size_t(-1);
+    static const DWORD ANY_LANG = DWORD(-1);
+    static const size_t MAX_RECORDS = 0x10000;
+    static const size_t MAX_VISITED_ENTRIES = 4 * MAX_RECORDS; // of all the directories, while building
+
+    static bool isNamed(DWORD key) { return (key & RESOURCE_NAME_IS_STRING) != 0; }
+
+    // the ID of the type, by its name in the form RT_*, i.e. RT_MANIFEST; 0 if unknown
+    static WORD getTypeId(const QString &typeName);
+    // the name in the form RT_*; empty if unknown
+    static QString getTypeName(WORD typeId);
+
+    ResourceIndex(PEFile *pe);
+    ResourceIndex(Executable *exe, offset_t rva); // rva: of the resource directory
+
+    bool isValid() const { return rootRva != INVALID_ADDR; }
+    offset_t getRva() const { return rootRva; }
+
+    size_t count() const { return records.size(); }
+    const std::vector<ResourceRecord>& getRecords() const { return records; }
+    const ResourceRecord* getRecord(size_t index) const { return (index < records.size()) ? &records[index] : NULL; }
+
+    // the index of the record; with ANY_LANG: the first one of the name. NOT_FOUND if none
+    size_t find(DWORD type, DWORD name, DWORD lang = ANY_LANG) const;
+    size_t find(DWORD type, const QString &name, DWORD lang = ANY_LANG) const;
+
+    // The path: type/name[/lang], i.e. "RT_MANIFEST/1/1033" or "24/1".
+    // The IDs are decimal, or hexadecimal with "0x"; anything else is a name. The comparison of the names is case insensitive.
+    size_t findPath(const QString &path) const;
+
+    // the range of the records of the type: [first, last); false if there are none
+    bool getTypeRange(DWORD type, size_t &first, size_t &last) const;
+    std::vector<DWORD> getTypes() const;
+
+    // the string of a named key, or the ID as a decimal number
+    QString getKeyName(DWORD key) const;
+
+    // the content of the resource; NULL if it is out of the image
+    BYTE* getContent(const ResourceRecord &record) const;
+
+protected:
+    void build();
+
+    // in the records of the type; the name: by the string if it is not empty, otherwise by the key
+    size_t findInType(DWORD type, DWORD name, const QString &nameStr, DWORD lang) const;
+    bool keyMatches(DWORD key, const QString &name) const;
+
+    // the content at the offset from the resource directory
+    BYTE* getAt(offset_t offset, bufsize_t size) const;
+
+    Executable *exe;
+    offset_t rootRva;
+    std::vector<ResourceRecord> records;
+};
@@ -3,6 +3,8 @@
 #include "PENodeWrapper.h"
 #include "pe_undoc.h"
 
+#include <vector>
+
 const QString RichHdr_ProdIdToVSversion(WORD prodId);
 const QString RichHdr_translateProdId(WORD prodId);
 
@@ -23,8 +25,16 @@ public:
         FIELD_COUNTER
     };
 
+    static const size_t VS_UNKNOWN = size_t(-1);
+
+    // the index of the Visual Studio release that shipped the tool; VS_UNKNOWN if not known
+    static size_t getVSVersionIndex(WORD prodId);
+    static size_t getVSVersionsCount();
+    static QString getVSVersionName(size_t index);
+
     RichHdrWrapper(PEFile *pe)
-        : PEElementWrapper(pe), richSign(NULL), dansHdr(NULL), compIdCounter(0) { wrap(); }
+        : PEElementWrapper(pe), richSign(NULL), dansHdr(NULL), compIdCounter(0),
+        checksum(0), fingerprint(0) { wrap(); }
 
     size_t compIdCount();
 
@@ -46,10 +56,26 @@ public:
     pe::RICH_COMP_ID getCompId(size_t fieldId);
     DWORD calcChecksum();
 
+    /* computed once, in wrap(): */
+    // the decoded comp IDs, sorted by: prodId, build (CV), count
+    const std::vector<pe::RICH_COMP_ID>& getCompIds() const { return compIds; }
+    // the calculated checksum, and is it the one stored in the header
+    DWORD getChecksum() const { return checksum; }
+    bool isChecksumValid() const { return richSign && checksum == richSign->checksum; }
+    // FNV-1a of the sorted comp IDs with their counts: independent of the order of the entries; 0 if there is no header
+    uint64_t getFingerprint() const { return fingerprint; }
+
+    // the counts of the objects per Visual Studio release (as in getVSVersionIndex), the unknown ones at the end
+    std::vector<DWORD> getToolchainVector() const;
+
 protected:
     pe::RICH_SIGNATURE* richSign;
     pe::RICH_DANS_HEADER* dansHdr;
     size_t compIdCounter;
+
+    std::vector<pe::RICH_COMP_ID> compIds;
+    DWORD checksum;
+    uint64_t fingerprint;
 };
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DataDirEntryWrapper.h"
+#include "SignedDataWrapper.h"
 
 /*
 typedef struct WIN_CERTIFICATE {
@@ -25,7 +26,7 @@ public:
     };
 
     SecurityDirWrapper(PEFile * pe)
-        : DataDirEntryWrapper(pe, pe::DIR_SECURITY), sizeOk(false)
+        : DataDirEntryWrapper(pe, pe::DIR_SECURITY), sizeOk(false), signedData(NULL)
     {
         wrap();
     }
@@ -48,9 +49,16 @@ public:
     QString translateType(int type);
     virtual QString translateFieldContent(size_t fieldId);
 
+    // Authenticode digest of the whole file (see: AuthenticodeHasher)
+    QByteArray computeDigest(QCryptographicHash::Algorithm algo = QCryptographicHash::Sha256);
+
+    // parsed PKCS#7 content of the certificate (if its type is PKCS_SIGNED_DATA)
+    SignedDataWrapper* getSignedData() { return signedData; }
+
 private:
     pe::WIN_CERTIFICATE* getCert();
-    void clear() {}
+    void clear() { delete signedData; signedData = NULL; }
 
     bool sizeOk;
+    SignedDataWrapper *signedData;
 };
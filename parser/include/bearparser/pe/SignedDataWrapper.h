@@ -0,0 +1,170 @@
+#pragma once
+
+#include "PENodeWrapper.h"
+#include "DerReader.h"
+
+/*
+Authenticode signature: PKCS#7 SignedData stored in the bCertificate of WIN_CERTIFICATE.
+The wrappers refer to the DER nodes in place; the fields are full nodes (tag, length and content).
+
+ContentInfo ::= SEQUENCE { contentType OID, content [0] EXPLICIT SignedData }
+SignedData ::= SEQUENCE {
+    version INTEGER,
+    digestAlgorithms SET OF AlgorithmIdentifier,
+    contentInfo SEQUENCE { contentType OID, content [0] EXPLICIT SpcIndirectDataContent },
+    certificates [0] IMPLICIT SET OF Certificate OPTIONAL,
+    crls [1] IMPLICIT OPTIONAL,
+    signerInfos SET OF SignerInfo
+}
+SpcIndirectDataContent ::= SEQUENCE { data SpcAttributeTypeAndOptionalValue, messageDigest DigestInfo }
+*/
+
+class DerElementWrapper : public ExeNodeWrapper
+{
+public:
+    DerElementWrapper(Executable *exe, ExeNodeWrapper *parent, size_t entryNumber, const DerNode &v_node, size_t fieldsCount);
+
+    virtual void* getPtr();
+    virtual bufsize_t getSize() { return size; }
+
+    virtual void* getFieldPtr(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual bufsize_t getFieldSize(size_t fieldId, size_t subField = FIELD_NONE);
+    virtual WrappedValue::data_type containsDataType(size_t fieldId, size_t subField = FIELD_NONE) { return WrappedValue::COMPLEX; }
+    virtual QString translateFieldContent(size_t fieldId);
+
+    DerNode getNode();
+    DerNode getFieldNode(size_t fieldId);
+
+protected:
+    void setField(size_t fieldId, const DerNode &fieldNode);
+
+    offset_t offset; // raw
+    bufsize_t size;
+    std::vector<offset_t> fieldOffsets;
+    std::vector<bufsize_t> fieldSizes;
+};
+
+//----
+
+class CertificateWrapper : public DerElementWrapper
+{
+public:
+    enum CertificateFID {
+        NONE = FIELD_NONE,
+        SERIAL = 0,
+        SIGN_ALGO,
+        ISSUER,
+        NOT_BEFORE,
+        NOT_AFTER,
+        SUBJECT,
+        PUBKEY_ALGO,
+        FIELD_COUNTER
+    };
+
+    CertificateWrapper(Executable *exe, ExeNodeWrapper *parent, size_t entryNumber, const DerNode &v_node)
+        : DerElementWrapper(exe, parent, entryNumber, v_node, FIELD_COUNTER)
+    {
+        wrap();
+    }
+
+    bool wrap();
+
+    virtual QString getName() { return "Certificate"; }
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual QString getFieldName(size_t fieldId);
+    virtual QString translateFieldContent(size_t fieldId);
+};
+
+//----
+
+class SignerInfoWrapper : public DerElementWrapper
+{
+public:
+    enum SignerInfoFID {
+        NONE = FIELD_NONE,
+        VERSION = 0,
+        ISSUER,
+        SERIAL,
+        DIGEST_ALGO,
+        MESSAGE_DIGEST,
+        SIGNING_TIME,
+        ENC_ALGO,
+        ENC_DIGEST,
+        FIELD_COUNTER
+    };
+
+    SignerInfoWrapper(Executable *exe, ExeNodeWrapper *parent, size_t entryNumber, const DerNode &v_node)
+        : DerElementWrapper(exe, parent, entryNumber, v_node, FIELD_COUNTER)
+    {
+        wrap();
+    }
+
+    bool wrap();
+
+    virtual QString getName() { return "Signer Info"; }
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual QString getFieldName(size_t fieldId);
+    virtual QString translateFieldContent(size_t fieldId);
+
+    // ContentInfo nodes of the signatures nested in the unauthenticated attributes
+    size_t getNestedSignatures(std::vector<DerNode> &nested);
+
+protected:
+    DerNode getAttributeValue(const DerNode &attributes, const BYTE *oid, bufsize_t oidSize);
+};
+
+//----
+
+class SignedDataWrapper : public DerElementWrapper
+{
+public:
+    enum SignedDataFID {
+        NONE = FIELD_NONE,
+        CONTENT_TYPE = 0,
+        VERSION,
+        DIGEST_ALGOS,
+        SIGNED_CONTENT_TYPE,
+        IMAGE_DIGEST_ALGO,
+        IMAGE_DIGEST,
+        FIELD_COUNTER
+    };
+
+    static const size_t MAX_NESTING = 8;
+
+    // node: the ContentInfo
+    SignedDataWrapper(Executable *exe, ExeNodeWrapper *parent, size_t entryNumber, const DerNode &v_node, size_t v_nestingLevel = 0)
+        : DerElementWrapper(exe, parent, entryNumber, v_node, FIELD_COUNTER), nestingLevel(v_nestingLevel)
+    {
+        wrap();
+    }
+
+    virtual ~SignedDataWrapper() { clear(); }
+
+    bool wrap();
+
+    virtual QString getName() { return nestingLevel ? "Nested Signature" : "Signature"; }
+    virtual size_t getFieldsCount() { return FIELD_COUNTER; }
+    virtual QString getFieldName(size_t fieldId);
+    virtual QString translateFieldContent(size_t fieldId);
+
+    // the digest of the image embedded by the signer (to be compared with the Authenticode digest)
+    QByteArray getImageDigest();
+    QString getImageDigestAlgo() { return translateFieldContent(IMAGE_DIGEST_ALGO); }
+
+    size_t getCertificatesCount() { return certificates.size(); }
+    CertificateWrapper* getCertificate(size_t index) { return (index < certificates.size()) ? certificates[index] : NULL; }
+
+    size_t getSignersCount() { return signers.size(); }
+    SignerInfoWrapper* getSigner(size_t index) { return (index < signers.size()) ? signers[index] : NULL; }
+
+    size_t getNestedCount() { return nested.size(); }
+    SignedDataWrapper* getNested(size_t index) { return (index < nested.size()) ? nested[index] : NULL; }
+
+protected:
+    virtual void clear();
+
+    size_t nestingLevel;
+    std::vector<CertificateWrapper*> certificates;
+    std::vector<SignerInfoWrapper*> signers;
+    std::vector<SignedDataWrapper*> nested;
+};
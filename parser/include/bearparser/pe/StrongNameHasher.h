@@ -0,0 +1,27 @@
+#pragma once
+
+#include "AuthenticodeHasher.h"
+
+/*
+Strong name signature of a .NET assembly: the hash of the headers (up to the end of the section headers;
+the checksum and the Security entry of the Data Directory are hashed as zeros), followed by the raw content
+of the sections in the order of their headers, excluding the signature blob itself.
+The content out of the sections (i.e. the certificates appended by Authenticode) is not covered.
+The ranges are hashed directly from the file buffer (no copies).
+*/
+class StrongNameHasher
+{
+public:
+    // the raw range of the signature blob (StrongNameSignature of the CLR header)
+    static bool getSignatureRange(PEFile *pe, DigestRange &range);
+
+    // the raw ranges covered by the signature, in the order of hashing
+    static bool getSignedRanges(PEFile *pe, std::vector<DigestRange> &ranges);
+
+    // the hash algorithm of the public key of the assembly (the HashAlgId of PublicKeyBlob); SHA-1 if unknown
+    static QCryptographicHash::Algorithm getHashAlgo(PEFile *pe);
+
+    // returns an empty array if failed
+    static QByteArray computeHash(PEFile *pe, QCryptographicHash::Algorithm algo);
+    static QByteArray computeHash(PEFile *pe) { return computeHash(pe, getHashAlgo(pe)); }
+};
@@ -1,10 +1,18 @@
 #pragma once
 
 #include "DataDirEntryWrapper.h"
+#include <vector>
 
 class TlsEntryWrapper;
 class TlsDirWrapper;
 
+// a callback of the TLS directory
+struct TlsCallback
+{
+    offset_t rva;
+    size_t slot;    // its index in the AddressOfCallBacks array
+};
+
 class TlsDirWrapper : public DataDirEntryWrapper
 {
 public:
@@ -20,6 +28,9 @@ public:
         FIELD_COUNTER
     };
 
+    // the loader walks the callbacks till the NULL entry: the limit for the unterminated (or hostile) arrays
+    static const size_t MAX_CALLBACKS = 0x400;
+
     TlsDirWrapper(PEFile *pe)
         : DataDirEntryWrapper(pe, pe::DIR_TLS) { wrap(); }
 
@@ -36,6 +47,13 @@ public:
     virtual QString getFieldName(size_t fieldId);
     virtual Executable::addr_type containsAddrType(size_t fieldId, size_t subField = FIELD_NONE);
 
+    /* Fills the callbacks (AddressOfCallBacks) with their RVAs and slots, in the order of calling.
+    The array is fetched at once and its VAs converted in bulk; reading stops at the NULL entry or at the limit.
+    The callbacks out of the image are skipped, the repeated ones are listed once (at their first slot).
+    Returns the count of the added callbacks.
+    */
+    size_t getCallbacks(std::vector<TlsCallback> &callbacks, size_t maxCount = MAX_CALLBACKS);
+
 private:
     inline void* getTlsDirPtr();
     IMAGE_TLS_DIRECTORY64* tls64();
@@ -1981,7 +1981,11 @@ namespace pe {
         DT_POGO = 13,
         DT_ILTCG = 14,
         DT_MPX = 15,
-        DT_REPRO = 16
+        DT_REPRO = 16,
+        DT_EMBEDDED_PORTABLE_PDB = 17,
+        DT_SPGO = 18,
+        DT_PDB_CHECKSUM = 19,
+        DT_EX_DLLCHARACTERISTICS = 20
     };
 
     enum subsystem {
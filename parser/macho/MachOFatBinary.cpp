@@ -0,0 +1,112 @@
+#include "macho/MachOFatBinary.h"
+
+namespace {
+    // more than any universal binary has; a Java class has its version here, which is much bigger
+    const uint32_t FAT_ARCH_MAX = 32;
+
+    uint32_t readBigEndian32(const BYTE *ptr)
+    {
+        return (uint32_t(ptr[0]) << 24) | (uint32_t(ptr[1]) << 16) | (uint32_t(ptr[2]) << 8) | uint32_t(ptr[3]);
+    }
+
+    uint64_t readBigEndian64(const BYTE *ptr)
+    {
+        return (uint64_t(readBigEndian32(ptr)) << 32) | readBigEndian32(ptr + sizeof(uint32_t));
+    }
+};
+
+size_t MachOFatBinary::readSlices(AbstractByteBuffer *buf, std::vector<MachOFatSlice> &slices, bool &isFat64)
+{
+    slices.clear();
+    if (!buf) return 0;
+
+    const BYTE *hdr = buf->getContentAt(0, sizeof(macho::fat_header));
+    if (!hdr) return 0;
+
+    const uint32_t magic = readBigEndian32(hdr + offsetof(macho::fat_header, magic));
+    if (magic != FAT_MAGIC && magic != FAT_MAGIC_64) return 0;
+    isFat64 = (magic == FAT_MAGIC_64);
+
+    const uint32_t count = readBigEndian32(hdr + offsetof(macho::fat_header, nfat_arch));
+    if (count == 0 || count > FAT_ARCH_MAX) return 0;
+
+    const bufsize_t archSize = isFat64 ? sizeof(macho::fat_arch_64) : sizeof(macho::fat_arch);
+    const offset_t tableEnd = sizeof(macho::fat_header) + count * archSize;
+    const BYTE *table = buf->getContentAt(sizeof(macho::fat_header), count * archSize);
+    if (!table) return 0;
+
+    const offset_t bufSize = buf->getContentSize();
+    for (uint32_t i = 0; i < count; i++) {
+        const BYTE *arch = table + i * archSize;
+
+        MachOFatSlice slice;
+        slice.cpuType = static_cast<int32_t>(readBigEndian32(arch));
+        slice.cpuSubtype = static_cast<int32_t>(readBigEndian32(arch + sizeof(uint32_t)));
+        if (isFat64) {
+            slice.offset = readBigEndian64(arch + offsetof(macho::fat_arch_64, offset));
+            slice.size = static_cast<bufsize_t>(readBigEndian64(arch + offsetof(macho::fat_arch_64, size)));
+            slice.align = readBigEndian32(arch + offsetof(macho::fat_arch_64, align));
+        } else {
+            slice.offset = readBigEndian32(arch + offsetof(macho::fat_arch, offset));
+            slice.size = readBigEndian32(arch + offsetof(macho::fat_arch, size));
+            slice.align = readBigEndian32(arch + offsetof(macho::fat_arch, align));
+        }
+
+        if (slice.offset < tableEnd || slice.size == 0 || slice.offset >= bufSize || slice.size > bufSize - slice.offset) {
+            Logger::append(Logger::D_WARNING, "Invalid slice #%u of the fat binary: offset = %llX, size = %llX", i,
+                static_cast<unsigned long long>(slice.offset), static_cast<unsigned long long>(slice.size));
+            continue;
+        }
+        slices.push_back(slice);
+    }
+    return slices.size();
+}
+
+bool MachOFatBinary::isFat(AbstractByteBuffer *buf)
+{
+    std::vector<MachOFatSlice> slices;
+    bool isFat64 = false;
+    return readSlices(buf, slices, isFat64) > 0;
+}
+
+MachOFatBinary::MachOFatBinary(AbstractByteBuffer *v_buf)
+    : buf(v_buf), isFat64(false)
+{
+    if (readSlices(buf, slices, isFat64) == 0) {
+        throw ExeException("Not a fat binary");
+    }
+    views.reserve(slices.size());
+    for (const MachOFatSlice &slice : slices) {
+        views.push_back(new BufferView(buf, slice.offset, slice.size));
+    }
+}
+
+MachOFatBinary::~MachOFatBinary()
+{
+    for (BufferView *view : views) {
+        delete view;
+    }
+    views.clear();
+}
+
+BufferView* MachOFatBinary::getSlice(size_t index) const
+{
+    if (index >= views.size()) return NULL;
+    return views[index];
+}
+
+size_t MachOFatBinary::findSlice(int32_t cpuType) const
+{
+    for (size_t i = 0; i < slices.size(); i++) {
+        if (slices[i].cpuType == cpuType) return i;
+    }
+    return NOT_FOUND;
+}
+
+size_t MachOFatBinary::getPreferredSlice() const
+{
+    for (size_t i = 0; i < slices.size(); i++) {
+        if (slices[i].cpuType & CPU_ARCH_ABI64) return i;
+    }
+    return 0;
+}
@@ -0,0 +1,417 @@
+#include "macho/MachOFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    bool isThinMachO(AbstractByteBuffer *buf)
+    {
+        const uint32_t *magic = buf ? (const uint32_t*) buf->getContentAt(0, sizeof(uint32_t)) : NULL;
+        if (!magic) return false;
+
+        if (*magic == MH_MAGIC_64) return buf->getContentAt(0, sizeof(macho::mach_header_64)) != NULL;
+        if (*magic == MH_MAGIC) return buf->getContentAt(0, sizeof(macho::mach_header)) != NULL;
+        return false;
+    }
+
+    std::string readName(const char (&name)[16])
+    {
+        return std::string(name, strnlen(name, sizeof(name)));
+    }
+
+    template <typename SegmentT, typename SectionT>
+    bool readSegment(MachOFile *macho, const MachOLoadCommand &command, MachOSegment &segment, std::vector<MachOSection> &sections)
+    {
+        if (command.cmdSize < sizeof(SegmentT)) return false;
+
+        const SegmentT *seg = (const SegmentT*) macho->getContentAt(command.raw, sizeof(SegmentT));
+        if (!seg) return false;
+
+        segment.cmdRaw = command.raw;
+        segment.name = readName(seg->segname);
+        segment.vmAddr = seg->vmaddr;
+        segment.vmSize = seg->vmsize;
+        segment.fileOffset = seg->fileoff;
+        segment.fileSize = seg->filesize;
+        segment.firstSection = sections.size();
+        segment.sectionsCount = 0;
+
+        // the section headers follow the segment command, within its size
+        size_t count = seg->nsects;
+        const size_t maxCount = (command.cmdSize - sizeof(SegmentT)) / sizeof(SectionT);
+        if (count > maxCount) {
+            Logger::append(Logger::D_WARNING, "Segment %s: the sections exceed the load command", segment.name.c_str());
+            count = maxCount;
+        }
+
+        const offset_t sectionsRaw = command.raw + sizeof(SegmentT);
+        for (size_t i = 0; i < count; i++) {
+            const offset_t hdrRaw = sectionsRaw + i * sizeof(SectionT);
+            const SectionT *sect = (const SectionT*) macho->getContentAt(hdrRaw, sizeof(SectionT));
+            if (!sect) break;
+
+            MachOSection section;
+            section.hdrRaw = hdrRaw;
+            section.segment = 0; // set by the caller
+            section.segmentName = readName(sect->segname);
+            section.name = readName(sect->sectname);
+            section.addr = sect->addr;
+            section.size = sect->size;
+            section.offset = sect->offset;
+            section.flags = sect->flags;
+            sections.push_back(section);
+            segment.sectionsCount++;
+        }
+        return true;
+    }
+};
+
+//-------------------------------------------------------------
+
+bool MachOFileBuilder::signatureMatches(AbstractByteBuffer *buf)
+{
+    if (buf == NULL) return false;
+    if (isThinMachO(buf)) return true;
+
+    if (!MachOFatBinary::isFat(buf)) return false;
+
+    MachOFatBinary fat(buf);
+    return isThinMachO(fat.getSlice(fat.getPreferredSlice()));
+}
+
+Executable* MachOFileBuilder::build(AbstractByteBuffer *buf)
+{
+    Executable *exe = NULL;
+    if (signatureMatches(buf) == false) return NULL;
+
+    try {
+        exe = new MachOFile(buf);
+    } catch (const ExeException &) {
+        exe = NULL;
+    }
+    return exe;
+}
+
+std::vector<QByteArray> MachOFileBuilder::magics()
+{
+    // thin: little endian; fat: big endian
+    return {
+        QByteArray("\xCE\xFA\xED\xFE", 4), QByteArray("\xCF\xFA\xED\xFE", 4),
+        QByteArray("\xCA\xFE\xBA\xBE", 4), QByteArray("\xCA\xFE\xBA\xBF", 4)
+    };
+}
+
+//-------------------------------------------------------------
+
+MachOFile::MachOFile(AbstractByteBuffer *v_buf, size_t v_sliceIndex)
+    : MappedExe(v_buf, Executable::BITS_32),
+      fat(NULL), sliceIndex(0), cpuType(0), fileType(0), imageBase(0), loadedSize(0)
+{
+    if (MachOFatBinary::isFat(v_buf)) {
+        fat = new MachOFatBinary(v_buf);
+        sliceIndex = (v_sliceIndex == PREFERRED_SLICE) ? fat->getPreferredSlice() : v_sliceIndex;
+
+        // from now on, the slice is the content of this executable
+        this->buf = fat->getSlice(sliceIndex);
+        if (!this->buf) {
+            delete fat;
+            throw ExeException("No such slice in the fat binary");
+        }
+    }
+    try {
+        wrap();
+    } catch (ExeException &) {
+        delete fat;
+        throw;
+    }
+    Logger::append(Logger::D_INFO, "Wrapped");
+}
+
+MachOFile::~MachOFile()
+{
+    // the wrappers refer to the slice, owned by the fat binary
+    clearWrappers();
+    delete fat;
+}
+
+void MachOFile::wrap()
+{
+    clearWrappers();
+
+    const uint32_t *magic = (const uint32_t*) getContentAt(0, sizeof(uint32_t));
+    if (!magic) {
+        throw ExeException("Could not wrap Mach-O: the file is too small");
+    }
+    if (*magic == MH_CIGAM || *magic == MH_CIGAM_64) {
+        throw ExeException("Could not wrap Mach-O: big endian is not supported");
+    }
+    if (*magic != MH_MAGIC && *magic != MH_MAGIC_64) {
+        throw ExeException("Could not wrap Mach-O: invalid magic");
+    }
+    this->bitMode = (*magic == MH_MAGIC_64) ? Executable::BITS_64 : Executable::BITS_32;
+
+    // mach_header is the beginning of mach_header_64
+    const macho::mach_header *hdr = (const macho::mach_header*) getContentAt(0, machoHdrSize());
+    if (!hdr) {
+        throw ExeException("Could not wrap Mach-O: the header is truncated");
+    }
+    this->cpuType = hdr->cputype;
+    this->fileType = hdr->filetype;
+
+    parseLoadCommands();
+    buildSegmentsMap();
+
+    this->wrappers[WR_MACHO_HDR] = new MachOHdrWrapper(this);
+    this->wrappers[WR_LOAD_CMDS] = new MachOLoadCmdsWrapper(this);
+    this->wrappers[WR_SEGMENTS] = new MachOSegmentsWrapper(this);
+    this->wrappers[WR_SECTIONS] = new MachOSectionsWrapper(this);
+}
+
+void MachOFile::clearWrappers()
+{
+    MappedExe::clearWrappers();
+
+    loadCommands.clear();
+    segments.clear();
+    sections.clear();
+    rvaRanges.clear();
+    rawRanges.clear();
+    imageBase = 0;
+    loadedSize = 0;
+}
+
+void MachOFile::parseLoadCommands()
+{
+    const macho::mach_header *hdr = (const macho::mach_header*) getContentAt(0, machoHdrSize());
+    if (!hdr) return;
+
+    const offset_t cmdsStart = machoHdrSize();
+    const offset_t rawSize = getRawSize();
+    offset_t cmdsEnd = cmdsStart + hdr->sizeofcmds;
+    if (cmdsEnd > rawSize) {
+        Logger::append(Logger::D_WARNING, "The load commands exceed the file");
+        cmdsEnd = rawSize;
+    }
+    loadCommands.reserve(std::min<size_t>(hdr->ncmds, hdr->sizeofcmds / sizeof(macho::load_command)));
+
+    // the sizes of the commands keep them aligned, as the loader requires
+    const uint32_t cmdAlign = (bitMode == Executable::BITS_64) ? 8 : 4;
+
+    offset_t raw = cmdsStart;
+    for (uint32_t i = 0; i < hdr->ncmds; i++) {
+        const macho::load_command *lc = NULL;
+        if (raw + sizeof(macho::load_command) <= cmdsEnd) {
+            lc = (const macho::load_command*) getContentAt(raw, sizeof(macho::load_command));
+        }
+        if (!lc || lc->cmdsize < sizeof(macho::load_command) || lc->cmdsize > cmdsEnd - raw || (lc->cmdsize % cmdAlign) != 0) {
+            Logger::append(Logger::D_WARNING, "Invalid load command #%u at: %llX", i, static_cast<unsigned long long>(raw));
+            break;
+        }
+        const MachOLoadCommand command = { raw, lc->cmd, lc->cmdsize };
+        loadCommands.push_back(command);
+
+        if (command.cmd == LC_SEGMENT || command.cmd == LC_SEGMENT_64) {
+            parseSegment(command);
+        }
+        raw += lc->cmdsize;
+    }
+}
+
+void MachOFile::parseSegment(const MachOLoadCommand &command)
+{
+    MachOSegment segment;
+    const bool isRead = (command.cmd == LC_SEGMENT_64)
+        ? readSegment<macho::segment_command_64, macho::section_64>(this, command, segment, sections)
+        : readSegment<macho::segment_command, macho::section>(this, command, segment, sections);
+    if (!isRead) {
+        Logger::append(Logger::D_WARNING, "Invalid segment command at: %llX", static_cast<unsigned long long>(command.raw));
+        return;
+    }
+    for (size_t i = segment.firstSection; i < sections.size(); i++) {
+        sections[i].segment = segments.size();
+    }
+    segments.push_back(segment);
+}
+
+void MachOFile::buildSegmentsMap()
+{
+    // the base is the segment that maps the headers (__TEXT); objects have a single segment that doesn't
+    imageBase = INVALID_ADDR;
+    for (const MachOSegment &segment : segments) {
+        if (segment.fileOffset == 0 && segment.fileSize != 0) {
+            imageBase = segment.vmAddr;
+            break;
+        }
+    }
+    if (imageBase == INVALID_ADDR) {
+        for (const MachOSegment &segment : segments) {
+            if (segment.fileSize != 0) imageBase = std::min<offset_t>(imageBase, segment.vmAddr);
+        }
+    }
+    if (imageBase == INVALID_ADDR) imageBase = 0;
+
+    for (const MachOSegment &segment : segments) {
+        // i.e. __PAGEZERO
+        if (segment.vmAddr < imageBase) continue;
+
+        const offset_t rva = segment.vmAddr - imageBase;
+        const offset_t raw = segment.fileOffset;
+        const bufsize_t vSize = static_cast<bufsize_t>(segment.vmSize);
+        // the part of the segment that is backed by the file:
+        const bufsize_t rawSize = static_cast<bufsize_t>(std::min<uint64_t>(segment.fileSize, segment.vmSize));
+
+        if (vSize) {
+            rvaRanges.push_back({ rva, vSize, raw, rawSize });
+            loadedSize = std::max<bufsize_t>(loadedSize, rva + vSize);
+        }
+        if (rawSize) {
+            rawRanges.push_back({ raw, rawSize, rva, rawSize });
+        }
+    }
+    for (std::vector<MachOMappedRange>* ranges : { &rvaRanges, &rawRanges }) {
+        std::sort(ranges->begin(), ranges->end(), [](const MachOMappedRange &a, const MachOMappedRange &b) {
+            return a.start < b.start;
+        });
+    }
+}
+
+offset_t MachOFile::translateAddr(const std::vector<MachOMappedRange> &ranges, offset_t addr)
+{
+    if (addr == INVALID_ADDR) return INVALID_ADDR;
+
+    // the segments don't overlap: only the last one that starts at the address or before it can contain it
+    auto itr = std::upper_bound(ranges.begin(), ranges.end(), addr,
+        [](offset_t a, const MachOMappedRange &range) { return a < range.start; });
+    if (itr == ranges.begin()) return INVALID_ADDR;
+    --itr;
+
+    const offset_t delta = addr - itr->start;
+    // i.e. __bss: mapped in the memory, but not backed by the file
+    if (delta >= itr->size || delta >= itr->mappedSize) return INVALID_ADDR;
+    return itr->mapped + delta;
+}
+
+//-------------------------------------------------------------
+
+bufsize_t MachOFile::getMappedSize(Executable::addr_type aType)
+{
+    if (aType == Executable::NOT_ADDR) return 0;
+    if (aType == Executable::RAW) {
+        return getRawSize();
+    }
+    if (aType == Executable::VA || aType == Executable::RVA) {
+        const bufsize_t unitSize = getAlignment(aType);
+        return (loadedSize < unitSize) ? unitSize : loadedSize;
+    }
+    return 0;
+}
+
+bufsize_t MachOFile::getAlignment(Executable::addr_type aType) const
+{
+    // the size of the page
+    return (cpuType == CPU_TYPE_ARM64 || cpuType == CPU_TYPE_ARM64_32) ? 0x4000 : 0x1000;
+}
+
+Executable::exe_arch MachOFile::getArch()
+{
+    switch (cpuType) {
+        case CPU_TYPE_X86: case CPU_TYPE_X86_64:
+            return Executable::ARCH_INTEL;
+        case CPU_TYPE_ARM: case CPU_TYPE_ARM64: case CPU_TYPE_ARM64_32:
+            return Executable::ARCH_ARM;
+    }
+    return Executable::ARCH_UNKNOWN;
+}
+
+offset_t MachOFile::getEntryPoint(Executable::addr_type addrType)
+{
+    offset_t rva = INVALID_ADDR;
+
+    const size_t mainIdx = findLoadCommand(LC_MAIN);
+    const size_t threadIdx = findLoadCommand(LC_UNIXTHREAD);
+    if (mainIdx != NOT_FOUND) {
+        // LC_MAIN: the file offset of main()
+        const MachOLoadCommand &command = loadCommands[mainIdx];
+        const macho::entry_point_command *ep = NULL;
+        if (command.cmdSize >= sizeof(macho::entry_point_command)) {
+            ep = (const macho::entry_point_command*) getContentAt(command.raw, sizeof(macho::entry_point_command));
+        }
+        if (ep) rva = rawToRva(static_cast<offset_t>(ep->entryoff));
+    }
+    else if (threadIdx != NOT_FOUND) {
+        // LC_UNIXTHREAD: the program counter of the initial thread state
+        const offset_t va = readThreadEntryPoint(loadCommands[threadIdx]);
+        if (va != INVALID_ADDR && va >= imageBase) rva = va - imageBase;
+    }
+    if (rva == INVALID_ADDR) return INVALID_ADDR;
+
+    if (addrType == Executable::RVA) return rva;
+    return convertAddr(rva, Executable::RVA, addrType);
+}
+
+offset_t MachOFile::readThreadEntryPoint(const MachOLoadCommand &command)
+{
+    const offset_t end = command.raw + command.cmdSize;
+    offset_t raw = command.raw + sizeof(macho::thread_command);
+
+    // the command may hold several states: flavor, count (in uint32_t), state
+    while (raw + 2 * sizeof(uint32_t) <= end) {
+        const uint32_t *flavorHdr = (const uint32_t*) getContentAt(raw, 2 * sizeof(uint32_t));
+        if (!flavorHdr) break;
+
+        const uint32_t flavor = flavorHdr[0];
+        const uint64_t stateSize = uint64_t(flavorHdr[1]) * sizeof(uint32_t);
+        const offset_t stateRaw = raw + 2 * sizeof(uint32_t);
+        if (stateSize > end - stateRaw) break;
+
+        // the index of the program counter in the state, and the size of the registers
+        size_t pcIndex = 0;
+        bufsize_t regSize = 0;
+        if (cpuType == CPU_TYPE_X86_64 && flavor == MACHO_x86_THREAD_STATE64) {
+            pcIndex = 16; regSize = sizeof(uint64_t); // rip: after rax...r15
+        } else if (cpuType == CPU_TYPE_X86 && flavor == MACHO_x86_THREAD_STATE32) {
+            pcIndex = 10; regSize = sizeof(uint32_t); // eip: after eax...eflags
+        } else if (cpuType == CPU_TYPE_ARM64 && flavor == MACHO_ARM_THREAD_STATE64) {
+            pcIndex = 32; regSize = sizeof(uint64_t); // pc: after x0...x28, fp, lr, sp
+        } else if (cpuType == CPU_TYPE_ARM && flavor == MACHO_ARM_THREAD_STATE) {
+            pcIndex = 15; regSize = sizeof(uint32_t); // pc: after r0...r12, sp, lr
+        }
+
+        if (regSize && (pcIndex + 1) * regSize <= stateSize) {
+            const BYTE *pc = getContentAt(stateRaw + pcIndex * regSize, regSize);
+            if (!pc) break;
+
+            uint64_t value = 0;
+            memcpy(&value, pc, regSize);
+            return static_cast<offset_t>(value);
+        }
+        raw = stateRaw + stateSize;
+    }
+    return INVALID_ADDR;
+}
+
+//-------------------------------------------------------------
+
+size_t MachOFile::findLoadCommand(uint32_t cmd) const
+{
+    for (size_t i = 0; i < loadCommands.size(); i++) {
+        if (loadCommands[i].cmd == cmd) return i;
+    }
+    return NOT_FOUND;
+}
+
+size_t MachOFile::findSegment(const std::string &name) const
+{
+    for (size_t i = 0; i < segments.size(); i++) {
+        if (segments[i].name == name) return i;
+    }
+    return NOT_FOUND;
+}
+
+size_t MachOFile::findSection(const std::string &segmentName, const std::string &name) const
+{
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (sections[i].segmentName == segmentName && sections[i].name == name) return i;
+    }
+    return NOT_FOUND;
+}
@@ -0,0 +1,101 @@
+#include "macho/MachOHdrWrapper.h"
+#include "macho/MachOFile.h"
+
+QString MachOHdrWrapper::translateCpuType(int32_t cpuType)
+{
+    switch (cpuType) {
+        case CPU_TYPE_VAX: return "VAX";
+        case CPU_TYPE_MC680x0: return "Motorola 680x0";
+        case CPU_TYPE_X86: return "Intel x86";
+        case CPU_TYPE_X86_64: return "AMD x86-64";
+        case CPU_TYPE_MC98000: return "Motorola 98000";
+        case CPU_TYPE_HPPA: return "HPPA";
+        case CPU_TYPE_ARM: return "ARM";
+        case CPU_TYPE_ARM64: return "ARM64";
+        case CPU_TYPE_ARM64_32: return "ARM64_32";
+        case CPU_TYPE_MC88000: return "Motorola 88000";
+        case CPU_TYPE_SPARC: return "SPARC";
+        case CPU_TYPE_I860: return "Intel i860";
+        case CPU_TYPE_POWERPC: return "PowerPC";
+        case CPU_TYPE_POWERPC64: return "PowerPC 64-bit";
+    }
+    return "";
+}
+
+QString MachOHdrWrapper::translateFileType(uint32_t fileType)
+{
+    switch (fileType) {
+        case MH_OBJECT: return "Relocatable object";
+        case MH_EXECUTE: return "Executable";
+        case MH_FVMLIB: return "Fixed VM shared library";
+        case MH_CORE: return "Core";
+        case MH_PRELOAD: return "Preloaded executable";
+        case MH_DYLIB: return "Dynamic library";
+        case MH_DYLINKER: return "Dynamic linker";
+        case MH_BUNDLE: return "Bundle";
+        case MH_DYLIB_STUB: return "Dynamic library stub";
+        case MH_DSYM: return "Debug symbols";
+        case MH_KEXT_BUNDLE: return "Kernel extension";
+        case MH_FILESET: return "File set";
+    }
+    return "";
+}
+
+void* MachOHdrWrapper::getPtr()
+{
+    return m_MachO->getContentAt(0, getSize());
+}
+
+bufsize_t MachOHdrWrapper::getSize()
+{
+    return m_MachO->machoHdrSize();
+}
+
+void* MachOHdrWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    BYTE *hdr = static_cast<BYTE*>(getPtr());
+    if (!hdr) return NULL;
+
+    switch (fieldId) {
+        case MAGIC: return hdr + offsetof(macho::mach_header_64, magic);
+        case CPU_TYPE: return hdr + offsetof(macho::mach_header_64, cputype);
+        case CPU_SUBTYPE: return hdr + offsetof(macho::mach_header_64, cpusubtype);
+        case FILE_TYPE: return hdr + offsetof(macho::mach_header_64, filetype);
+        case NCMDS: return hdr + offsetof(macho::mach_header_64, ncmds);
+        case SIZEOF_CMDS: return hdr + offsetof(macho::mach_header_64, sizeofcmds);
+        case FLAGS: return hdr + offsetof(macho::mach_header_64, flags);
+        case RESERVED: return isBit64() ? hdr + offsetof(macho::mach_header_64, reserved) : NULL;
+    }
+    return hdr;
+}
+
+bufsize_t MachOHdrWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    if (fieldId == RESERVED && !isBit64()) return 0;
+    if (fieldId < FIELD_COUNTER) return sizeof(uint32_t);
+    return getSize();
+}
+
+QString MachOHdrWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case MAGIC: return "Magic";
+        case CPU_TYPE: return "CPU type";
+        case CPU_SUBTYPE: return "CPU subtype";
+        case FILE_TYPE: return "File type";
+        case NCMDS: return "Number of load commands";
+        case SIZEOF_CMDS: return "Size of load commands";
+        case FLAGS: return "Flags";
+        case RESERVED: return "Reserved";
+    }
+    return getName();
+}
+
+QString MachOHdrWrapper::translateFieldContent(size_t fieldId)
+{
+    switch (fieldId) {
+        case CPU_TYPE: return translateCpuType(m_MachO->machoCpuType());
+        case FILE_TYPE: return translateFileType(m_MachO->machoFileType());
+    }
+    return "";
+}
@@ -0,0 +1,113 @@
+#include "macho/MachOLoadCmdsWrapper.h"
+#include "macho/MachOFile.h"
+
+const std::unordered_map<uint32_t, QString> MachOLoadCmdsWrapper::s_commands = {
+    {LC_SEGMENT, "SEGMENT"},
+    {LC_SYMTAB, "SYMTAB"},
+    {LC_SYMSEG, "SYMSEG"},
+    {LC_THREAD, "THREAD"},
+    {LC_UNIXTHREAD, "UNIXTHREAD"},
+    {LC_DYSYMTAB, "DYSYMTAB"},
+    {LC_LOAD_DYLIB, "LOAD_DYLIB"},
+    {LC_ID_DYLIB, "ID_DYLIB"},
+    {LC_LOAD_DYLINKER, "LOAD_DYLINKER"},
+    {LC_ID_DYLINKER, "ID_DYLINKER"},
+    {LC_PREBOUND_DYLIB, "PREBOUND_DYLIB"},
+    {LC_ROUTINES, "ROUTINES"},
+    {LC_SUB_FRAMEWORK, "SUB_FRAMEWORK"},
+    {LC_SUB_UMBRELLA, "SUB_UMBRELLA"},
+    {LC_SUB_CLIENT, "SUB_CLIENT"},
+    {LC_SUB_LIBRARY, "SUB_LIBRARY"},
+    {LC_TWOLEVEL_HINTS, "TWOLEVEL_HINTS"},
+    {LC_PREBIND_CKSUM, "PREBIND_CKSUM"},
+    {LC_LOAD_WEAK_DYLIB, "LOAD_WEAK_DYLIB"},
+    {LC_SEGMENT_64, "SEGMENT_64"},
+    {LC_ROUTINES_64, "ROUTINES_64"},
+    {LC_UUID, "UUID"},
+    {LC_RPATH, "RPATH"},
+    {LC_CODE_SIGNATURE, "CODE_SIGNATURE"},
+    {LC_SEGMENT_SPLIT_INFO, "SEGMENT_SPLIT_INFO"},
+    {LC_REEXPORT_DYLIB, "REEXPORT_DYLIB"},
+    {LC_LAZY_LOAD_DYLIB, "LAZY_LOAD_DYLIB"},
+    {LC_ENCRYPTION_INFO, "ENCRYPTION_INFO"},
+    {LC_DYLD_INFO, "DYLD_INFO"},
+    {LC_DYLD_INFO_ONLY, "DYLD_INFO_ONLY"},
+    {LC_LOAD_UPWARD_DYLIB, "LOAD_UPWARD_DYLIB"},
+    {LC_VERSION_MIN_MACOSX, "VERSION_MIN_MACOSX"},
+    {LC_VERSION_MIN_IPHONEOS, "VERSION_MIN_IPHONEOS"},
+    {LC_FUNCTION_STARTS, "FUNCTION_STARTS"},
+    {LC_DYLD_ENVIRONMENT, "DYLD_ENVIRONMENT"},
+    {LC_MAIN, "MAIN"},
+    {LC_DATA_IN_CODE, "DATA_IN_CODE"},
+    {LC_SOURCE_VERSION, "SOURCE_VERSION"},
+    {LC_DYLIB_CODE_SIGN_DRS, "DYLIB_CODE_SIGN_DRS"},
+    {LC_ENCRYPTION_INFO_64, "ENCRYPTION_INFO_64"},
+    {LC_LINKER_OPTION, "LINKER_OPTION"},
+    {LC_LINKER_OPTIMIZATION_HINT, "LINKER_OPTIMIZATION_HINT"},
+    {LC_VERSION_MIN_TVOS, "VERSION_MIN_TVOS"},
+    {LC_VERSION_MIN_WATCHOS, "VERSION_MIN_WATCHOS"},
+    {LC_NOTE, "NOTE"},
+    {LC_BUILD_VERSION, "BUILD_VERSION"},
+    {LC_DYLD_EXPORTS_TRIE, "DYLD_EXPORTS_TRIE"},
+    {LC_DYLD_CHAINED_FIXUPS, "DYLD_CHAINED_FIXUPS"},
+    {LC_FILESET_ENTRY, "FILESET_ENTRY"},
+};
+
+QString MachOLoadCmdsWrapper::translateCommand(uint32_t cmd)
+{
+    auto itr = s_commands.find(cmd);
+    if (itr != s_commands.end()) return itr->second;
+    return "0x" + QString::number(cmd, 16);
+}
+
+void* MachOLoadCmdsWrapper::getPtr()
+{
+    const bufsize_t size = getSize();
+    if (size == 0) return NULL;
+    return m_MachO->getContentAt(m_MachO->machoHdrSize(), size);
+}
+
+bufsize_t MachOLoadCmdsWrapper::getSize()
+{
+    // the commands that were read
+    const std::vector<MachOLoadCommand> &commands = m_MachO->getLoadCommands();
+    if (commands.empty()) return 0;
+    return static_cast<bufsize_t>(commands.back().raw + commands.back().cmdSize - m_MachO->machoHdrSize());
+}
+
+size_t MachOLoadCmdsWrapper::getSubFieldsCount()
+{
+    return m_MachO->getLoadCommands().size();
+}
+
+void* MachOLoadCmdsWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+
+    const std::vector<MachOLoadCommand> &commands = m_MachO->getLoadCommands();
+    if (index >= commands.size()) return NULL;
+
+    BYTE *ptr = m_MachO->getContentAt(commands[index].raw, commands[index].cmdSize);
+    if (!ptr) return NULL;
+
+    if (fieldId == CMD_SIZE) return ptr + offsetof(macho::load_command, cmdsize);
+    return ptr;
+}
+
+bufsize_t MachOLoadCmdsWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    if (fieldId == CMD || fieldId == CMD_SIZE) return sizeof(uint32_t);
+
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+    const std::vector<MachOLoadCommand> &commands = m_MachO->getLoadCommands();
+    return (index < commands.size()) ? commands[index].cmdSize : 0;
+}
+
+QString MachOLoadCmdsWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case CMD: return "Command";
+        case CMD_SIZE: return "Command size";
+    }
+    return getName();
+}
@@ -0,0 +1,7 @@
+#include "macho/MachONodeWrapper.h"
+#include "macho/MachOFile.h"
+
+MachOElementWrapper::MachOElementWrapper(MachOFile *macho)
+    : ExeElementWrapper(macho), m_MachO(macho)
+{
+}
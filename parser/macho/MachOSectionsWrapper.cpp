@@ -0,0 +1,133 @@
+#include "macho/MachOSectionsWrapper.h"
+#include "macho/MachOFile.h"
+
+namespace {
+    struct FieldLayout {
+        size_t offset;
+        bufsize_t size;
+    };
+
+#define SECTION_FIELD(type, field) { offsetof(type, field), sizeof(type::field) }
+
+    const FieldLayout s_section32[MachOSectionsWrapper::FIELD_COUNTER] = {
+        SECTION_FIELD(macho::section, sectname),
+        SECTION_FIELD(macho::section, segname),
+        SECTION_FIELD(macho::section, addr),
+        SECTION_FIELD(macho::section, size),
+        SECTION_FIELD(macho::section, offset),
+        SECTION_FIELD(macho::section, align),
+        SECTION_FIELD(macho::section, reloff),
+        SECTION_FIELD(macho::section, nreloc),
+        SECTION_FIELD(macho::section, flags),
+        SECTION_FIELD(macho::section, reserved1),
+        SECTION_FIELD(macho::section, reserved2),
+        { 0, 0 } // no reserved3
+    };
+
+    const FieldLayout s_section64[MachOSectionsWrapper::FIELD_COUNTER] = {
+        SECTION_FIELD(macho::section_64, sectname),
+        SECTION_FIELD(macho::section_64, segname),
+        SECTION_FIELD(macho::section_64, addr),
+        SECTION_FIELD(macho::section_64, size),
+        SECTION_FIELD(macho::section_64, offset),
+        SECTION_FIELD(macho::section_64, align),
+        SECTION_FIELD(macho::section_64, reloff),
+        SECTION_FIELD(macho::section_64, nreloc),
+        SECTION_FIELD(macho::section_64, flags),
+        SECTION_FIELD(macho::section_64, reserved1),
+        SECTION_FIELD(macho::section_64, reserved2),
+        SECTION_FIELD(macho::section_64, reserved3)
+    };
+
+#undef SECTION_FIELD
+};
+
+void* MachOSectionsWrapper::getPtr()
+{
+    ExeElementWrapper *commands = m_MachO->getWrapper(MachOFile::WR_LOAD_CMDS);
+    return commands ? commands->getPtr() : NULL;
+}
+
+bufsize_t MachOSectionsWrapper::getSize()
+{
+    ExeElementWrapper *commands = m_MachO->getWrapper(MachOFile::WR_LOAD_CMDS);
+    return commands ? commands->getSize() : 0;
+}
+
+size_t MachOSectionsWrapper::getSubFieldsCount()
+{
+    return m_MachO->getSections().size();
+}
+
+bool MachOSectionsWrapper::is64(size_t index)
+{
+    // the type of the segment command that holds the section
+    const std::vector<MachOSection> &sections = m_MachO->getSections();
+    const std::vector<MachOSegment> &segments = m_MachO->getSegments();
+    if (index >= sections.size() || sections[index].segment >= segments.size()) return isBit64();
+
+    const uint32_t *cmd = (const uint32_t*) m_MachO->getContentAt(segments[sections[index].segment].cmdRaw, sizeof(uint32_t));
+    return cmd ? (*cmd == LC_SEGMENT_64) : isBit64();
+}
+
+void* MachOSectionsWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+
+    const std::vector<MachOSection> &sections = m_MachO->getSections();
+    if (index >= sections.size()) return NULL;
+
+    const bool isSection64 = is64(index);
+    const bufsize_t hdrSize = isSection64 ? sizeof(macho::section_64) : sizeof(macho::section);
+    BYTE *ptr = m_MachO->getContentAt(sections[index].hdrRaw, hdrSize);
+    if (!ptr) return NULL;
+
+    if (fieldId >= FIELD_COUNTER) return ptr;
+
+    const FieldLayout &field = isSection64 ? s_section64[fieldId] : s_section32[fieldId];
+    if (field.size == 0) return NULL;
+    return ptr + field.offset;
+}
+
+bufsize_t MachOSectionsWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+    const bool isSection64 = is64(index);
+
+    if (fieldId >= FIELD_COUNTER) return isSection64 ? sizeof(macho::section_64) : sizeof(macho::section);
+    return isSection64 ? s_section64[fieldId].size : s_section32[fieldId].size;
+}
+
+QString MachOSectionsWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case SECT_NAME: return "Name";
+        case SEG_NAME: return "Segment name";
+        case ADDR: return "Address";
+        case SIZE: return "Size";
+        case OFFSET: return "File offset";
+        case ALIGN: return "Alignment (power of 2)";
+        case REL_OFFSET: return "Relocations offset";
+        case NRELOC: return "Number of relocations";
+        case FLAGS: return "Flags";
+        case RESERVED1: return "Reserved1";
+        case RESERVED2: return "Reserved2";
+        case RESERVED3: return "Reserved3";
+    }
+    return getName();
+}
+
+Executable::addr_type MachOSectionsWrapper::containsAddrType(size_t fieldId, size_t subField)
+{
+    switch (fieldId) {
+        case ADDR: return Executable::VA;
+        case OFFSET: case REL_OFFSET: return Executable::RAW;
+    }
+    return Executable::NOT_ADDR;
+}
+
+WrappedValue::data_type MachOSectionsWrapper::containsDataType(size_t fieldId, size_t subField)
+{
+    if (fieldId == SECT_NAME || fieldId == SEG_NAME) return WrappedValue::STRING;
+    return WrappedValue::INT;
+}
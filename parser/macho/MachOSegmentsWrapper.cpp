@@ -0,0 +1,120 @@
+#include "macho/MachOSegmentsWrapper.h"
+#include "macho/MachOFile.h"
+
+namespace {
+    struct FieldLayout {
+        size_t offset;
+        bufsize_t size;
+    };
+
+#define SEGMENT_FIELD(type, field) { offsetof(type, field), sizeof(type::field) }
+
+    const FieldLayout s_segment32[MachOSegmentsWrapper::FIELD_COUNTER] = {
+        SEGMENT_FIELD(macho::segment_command, segname),
+        SEGMENT_FIELD(macho::segment_command, vmaddr),
+        SEGMENT_FIELD(macho::segment_command, vmsize),
+        SEGMENT_FIELD(macho::segment_command, fileoff),
+        SEGMENT_FIELD(macho::segment_command, filesize),
+        SEGMENT_FIELD(macho::segment_command, maxprot),
+        SEGMENT_FIELD(macho::segment_command, initprot),
+        SEGMENT_FIELD(macho::segment_command, nsects),
+        SEGMENT_FIELD(macho::segment_command, flags)
+    };
+
+    const FieldLayout s_segment64[MachOSegmentsWrapper::FIELD_COUNTER] = {
+        SEGMENT_FIELD(macho::segment_command_64, segname),
+        SEGMENT_FIELD(macho::segment_command_64, vmaddr),
+        SEGMENT_FIELD(macho::segment_command_64, vmsize),
+        SEGMENT_FIELD(macho::segment_command_64, fileoff),
+        SEGMENT_FIELD(macho::segment_command_64, filesize),
+        SEGMENT_FIELD(macho::segment_command_64, maxprot),
+        SEGMENT_FIELD(macho::segment_command_64, initprot),
+        SEGMENT_FIELD(macho::segment_command_64, nsects),
+        SEGMENT_FIELD(macho::segment_command_64, flags)
+    };
+
+#undef SEGMENT_FIELD
+};
+
+void* MachOSegmentsWrapper::getPtr()
+{
+    ExeElementWrapper *commands = m_MachO->getWrapper(MachOFile::WR_LOAD_CMDS);
+    return commands ? commands->getPtr() : NULL;
+}
+
+bufsize_t MachOSegmentsWrapper::getSize()
+{
+    ExeElementWrapper *commands = m_MachO->getWrapper(MachOFile::WR_LOAD_CMDS);
+    return commands ? commands->getSize() : 0;
+}
+
+size_t MachOSegmentsWrapper::getSubFieldsCount()
+{
+    return m_MachO->getSegments().size();
+}
+
+bool MachOSegmentsWrapper::is64(size_t index)
+{
+    // the type of the command, rather than the one of the file
+    const std::vector<MachOSegment> &segments = m_MachO->getSegments();
+    if (index >= segments.size()) return isBit64();
+
+    const uint32_t *cmd = (const uint32_t*) m_MachO->getContentAt(segments[index].cmdRaw, sizeof(uint32_t));
+    return cmd ? (*cmd == LC_SEGMENT_64) : isBit64();
+}
+
+void* MachOSegmentsWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+
+    const std::vector<MachOSegment> &segments = m_MachO->getSegments();
+    if (index >= segments.size()) return NULL;
+
+    const bool isSegment64 = is64(index);
+    const bufsize_t cmdSize = isSegment64 ? sizeof(macho::segment_command_64) : sizeof(macho::segment_command);
+    BYTE *ptr = m_MachO->getContentAt(segments[index].cmdRaw, cmdSize);
+    if (!ptr) return NULL;
+
+    if (fieldId >= FIELD_COUNTER) return ptr;
+    return ptr + (isSegment64 ? s_segment64[fieldId].offset : s_segment32[fieldId].offset);
+}
+
+bufsize_t MachOSegmentsWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    const size_t index = (subField == size_t(FIELD_NONE)) ? 0 : subField;
+    const bool isSegment64 = is64(index);
+
+    if (fieldId >= FIELD_COUNTER) return isSegment64 ? sizeof(macho::segment_command_64) : sizeof(macho::segment_command);
+    return isSegment64 ? s_segment64[fieldId].size : s_segment32[fieldId].size;
+}
+
+QString MachOSegmentsWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case SEG_NAME: return "Name";
+        case VM_ADDR: return "VM address";
+        case VM_SIZE: return "VM size";
+        case FILE_OFFSET: return "File offset";
+        case FILE_SIZE: return "File size";
+        case MAX_PROT: return "Max. protection";
+        case INIT_PROT: return "Initial protection";
+        case NSECTS: return "Number of sections";
+        case FLAGS: return "Flags";
+    }
+    return getName();
+}
+
+Executable::addr_type MachOSegmentsWrapper::containsAddrType(size_t fieldId, size_t subField)
+{
+    switch (fieldId) {
+        case VM_ADDR: return Executable::VA;
+        case FILE_OFFSET: return Executable::RAW;
+    }
+    return Executable::NOT_ADDR;
+}
+
+WrappedValue::data_type MachOSegmentsWrapper::containsDataType(size_t fieldId, size_t subField)
+{
+    if (fieldId == SEG_NAME) return WrappedValue::STRING;
+    return WrappedValue::INT;
+}
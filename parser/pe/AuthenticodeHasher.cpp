@@ -0,0 +1,123 @@
+#include "pe/AuthenticodeHasher.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+    inline bool isRangeBefore(const DigestRange &a, const DigestRange &b)
+    {
+        return a.offset < b.offset;
+    }
+
+}; //namespace
+
+bool AuthenticodeHasher::addExcluded(PEFile *pe, std::vector<DigestRange> &excluded)
+{
+    OptHdrWrapper *optHdr = dynamic_cast<OptHdrWrapper*>(pe->getWrapper(PEFile::WR_OPTIONAL_HDR));
+    if (!optHdr) return false;
+
+    const offset_t checksumOffset = optHdr->getFieldOffset(OptHdrWrapper::CHECKSUM);
+    if (checksumOffset == INVALID_ADDR) return false;
+    excluded.push_back(DigestRange(checksumOffset, sizeof(DWORD)));
+
+    DataDirWrapper *dataDir = dynamic_cast<DataDirWrapper*>(pe->getWrapper(PEFile::WR_DATADIR));
+    if (!dataDir || dataDir->getDirsCount() <= pe::DIR_SECURITY) {
+        // no Security entry: nothing more to skip
+        return true;
+    }
+    const offset_t entryOffset = dataDir->getFieldOffset(pe::DIR_SECURITY, DataDirWrapper::ADDRESS);
+    if (entryOffset == INVALID_ADDR) return false;
+    excluded.push_back(DigestRange(entryOffset, sizeof(IMAGE_DATA_DIRECTORY)));
+
+    IMAGE_DATA_DIRECTORY *ddir = pe->getDataDirectory();
+    if (!ddir) return false;
+
+    // the address of the Security directory is a raw offset
+    const offset_t certOffset = ddir[pe::DIR_SECURITY].VirtualAddress;
+    const bufsize_t certSize = ddir[pe::DIR_SECURITY].Size;
+    if (certOffset != 0 && certSize != 0 && certOffset < pe->getRawSize()) {
+        excluded.push_back(DigestRange(certOffset, certSize));
+    }
+    return true;
+}
+
+bool AuthenticodeHasher::getDigestRanges(PEFile *pe, std::vector<DigestRange> &ranges)
+{
+    if (!pe) return false;
+
+    std::vector<DigestRange> excluded;
+    if (!addExcluded(pe, excluded)) {
+        Logger::append(Logger::D_ERROR, "Cannot find the ranges excluded from the digest");
+        return false;
+    }
+    std::sort(excluded.begin(), excluded.end(), isRangeBefore);
+
+    const offset_t fileSize = pe->getRawSize();
+    offset_t offset = 0;
+    for (size_t i = 0; i < excluded.size(); i++) {
+        const DigestRange &skip = excluded[i];
+        if (skip.offset > offset) {
+            ranges.push_back(DigestRange(offset, static_cast<bufsize_t>(std::min(skip.offset, fileSize) - offset)));
+        }
+        const offset_t skipEnd = std::min(static_cast<offset_t>(skip.offset + skip.size), fileSize);
+        offset = std::max(offset, skipEnd);
+    }
+    if (offset < fileSize) {
+        ranges.push_back(DigestRange(offset, static_cast<bufsize_t>(fileSize - offset)));
+    }
+    return true;
+}
+
+QByteArray AuthenticodeHasher::hashRanges(PEFile *pe, const std::vector<DigestRange> &ranges, QCryptographicHash::Algorithm algo)
+{
+    if (!pe) return QByteArray();
+
+    static const BYTE zeros[sizeof(IMAGE_DATA_DIRECTORY)] = { 0 };
+
+    QCryptographicHash hash(algo);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        offset_t offset = ranges[i].offset;
+        bufsize_t remaining = ranges[i].size;
+        while (ranges[i].zeroed && remaining > 0) {
+            const bufsize_t chunkSize = std::min<bufsize_t>(remaining, sizeof(zeros));
+            hash.addData(reinterpret_cast<const char*>(zeros), static_cast<int>(chunkSize));
+            remaining -= chunkSize;
+        }
+        while (remaining > 0) {
+            // addData takes the size as int
+            const bufsize_t chunkSize = std::min(remaining, MAX_HASHED_CHUNK);
+            const BYTE *ptr = pe->getContentAt(offset, Executable::RAW, chunkSize);
+            if (!ptr) {
+                Logger::append(Logger::D_ERROR, "Cannot fetch the content at: %llX", static_cast<unsigned long long>(offset));
+                return QByteArray();
+            }
+            hash.addData(reinterpret_cast<const char*>(ptr), static_cast<int>(chunkSize));
+            offset += chunkSize;
+            remaining -= chunkSize;
+        }
+    }
+    return hash.result();
+}
+
+QByteArray AuthenticodeHasher::computeDigest(PEFile *pe, QCryptographicHash::Algorithm algo)
+{
+    std::vector<DigestRange> ranges;
+    if (!getDigestRanges(pe, ranges)) return QByteArray();
+
+    return hashRanges(pe, ranges, algo);
+}
+
+size_t AuthenticodeHasher::computeDigests(const std::vector<PEFile*> &pes, QCryptographicHash::Algorithm algo,
+    std::vector<QByteArray> &digests, size_t threads)
+{
+    digests.assign(pes.size(), QByteArray());
+    if (pes.size() == 0) return 0;
+
+    std::atomic<size_t> computed(0);
+    pe_util::parallelFor(pes.size(), threads, [&](size_t indx) {
+        digests[indx] = computeDigest(pes[indx], algo);
+        if (digests[indx].size()) computed++;
+    });
+    return computed;
+}
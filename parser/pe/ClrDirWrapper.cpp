@@ -1,4 +1,6 @@
 #include "pe/ClrDirWrapper.h"
+#include "pe/PEFile.h"
+#include "pe/StrongNameHasher.h"
 
 /*
 typedef struct IMAGE_COR20_HEADER
@@ -53,6 +55,14 @@ pe::IMAGE_COR20_HEADER* ClrDirWrapper::clrDir()
 
 bool ClrDirWrapper::wrap()
 {
+    clear();
+    pe::IMAGE_COR20_HEADER* d = clrDir();
+    if (!d || d->MetaData.VirtualAddress == 0) return true;
+
+    metadata = new ClrMetadata(m_Exe, d->MetaData.VirtualAddress, d->MetaData.Size);
+    if (!metadata->isValid()) {
+        clear();
+    }
     return true;
 }
 
@@ -232,3 +242,48 @@ QString ClrDirWrapper::translateFieldContent(size_t fieldId)
     return list.join(";");
 }
 
+size_t ClrDirWrapper::getManagedResources(std::vector<ClrManagedResource> &resources)
+{
+    const pe::IMAGE_COR20_HEADER* d = clrDir();
+    if (!d || !metadata) return 0;
+
+    const ClrTable &table = metadata->getTable(ClrMetadata::TABLE_MANIFEST_RESOURCE);
+    const uint32_t count = table.getRowsCount();
+    resources.reserve(resources.size() + count);
+
+    for (uint32_t rid = 1; rid <= count; rid++) {
+        ClrManagedResource resource;
+        resource.name = metadata->getString(table.getValue(rid, ClrMetadata::MANIFESTRES_NAME));
+        resource.flags = table.getValue(rid, ClrMetadata::MANIFESTRES_FLAGS);
+        resource.implementation = table.getValue(rid, ClrMetadata::MANIFESTRES_IMPLEMENTATION);
+        resource.raw = INVALID_ADDR;
+        resource.size = 0;
+
+        // embedded: { DWORD length; BYTE data[length] } at the offset in the Resources blob
+        const DWORD offset = table.getValue(rid, ClrMetadata::MANIFESTRES_OFFSET);
+        const DWORD blobSize = d->Resources.Size;
+        if (resource.implementation == 0 && d->Resources.VirtualAddress != 0 && blobSize >= sizeof(DWORD) && offset <= blobSize - sizeof(DWORD)) {
+            const offset_t rva = offset_t(d->Resources.VirtualAddress) + offset;
+            const DWORD *length = (DWORD*) m_Exe->getContentAt(rva, Executable::RVA, sizeof(DWORD));
+            if (length && *length <= blobSize - offset - sizeof(DWORD)
+                && m_Exe->getContentAt(rva + sizeof(DWORD), Executable::RVA, *length))
+            {
+                resource.raw = m_Exe->rvaToRaw(rva + sizeof(DWORD));
+                resource.size = (resource.raw != INVALID_ADDR) ? *length : 0;
+            }
+        }
+        resources.push_back(resource);
+    }
+    return count;
+}
+
+BufferView* ClrDirWrapper::createResourceView(const ClrManagedResource &resource)
+{
+    if (resource.raw == INVALID_ADDR) return NULL;
+    return new BufferView(m_Exe, resource.raw, resource.size);
+}
+
+QByteArray ClrDirWrapper::computeStrongNameHash()
+{
+    return StrongNameHasher::computeHash(m_PE);
+}
@@ -0,0 +1,516 @@
+#include "pe/ClrMetadata.h"
+
+#include <cstring>
+
+/*
+ECMA-335 II.24.2.1: the metadata root
+    DWORD Signature;        // "BSJB"
+    WORD MajorVersion;
+    WORD MinorVersion;
+    DWORD Reserved;
+    DWORD Length;           // of the version string, padded to 4
+    char Version[Length];
+    WORD Flags;
+    WORD Streams;
+    followed by the stream headers: { DWORD Offset; DWORD Size; char Name[]; } the name padded to 4, up to 32 characters
+
+ECMA-335 II.24.2.6: the "#~" stream
+    DWORD Reserved;
+    BYTE MajorVersion;
+    BYTE MinorVersion;
+    BYTE HeapSizes;
+    BYTE Reserved;
+    QWORD Valid;            // the bit vector of the present tables
+    QWORD Sorted;
+    DWORD Rows[];           // one per present table
+    followed by the tables
+*/
+
+namespace {
+    const bufsize_t ROOT_HDR_SIZE = 16; // up to the version string
+    const bufsize_t STREAM_NAME_MAX = 32;
+    const WORD STREAMS_MAX = 64;        // the runtime accepts just a few
+    const bufsize_t TABLES_HDR_SIZE = 24;
+    const size_t VALID_BITS = 64;
+    const bufsize_t GUID_SIZE = 16;
+
+    const BYTE HEAP_STRING_4 = 0x01;
+    const BYTE HEAP_GUID_4 = 0x02;
+    const BYTE HEAP_BLOB_4 = 0x04;
+    const BYTE HEAP_EXTRA_DATA = 0x40;  // a DWORD follows the row counts (0x20 is: delta only)
+
+    // the kinds of the columns; below COL_CODED: a simple index to the table of this ID
+    const BYTE COL_CODED = 0x40;        // + ClrMetadata::coded_index
+    const BYTE COL_U16 = 0x80;
+    const BYTE COL_U32 = 0x81;
+    const BYTE COL_STRING = 0x82;
+    const BYTE COL_GUID = 0x83;
+    const BYTE COL_BLOB = 0x84;
+
+    const BYTE TDOR = COL_CODED + ClrMetadata::CI_TYPE_DEF_OR_REF;
+    const BYTE HCON = COL_CODED + ClrMetadata::CI_HAS_CONSTANT;
+    const BYTE HCA = COL_CODED + ClrMetadata::CI_HAS_CUSTOM_ATTRIBUTE;
+    const BYTE HFM = COL_CODED + ClrMetadata::CI_HAS_FIELD_MARSHAL;
+    const BYTE HDS = COL_CODED + ClrMetadata::CI_HAS_DECL_SECURITY;
+    const BYTE MRP = COL_CODED + ClrMetadata::CI_MEMBER_REF_PARENT;
+    const BYTE HSEM = COL_CODED + ClrMetadata::CI_HAS_SEMANTICS;
+    const BYTE MDOR = COL_CODED + ClrMetadata::CI_METHOD_DEF_OR_REF;
+    const BYTE MFWD = COL_CODED + ClrMetadata::CI_MEMBER_FORWARDED;
+    const BYTE IMPL = COL_CODED + ClrMetadata::CI_IMPLEMENTATION;
+    const BYTE CAT = COL_CODED + ClrMetadata::CI_CUSTOM_ATTRIBUTE_TYPE;
+    const BYTE RS = COL_CODED + ClrMetadata::CI_RESOLUTION_SCOPE;
+    const BYTE TOMD = COL_CODED + ClrMetadata::CI_TYPE_OR_METHOD_DEF;
+
+    struct TableDef {
+        const char *name;
+        size_t columnsCount;
+        BYTE columns[ClrTable::MAX_COLUMNS];
+    };
+
+    // ECMA-335 II.22, in the order of the IDs
+    const TableDef TABLE_DEFS[ClrMetadata::TABLES_COUNT] = {
+        { "Module", 5, { COL_U16, COL_STRING, COL_GUID, COL_GUID, COL_GUID } },
+        { "TypeRef", 3, { RS, COL_STRING, COL_STRING } },
+        { "TypeDef", 6, { COL_U32, COL_STRING, COL_STRING, TDOR, ClrMetadata::TABLE_FIELD, ClrMetadata::TABLE_METHOD_DEF } },
+        { "FieldPtr", 1, { ClrMetadata::TABLE_FIELD } },
+        { "Field", 3, { COL_U16, COL_STRING, COL_BLOB } },
+        { "MethodPtr", 1, { ClrMetadata::TABLE_METHOD_DEF } },
+        { "MethodDef", 6, { COL_U32, COL_U16, COL_U16, COL_STRING, COL_BLOB, ClrMetadata::TABLE_PARAM } },
+        { "ParamPtr", 1, { ClrMetadata::TABLE_PARAM } },
+        { "Param", 3, { COL_U16, COL_U16, COL_STRING } },
+        { "InterfaceImpl", 2, { ClrMetadata::TABLE_TYPE_DEF, TDOR } },
+        { "MemberRef", 3, { MRP, COL_STRING, COL_BLOB } },
+        { "Constant", 3, { COL_U16, HCON, COL_BLOB } },
+        { "CustomAttribute", 3, { HCA, CAT, COL_BLOB } },
+        { "FieldMarshal", 2, { HFM, COL_BLOB } },
+        { "DeclSecurity", 3, { COL_U16, HDS, COL_BLOB } },
+        { "ClassLayout", 3, { COL_U16, COL_U32, ClrMetadata::TABLE_TYPE_DEF } },
+        { "FieldLayout", 2, { COL_U32, ClrMetadata::TABLE_FIELD } },
+        { "StandAloneSig", 1, { COL_BLOB } },
+        { "EventMap", 2, { ClrMetadata::TABLE_TYPE_DEF, ClrMetadata::TABLE_EVENT } },
+        { "EventPtr", 1, { ClrMetadata::TABLE_EVENT } },
+        { "Event", 3, { COL_U16, COL_STRING, TDOR } },
+        { "PropertyMap", 2, { ClrMetadata::TABLE_TYPE_DEF, ClrMetadata::TABLE_PROPERTY } },
+        { "PropertyPtr", 1, { ClrMetadata::TABLE_PROPERTY } },
+        { "Property", 3, { COL_U16, COL_STRING, COL_BLOB } },
+        { "MethodSemantics", 3, { COL_U16, ClrMetadata::TABLE_METHOD_DEF, HSEM } },
+        { "MethodImpl", 3, { ClrMetadata::TABLE_TYPE_DEF, MDOR, MDOR } },
+        { "ModuleRef", 1, { COL_STRING } },
+        { "TypeSpec", 1, { COL_BLOB } },
+        { "ImplMap", 4, { COL_U16, MFWD, COL_STRING, ClrMetadata::TABLE_MODULE_REF } },
+        { "FieldRVA", 2, { COL_U32, ClrMetadata::TABLE_FIELD } },
+        { "ENCLog", 2, { COL_U32, COL_U32 } },
+        { "ENCMap", 1, { COL_U32 } },
+        { "Assembly", 9, { COL_U32, COL_U16, COL_U16, COL_U16, COL_U16, COL_U32, COL_BLOB, COL_STRING, COL_STRING } },
+        { "AssemblyProcessor", 1, { COL_U32 } },
+        { "AssemblyOS", 3, { COL_U32, COL_U32, COL_U32 } },
+        { "AssemblyRef", 9, { COL_U16, COL_U16, COL_U16, COL_U16, COL_U32, COL_BLOB, COL_STRING, COL_STRING, COL_BLOB } },
+        { "AssemblyRefProcessor", 2, { COL_U32, ClrMetadata::TABLE_ASSEMBLY_REF } },
+        { "AssemblyRefOS", 4, { COL_U32, COL_U32, COL_U32, ClrMetadata::TABLE_ASSEMBLY_REF } },
+        { "File", 3, { COL_U32, COL_STRING, COL_BLOB } },
+        { "ExportedType", 5, { COL_U32, COL_U32, COL_STRING, COL_STRING, IMPL } },
+        { "ManifestResource", 4, { COL_U32, COL_U32, COL_STRING, IMPL } },
+        { "NestedClass", 2, { ClrMetadata::TABLE_TYPE_DEF, ClrMetadata::TABLE_TYPE_DEF } },
+        { "GenericParam", 4, { COL_U16, COL_U16, TOMD, COL_STRING } },
+        { "MethodSpec", 2, { MDOR, COL_BLOB } },
+        { "GenericParamConstraint", 2, { ClrMetadata::TABLE_GENERIC_PARAM, TDOR } }
+    };
+
+    const BYTE TAG_UNUSED = 0xFF;
+    const size_t CODED_TABLES_MAX = 22;
+
+    struct CodedIndexDef {
+        BYTE tagBits;
+        size_t tablesCount;
+        BYTE tables[CODED_TABLES_MAX];
+    };
+
+    // ECMA-335 II.24.2.6, in the order of the tags
+    const CodedIndexDef CODED_INDEX_DEFS[ClrMetadata::CI_COUNT] = {
+        { 2, 3, { ClrMetadata::TABLE_TYPE_DEF, ClrMetadata::TABLE_TYPE_REF, ClrMetadata::TABLE_TYPE_SPEC } },
+        { 2, 3, { ClrMetadata::TABLE_FIELD, ClrMetadata::TABLE_PARAM, ClrMetadata::TABLE_PROPERTY } },
+        { 5, 22, {
+            ClrMetadata::TABLE_METHOD_DEF, ClrMetadata::TABLE_FIELD, ClrMetadata::TABLE_TYPE_REF, ClrMetadata::TABLE_TYPE_DEF,
+            ClrMetadata::TABLE_PARAM, ClrMetadata::TABLE_INTERFACE_IMPL, ClrMetadata::TABLE_MEMBER_REF, ClrMetadata::TABLE_MODULE,
+            ClrMetadata::TABLE_DECL_SECURITY, ClrMetadata::TABLE_PROPERTY, ClrMetadata::TABLE_EVENT, ClrMetadata::TABLE_STANDALONE_SIG,
+            ClrMetadata::TABLE_MODULE_REF, ClrMetadata::TABLE_TYPE_SPEC, ClrMetadata::TABLE_ASSEMBLY, ClrMetadata::TABLE_ASSEMBLY_REF,
+            ClrMetadata::TABLE_FILE, ClrMetadata::TABLE_EXPORTED_TYPE, ClrMetadata::TABLE_MANIFEST_RESOURCE, ClrMetadata::TABLE_GENERIC_PARAM,
+            ClrMetadata::TABLE_GENERIC_PARAM_CONSTRAINT, ClrMetadata::TABLE_METHOD_SPEC }
+        },
+        { 1, 2, { ClrMetadata::TABLE_FIELD, ClrMetadata::TABLE_PARAM } },
+        { 2, 3, { ClrMetadata::TABLE_TYPE_DEF, ClrMetadata::TABLE_METHOD_DEF, ClrMetadata::TABLE_ASSEMBLY } },
+        { 3, 5, { ClrMetadata::TABLE_TYPE_DEF, ClrMetadata::TABLE_TYPE_REF, ClrMetadata::TABLE_MODULE_REF, ClrMetadata::TABLE_METHOD_DEF, ClrMetadata::TABLE_TYPE_SPEC } },
+        { 1, 2, { ClrMetadata::TABLE_EVENT, ClrMetadata::TABLE_PROPERTY } },
+        { 1, 2, { ClrMetadata::TABLE_METHOD_DEF, ClrMetadata::TABLE_MEMBER_REF } },
+        { 1, 2, { ClrMetadata::TABLE_FIELD, ClrMetadata::TABLE_METHOD_DEF } },
+        { 2, 3, { ClrMetadata::TABLE_FILE, ClrMetadata::TABLE_ASSEMBLY_REF, ClrMetadata::TABLE_EXPORTED_TYPE } },
+        { 3, 5, { TAG_UNUSED, TAG_UNUSED, ClrMetadata::TABLE_METHOD_DEF, ClrMetadata::TABLE_MEMBER_REF, TAG_UNUSED } },
+        { 2, 4, { ClrMetadata::TABLE_MODULE, ClrMetadata::TABLE_MODULE_REF, ClrMetadata::TABLE_ASSEMBLY_REF, ClrMetadata::TABLE_TYPE_REF } },
+        { 1, 2, { ClrMetadata::TABLE_TYPE_DEF, ClrMetadata::TABLE_METHOD_DEF } }
+    };
+
+    WORD readWord(const BYTE *ptr)
+    {
+        return WORD(ptr[0]) | (WORD(ptr[1]) << 8);
+    }
+
+    DWORD readDword(const BYTE *ptr)
+    {
+        return DWORD(ptr[0]) | (DWORD(ptr[1]) << 8) | (DWORD(ptr[2]) << 16) | (DWORD(ptr[3]) << 24);
+    }
+
+    uint64_t readQword(const BYTE *ptr)
+    {
+        return uint64_t(readDword(ptr)) | (uint64_t(readDword(ptr + sizeof(DWORD))) << 32);
+    }
+};
+
+QString ClrMetadata::getTableName(table_id table)
+{
+    if (table >= TABLES_COUNT) return "";
+    return TABLE_DEFS[table].name;
+}
+
+bool ClrMetadata::decodeCodedIndex(coded_index kind, uint32_t value, table_id &table, uint32_t &rid)
+{
+    if (kind >= CI_COUNT) return false;
+
+    const CodedIndexDef &def = CODED_INDEX_DEFS[kind];
+    const uint32_t tag = value & ((1u << def.tagBits) - 1);
+    if (tag >= def.tablesCount || def.tables[tag] == TAG_UNUSED) return false;
+
+    table = static_cast<table_id>(def.tables[tag]);
+    rid = value >> def.tagBits;
+    return true;
+}
+
+bufsize_t ClrMetadata::readCompressedUInt(const BYTE *ptr, bufsize_t available, uint32_t &value)
+{
+    if (!ptr || available == 0) return 0;
+
+    if ((ptr[0] & 0x80) == 0) {
+        value = ptr[0];
+        return 1;
+    }
+    if ((ptr[0] & 0xC0) == 0x80) {
+        if (available < 2) return 0;
+        value = (uint32_t(ptr[0] & 0x3F) << 8) | ptr[1];
+        return 2;
+    }
+    if ((ptr[0] & 0xE0) == 0xC0) {
+        if (available < 4) return 0;
+        value = (uint32_t(ptr[0] & 0x1F) << 24) | (uint32_t(ptr[1]) << 16) | (uint32_t(ptr[2]) << 8) | ptr[3];
+        return 4;
+    }
+    return 0;
+}
+
+ClrMetadata::ClrMetadata(Executable *exe, offset_t rva, bufsize_t size)
+    : root(NULL), rootRva(rva), rootSize(size),
+    majorVersion(0), minorVersion(0),
+    stringsHeap(NULL), stringsSize(0), usHeap(NULL), usSize(0),
+    blobHeap(NULL), blobSize(0), guidHeap(NULL), guidSize(0),
+    uncompressed(false), heapSizes(0), validMask(0), sortedMask(0)
+{
+    if (!exe || rva == 0 || rva == INVALID_ADDR || size < ROOT_HDR_SIZE) return;
+
+    if (!parseRoot(exe)) {
+        root = NULL;
+        streams.clear();
+        return;
+    }
+    parseTables();
+}
+
+bool ClrMetadata::parseRoot(Executable *exe)
+{
+    root = exe->getContentAt(rootRva, Executable::RVA, rootSize);
+    if (!root) {
+        Logger::append(Logger::D_WARNING, "The .NET metadata is out of the image: RVA = %llX, size = %llX",
+            static_cast<unsigned long long>(rootRva), static_cast<unsigned long long>(rootSize));
+        return false;
+    }
+    if (readDword(root) != SIGNATURE) {
+        Logger::append(Logger::D_WARNING, "Invalid signature of the .NET metadata");
+        return false;
+    }
+    majorVersion = readWord(root + 4);
+    minorVersion = readWord(root + 6);
+
+    const DWORD versionLen = readDword(root + 12);
+    // the streams count follows the version and the flags
+    if (rootSize < ROOT_HDR_SIZE + 2 * sizeof(WORD)) return false;
+    if (versionLen > rootSize - ROOT_HDR_SIZE - 2 * sizeof(WORD)) return false;
+
+    const char *version = reinterpret_cast<const char*>(root + ROOT_HDR_SIZE);
+    versionString = QString::fromUtf8(version, static_cast<int>(strnlen(version, versionLen)));
+
+    offset_t offset = ROOT_HDR_SIZE + versionLen + sizeof(WORD);
+    const WORD streamsCount = readWord(root + offset);
+    offset += sizeof(WORD);
+    if (streamsCount > STREAMS_MAX) {
+        Logger::append(Logger::D_WARNING, "Too many streams in the .NET metadata: %u", streamsCount);
+        return false;
+    }
+
+    for (WORD i = 0; i < streamsCount; i++) {
+        if (offset + 2 * sizeof(DWORD) >= rootSize) break;
+
+        ClrStream stream;
+        stream.offset = readDword(root + offset);
+        stream.size = readDword(root + offset + sizeof(DWORD));
+        offset += 2 * sizeof(DWORD);
+
+        const char *name = reinterpret_cast<const char*>(root + offset);
+        const size_t nameLen = strnlen(name, std::min<size_t>(STREAM_NAME_MAX, rootSize - offset));
+        stream.name = std::string(name, nameLen);
+        // the terminator included, padded to 4
+        offset += (nameLen + 1 + 3) & ~offset_t(3);
+
+        if (stream.offset >= rootSize) {
+            Logger::append(Logger::D_WARNING, "The .NET stream %s is out of the metadata", stream.name.c_str());
+            stream.size = 0;
+        } else if (stream.size > rootSize - stream.offset) {
+            stream.size = rootSize - static_cast<bufsize_t>(stream.offset);
+        }
+        streams.push_back(stream);
+    }
+
+    bufsize_t heapSize = 0;
+    const BYTE *heap = getStream(findStream("#Strings"), heapSize);
+    stringsHeap = heap; stringsSize = heapSize;
+    heap = getStream(findStream("#US"), heapSize);
+    usHeap = heap; usSize = heapSize;
+    heap = getStream(findStream("#Blob"), heapSize);
+    blobHeap = heap; blobSize = heapSize;
+    heap = getStream(findStream("#GUID"), heapSize);
+    guidHeap = heap; guidSize = heapSize;
+    return true;
+}
+
+bool ClrMetadata::parseTables()
+{
+    size_t index = findStream("#~");
+    if (index == NOT_FOUND) {
+        index = findStream("#-");
+        uncompressed = (index != NOT_FOUND);
+    }
+    bufsize_t streamSize = 0;
+    const BYTE *stream = getStream(index, streamSize);
+    if (!stream || streamSize < TABLES_HDR_SIZE) return false;
+
+    heapSizes = stream[6];
+    validMask = readQword(stream + 8);
+    sortedMask = readQword(stream + 16);
+
+    offset_t offset = TABLES_HDR_SIZE;
+    uint32_t rows[VALID_BITS] = { 0 };
+    for (size_t i = 0; i < VALID_BITS; i++) {
+        if (!(validMask & (uint64_t(1) << i))) continue;
+        if (offset + sizeof(DWORD) > streamSize) return false;
+
+        rows[i] = readDword(stream + offset);
+        offset += sizeof(DWORD);
+    }
+    if (heapSizes & HEAP_EXTRA_DATA) {
+        offset += sizeof(DWORD);
+    }
+
+    // the sizes of the indices depend on the row counts of all the tables
+    BYTE codedSizes[CI_COUNT] = { 0 };
+    for (size_t ci = 0; ci < CI_COUNT; ci++) {
+        const CodedIndexDef &def = CODED_INDEX_DEFS[ci];
+        uint32_t maxRows = 0;
+        for (size_t t = 0; t < def.tablesCount; t++) {
+            if (def.tables[t] != TAG_UNUSED) maxRows = std::max(maxRows, rows[def.tables[t]]);
+        }
+        codedSizes[ci] = (maxRows < (1u << (16 - def.tagBits))) ? sizeof(WORD) : sizeof(DWORD);
+    }
+
+    for (size_t t = 0; t < TABLES_COUNT; t++) {
+        if (!(validMask & (uint64_t(1) << t))) continue;
+
+        const TableDef &def = TABLE_DEFS[t];
+        ClrTable &table = tables[t];
+        table.columnsCount = def.columnsCount;
+        bufsize_t rowSize = 0;
+        for (size_t c = 0; c < def.columnsCount; c++) {
+            const BYTE kind = def.columns[c];
+            BYTE colSize = sizeof(WORD);
+            if (kind < COL_CODED) {
+                colSize = (rows[kind] > 0xFFFF) ? sizeof(DWORD) : sizeof(WORD);
+            } else if (kind < COL_U16) {
+                colSize = codedSizes[kind - COL_CODED];
+            } else if (kind == COL_U32) {
+                colSize = sizeof(DWORD);
+            } else if (kind == COL_STRING) {
+                colSize = (heapSizes & HEAP_STRING_4) ? sizeof(DWORD) : sizeof(WORD);
+            } else if (kind == COL_GUID) {
+                colSize = (heapSizes & HEAP_GUID_4) ? sizeof(DWORD) : sizeof(WORD);
+            } else if (kind == COL_BLOB) {
+                colSize = (heapSizes & HEAP_BLOB_4) ? sizeof(DWORD) : sizeof(WORD);
+            }
+            table.columnOffsets[c] = static_cast<BYTE>(rowSize);
+            table.columnSizes[c] = colSize;
+            rowSize += colSize;
+        }
+        table.rowSize = rowSize;
+
+        const uint64_t tableSize = uint64_t(rowSize) * rows[t];
+        if (offset > streamSize || tableSize > streamSize - offset) {
+            // the next tables cannot be located either
+            Logger::append(Logger::D_WARNING, "The .NET table %s is out of the stream", def.name);
+            return false;
+        }
+        table.data = stream + offset;
+        table.rows = rows[t];
+        offset += static_cast<offset_t>(tableSize);
+    }
+    // the tables above TABLES_COUNT (i.e. of the portable PDB) are not parsed
+    return true;
+}
+
+//---
+
+size_t ClrMetadata::findStream(const std::string &name) const
+{
+    for (size_t i = 0; i < streams.size(); i++) {
+        if (streams[i].name == name) return i;
+    }
+    return NOT_FOUND;
+}
+
+const BYTE* ClrMetadata::getStream(size_t index, bufsize_t &size) const
+{
+    size = 0;
+    if (!root || index >= streams.size() || streams[index].size == 0) return NULL;
+
+    size = streams[index].size;
+    return root + streams[index].offset;
+}
+
+std::string_view ClrMetadata::getString(uint32_t index) const
+{
+    if (!stringsHeap || index >= stringsSize) return std::string_view();
+
+    const char *str = reinterpret_cast<const char*>(stringsHeap + index);
+    const size_t maxLen = static_cast<size_t>(stringsSize - index);
+    const char *end = static_cast<const char*>(memchr(str, 0, maxLen));
+    return std::string_view(str, end ? static_cast<size_t>(end - str) : maxLen);
+}
+
+QString ClrMetadata::getUserString(uint32_t index) const
+{
+    if (!usHeap || index >= usSize) return "";
+
+    uint32_t len = 0;
+    const bufsize_t lenSize = readCompressedUInt(usHeap + index, usSize - index, len);
+    if (lenSize == 0 || len > usSize - index - lenSize) return "";
+
+    // UTF-16, followed by a byte of flags
+    const BYTE *str = usHeap + index + lenSize;
+    QString out;
+    for (uint32_t i = 0; i + 1 < len; i += 2) {
+        out.append(QChar(readWord(str + i)));
+    }
+    return out;
+}
+
+ClrBlob ClrMetadata::getBlob(uint32_t index) const
+{
+    ClrBlob blob = { NULL, 0 };
+    if (!blobHeap || index >= blobSize) return blob;
+
+    uint32_t len = 0;
+    const bufsize_t lenSize = readCompressedUInt(blobHeap + index, blobSize - index, len);
+    if (lenSize == 0 || len > blobSize - index - lenSize) return blob;
+
+    blob.data = blobHeap + index + lenSize;
+    blob.size = len;
+    return blob;
+}
+
+const BYTE* ClrMetadata::getGuid(uint32_t index) const
+{
+    if (!guidHeap || index == 0 || index > guidSize / GUID_SIZE) return NULL;
+    return guidHeap + (index - 1) * GUID_SIZE;
+}
+
+//---
+
+std::string ClrMetadata::getTypeFullName(uint32_t typeRid) const
+{
+    const std::string_view name = getTypeName(typeRid);
+    const std::string_view nameSpace = getTypeNamespace(typeRid);
+    if (nameSpace.empty()) return std::string(name);
+
+    std::string fullName;
+    fullName.reserve(nameSpace.size() + 1 + name.size());
+    fullName.append(nameSpace).append(".").append(name);
+    return fullName;
+}
+
+uint32_t ClrMetadata::getTypeMethods(uint32_t typeRid, uint32_t &firstIndex) const
+{
+    const ClrTable &types = tables[TABLE_TYPE_DEF];
+    const uint32_t listRows = tables[TABLE_METHOD_PTR].isValid() ? tables[TABLE_METHOD_PTR].getRowsCount() : tables[TABLE_METHOD_DEF].getRowsCount();
+
+    firstIndex = 0;
+    if (typeRid == 0 || typeRid > types.getRowsCount()) return 0;
+
+    // the list runs up to the list of the next type
+    const uint32_t first = types.getValue(typeRid, TYPEDEF_METHOD_LIST);
+    const uint32_t end = (typeRid < types.getRowsCount()) ? types.getValue(typeRid + 1, TYPEDEF_METHOD_LIST) : (listRows + 1);
+    if (first == 0 || first > listRows || end <= first) return 0;
+
+    firstIndex = first;
+    return std::min(end, listRows + 1) - first;
+}
+
+uint32_t ClrMetadata::findMethodOwner(uint32_t methodIndex) const
+{
+    const ClrTable &types = tables[TABLE_TYPE_DEF];
+    if (methodIndex == 0) return 0;
+
+    // the last type whose list starts at or before the method; the lists are in ascending order
+    uint32_t lo = 1, hi = types.getRowsCount() + 1;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (types.getValue(mid, TYPEDEF_METHOD_LIST) <= methodIndex) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    const uint32_t owner = lo - 1;
+    uint32_t firstIndex = 0;
+    const uint32_t count = getTypeMethods(owner, firstIndex);
+    if (count == 0 || methodIndex >= firstIndex + count) return 0;
+    return owner;
+}
+
+uint32_t ClrMetadata::resolveMethod(uint32_t methodIndex) const
+{
+    const ClrTable &methodPtrs = tables[TABLE_METHOD_PTR];
+    if (!methodPtrs.isValid()) return methodIndex;
+    return methodPtrs.getValue(methodIndex, 0);
+}
+
+bool ClrMetadata::getMemberRefParent(uint32_t memberRid, table_id &table, uint32_t &rid) const
+{
+    const ClrTable &members = tables[TABLE_MEMBER_REF];
+    if (!members.getRow(memberRid)) return false;
+    return decodeCodedIndex(CI_MEMBER_REF_PARENT, members.getValue(memberRid, MEMBERREF_CLASS), table, rid);
+}
+
+QString ClrMetadata::getAssemblyRefVersion(uint32_t assemblyRid) const
+{
+    const ClrTable &refs = tables[TABLE_ASSEMBLY_REF];
+    if (!refs.getRow(assemblyRid)) return "";
+
+    return QString("%1.%2.%3.%4")
+        .arg(refs.getValue(assemblyRid, ASSEMBLYREF_MAJOR_VER))
+        .arg(refs.getValue(assemblyRid, ASSEMBLYREF_MINOR_VER))
+        .arg(refs.getValue(assemblyRid, ASSEMBLYREF_BUILD_NUM))
+        .arg(refs.getValue(assemblyRid, ASSEMBLYREF_REVISION_NUM));
+}
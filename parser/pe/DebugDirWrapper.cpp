@@ -1,7 +1,66 @@
 #include "pe/DebugDirWrapper.h"
+#include "pe/PEFile.h"
 #include <QtGlobal>
 
+#include <cstring>
+
 using namespace pe;
+
+namespace {
+    // IMAGE_DLLCHARACTERISTICS_EX_*
+    const DWORD EX_CET_COMPAT = 0x01;
+    const DWORD EX_CET_COMPAT_STRICT_MODE = 0x02;
+    const DWORD EX_CET_SET_CONTEXT_IP_VALIDATION_RELAXED_MODE = 0x04;
+    const DWORD EX_CET_DYNAMIC_APIS_ALLOW_IN_PROC = 0x08;
+    const DWORD EX_FORWARD_CFI_COMPAT = 0x40;
+    const DWORD EX_HOTPATCH_COMPATIBLE = 0x80;
+
+    const bufsize_t RSDS_HDR_SIZE = offsetof(DEBUG_RSDSI, szPdb);
+    const bufsize_t NB10_HDR_SIZE = offsetof(DEBUG_NB10, PdbFileName);
+
+    DWORD readDword(const BYTE *ptr)
+    {
+        DWORD val = 0;
+        ::memcpy(&val, ptr, sizeof(DWORD));
+        return val;
+    }
+
+    QString toHex(uint64_t val, int width)
+    {
+        return QString::number(val, 16).toUpper().rightJustified(width, '0');
+    }
+
+    // the string bounded by the end of the record
+    std::string readString(const BYTE *ptr, bufsize_t available)
+    {
+        const BYTE *end = (const BYTE*) ::memchr(ptr, 0, available);
+        return std::string((const char*) ptr, end ? size_t(end - ptr) : size_t(available));
+    }
+};
+
+QString PdbInfo::getId() const
+{
+    QString id;
+    if (cvSignature == CV_SIGNATURE_RSDS) {
+        // the first 3 fields of the GUID are little-endian
+        id = toHex(readDword(guid), 8)
+            + toHex(guid[4] | (guid[5] << 8), 4)
+            + toHex(guid[6] | (guid[7] << 8), 4);
+        for (size_t i = 8; i < sizeof(guid); i++) {
+            id += toHex(guid[i], 2);
+        }
+    } else {
+        id = toHex(readDword(guid), 8);
+    }
+    return id + toHex(age, 1);
+}
+
+QString PdbInfo::getName() const
+{
+    const size_t pos = path.find_last_of("\\/");
+    const std::string name = (pos == std::string::npos) ? path : path.substr(pos + 1);
+    return QString::fromStdString(name).toLower();
+}
 /*
 typedef struct _IMAGE_DEBUG_DIRECTORY {
     DWORD   Characteristics;
@@ -47,6 +106,139 @@ bool DebugDirWrapper::isRepro()
     }
     return false;
 }
+const BYTE* DebugDirWrapper::getRecordData(PEFile *pe, DWORD type, bufsize_t &size)
+{
+    if (!pe) return NULL;
+    DataDirWrapper *dDir = dynamic_cast<DataDirWrapper*>(pe->getWrapper(PEFile::WR_DATADIR));
+    IMAGE_DATA_DIRECTORY *dirs = pe->getDataDirectory();
+    if (!dDir || !dirs || dDir->getDirsCount() <= pe::DIR_DEBUG) return NULL;
+
+    const offset_t rva = dirs[pe::DIR_DEBUG].VirtualAddress;
+    const size_t count = dirs[pe::DIR_DEBUG].Size / sizeof(IMAGE_DEBUG_DIRECTORY);
+    if (rva == 0 || count == 0) return NULL;
+
+    const IMAGE_DEBUG_DIRECTORY *records = (IMAGE_DEBUG_DIRECTORY*) pe->getContentAt(rva, Executable::RVA, static_cast<bufsize_t>(count * sizeof(IMAGE_DEBUG_DIRECTORY)));
+    if (!records) return NULL;
+
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].Type != type) continue;
+
+        // the content is read by the PointerToRawData, as the wrappers do
+        size = records[i].SizeOfData;
+        if (size == 0) return NULL;
+        return pe->getContentAt(records[i].PointerToRawData, Executable::RAW, size);
+    }
+    return NULL;
+}
+
+bool DebugDirWrapper::getPdbInfo(PEFile *pe, PdbInfo &info)
+{
+    bufsize_t size = 0;
+    const BYTE *ptr = getRecordData(pe, DT_CODEVIEW, size);
+    if (!ptr || size < sizeof(DWORD)) return false;
+
+    info.cvSignature = readDword(ptr);
+    ::memset(info.guid, 0, sizeof(info.guid));
+    if (info.cvSignature == CV_SIGNATURE_RSDS) {
+        if (size < RSDS_HDR_SIZE) return false;
+        const DEBUG_RSDSI *rsds = (DEBUG_RSDSI*) ptr;
+        ::memcpy(info.guid, &rsds->guidSig, sizeof(info.guid));
+        info.age = rsds->age;
+        info.path = readString(ptr + RSDS_HDR_SIZE, size - RSDS_HDR_SIZE);
+        return true;
+    }
+    if (info.cvSignature == CV_SIGNATURE_NB10) {
+        if (size < NB10_HDR_SIZE) return false;
+        const DEBUG_NB10 *nb = (DEBUG_NB10*) ptr;
+        ::memcpy(info.guid, &nb->Signature, sizeof(DWORD));
+        info.age = nb->Age;
+        info.path = readString(ptr + NB10_HDR_SIZE, size - NB10_HDR_SIZE);
+        return true;
+    }
+    return false;
+}
+
+QString DebugDirWrapper::getPdbKey(PEFile *pe)
+{
+    PdbInfo info;
+    if (!getPdbInfo(pe, info) || info.path.empty()) return "";
+    return info.getKey();
+}
+
+size_t DebugDirWrapper::getPogoEntries(PEFile *pe, std::vector<PogoEntry> &entries, DWORD *signature)
+{
+    bufsize_t size = 0;
+    const BYTE *ptr = getRecordData(pe, DT_POGO, size);
+    if (!ptr || size < sizeof(DWORD)) return 0;
+
+    if (signature) *signature = readDword(ptr);
+
+    // after the signature: { DWORD rva; DWORD size; char name[]; } aligned to 4
+    const size_t entryHdrSize = 2 * sizeof(DWORD);
+    size_t initialSize = entries.size();
+    bufsize_t offset = sizeof(DWORD);
+    while (offset + entryHdrSize < size) {
+        PogoEntry entry;
+        entry.rva = readDword(ptr + offset);
+        entry.size = readDword(ptr + offset + sizeof(DWORD));
+        offset += entryHdrSize;
+        entry.name = readString(ptr + offset, size - offset);
+        if (entry.rva == 0 && entry.size == 0 && entry.name.empty()) break;
+
+        offset += static_cast<bufsize_t>(entry.name.length() + 1);
+        offset = (offset + 3) & ~bufsize_t(3);
+        entries.push_back(entry);
+    }
+    return entries.size() - initialSize;
+}
+
+bool DebugDirWrapper::getVcFeature(PEFile *pe, VcFeatureInfo &info)
+{
+    bufsize_t size = 0;
+    const BYTE *ptr = getRecordData(pe, DT_VC_FEATURE, size);
+    if (!ptr || size < 5 * sizeof(DWORD)) return false;
+
+    info.preVc11 = readDword(ptr);
+    info.cCpp = readDword(ptr + 4);
+    info.gs = readDword(ptr + 8);
+    info.sdl = readDword(ptr + 12);
+    info.guardN = readDword(ptr + 16);
+    return true;
+}
+
+bool DebugDirWrapper::getExDllCharacteristics(PEFile *pe, DWORD &flags)
+{
+    bufsize_t size = 0;
+    const BYTE *ptr = getRecordData(pe, DT_EX_DLLCHARACTERISTICS, size);
+    if (!ptr || size < sizeof(DWORD)) return false;
+
+    flags = readDword(ptr);
+    return true;
+}
+
+QString DebugDirWrapper::translateExDllCharacteristics(DWORD flags)
+{
+    QStringList list;
+    if (flags & EX_CET_COMPAT) list.append("CET_COMPAT");
+    if (flags & EX_CET_COMPAT_STRICT_MODE) list.append("CET_COMPAT_STRICT_MODE");
+    if (flags & EX_CET_SET_CONTEXT_IP_VALIDATION_RELAXED_MODE) list.append("CET_SET_CONTEXT_IP_VALIDATION_RELAXED_MODE");
+    if (flags & EX_CET_DYNAMIC_APIS_ALLOW_IN_PROC) list.append("CET_DYNAMIC_APIS_ALLOW_IN_PROC");
+    if (flags & EX_FORWARD_CFI_COMPAT) list.append("FORWARD_CFI_COMPAT");
+    if (flags & EX_HOTPATCH_COMPATIBLE) list.append("HOTPATCH_COMPATIBLE");
+    return list.join(";");
+}
+
+QByteArray DebugDirWrapper::getReproHash(PEFile *pe)
+{
+    bufsize_t size = 0;
+    const BYTE *ptr = getRecordData(pe, DT_REPRO, size);
+    if (!ptr || size < sizeof(DWORD)) return QByteArray();
+
+    // { DWORD length; BYTE hash[length]; }
+    const DWORD length = readDword(ptr);
+    if (length == 0 || length > size - sizeof(DWORD)) return QByteArray();
+    return QByteArray((const char*) ptr + sizeof(DWORD), length);
+}
 //---
 
 bool DebugDirEntryWrapper::wrap()
@@ -131,6 +323,10 @@ QString DebugDirEntryWrapper::translateType(int type)
         case pe::DT_ILTCG : return "ILTCG";
         case pe::DT_MPX : return "MPX";
         case pe::DT_REPRO : return "REPRO";
+        case pe::DT_EMBEDDED_PORTABLE_PDB : return "Embedded Portable PDB";
+        case pe::DT_SPGO : return "SPGO";
+        case pe::DT_PDB_CHECKSUM : return "PDB Checksum";
+        case pe::DT_EX_DLLCHARACTERISTICS : return "Extended DLL Characteristics";
     }
     return "<Unknown>";
 }
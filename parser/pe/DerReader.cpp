@@ -0,0 +1,295 @@
+#include "pe/DerReader.h"
+
+#include <cstring>
+
+namespace {
+
+    struct OidName
+    {
+        const char *oid;
+        const char *name;
+    };
+
+    const OidName KNOWN_OIDS[] = {
+        { "1.2.840.113549.2.5", "md5" },
+        { "1.3.14.3.2.26", "sha1" },
+        { "2.16.840.1.101.3.4.2.1", "sha256" },
+        { "2.16.840.1.101.3.4.2.2", "sha384" },
+        { "2.16.840.1.101.3.4.2.3", "sha512" },
+        { "1.2.840.113549.1.1.1", "rsaEncryption" },
+        { "1.2.840.113549.1.1.4", "md5WithRSAEncryption" },
+        { "1.2.840.113549.1.1.5", "sha1WithRSAEncryption" },
+        { "1.2.840.113549.1.1.11", "sha256WithRSAEncryption" },
+        { "1.2.840.113549.1.1.12", "sha384WithRSAEncryption" },
+        { "1.2.840.113549.1.1.13", "sha512WithRSAEncryption" },
+        { "1.2.840.10045.2.1", "ecPublicKey" },
+        { "1.2.840.10045.4.3.2", "ecdsa-with-SHA256" },
+        { "1.2.840.10045.4.3.3", "ecdsa-with-SHA384" },
+        { "1.2.840.113549.1.7.1", "data" },
+        { "1.2.840.113549.1.7.2", "signedData" },
+        { "1.2.840.113549.1.9.1", "emailAddress" },
+        { "1.2.840.113549.1.9.3", "contentType" },
+        { "1.2.840.113549.1.9.4", "messageDigest" },
+        { "1.2.840.113549.1.9.5", "signingTime" },
+        { "1.2.840.113549.1.9.6", "counterSignature" },
+        { "1.3.6.1.4.1.311.2.1.4", "SPC_INDIRECT_DATA" },
+        { "1.3.6.1.4.1.311.2.1.11", "SPC_STATEMENT_TYPE" },
+        { "1.3.6.1.4.1.311.2.1.12", "SPC_SP_OPUS_INFO" },
+        { "1.3.6.1.4.1.311.2.1.15", "SPC_PE_IMAGE_DATA" },
+        { "1.3.6.1.4.1.311.2.4.1", "SPC_NESTED_SIGNATURE" },
+        { "1.3.6.1.4.1.311.3.3.1", "RFC3161_COUNTERSIGNATURE" },
+        { "2.5.4.3", "CN" },
+        { "2.5.4.5", "serialNumber" },
+        { "2.5.4.6", "C" },
+        { "2.5.4.7", "L" },
+        { "2.5.4.8", "ST" },
+        { "2.5.4.10", "O" },
+        { "2.5.4.11", "OU" },
+        { NULL, NULL }
+    };
+
+}; //namespace
+
+//----
+
+DerNode DerNode::read(const BYTE *ptr, const BYTE *limit)
+{
+    DerNode node;
+    if (!ptr || !limit || ptr >= limit) return node;
+
+    const bufsize_t available = static_cast<bufsize_t>(limit - ptr);
+    if (available < 2) return node;
+
+    const BYTE tag = ptr[0];
+    if ((tag & 0x1F) == 0x1F) return node; // multi-byte tags are not used by the supported structures
+
+    bufsize_t hdrSize = 2;
+    bufsize_t contentSize = ptr[1];
+    if (contentSize & 0x80) {
+        const bufsize_t lenBytes = contentSize & 0x7F;
+        // 0 means indefinite length: not allowed in DER
+        if (lenBytes == 0 || lenBytes > sizeof(DWORD) || (hdrSize + lenBytes) > available) return node;
+
+        contentSize = 0;
+        for (bufsize_t i = 0; i < lenBytes; i++) {
+            contentSize = (contentSize << 8) | ptr[hdrSize + i];
+        }
+        hdrSize += lenBytes;
+    }
+    if (contentSize > (available - hdrSize)) return node;
+
+    node.ptr = ptr;
+    node.limit = limit;
+    node.tag = tag;
+    node.hdrSize = hdrSize;
+    node.contentSize = contentSize;
+    return node;
+}
+
+DerNode DerNode::firstChild() const
+{
+    if (!isValid() || !isConstructed()) return DerNode();
+    return read(getContent(), getContent() + contentSize);
+}
+
+DerNode DerNode::next() const
+{
+    if (!isValid()) return DerNode();
+    return read(ptr + getSize(), limit);
+}
+
+DerNode DerNode::child(size_t index) const
+{
+    DerNode node = firstChild();
+    for (size_t i = 0; i < index && node.isValid(); i++) {
+        node = node.next();
+    }
+    return node;
+}
+
+size_t DerNode::childrenCount() const
+{
+    size_t count = 0;
+    for (DerNode node = firstChild(); node.isValid(); node = node.next()) {
+        count++;
+    }
+    return count;
+}
+
+DerNode DerNode::findChild(BYTE childTag, size_t startIndex) const
+{
+    DerNode node = child(startIndex);
+    for (; node.isValid(); node = node.next()) {
+        if (node.getTag() == childTag) return node;
+    }
+    return DerNode();
+}
+
+bool DerNode::isOid(const BYTE *oid, bufsize_t oidSize) const
+{
+    if (!isValid() || tag != der::TAG_OID || !oid) return false;
+    // DER has a single encoding of each OID
+    return contentSize == oidSize && memcmp(getContent(), oid, oidSize) == 0;
+}
+
+//----
+
+QString der_util::oidToString(const DerNode &node)
+{
+    if (!node.isValid() || node.getTag() != der::TAG_OID || node.getContentSize() == 0) return "";
+
+    const BYTE *content = node.getContent();
+    const bufsize_t size = node.getContentSize();
+
+    std::string str;
+    uint64_t value = 0;
+    bool isFirst = true;
+    for (bufsize_t i = 0; i < size; i++) {
+        value = (value << 7) | (content[i] & 0x7F);
+        if (content[i] & 0x80) continue; // continued in the next byte
+
+        char buf[32] = { 0 };
+        if (isFirst) {
+            const uint64_t first = (value < 80) ? (value / 40) : 2;
+            snprintf(buf, sizeof(buf), "%llu.%llu", static_cast<unsigned long long>(first), static_cast<unsigned long long>(value - (first * 40)));
+            isFirst = false;
+        } else {
+            snprintf(buf, sizeof(buf), ".%llu", static_cast<unsigned long long>(value));
+        }
+        str += buf;
+        value = 0;
+    }
+    return QString::fromLatin1(str.c_str(), static_cast<int>(str.length()));
+}
+
+QString der_util::getOidName(const QString &oid)
+{
+    const std::string oidStr = oid.toStdString();
+    for (size_t i = 0; KNOWN_OIDS[i].oid != NULL; i++) {
+        if (oidStr == KNOWN_OIDS[i].oid) return KNOWN_OIDS[i].name;
+    }
+    return "";
+}
+
+QString der_util::algorithmToString(const DerNode &algId)
+{
+    const DerNode oid = (algId.getTag() == der::TAG_OID) ? algId : algId.firstChild();
+    const QString oidStr = oidToString(oid);
+    const QString name = getOidName(oidStr);
+    return name.length() ? name : oidStr;
+}
+
+QString der_util::toHex(const DerNode &node)
+{
+    if (!node.isValid()) return "";
+
+    static const char hexChars[] = "0123456789abcdef";
+    const BYTE *content = node.getContent();
+
+    std::string str;
+    for (bufsize_t i = 0; i < node.getContentSize(); i++) {
+        str.push_back(hexChars[content[i] >> 4]);
+        str.push_back(hexChars[content[i] & 0xF]);
+    }
+    return QString::fromLatin1(str.c_str(), static_cast<int>(str.length()));
+}
+
+QString der_util::stringToText(const DerNode &node)
+{
+    if (!node.isValid()) return "";
+
+    const char *content = reinterpret_cast<const char*>(node.getContent());
+    const int size = static_cast<int>(node.getContentSize());
+
+    switch (node.getTag()) {
+        case der::TAG_UTF8_STRING:
+            return QString::fromUtf8(content, size);
+        case der::TAG_BMP_STRING:
+        {
+            // UTF-16 big endian
+            QString str;
+            for (int i = 0; (i + 1) < size; i += 2) {
+                const ushort c = (static_cast<BYTE>(content[i]) << 8) | static_cast<BYTE>(content[i + 1]);
+                str.append(QChar(c));
+            }
+            return str;
+        }
+        case der::TAG_PRINTABLE_STRING:
+        case der::TAG_T61_STRING:
+        case der::TAG_IA5_STRING:
+            return QString::fromLatin1(content, size);
+    }
+    return "";
+}
+
+QString der_util::timeToText(const DerNode &node)
+{
+    if (!node.isValid()) return "";
+
+    const std::string str(reinterpret_cast<const char*>(node.getContent()), node.getContentSize());
+    std::string year;
+    std::string rest;
+    if (node.getTag() == der::TAG_UTC_TIME && str.length() >= 12) {
+        year = ((str[0] >= '5') ? "19" : "20") + str.substr(0, 2);
+        rest = str.substr(2);
+    } else if (node.getTag() == der::TAG_GENERALIZED_TIME && str.length() >= 14) {
+        year = str.substr(0, 4);
+        rest = str.substr(4);
+    } else {
+        return QString::fromLatin1(str.c_str(), static_cast<int>(str.length()));
+    }
+    // MMDDHHMMSS
+    const std::string text = year + "-" + rest.substr(0, 2) + "-" + rest.substr(2, 2)
+        + " " + rest.substr(4, 2) + ":" + rest.substr(6, 2) + ":" + rest.substr(8, 2);
+    return QString::fromLatin1(text.c_str(), static_cast<int>(text.length()));
+}
+
+QString der_util::nameToText(const DerNode &name)
+{
+    // Name ::= SEQUENCE OF RelativeDistinguishedName (SET OF { OID, value })
+    QString text;
+    for (DerNode rdn = name.firstChild(); rdn.isValid(); rdn = rdn.next()) {
+        for (DerNode attr = rdn.firstChild(); attr.isValid(); attr = attr.next()) {
+            const DerNode oid = attr.firstChild();
+            const QString oidStr = oidToString(oid);
+            const QString attrName = getOidName(oidStr);
+
+            if (text.length()) text += ", ";
+            text += (attrName.length() ? attrName : oidStr) + "=" + stringToText(oid.next());
+        }
+    }
+    return text;
+}
+
+QString der_util::toText(const DerNode &node)
+{
+    if (!node.isValid()) return "";
+
+    switch (node.getTag()) {
+        case der::TAG_OID:
+        {
+            const QString oidStr = oidToString(node);
+            const QString name = getOidName(oidStr);
+            return name.length() ? name : oidStr;
+        }
+        case der::TAG_UTC_TIME:
+        case der::TAG_GENERALIZED_TIME:
+            return timeToText(node);
+        case der::TAG_UTF8_STRING:
+        case der::TAG_BMP_STRING:
+        case der::TAG_PRINTABLE_STRING:
+        case der::TAG_T61_STRING:
+        case der::TAG_IA5_STRING:
+            return stringToText(node);
+        case der::TAG_INTEGER:
+        {
+            if (node.getContentSize() > sizeof(DWORD)) return toHex(node);
+            uint64_t value = 0;
+            for (bufsize_t i = 0; i < node.getContentSize(); i++) {
+                value = (value << 8) | node.getContent()[i];
+            }
+            return QString::number(value);
+        }
+    }
+    return toHex(node);
+}
@@ -15,22 +15,54 @@ typedef struct _ARM_EXCEPT_RECORD {
 } ARM_EXCEPT_RECORD;
 
 
+ExceptionDirWrapper::RecordFormat ExceptionDirWrapper::findRecordFormat()
+{
+    if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
+        return RECORD_ARM64;
+    }
+    if (this->m_Exe->getArch() != Executable::ARCH_INTEL) {
+        return RECORD_NONE;
+    }
+    if (ldConfig && ldConfig->isHybrid()) {
+        // the directory may point to the x64 records of an ARM64EC image (ARM64X, as loaded for x64)
+        offset_t extraRva = 0;
+        bufsize_t extraSize = 0;
+        if (ldConfig->getExtraRfeTable(extraRva, extraSize) && extraRva == getDirEntryAddress()) {
+            return RECORD_INTEL;
+        }
+        // the first field of both formats is the RVA of the function
+        const DWORD *start = (DWORD*) m_Exe->getContentAt(getDirEntryAddress(), Executable::RVA, sizeof(DWORD));
+        if (start) {
+            const LdConfigDirWrapper::CodeRangeType type = ldConfig->getCodeRangeType(*start);
+            if (type == LdConfigDirWrapper::CODE_RANGE_ARM64 || type == LdConfigDirWrapper::CODE_RANGE_ARM64EC) {
+                return RECORD_ARM64;
+            }
+        }
+    }
+    return RECORD_INTEL;
+}
+
+bufsize_t ExceptionDirWrapper::getRecordSize() const
+{
+    switch (recordFormat) {
+        case RECORD_INTEL: return sizeof(IMAGE_IA64_RUNTIME_FUNCTION_ENTRY);
+        case RECORD_ARM64: return sizeof(ARM_EXCEPT_RECORD);
+        default: break;
+    }
+    return 0;
+}
+
 bool ExceptionDirWrapper::wrap()
 {
     clear();
     parsedSize = 0;
+    recordFormat = findRecordFormat();
     bufsize_t maxSize = getDirEntrySize(true);
     if (maxSize == 0) return false; // nothing to parse
 
     if (!getPtr()) return false;
 
-    size_t entrySize = 0;
-    if (this->m_Exe->getArch() == Executable::ARCH_INTEL) {
-        entrySize = sizeof(IMAGE_IA64_RUNTIME_FUNCTION_ENTRY);
-    }
-    else if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
-        entrySize = 8;
-    }
+    const size_t entrySize = getRecordSize();
     size_t entryId = 0;
     while (parsedSize < maxSize) {
         ExceptionEntryWrapper* entry = new ExceptionEntryWrapper(this->m_Exe, this, entryId++);
@@ -52,13 +84,7 @@ bool ExceptionDirWrapper::wrap()
 
 void* ExceptionDirWrapper::getPtr()
 {
-    size_t entrySize = 0;
-    if (this->m_Exe->getArch() == Executable::ARCH_INTEL) {
-        entrySize = sizeof(IMAGE_IA64_RUNTIME_FUNCTION_ENTRY);
-    }
-    else if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
-        entrySize = sizeof(uint64_t);
-    }
+    const bufsize_t entrySize = getRecordSize();
     const offset_t rva = getDirEntryAddress();
     BYTE* first = m_Exe->getContentAt(rva, Executable::RVA, entrySize);
     if (!first || !entrySize) {
@@ -89,15 +115,8 @@ void* ExceptionEntryWrapper::getPtr()
 
 bufsize_t ExceptionEntryWrapper::_getSize()
 {
-    if (this->m_Exe) {
-        if (this->m_Exe->getArch() == Executable::ARCH_INTEL) {
-            return sizeof(IMAGE_IA64_RUNTIME_FUNCTION_ENTRY);
-        }
-        if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
-            return 8;
-        }
-    }
-    return 0;  
+    if (!this->parentDir) return 0;
+    return this->parentDir->getRecordSize();
 }
 
 bufsize_t ExceptionEntryWrapper::getSize()
@@ -110,10 +129,10 @@ bufsize_t ExceptionEntryWrapper::getSize()
 
 size_t ExceptionEntryWrapper::getFieldsCount()
 {
-    if (this->m_Exe->getArch() == Executable::ARCH_INTEL) {
+    if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_INTEL) {
         return ExceptionBlockFID_Intel::FIELD_COUNTER; 
     }
-    else if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
+    else if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_ARM64) {
         return ExceptionBlockFID_Arm64::ARM_EXCEPT_FIELD_COUNTER;
     }
     return 0;
@@ -124,7 +143,7 @@ void* ExceptionEntryWrapper::getFieldPtr(size_t fieldId, size_t subField)
     void *ptr = this->getPtr();
     if (!ptr) return nullptr;
     
-    if (this->m_Exe->getArch() == Executable::ARCH_INTEL) {
+    if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_INTEL) {
         IMAGE_IA64_RUNTIME_FUNCTION_ENTRY* exc = (IMAGE_IA64_RUNTIME_FUNCTION_ENTRY*) ptr;
         if (!exc) return NULL;
 
@@ -134,7 +153,7 @@ void* ExceptionEntryWrapper::getFieldPtr(size_t fieldId, size_t subField)
             case UNWIND_INFO_ADDR : return &exc->UnwindInfoAddress;
         }
     }
-    else if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
+    else if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_ARM64) {
         ARM_EXCEPT_RECORD *rec = (ARM_EXCEPT_RECORD*) ptr;
         if (!rec) return NULL;
         
@@ -148,7 +167,7 @@ void* ExceptionEntryWrapper::getFieldPtr(size_t fieldId, size_t subField)
 
 QString ExceptionEntryWrapper::getFieldName(size_t fieldId)
 {
-    if (this->m_Exe->getArch() == Executable::ARCH_INTEL) {
+    if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_INTEL) {
         switch (fieldId) {
             case BEGIN_ADDR : return "BeginAddress";
             case END_ADDR : return "EndAddress";
@@ -156,7 +175,7 @@ QString ExceptionEntryWrapper::getFieldName(size_t fieldId)
         }
         return "";
     }
-    else if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
+    else if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_ARM64) {
         switch (fieldId) {
             case ARM_EXCEPT_START : return "Start";
             case ARM_EXCEPT_XDATA : return "XData";
@@ -167,7 +186,7 @@ QString ExceptionEntryWrapper::getFieldName(size_t fieldId)
 
 Executable::addr_type ExceptionEntryWrapper::containsAddrType(size_t fieldId, size_t subField)
 {
-    if (this->m_Exe->getArch() == Executable::ARCH_INTEL) {
+    if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_INTEL) {
         switch (fieldId) {
             case BEGIN_ADDR :
             case END_ADDR :
@@ -175,7 +194,7 @@ Executable::addr_type ExceptionEntryWrapper::containsAddrType(size_t fieldId, si
                 return Executable::RVA;
         }
     }
-    else if (this->m_Exe->getArch() == Executable::ARCH_ARM && this->m_Exe->getBitMode() == 64) {
+    else if (this->parentDir->getRecordFormat() == ExceptionDirWrapper::RECORD_ARM64) {
 
         if (fieldId == ARM_EXCEPT_START) return Executable::RVA;
         if (fieldId == ARM_EXCEPT_XDATA) {
@@ -1,5 +1,7 @@
 #include "pe/LdConfigDirWrapper.h"
 
+#include <algorithm>
+
 // offset from the beginning of the structure
 #define getStructFieldOffset(STRUCT, FIELD) ((ULONGLONG) &(STRUCT.FIELD) - (ULONGLONG)&STRUCT)
 
@@ -67,6 +69,164 @@ bool LdConfigDirWrapper::wrapSubentriesTable(size_t parentFieldId, size_t counte
     return isOk;
 }
 
+bool LdConfigDirWrapper::indexGuardTable(GuardTable table, size_t parentFieldId, size_t counterFieldId)
+{
+    bool isOk = false;
+    uint64_t count = this->getNumValue(counterFieldId, &isOk);
+    if (!isOk || count == 0) {
+        return false;
+    }
+    const BYTE *first = (BYTE*) firstSubEntryPtr(parentFieldId);
+    if (!first) return false;
+
+    const size_t entrySize = firstSubEntrySize(parentFieldId);
+    const offset_t offset = this->getOffset((void*) first);
+    if (offset == INVALID_ADDR) return false;
+
+    // read only the entries that fit in the file, as wrapSubentriesTable does
+    const uint64_t available = m_Exe->getMaxSizeFromOffset(offset) / entrySize;
+    if (count > available) {
+        Logger::append(Logger::D_WARNING, "%s: the table is truncated", getFieldName(parentFieldId).toStdString().c_str());
+        count = available;
+    }
+    std::vector<DWORD> &rvas = guardRvas[table];
+    rvas.reserve(static_cast<size_t>(count));
+    const BYTE *ptr = first;
+    for (uint64_t i = 0; i < count; i++, ptr += entrySize) {
+        rvas.push_back(DWORD(ptr[0]) | (DWORD(ptr[1]) << 8) | (DWORD(ptr[2]) << 16) | (DWORD(ptr[3]) << 24));
+    }
+    // the linker emits them sorted (the loader relies on it), but a malformed file may not be
+    if (!std::is_sorted(rvas.begin(), rvas.end())) {
+        std::sort(rvas.begin(), rvas.end());
+    }
+    rvas.erase(std::unique(rvas.begin(), rvas.end()), rvas.end());
+    return true;
+}
+
+bool LdConfigDirWrapper::isInGuardTable(GuardTable table, offset_t rva) const
+{
+    if (rva > DWORD(-1)) return false;
+    const std::vector<DWORD> &rvas = getGuardRvas(table);
+    return std::binary_search(rvas.begin(), rvas.end(), DWORD(rva));
+}
+
+size_t LdConfigDirWrapper::intersectGuardTable(GuardTable table, const std::vector<offset_t> &candidates, std::vector<offset_t> &listed) const
+{
+    const std::vector<DWORD> &rvas = getGuardRvas(table);
+    if (rvas.empty() || candidates.empty()) return 0;
+
+    std::vector<offset_t> sorted(candidates);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    // both are sorted: each search starts where the previous one ended
+    size_t found = 0;
+    std::vector<DWORD>::const_iterator tItr = rvas.begin();
+    for (std::vector<offset_t>::const_iterator cItr = sorted.begin(); cItr != sorted.end() && tItr != rvas.end(); ++cItr) {
+        tItr = std::lower_bound(tItr, rvas.end(), *cItr, [](DWORD rva, offset_t val) { return rva < val; });
+        if (tItr != rvas.end() && *tItr == *cItr) {
+            listed.push_back(*cItr);
+            found++;
+        }
+    }
+    return found;
+}
+
+bool LdConfigDirWrapper::wrapCodeRanges()
+{
+    bool isOk = false;
+    const uint64_t metadataVA = this->getNumValue(CHPE_METADATA_PTR, &isOk);
+    if (!isOk || metadataVA == 0) {
+        return false;
+    }
+    // both IMAGE_CHPE_METADATA_X86 and IMAGE_ARM64EC_METADATA start with: Version, CodeMap (RVA), CodeMapCount
+    const DWORD *hdr = (DWORD*) m_Exe->getContentAt(metadataVA, Executable::VA, 3 * sizeof(DWORD));
+    if (!hdr) {
+        Logger::append(Logger::D_WARNING, "The hybrid metadata is out of the image");
+        return false;
+    }
+    const bool isChpeX86 = (m_Exe->getBitMode() == Executable::BITS_32);
+    if (!isChpeX86) {
+        // IMAGE_ARM64EC_METADATA: ExtraRFETable and ExtraRFETableSize are its 17th and 18th DWORDs
+        const DWORD *ec = (DWORD*) m_Exe->getContentAt(metadataVA, Executable::VA, 18 * sizeof(DWORD));
+        if (ec && ec[16] != 0 && ec[17] != 0) {
+            extraRfeRva = ec[16];
+            extraRfeSize = ec[17];
+        }
+    }
+    uint64_t count = hdr[2];
+    const BYTE *first = m_Exe->getContentAt(hdr[1], Executable::RVA, 2 * sizeof(DWORD));
+    if (!first || count == 0) return false;
+
+    // IMAGE_CHPE_RANGE_ENTRY: StartOffset (with the type in the lowest bits), Length
+    const size_t entrySize = 2 * sizeof(DWORD);
+    const uint64_t available = m_Exe->getMaxSizeFromPtr((BYTE*) first) / entrySize;
+    if (count > available) {
+        Logger::append(Logger::D_WARNING, "The code map is truncated");
+        count = available;
+    }
+    codeRanges.reserve(static_cast<size_t>(count));
+    const BYTE *ptr = first;
+    for (uint64_t i = 0; i < count; i++, ptr += entrySize) {
+        const DWORD startOffset = DWORD(ptr[0]) | (DWORD(ptr[1]) << 8) | (DWORD(ptr[2]) << 16) | (DWORD(ptr[3]) << 24);
+        const DWORD length = DWORD(ptr[4]) | (DWORD(ptr[5]) << 8) | (DWORD(ptr[6]) << 16) | (DWORD(ptr[7]) << 24);
+
+        CodeRange range;
+        if (isChpeX86) {
+            // the lowest bit: NativeCode
+            range.start = startOffset & ~DWORD(1);
+            range.type = (startOffset & 1) ? CODE_RANGE_ARM64 : CODE_RANGE_X86;
+        } else {
+            // the lowest 2 bits: 0 = ARM64, 1 = ARM64EC, 2 = AMD64
+            range.start = startOffset & ~DWORD(3);
+            switch (startOffset & 3) {
+                case 0: range.type = CODE_RANGE_ARM64; break;
+                case 1: range.type = CODE_RANGE_ARM64EC; break;
+                case 2: range.type = CODE_RANGE_AMD64; break;
+                default: continue;
+            }
+        }
+        if (length == 0 || uint64_t(range.start) + length > DWORD(-1)) continue;
+        range.end = range.start + length;
+        codeRanges.push_back(range);
+    }
+    std::sort(codeRanges.begin(), codeRanges.end(),
+        [](const CodeRange &a, const CodeRange &b) { return a.start < b.start; });
+    return !codeRanges.empty();
+}
+
+LdConfigDirWrapper::CodeRangeType LdConfigDirWrapper::getCodeRangeType(offset_t rva) const
+{
+    if (codeRanges.empty() || rva > DWORD(-1)) return CODE_RANGE_NONE;
+
+    // the last range starting at or before the RVA
+    std::vector<CodeRange>::const_iterator itr = std::upper_bound(codeRanges.begin(), codeRanges.end(), rva,
+        [](offset_t val, const CodeRange &range) { return val < range.start; });
+    if (itr == codeRanges.begin()) return CODE_RANGE_NONE;
+    --itr;
+    return (rva < itr->end) ? itr->type : CODE_RANGE_NONE;
+}
+
+bool LdConfigDirWrapper::getExtraRfeTable(offset_t &rva, bufsize_t &size) const
+{
+    if (extraRfeRva == 0) return false;
+    rva = extraRfeRva;
+    size = extraRfeSize;
+    return true;
+}
+
+QString LdConfigDirWrapper::translateCodeRangeType(CodeRangeType type)
+{
+    switch (type) {
+        case CODE_RANGE_ARM64: return "ARM64";
+        case CODE_RANGE_ARM64EC: return "ARM64EC";
+        case CODE_RANGE_AMD64: return "AMD64";
+        case CODE_RANGE_X86: return "x86";
+        default: break;
+    }
+    return "";
+}
+
 bool LdConfigDirWrapper::wrap()
 {
     clear();
@@ -81,6 +241,13 @@ bool LdConfigDirWrapper::wrap()
     wrapSubentriesTable(GUARD_ADDR_IAT_ENTRY_TABLE, GUARD_ADDR_IAT_ENTRY_COUNT);
     
     wrapSubentriesTable(GUARD_EH_CONT_TABLE, GUARD_EH_CONT_COUNT);
+
+    indexGuardTable(GUARD_TABLE_FUNCTIONS, GUARD_TABLE, GUARD_COUNT);
+    indexGuardTable(GUARD_TABLE_IAT, GUARD_ADDR_IAT_ENTRY_TABLE, GUARD_ADDR_IAT_ENTRY_COUNT);
+    indexGuardTable(GUARD_TABLE_LONG_JUMP, GUARD_LONG_JUMP_TABLE, GUARD_LONG_JUMP_COUNT);
+    indexGuardTable(GUARD_TABLE_EH_CONT, GUARD_EH_CONT_TABLE, GUARD_EH_CONT_COUNT);
+
+    wrapCodeRanges();
     return true;
 }
 
@@ -96,6 +263,12 @@ void LdConfigDirWrapper::clear()
         std::vector<ExeNodeWrapper*> &vec = mapItr->second;
         vec.clear();
     }
+    for (size_t i = 0; i < GUARD_TABLES_COUNT; i++) {
+        guardRvas[i].clear();
+    }
+    codeRanges.clear();
+    extraRfeRva = 0;
+    extraRfeSize = 0;
     ExeNodeWrapper::clear();
 }
 
@@ -1,6 +1,42 @@
 #include "pe/PEFile.h"
 #include "FileBuffer.h"
 
+namespace {
+    struct OverlayMagic {
+        PEFile::overlay_format format;
+        offset_t offset;    // from the start of the overlay
+        const char *magic;
+        bufsize_t size;
+    };
+
+    const OverlayMagic OVERLAY_MAGICS[] = {
+        { PEFile::OVL_ZIP,  0, "PK\x03\x04", 4 },
+        { PEFile::OVL_ZIP,  0, "PK\x05\x06", 4 },                   // empty archive
+        { PEFile::OVL_7Z,   0, "7z\xBC\xAF\x27\x1C", 6 },
+        { PEFile::OVL_RAR,  0, "Rar!\x1A\x07", 6 },
+        { PEFile::OVL_CAB,  0, "MSCF\0\0\0\0", 8 },
+        { PEFile::OVL_NSIS, 8, "NullsoftInst", 12 },                 // firstheader: { flags, siginfo, nsinst[3] }
+        { PEFile::OVL_INNO, 0, "rDlPtS", 6 },                        // the offset table of SetupLdr
+        { PEFile::OVL_INNO, 0, "Inno Setup Setup Data (", 23 },
+        { PEFile::OVL_INNO, 0, "zlb\x1A", 4 }
+    };
+};
+
+QString PEFile::translateOverlayFormat(overlay_format format)
+{
+    switch (format) {
+        case OVL_NONE: return "none";
+        case OVL_ZIP: return "ZIP";
+        case OVL_7Z: return "7-Zip";
+        case OVL_RAR: return "RAR";
+        case OVL_CAB: return "Cabinet";
+        case OVL_NSIS: return "NSIS";
+        case OVL_INNO: return "Inno Setup";
+        default: break;
+    }
+    return "unknown";
+}
+
 bool PEFileBuilder::signatureMatches(AbstractByteBuffer *buf)
 {
     if (buf == NULL) return false;
@@ -147,7 +183,7 @@ void PEFile::_init(AbstractByteBuffer *v_buf)
     dataDirEntries[pe::DIR_TLS] = new TlsDirWrapper(this);
     dataDirEntries[pe::DIR_LOAD_CONFIG] = new LdConfigDirWrapper(this);
     dataDirEntries[pe::DIR_BASERELOC] = new RelocDirWrapper(this);
-    dataDirEntries[pe::DIR_EXCEPTION] = new ExceptionDirWrapper(this);
+    dataDirEntries[pe::DIR_EXCEPTION] = new ExceptionDirWrapper(this, dynamic_cast<LdConfigDirWrapper*>(dataDirEntries[pe::DIR_LOAD_CONFIG]));
     dataDirEntries[pe::DIR_RESOURCE] = new ResourceDirWrapper(this, album);
     dataDirEntries[pe::DIR_COM_DESCRIPTOR] = new ClrDirWrapper(this); 
  
@@ -194,8 +230,13 @@ void PEFile::wrapCore()
 bool PEFile::wrapDataDirs()
 {
     bool anyModified = false;
+    // the exception directory depends on the code map of the load config: rewrap it first
+    if (dataDirEntries[pe::DIR_LOAD_CONFIG] && dataDirEntries[pe::DIR_LOAD_CONFIG]->wrap()) {
+        anyModified = true;
+    }
     // rewrap directories
     for (size_t i = 0 ; i < pe::DIR_ENTRIES_COUNT; i++) {
+        if (i == pe::DIR_LOAD_CONFIG) continue;
         if (dataDirEntries[i]) {
             if (dataDirEntries[i]->wrap()) {
                 anyModified = true;
@@ -456,6 +497,91 @@ BufferView* PEFile::createSectionView(size_t secId)
     return _createSectionView(sec);
 }
 
+size_t PEFile::findOverlayRanges(offset_t starts[MAX_OVERLAY_RANGES], offset_t ends[MAX_OVERLAY_RANGES])
+{
+    const offset_t start = getLastMapped(Executable::RAW);
+    const offset_t end = getRawSize();
+    if (start == INVALID_ADDR || start >= end) {
+        return 0;
+    }
+    // the address of the Security directory is a raw offset
+    offset_t certStart = 0;
+    offset_t certEnd = 0;
+    DataDirWrapper *dataDir = getDataDirWrapper();
+    IMAGE_DATA_DIRECTORY *ddir = getDataDirectory();
+    if (dataDir && ddir && dataDir->getDirsCount() > pe::DIR_SECURITY) {
+        certStart = ddir[pe::DIR_SECURITY].VirtualAddress;
+        certEnd = certStart + ddir[pe::DIR_SECURITY].Size;
+    }
+    if (certStart == 0 || certStart >= certEnd || certEnd <= start || certStart >= end) {
+        starts[0] = start;
+        ends[0] = end;
+        return 1;
+    }
+    size_t count = 0;
+    if (certStart > start) {
+        starts[count] = start;
+        ends[count] = certStart;
+        count++;
+    }
+    if (certEnd < end) {
+        // the data appended after the certificates
+        starts[count] = certEnd;
+        ends[count] = end;
+        count++;
+    }
+    return count;
+}
+
+size_t PEFile::getOverlayRangesCount()
+{
+    offset_t starts[MAX_OVERLAY_RANGES];
+    offset_t ends[MAX_OVERLAY_RANGES];
+    return findOverlayRanges(starts, ends);
+}
+
+bool PEFile::getOverlayRange(offset_t &offset, bufsize_t &size, size_t rangeIndex)
+{
+    offset_t starts[MAX_OVERLAY_RANGES];
+    offset_t ends[MAX_OVERLAY_RANGES];
+    if (rangeIndex >= findOverlayRanges(starts, ends)) {
+        return false;
+    }
+    offset = starts[rangeIndex];
+    size = static_cast<bufsize_t>(ends[rangeIndex] - starts[rangeIndex]);
+    return true;
+}
+
+BufferView* PEFile::getOverlay(size_t rangeIndex)
+{
+    offset_t offset = 0;
+    bufsize_t size = 0;
+    if (!getOverlayRange(offset, size, rangeIndex)) {
+        return NULL;
+    }
+    return new BufferView(this, offset, size);
+}
+
+PEFile::overlay_format PEFile::getOverlayFormat()
+{
+    offset_t offset = 0;
+    bufsize_t size = 0;
+    if (!getOverlayRange(offset, size)) {
+        return OVL_NONE;
+    }
+    const size_t magicsCount = sizeof(OVERLAY_MAGICS) / sizeof(OVERLAY_MAGICS[0]);
+    for (size_t i = 0; i < magicsCount; i++) {
+        const OverlayMagic &m = OVERLAY_MAGICS[i];
+        if (m.offset + m.size > size) continue;
+
+        const BYTE *ptr = this->getContentAt(offset + m.offset, m.size);
+        if (ptr && memcmp(ptr, m.magic, m.size) == 0) {
+            return m.format;
+        }
+    }
+    return OVL_UNKNOWN;
+}
+
 bool PEFile::moveDataDirEntry(pe::dir_entry dirNum, offset_t newOffset, Executable::addr_type addrType)
 {
     bool allowExceptions = true; //TODO: configure exception mode outside...
@@ -733,3 +859,26 @@ size_t PEFile::getExportsMap(QMap<offset_t,QString> &entrypoints, Executable::ad
     }
     return entrypoints.size() - initialSize;
 }
+
+size_t PEFile::getTlsCallbacksMap(QMap<offset_t,QString> &entrypoints, Executable::addr_type aType)
+{
+    TlsDirWrapper* tls = dynamic_cast<TlsDirWrapper*>(this->getWrapper(PEFile::WR_DIR_ENTRY + pe::DIR_TLS));
+    if (!tls) return 0;
+
+    std::vector<TlsCallback> callbacks;
+    if (tls->getCallbacks(callbacks) == 0) return 0;
+
+    size_t initialSize = entrypoints.size();
+    for (size_t i = 0; i < callbacks.size(); i++) {
+        offset_t offset = this->convertAddr(callbacks[i].rva, Executable::RVA, aType);
+        if (offset == INVALID_ADDR) {
+            continue;
+        }
+        // keep the name of the export, if the callback is also exported
+        if (entrypoints.contains(offset)) {
+            continue;
+        }
+        entrypoints.insert(offset, "TlsCallback_" + QString::number(callbacks[i].slot));
+    }
+    return entrypoints.size() - initialSize;
+}
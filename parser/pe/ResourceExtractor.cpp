@@ -0,0 +1,405 @@
+#include "pe/ResourceExtractor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+
+namespace {
+    const WORD ICO_TYPE_ICON = 1;
+    const WORD ICO_TYPE_CURSOR = 2;
+
+    // .ico / .cur: ICONDIR: { WORD Reserved; WORD Type; WORD Count; }
+    const bufsize_t ICONDIR_SIZE = 6;
+    // ICONDIRENTRY: { BYTE Width, Height, ColorCount, Reserved; WORD Planes (XHotspot); WORD BitCount (YHotspot); DWORD BytesInRes; DWORD ImageOffset; }
+    const bufsize_t ICONDIRENTRY_SIZE = 16;
+
+    // RT_GROUP_ICON: GRPICONDIRENTRY: { BYTE Width, Height, ColorCount, Reserved; WORD Planes, BitCount; DWORD BytesInRes; WORD Id; }
+    // RT_GROUP_CURSOR: GRPCURSORDIRENTRY: { WORD Width, Height; WORD Planes, BitCount; DWORD BytesInRes; WORD Id; } (the Height of both masks)
+    const bufsize_t GRPDIRENTRY_SIZE = 14;
+    const offset_t GRPDIRENTRY_ID_OFFSET = 12;
+    const size_t MAX_GROUP_ENTRIES = 0x100;
+
+    // RT_CURSOR: { WORD XHotspot; WORD YHotspot; } precedes the image
+    const bufsize_t CURSOR_HOTSPOT_SIZE = 4;
+
+    const bufsize_t BITMAPFILEHEADER_SIZE = 14;
+    const bufsize_t BITMAPCOREHEADER_SIZE = 12;
+    const bufsize_t BITMAPINFOHEADER_SIZE = 40;
+    const DWORD BI_BITFIELDS = 3;
+    const DWORD BI_ALPHABITFIELDS = 6;
+
+    const BYTE PNG_MAGIC[] = { 0x89, 'P', 'N', 'G' };
+    const offset_t PNG_WIDTH_OFFSET = 16; // in IHDR, big endian
+
+    const int MAX_NAME_LEN = 64;
+
+    inline WORD readWord(const BYTE *ptr)
+    {
+        return WORD(ptr[0]) | (WORD(ptr[1]) << 8);
+    }
+
+    inline DWORD readDword(const BYTE *ptr)
+    {
+        return DWORD(ptr[0]) | (DWORD(ptr[1]) << 8) | (DWORD(ptr[2]) << 16) | (DWORD(ptr[3]) << 24);
+    }
+
+    inline DWORD readDwordBE(const BYTE *ptr)
+    {
+        return (DWORD(ptr[0]) << 24) | (DWORD(ptr[1]) << 16) | (DWORD(ptr[2]) << 8) | DWORD(ptr[3]);
+    }
+
+    inline void appendByte(QByteArray &buf, BYTE val)
+    {
+        buf.append(static_cast<char>(val));
+    }
+
+    inline void appendWord(QByteArray &buf, WORD val)
+    {
+        appendByte(buf, val & 0xFF);
+        appendByte(buf, (val >> 8) & 0xFF);
+    }
+
+    inline void appendDword(QByteArray &buf, DWORD val)
+    {
+        appendWord(buf, val & 0xFFFF);
+        appendWord(buf, (val >> 16) & 0xFFFF);
+    }
+
+    // in ICONDIRENTRY 0 stands for 256 (or more)
+    inline BYTE toEntryDimension(DWORD val)
+    {
+        return (val >= 256) ? 0 : static_cast<BYTE>(val);
+    }
+
+    // the image of an icon: a PNG, or a DIB with the height of both masks
+    void getImageInfo(const BYTE *img, bufsize_t size, DWORD &width, DWORD &height, WORD &bitCount)
+    {
+        width = height = 0;
+        bitCount = 0;
+        if (size >= PNG_WIDTH_OFFSET + 2 * sizeof(DWORD) && memcmp(img, PNG_MAGIC, sizeof(PNG_MAGIC)) == 0) {
+            width = readDwordBE(img + PNG_WIDTH_OFFSET);
+            height = readDwordBE(img + PNG_WIDTH_OFFSET + sizeof(DWORD));
+            bitCount = 32;
+            return;
+        }
+        if (size < BITMAPINFOHEADER_SIZE) return;
+        width = readDword(img + 4);
+        height = readDword(img + 8) / 2;
+        bitCount = readWord(img + 14);
+    }
+
+    void appendIconDir(QByteArray &buf, bool isCursor, size_t count)
+    {
+        appendWord(buf, 0);
+        appendWord(buf, isCursor ? ICO_TYPE_CURSOR : ICO_TYPE_ICON);
+        appendWord(buf, static_cast<WORD>(count));
+    }
+
+    std::string sanitize(const QString &name)
+    {
+        std::string str = name.left(MAX_NAME_LEN).toStdString();
+        for (size_t i = 0; i < str.length(); i++) {
+            const unsigned char c = static_cast<unsigned char>(str[i]);
+            if (!isalnum(c) && c != '-' && c != '_') str[i] = '_';
+        }
+        return str;
+    }
+
+    bool writePayload(const QString &path, ResourcePayload &payload)
+    {
+        QFile fOut(path);
+        if (fOut.open(QFile::WriteOnly) == false) {
+            return false;
+        }
+        bool isOk = true;
+        if (payload.header.size()) {
+            isOk = (fOut.write(payload.header) == payload.header.size());
+        }
+        for (size_t i = 0; isOk && i < payload.parts.size(); i++) {
+            BYTE *content = payload.parts[i].getContent();
+            const bufsize_t size = payload.parts[i].getContentSize();
+            if (!content) {
+                isOk = false;
+                break;
+            }
+            isOk = (static_cast<bufsize_t>(fOut.write((char*)content, size)) == size);
+        }
+        fOut.close();
+        return isOk;
+    }
+};
+
+bufsize_t ResourcePayload::getSize() const
+{
+    bufsize_t size = static_cast<bufsize_t>(header.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+        size += parts[i].getRequestedSize();
+    }
+    return size;
+}
+
+QString ResourceExtractor::getExtension(DWORD type)
+{
+    if (ResourceIndex::isNamed(type)) return "bin";
+
+    switch (type) {
+        case pe::RESTYPE_ICON:
+        case pe::RESTYPE_GROUP_ICON:
+            return "ico";
+        case pe::RESTYPE_CURSOR:
+        case pe::RESTYPE_GROUP_CURSOR:
+            return "cur";
+        case pe::RESTYPE_BITMAP: return "bmp";
+        case pe::RESTYPE_HTML: return "htm";
+        case pe::RESTYPE_MANIFEST: return "manifest";
+        default: break;
+    }
+    return "bin";
+}
+
+ResourceExtractor::ResourceExtractor(PEFile *v_pe)
+    : pe(v_pe), index(v_pe)
+{
+}
+
+bool ResourceExtractor::makeViews(const ResourceRecord &record, bufsize_t skip, std::vector<BufferView> &parts)
+{
+    BYTE *content = index.getContent(record);
+    if (!content || record.size <= skip) return false;
+
+    const offset_t raw = pe->getOffset(content);
+    if (raw == INVALID_ADDR) return false;
+
+    parts.push_back(BufferView(pe, raw + skip, record.size - skip));
+    return true;
+}
+
+bool ResourceExtractor::makeImage(const ResourceRecord &record, ResourcePayload &payload)
+{
+    const bool isCursor = (record.type == pe::RESTYPE_CURSOR);
+    const bufsize_t skip = isCursor ? CURSOR_HOTSPOT_SIZE : 0;
+
+    const BYTE *content = index.getContent(record);
+    if (!content || record.size <= skip) return false;
+
+    DWORD width = 0, height = 0;
+    WORD bitCount = 0;
+    getImageInfo(content + skip, record.size - skip, width, height, bitCount);
+
+    if (!makeViews(record, skip, payload.parts)) return false;
+
+    appendIconDir(payload.header, isCursor, 1);
+    appendByte(payload.header, toEntryDimension(width));
+    appendByte(payload.header, toEntryDimension(height));
+    appendByte(payload.header, 0); // colors
+    appendByte(payload.header, 0);
+    appendWord(payload.header, isCursor ? readWord(content) : 1);
+    appendWord(payload.header, isCursor ? readWord(content + sizeof(WORD)) : bitCount);
+    appendDword(payload.header, record.size - skip);
+    appendDword(payload.header, ICONDIR_SIZE + ICONDIRENTRY_SIZE);
+    return true;
+}
+
+bool ResourceExtractor::makeGroup(const ResourceRecord &record, ResourcePayload &payload)
+{
+    const bool isCursor = (record.type == pe::RESTYPE_GROUP_CURSOR);
+    const DWORD imageType = isCursor ? pe::RESTYPE_CURSOR : pe::RESTYPE_ICON;
+    const bufsize_t skip = isCursor ? CURSOR_HOTSPOT_SIZE : 0;
+
+    const BYTE *content = index.getContent(record);
+    if (!content || record.size < ICONDIR_SIZE) return false;
+
+    const size_t count = std::min<size_t>(readWord(content + 4), (record.size - ICONDIR_SIZE) / GRPDIRENTRY_SIZE);
+    if (count > MAX_GROUP_ENTRIES) {
+        Logger::append(Logger::D_WARNING, "Too many entries in the group: %zu", count);
+        return false;
+    }
+
+    // the entries whose images are present
+    std::vector<const BYTE*> entries;
+    std::vector<const ResourceRecord*> images;
+    for (size_t i = 0; i < count; i++) {
+        const BYTE *entry = content + ICONDIR_SIZE + i * GRPDIRENTRY_SIZE;
+        const DWORD id = readWord(entry + GRPDIRENTRY_ID_OFFSET);
+
+        size_t found = index.find(imageType, id, record.lang);
+        if (found == ResourceIndex::NOT_FOUND) {
+            found = index.find(imageType, id);
+        }
+        const ResourceRecord *image = index.getRecord(found);
+        if (!image || !makeViews(*image, skip, payload.parts)) {
+            Logger::append(Logger::D_WARNING, "Missing image of the group: %u", static_cast<unsigned>(id));
+            continue;
+        }
+        entries.push_back(entry);
+        images.push_back(image);
+    }
+    if (entries.empty()) return false;
+
+    appendIconDir(payload.header, isCursor, entries.size());
+    DWORD offset = static_cast<DWORD>(ICONDIR_SIZE + entries.size() * ICONDIRENTRY_SIZE);
+    for (size_t i = 0; i < entries.size(); i++) {
+        const BYTE *entry = entries[i];
+        const DWORD imageSize = images[i]->size - skip;
+
+        if (isCursor) {
+            const BYTE *hotspot = index.getContent(*images[i]);
+            appendByte(payload.header, toEntryDimension(readWord(entry)));
+            appendByte(payload.header, toEntryDimension(readWord(entry + 2) / 2));
+            appendByte(payload.header, 0);
+            appendByte(payload.header, 0);
+            appendWord(payload.header, readWord(hotspot));
+            appendWord(payload.header, readWord(hotspot + sizeof(WORD)));
+        } else {
+            // the same layout up to BytesInRes
+            payload.header.append(reinterpret_cast<const char*>(entry), 8);
+        }
+        appendDword(payload.header, imageSize);
+        appendDword(payload.header, offset);
+        offset += imageSize;
+    }
+    return true;
+}
+
+bool ResourceExtractor::makeBitmap(const ResourceRecord &record, ResourcePayload &payload)
+{
+    const BYTE *content = index.getContent(record);
+    if (!content || record.size < BITMAPCOREHEADER_SIZE) return false;
+
+    const DWORD hdrSize = readDword(content);
+    WORD bitCount = 0;
+    DWORD colorsUsed = 0;
+    bufsize_t paletteEntrySize = 4; // RGBQUAD
+    bufsize_t masksSize = 0;
+
+    if (hdrSize == BITMAPCOREHEADER_SIZE) {
+        bitCount = readWord(content + 10);
+        paletteEntrySize = 3; // RGBTRIPLE
+    } else if (hdrSize >= BITMAPINFOHEADER_SIZE && record.size >= BITMAPINFOHEADER_SIZE) {
+        bitCount = readWord(content + 14);
+        colorsUsed = readDword(content + 32);
+        const DWORD compression = readDword(content + 16);
+        if (hdrSize == BITMAPINFOHEADER_SIZE) {
+            // the masks follow only the basic header
+            if (compression == BI_BITFIELDS) masksSize = 3 * sizeof(DWORD);
+            if (compression == BI_ALPHABITFIELDS) masksSize = 4 * sizeof(DWORD);
+        }
+    } else {
+        return false;
+    }
+    uint64_t colors = colorsUsed;
+    if (colors == 0 && bitCount <= 8) {
+        colors = uint64_t(1) << bitCount;
+    }
+    const uint64_t offBits = std::min<uint64_t>(uint64_t(BITMAPFILEHEADER_SIZE) + hdrSize + masksSize + colors * paletteEntrySize,
+        uint64_t(BITMAPFILEHEADER_SIZE) + record.size);
+
+    if (!makeViews(record, 0, payload.parts)) return false;
+
+    // BITMAPFILEHEADER: { WORD bfType; DWORD bfSize; WORD bfReserved1; WORD bfReserved2; DWORD bfOffBits; }
+    appendByte(payload.header, 'B');
+    appendByte(payload.header, 'M');
+    appendDword(payload.header, static_cast<DWORD>(BITMAPFILEHEADER_SIZE + record.size));
+    appendWord(payload.header, 0);
+    appendWord(payload.header, 0);
+    appendDword(payload.header, static_cast<DWORD>(offBits));
+    return true;
+}
+
+QString ResourceExtractor::makeFileName(size_t recordIndex) const
+{
+    const ResourceRecord *record = index.getRecord(recordIndex);
+    if (!record) return "";
+
+    QString typeName;
+    if (!ResourceIndex::isNamed(record->type)) {
+        typeName = ResourceIndex::getTypeName(static_cast<WORD>(record->type));
+    }
+    if (typeName.length() == 0) {
+        typeName = index.getKeyName(record->type);
+    }
+    const std::string name = sanitize(typeName) + "_" + sanitize(index.getKeyName(record->name)) + "_" + std::to_string(record->lang);
+    return QString::number(recordIndex).rightJustified(4, '0') + "_" + QString::fromStdString(name);
+}
+
+bool ResourceExtractor::getPayload(size_t recordIndex, ResourcePayload &payload)
+{
+    const ResourceRecord *record = index.getRecord(recordIndex);
+    if (!record) return false;
+
+    payload.index = recordIndex;
+    payload.header.clear();
+    payload.parts.clear();
+
+    QString extension = getExtension(record->type);
+    bool isRebuilt = true;
+    if (!ResourceIndex::isNamed(record->type)) {
+        switch (record->type) {
+            case pe::RESTYPE_ICON:
+            case pe::RESTYPE_CURSOR:
+                isRebuilt = makeImage(*record, payload);
+                break;
+            case pe::RESTYPE_GROUP_ICON:
+            case pe::RESTYPE_GROUP_CURSOR:
+                isRebuilt = makeGroup(*record, payload);
+                break;
+            case pe::RESTYPE_BITMAP:
+                isRebuilt = makeBitmap(*record, payload);
+                break;
+            default:
+                break; // stored as it is
+        }
+    }
+    if (!isRebuilt) {
+        // malformed: given without the header
+        payload.header.clear();
+        payload.parts.clear();
+        extension = "bin";
+    }
+    if (payload.parts.empty() && !makeViews(*record, 0, payload.parts)) {
+        return false;
+    }
+    payload.fileName = makeFileName(recordIndex) + "." + extension;
+    return true;
+}
+
+size_t ResourceExtractor::extract(const PayloadCallback &callback)
+{
+    size_t given = 0;
+    for (size_t i = 0; i < index.count(); i++) {
+        ResourcePayload payload;
+        if (!getPayload(i, payload)) continue;
+
+        given++;
+        if (!callback(payload)) break;
+    }
+    return given;
+}
+
+size_t ResourceExtractor::extractToDir(const QString &dirPath, size_t queueDepth)
+{
+    QDir dir(dirPath);
+    if (!dir.exists() && !QDir().mkpath(dirPath)) {
+        Logger::append(Logger::D_ERROR, "Cannot create the directory: %s", dirPath.toStdString().c_str());
+        return 0;
+    }
+    // the payloads are only views: prepared upfront, the workers just write them
+    std::vector<ResourcePayload> payloads;
+    extract([&payloads](ResourcePayload &payload) {
+        payloads.push_back(payload);
+        return true;
+    });
+    if (payloads.empty()) return 0;
+
+    // each worker writes one file at a time: their count is the depth of the queue
+    std::atomic<size_t> writtenCount(0);
+    pe_util::parallelFor(payloads.size(), std::max<size_t>(1, queueDepth), [&](size_t indx) {
+        if (writePayload(dir.filePath(payloads[indx].fileName), payloads[indx])) {
+            writtenCount++;
+        } else {
+            Logger::append(Logger::D_WARNING, "Cannot write the file: %s", payloads[indx].fileName.toStdString().c_str());
+        }
+    });
+    return writtenCount;
+}
@@ -0,0 +1,309 @@
+#include "pe/ResourceIndex.h"
+
+#include <algorithm>
+
+namespace {
+    enum TreeLevel {
+        LEVEL_TYPE = 0,
+        LEVEL_NAME,
+        LEVEL_LANG
+    };
+
+    struct DirFrame {
+        offset_t offset; // from the resource directory
+        TreeLevel level;
+        DWORD type;
+        DWORD name;
+    };
+
+    struct TypeName {
+        const char *name;
+        WORD id;
+    };
+
+    const TypeName TYPE_NAMES[] = {
+        { "RT_CURSOR", pe::RESTYPE_CURSOR },
+        { "RT_BITMAP", pe::RESTYPE_BITMAP },
+        { "RT_ICON", pe::RESTYPE_ICON },
+        { "RT_MENU", pe::RESTYPE_MENU },
+        { "RT_DIALOG", pe::RESTYPE_DIALOG },
+        { "RT_STRING", pe::RESTYPE_STRING },
+        { "RT_FONTDIR", pe::RESTYPE_FONTDIR },
+        { "RT_FONT", pe::RESTYPE_FONT },
+        { "RT_ACCELERATOR", pe::RESTYPE_ACCELERATOR },
+        { "RT_RCDATA", pe::RESTYPE_RCDATA },
+        { "RT_MESSAGETABLE", pe::RESTYPE_MESSAGETABLE },
+        { "RT_GROUP_CURSOR", pe::RESTYPE_GROUP_CURSOR },
+        { "RT_GROUP_ICON", pe::RESTYPE_GROUP_ICON },
+        { "RT_VERSION", pe::RESTYPE_VERSION },
+        { "RT_DLGINCLUDE", pe::RESTYPE_DLGINCLUDE },
+        { "RT_PLUGPLAY", pe::RESTYPE_PLUGPLAY },
+        { "RT_VXD", pe::RESTYPE_VXD },
+        { "RT_ANICURSOR", pe::RESTYPE_ANICURSOR },
+        { "RT_ANIICON", pe::RESTYPE_ANIICON },
+        { "RT_HTML", pe::RESTYPE_HTML },
+        { "RT_MANIFEST", pe::RESTYPE_MANIFEST }
+    };
+
+    bool recordLess(const ResourceRecord &a, const ResourceRecord &b)
+    {
+        if (a.type != b.type) return a.type < b.type;
+        if (a.name != b.name) return a.name < b.name;
+        return a.lang < b.lang;
+    }
+
+    // decimal, or hexadecimal with "0x"
+    bool parseId(const QString &str, DWORD &id)
+    {
+        bool isOk = false;
+        const uint value = str.startsWith("0x", Qt::CaseInsensitive) ? str.mid(2).toUInt(&isOk, 16) : str.toUInt(&isOk, 10);
+        if (!isOk || value > MAX_WORD) return false;
+        id = static_cast<DWORD>(value);
+        return true;
+    }
+};
+
+WORD ResourceIndex::getTypeId(const QString &typeName)
+{
+    const size_t namesCount = sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]);
+    for (size_t i = 0; i < namesCount; i++) {
+        if (typeName.compare(TYPE_NAMES[i].name, Qt::CaseInsensitive) == 0) {
+            return TYPE_NAMES[i].id;
+        }
+    }
+    return 0;
+}
+
+QString ResourceIndex::getTypeName(WORD typeId)
+{
+    const size_t namesCount = sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]);
+    for (size_t i = 0; i < namesCount; i++) {
+        if (TYPE_NAMES[i].id == typeId) {
+            return TYPE_NAMES[i].name;
+        }
+    }
+    return "";
+}
+
+ResourceIndex::ResourceIndex(PEFile *pe)
+    : exe(pe), rootRva(INVALID_ADDR)
+{
+    DataDirWrapper *dataDir = pe ? pe->getDataDirWrapper() : NULL;
+    IMAGE_DATA_DIRECTORY *ddir = pe ? pe->getDataDirectory() : NULL;
+    if (!dataDir || !ddir || dataDir->getDirsCount() <= pe::DIR_RESOURCE) return;
+
+    const offset_t rva = ddir[pe::DIR_RESOURCE].VirtualAddress;
+    if (rva == 0) return;
+
+    rootRva = rva;
+    build();
+}
+
+ResourceIndex::ResourceIndex(Executable *exe, offset_t rva)
+    : exe(exe), rootRva(INVALID_ADDR)
+{
+    if (!exe || rva == 0 || rva == INVALID_ADDR) return;
+
+    rootRva = rva;
+    build();
+}
+
+BYTE* ResourceIndex::getAt(offset_t offset, bufsize_t size) const
+{
+    if (!exe || rootRva == INVALID_ADDR) return NULL;
+    return exe->getContentAt(rootRva + offset, Executable::RVA, size);
+}
+
+void ResourceIndex::build()
+{
+    records.clear();
+    if (!getAt(0, sizeof(IMAGE_RESOURCE_DIRECTORY))) {
+        Logger::append(Logger::D_WARNING, "The resource directory is out of the image");
+        rootRva = INVALID_ADDR;
+        return;
+    }
+
+    // Depth-first, with an explicit stack. The depth is fixed, so the walk cannot loop, but the directories
+    // may be shared by many entries (each walk gives its own records): the count of all the entries read is bounded.
+    std::vector<DirFrame> stack;
+    stack.push_back(DirFrame{ 0, LEVEL_TYPE, 0, 0 });
+
+    size_t entriesLeft = MAX_VISITED_ENTRIES;
+    bool isTruncated = false;
+    while (!stack.empty() && !isTruncated) {
+        const DirFrame frame = stack.back();
+        stack.pop_back();
+
+        const IMAGE_RESOURCE_DIRECTORY *dir = (IMAGE_RESOURCE_DIRECTORY*) getAt(frame.offset, sizeof(IMAGE_RESOURCE_DIRECTORY));
+        if (!dir) continue;
+
+        const offset_t entriesOffset = frame.offset + sizeof(IMAGE_RESOURCE_DIRECTORY);
+        BYTE *entriesPtr = getAt(entriesOffset, sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+        if (!entriesPtr) continue;
+
+        // clamp to what is in the file
+        const size_t entriesCount = std::min<size_t>(size_t(dir->NumberOfNamedEntries) + dir->NumberOfIdEntries,
+            exe->getMaxSizeFromPtr(entriesPtr) / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+        const IMAGE_RESOURCE_DIRECTORY_ENTRY *entries = (IMAGE_RESOURCE_DIRECTORY_ENTRY*) entriesPtr;
+
+        for (size_t i = 0; i < entriesCount; i++) {
+            if (entriesLeft == 0) {
+                isTruncated = true;
+                break;
+            }
+            entriesLeft--;
+
+            const IMAGE_RESOURCE_DIRECTORY_ENTRY &entry = entries[i];
+            const bool isDir = (entry.OffsetToData & RESOURCE_DATA_IS_DIRECTORY) != 0;
+
+            if (frame.level != LEVEL_LANG) {
+                if (!isDir) continue; // a leaf above the level of languages is not loaded
+
+                DirFrame child = frame;
+                child.offset = entry.OffsetToData & ~RESOURCE_DATA_IS_DIRECTORY;
+
+                if (frame.level == LEVEL_TYPE) {
+                    child.level = LEVEL_NAME;
+                    child.type = entry.Name;
+                } else {
+                    child.level = LEVEL_LANG;
+                    child.name = entry.Name;
+                }
+                stack.push_back(child);
+                continue;
+            }
+            if (isDir) continue; // too deep
+
+            const IMAGE_RESOURCE_DATA_ENTRY *leaf = (IMAGE_RESOURCE_DATA_ENTRY*) getAt(entry.OffsetToData, sizeof(IMAGE_RESOURCE_DATA_ENTRY));
+            if (!leaf) continue;
+
+            if (records.size() >= MAX_RECORDS) {
+                isTruncated = true;
+                break;
+            }
+            const ResourceRecord record = { frame.type, frame.name, entry.Name, leaf->OffsetToData, leaf->Size, leaf->CodePage };
+            records.push_back(record);
+        }
+    }
+    if (isTruncated) {
+        Logger::append(Logger::D_WARNING, "Too many resources: indexed only %zu", records.size());
+    }
+    // stable: the duplicates stay in the order of the tree
+    std::stable_sort(records.begin(), records.end(), recordLess);
+}
+
+bool ResourceIndex::getTypeRange(DWORD type, size_t &first, size_t &last) const
+{
+    const ResourceRecord key = { type, 0, 0, 0, 0, 0 };
+    std::vector<ResourceRecord>::const_iterator itr = std::lower_bound(records.begin(), records.end(), key, recordLess);
+    std::vector<ResourceRecord>::const_iterator end = itr;
+    while (end != records.end() && end->type == type) {
+        ++end;
+    }
+    if (itr == end) return false;
+
+    first = static_cast<size_t>(itr - records.begin());
+    last = static_cast<size_t>(end - records.begin());
+    return true;
+}
+
+std::vector<DWORD> ResourceIndex::getTypes() const
+{
+    std::vector<DWORD> types;
+    for (size_t i = 0; i < records.size(); i++) {
+        if (types.empty() || types.back() != records[i].type) {
+            types.push_back(records[i].type);
+        }
+    }
+    return types;
+}
+
+size_t ResourceIndex::find(DWORD type, DWORD name, DWORD lang) const
+{
+    const ResourceRecord key = { type, name, (lang == ANY_LANG) ? 0 : lang, 0, 0, 0 };
+    std::vector<ResourceRecord>::const_iterator itr = std::lower_bound(records.begin(), records.end(), key, recordLess);
+    if (itr == records.end() || itr->type != type || itr->name != name) {
+        return NOT_FOUND;
+    }
+    if (lang != ANY_LANG && itr->lang != lang) {
+        return NOT_FOUND;
+    }
+    return static_cast<size_t>(itr - records.begin());
+}
+
+size_t ResourceIndex::find(DWORD type, const QString &name, DWORD lang) const
+{
+    return findInType(type, 0, name, lang);
+}
+
+size_t ResourceIndex::findInType(DWORD type, DWORD name, const QString &nameStr, DWORD lang) const
+{
+    if (nameStr.isEmpty()) {
+        return find(type, name, lang);
+    }
+    size_t first = 0, last = 0;
+    if (!getTypeRange(type, first, last)) return NOT_FOUND;
+
+    for (size_t i = first; i < last; i++) {
+        const ResourceRecord &record = records[i];
+        if (lang != ANY_LANG && record.lang != lang) continue;
+        if (keyMatches(record.name, nameStr)) return i;
+    }
+    return NOT_FOUND;
+}
+
+size_t ResourceIndex::findPath(const QString &path) const
+{
+    const QStringList parts = path.split('/');
+    if (parts.size() < 2 || parts.size() > 3) return NOT_FOUND;
+
+    DWORD lang = ANY_LANG;
+    if (parts.size() == 3 && !parseId(parts[2], lang)) return NOT_FOUND;
+
+    DWORD type = 0;
+    if (!parseId(parts[0], type)) {
+        type = getTypeId(parts[0]);
+    }
+    if (type == 0) {
+        // a named type: the records of a type are continuous, so the first match gives the key
+        size_t i = 0;
+        for (; i < records.size(); i++) {
+            if (keyMatches(records[i].type, parts[0])) break;
+        }
+        if (i == records.size()) return NOT_FOUND;
+        type = records[i].type;
+    }
+    DWORD name = 0;
+    if (parseId(parts[1], name)) {
+        return find(type, name, lang);
+    }
+    return findInType(type, 0, parts[1], lang);
+}
+
+bool ResourceIndex::keyMatches(DWORD key, const QString &name) const
+{
+    if (!isNamed(key)) return false;
+    return getKeyName(key).compare(name, Qt::CaseInsensitive) == 0;
+}
+
+QString ResourceIndex::getKeyName(DWORD key) const
+{
+    if (!isNamed(key)) {
+        return QString::number(key);
+    }
+    // IMAGE_RESOURCE_DIR_STRING_U: { WORD Length; WCHAR NameString[Length]; }
+    const offset_t offset = key & ~RESOURCE_NAME_IS_STRING;
+    const WORD *lenPtr = (WORD*) getAt(offset, sizeof(WORD));
+    if (!lenPtr) return "";
+
+    const WORD len = *lenPtr;
+    const WORD *str = (WORD*) getAt(offset + sizeof(WORD), static_cast<bufsize_t>(len) * sizeof(WORD));
+    if (!str) return "";
+    return QString::fromUtf16(reinterpret_cast<const char16_t*>(str), static_cast<int>(len));
+}
+
+BYTE* ResourceIndex::getContent(const ResourceRecord &record) const
+{
+    if (!exe || record.size == 0) return NULL;
+    return exe->getContentAt(record.dataRva, Executable::RVA, record.size);
+}
@@ -1,10 +1,163 @@
 #include "pe/RichHdrWrapper.h"
 #include "pe/PEFile.h"
 #include <iostream>
+#include <algorithm>
 
+namespace {
+    // list from: https://github.com/kirschju/richheader ; indexed by the prodId
+    constexpr const char* PROD_ID_NAMES[] = {
+        "Unknown", "Import0", "Linker510", "Cvtomf510",
+        "Linker600", "Cvtomf600", "Cvtres500", "Utc11_Basic",
+        "Utc11_C", "Utc12_Basic", "Utc12_C", "Utc12_CPP",
+        "AliasObj60", "VisualBasic60", "Masm613", "Masm710",
+        "Linker511", "Cvtomf511", "Masm614", "Linker512",
+        "Cvtomf512", "Utc12_C_Std", "Utc12_CPP_Std", "Utc12_C_Book",
+        "Utc12_CPP_Book", "Implib700", "Cvtomf700", "Utc13_Basic",
+        "Utc13_C", "Utc13_CPP", "Linker610", "Cvtomf610",
+        "Linker601", "Cvtomf601", "Utc12_1_Basic", "Utc12_1_C",
+        "Utc12_1_CPP", "Linker620", "Cvtomf620", "AliasObj70",
+        "Linker621", "Cvtomf621", "Masm615", "Utc13_LTCG_C",
+        "Utc13_LTCG_CPP", "Masm620", "ILAsm100", "Utc12_2_Basic",
+        "Utc12_2_C", "Utc12_2_CPP", "Utc12_2_C_Std", "Utc12_2_CPP_Std",
+        "Utc12_2_C_Book", "Utc12_2_CPP_Book", "Implib622", "Cvtomf622",
+        "Cvtres501", "Utc13_C_Std", "Utc13_CPP_Std", "Cvtpgd1300",
+        "Linker622", "Linker700", "Export622", "Export700",
+        "Masm700", "Utc13_POGO_I_C", "Utc13_POGO_I_CPP", "Utc13_POGO_O_C",
+        "Utc13_POGO_O_CPP", "Cvtres700", "Cvtres710p", "Linker710p",
+        "Cvtomf710p", "Export710p", "Implib710p", "Masm710p",
+        "Utc1310p_C", "Utc1310p_CPP", "Utc1310p_C_Std", "Utc1310p_CPP_Std",
+        "Utc1310p_LTCG_C", "Utc1310p_LTCG_CPP", "Utc1310p_POGO_I_C", "Utc1310p_POGO_I_CPP",
+        "Utc1310p_POGO_O_C", "Utc1310p_POGO_O_CPP", "Linker624", "Cvtomf624",
+        "Export624", "Implib624", "Linker710", "Cvtomf710",
+        "Export710", "Implib710", "Cvtres710", "Utc1310_C",
+        "Utc1310_CPP", "Utc1310_C_Std", "Utc1310_CPP_Std", "Utc1310_LTCG_C",
+        "Utc1310_LTCG_CPP", "Utc1310_POGO_I_C", "Utc1310_POGO_I_CPP", "Utc1310_POGO_O_C",
+        "Utc1310_POGO_O_CPP", "AliasObj710", "AliasObj710p", "Cvtpgd1310",
+        "Cvtpgd1310p", "Utc1400_C", "Utc1400_CPP", "Utc1400_C_Std",
+        "Utc1400_CPP_Std", "Utc1400_LTCG_C", "Utc1400_LTCG_CPP", "Utc1400_POGO_I_C",
+        "Utc1400_POGO_I_CPP", "Utc1400_POGO_O_C", "Utc1400_POGO_O_CPP", "Cvtpgd1400",
+        "Linker800", "Cvtomf800", "Export800", "Implib800",
+        "Cvtres800", "Masm800", "AliasObj800", "PhoenixPrerelease",
+        "Utc1400_CVTCIL_C", "Utc1400_CVTCIL_CPP", "Utc1400_LTCG_MSIL", "Utc1500_C",
+        "Utc1500_CPP", "Utc1500_C_Std", "Utc1500_CPP_Std", "Utc1500_CVTCIL_C",
+        "Utc1500_CVTCIL_CPP", "Utc1500_LTCG_C", "Utc1500_LTCG_CPP", "Utc1500_LTCG_MSIL",
+        "Utc1500_POGO_I_C", "Utc1500_POGO_I_CPP", "Utc1500_POGO_O_C", "Utc1500_POGO_O_CPP",
+        "Cvtpgd1500", "Linker900", "Export900", "Implib900",
+        "Cvtres900", "Masm900", "AliasObj900", "Resource",
+        "AliasObj1000", "Cvtpgd1600", "Cvtres1000", "Export1000",
+        "Implib1000", "Linker1000", "Masm1000", "Phx1600_C",
+        "Phx1600_CPP", "Phx1600_CVTCIL_C", "Phx1600_CVTCIL_CPP", "Phx1600_LTCG_C",
+        "Phx1600_LTCG_CPP", "Phx1600_LTCG_MSIL", "Phx1600_POGO_I_C", "Phx1600_POGO_I_CPP",
+        "Phx1600_POGO_O_C", "Phx1600_POGO_O_CPP", "Utc1600_C", "Utc1600_CPP",
+        "Utc1600_CVTCIL_C", "Utc1600_CVTCIL_CPP", "Utc1600_LTCG_C", "Utc1600_LTCG_CPP",
+        "Utc1600_LTCG_MSIL", "Utc1600_POGO_I_C", "Utc1600_POGO_I_CPP", "Utc1600_POGO_O_C",
+        "Utc1600_POGO_O_CPP", "AliasObj1010", "Cvtpgd1610", "Cvtres1010",
+        "Export1010", "Implib1010", "Linker1010", "Masm1010",
+        "Utc1610_C", "Utc1610_CPP", "Utc1610_CVTCIL_C", "Utc1610_CVTCIL_CPP",
+        "Utc1610_LTCG_C", "Utc1610_LTCG_CPP", "Utc1610_LTCG_MSIL", "Utc1610_POGO_I_C",
+        "Utc1610_POGO_I_CPP", "Utc1610_POGO_O_C", "Utc1610_POGO_O_CPP", "AliasObj1100",
+        "Cvtpgd1700", "Cvtres1100", "Export1100", "Implib1100",
+        "Linker1100", "Masm1100", "Utc1700_C", "Utc1700_CPP",
+        "Utc1700_CVTCIL_C", "Utc1700_CVTCIL_CPP", "Utc1700_LTCG_C", "Utc1700_LTCG_CPP",
+        "Utc1700_LTCG_MSIL", "Utc1700_POGO_I_C", "Utc1700_POGO_I_CPP", "Utc1700_POGO_O_C",
+        "Utc1700_POGO_O_CPP", "AliasObj1200", "Cvtpgd1800", "Cvtres1200",
+        "Export1200", "Implib1200", "Linker1200", "Masm1200",
+        "Utc1800_C", "Utc1800_CPP", "Utc1800_CVTCIL_C", "Utc1800_CVTCIL_CPP",
+        "Utc1800_LTCG_C", "Utc1800_LTCG_CPP", "Utc1800_LTCG_MSIL", "Utc1800_POGO_I_C",
+        "Utc1800_POGO_I_CPP", "Utc1800_POGO_O_C", "Utc1800_POGO_O_CPP", "AliasObj1210",
+        "Cvtpgd1810", "Cvtres1210", "Export1210", "Implib1210",
+        "Linker1210", "Masm1210", "Utc1810_C", "Utc1810_CPP",
+        "Utc1810_CVTCIL_C", "Utc1810_CVTCIL_CPP", "Utc1810_LTCG_C", "Utc1810_LTCG_CPP",
+        "Utc1810_LTCG_MSIL", "Utc1810_POGO_I_C", "Utc1810_POGO_I_CPP", "Utc1810_POGO_O_C",
+        "Utc1810_POGO_O_CPP", "AliasObj1400", "Cvtpgd1900", "Cvtres1400",
+        "Export1400", "Implib1400", "Linker1400", "Masm1400",
+        "Utc1900_C", "Utc1900_CPP", "Utc1900_CVTCIL_C", "Utc1900_CVTCIL_CPP",
+        "Utc1900_LTCG_C", "Utc1900_LTCG_CPP", "Utc1900_LTCG_MSIL", "Utc1900_POGO_I_C",
+        "Utc1900_POGO_I_CPP", "Utc1900_POGO_O_C", "Utc1900_POGO_O_CPP"
+    };
+    constexpr size_t PROD_ID_NAMES_COUNT = sizeof(PROD_ID_NAMES) / sizeof(PROD_ID_NAMES[0]);
+
+    struct VSVersionRange
+    {
+        WORD first;
+        WORD last; // inclusive
+        const char* name;
+    };
+
+    // list based on: https://github.com/kirschju/richheader + pnx's notes
+    constexpr VSVersionRange VS_VERSIONS[] = {
+        { 0x0001, 0x0001, "Visual Studio" },
+        { 0x0002, 0x0002, "Visual Studio 97 05.00" },
+        { 0x0006, 0x0006, "Visual Studio 97 05.00" },
+        { 0x000a, 0x000b, "Visual Studio 6.0 06.00" },
+        { 0x000c, 0x000c, "Visual Studio 97 05.00" },
+        { 0x000d, 0x000d, "Visual Studio 6.0 06.00" },
+        { 0x000e, 0x000e, "Visual Studio 97 05.00" },
+        { 0x0015, 0x0016, "Visual Studio 6.0 06.00" },
+        { 0x0019, 0x0045, "Visual Studio 2002 07.00" },
+        { 0x005a, 0x006c, "Visual Studio 2003 07.10" },
+        { 0x006d, 0x0082, "Visual Studio 2005 08.00" },
+        { 0x0083, 0x0097, "Visual Studio 2008 09.00" },
+        { 0x0098, 0x00b4, "Visual Studio 2010 10.00" },
+        { 0x00b5, 0x00c6, "Visual Studio 2010 10.10" },
+        { 0x00c7, 0x00d8, "Visual Studio 2012 11.00" },
+        { 0x00d9, 0x00ea, "Visual Studio 2013 12.00" },
+        { 0x00eb, 0x00fc, "Visual Studio 2013 12.10" },
+        { 0x00fd, 0x0105, "Visual Studio 2015 14.00" },
+        { 0x0106, 0x010a, "Visual Studio 2017 14.01+" }
+    };
+    constexpr size_t VS_VERSIONS_COUNT = sizeof(VS_VERSIONS) / sizeof(VS_VERSIONS[0]);
+
+    constexpr bool isSortedDisjoint(size_t i = 1)
+    {
+        return (i >= VS_VERSIONS_COUNT) ? true
+            : (VS_VERSIONS[i - 1].last < VS_VERSIONS[i].first && VS_VERSIONS[i].first <= VS_VERSIONS[i].last && isSortedDisjoint(i + 1));
+    }
+    static_assert(isSortedDisjoint(), "The ranges of the versions must be sorted and disjoint");
+
+    const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+    const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    inline uint64_t fnv1a(uint64_t hash, uint64_t val, size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; i++) {
+            hash ^= (val >> (i * 8)) & 0xFF;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+};
+
+
+size_t RichHdrWrapper::getVSVersionIndex(WORD prodId)
+{
+    // the last range starting at or before the prodId
+    const VSVersionRange *end = VS_VERSIONS + VS_VERSIONS_COUNT;
+    const VSVersionRange *itr = std::upper_bound(VS_VERSIONS, end, prodId,
+        [](WORD val, const VSVersionRange &range) { return val < range.first; });
+    if (itr == VS_VERSIONS) return VS_UNKNOWN;
+    --itr;
+    if (prodId > itr->last) return VS_UNKNOWN;
+    return size_t(itr - VS_VERSIONS);
+}
+
+size_t RichHdrWrapper::getVSVersionsCount()
+{
+    return VS_VERSIONS_COUNT;
+}
+
+QString RichHdrWrapper::getVSVersionName(size_t index)
+{
+    if (index >= VS_VERSIONS_COUNT) return "";
+    return VS_VERSIONS[index].name;
+}
 
 bool RichHdrWrapper::wrap()
 {
+    this->compIds.clear();
+    this->checksum = 0;
+    this->fingerprint = 0;
+
     this->richSign = m_PE->getRichHeaderSign();
     this->dansHdr = m_PE->getRichHeaderBgn(richSign);
     if (!this->richSign || !this->dansHdr) {
@@ -12,9 +165,45 @@ bool RichHdrWrapper::wrap()
         return false;
     }
     this->compIdCounter = this->compIdCount();
+
+    // decode all the comp IDs at once
+    const DWORD xorVal = this->richSign->checksum;
+    this->compIds.reserve(this->compIdCounter);
+    for (size_t i = 0; i < this->compIdCounter; i++) {
+        pe::RICH_COMP_ID compId = this->dansHdr->compId[i];
+        compId.CV ^= WORD(xorVal);
+        compId.prodId ^= WORD(xorVal >> 16);
+        compId.count ^= xorVal;
+        this->compIds.push_back(compId);
+    }
+    this->checksum = this->calcChecksum();
+
+    std::sort(this->compIds.begin(), this->compIds.end(),
+        [](const pe::RICH_COMP_ID &a, const pe::RICH_COMP_ID &b) {
+            if (a.prodId != b.prodId) return a.prodId < b.prodId;
+            if (a.CV != b.CV) return a.CV < b.CV;
+            return a.count < b.count;
+        });
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < this->compIds.size(); i++) {
+        const pe::RICH_COMP_ID &compId = this->compIds[i];
+        hash = fnv1a(hash, (DWORD(compId.prodId) << 16) | compId.CV, sizeof(DWORD));
+        hash = fnv1a(hash, compId.count, sizeof(DWORD));
+    }
+    this->fingerprint = hash;
     return true;
 }
 
+std::vector<DWORD> RichHdrWrapper::getToolchainVector() const
+{
+    std::vector<DWORD> counts(VS_VERSIONS_COUNT + 1, 0);
+    for (size_t i = 0; i < this->compIds.size(); i++) {
+        const size_t index = getVSVersionIndex(this->compIds[i].prodId);
+        counts[(index == VS_UNKNOWN) ? VS_VERSIONS_COUNT : index] += this->compIds[i].count;
+    }
+    return counts;
+}
+
 void* RichHdrWrapper::getPtr()
 {
     if (!this->dansHdr) {
@@ -152,7 +341,9 @@ pe::RICH_COMP_ID RichHdrWrapper::getCompId(size_t fieldId)
 
 inline DWORD rol32(DWORD temp, DWORD i)
 {
-    return ((temp << (i%32)) | (temp >> (32-(i%32))));
+    i %= 32;
+    if (i == 0) return temp; // shifting by 32 is undefined
+    return ((temp << i) | (temp >> (32 - i)));
 }
 
 DWORD RichHdrWrapper::calcChecksum()
@@ -172,10 +363,9 @@ DWORD RichHdrWrapper::calcChecksum()
         BYTE temp = data[i];
         cksum += rol32(temp,i);
     }
-    size_t compKeys = compIdCount();
-    for (size_t k = COMP_ID_1; k < (COMP_ID_1 + compKeys); k++) {
-        pe::RICH_COMP_ID compId = this->getCompId(k);
-        
+    for (size_t k = 0; k < this->compIds.size(); k++) {
+        const pe::RICH_COMP_ID &compId = this->compIds[k];
+
         DWORD temp = compId.prodId << 16 | compId.CV;
         DWORD roled = rol32(temp, compId.count);
         cksum += roled;
@@ -211,7 +401,7 @@ QString RichHdrWrapper::translateFieldContent(size_t fieldId)
     }
     
     if (fieldId == CHECKSUM + cnt) {
-        return QString::number(this->calcChecksum(), 16);
+        return QString::number(this->checksum, 16);
     }
     
     if (fieldId >= COMP_ID_1 && fieldId <= COMP_ID_1 + cnt)
@@ -228,315 +418,15 @@ QString RichHdrWrapper::translateFieldContent(size_t fieldId)
 }
 
 
-const QString RichHdr_ProdIdToVSversion(WORD i)
+const QString RichHdr_ProdIdToVSversion(WORD prodId)
 {
-    //list based on: https://github.com/kirschju/richheader + pnx's notes
-    if (i >= 0x0106 && i < (0x010a + 1))
-        return "Visual Studio 2017 14.01+";
-    if (i >= 0x00fd && i < (0x0106))
-        return "Visual Studio 2015 14.00";
-    if (i >= 0x00eb && i < 0x00fd)
-        return "Visual Studio 2013 12.10";
-    if (i >= 0x00d9 && i < 0x00eb)
-        return "Visual Studio 2013 12.00";
-    if (i >= 0x00c7 && i < 0x00d9)
-        return "Visual Studio 2012 11.00";
-    if (i >= 0x00b5 && i < 0x00c7)
-        return "Visual Studio 2010 10.10";
-    if (i >= 0x0098 && i < 0x00b5)
-        return "Visual Studio 2010 10.00";
-    if (i >= 0x0083 && i < 0x0098)
-        return "Visual Studio 2008 09.00";
-    if (i >= 0x006d && i < 0x0083)
-        return "Visual Studio 2005 08.00";
-    if (i >= 0x005a && i < 0x006d)
-        return "Visual Studio 2003 07.10";
-    if (i >= 0x0019 && i < (0x0045 + 1))
-        return "Visual Studio 2002 07.00";
-    if (i == 0xA || i == 0xB || i == 0xD || i == 0x15 || i == 0x16 )
-        return "Visual Studio 6.0 06.00";
-    if (i == 0x2 || i == 0x6 || i == 0xC || i == 0xE)
-        return "Visual Studio 97 05.00";
-    if (i == 1)
-        return "Visual Studio";
-    return "";
+    const size_t index = RichHdrWrapper::getVSVersionIndex(prodId);
+    if (index == RichHdrWrapper::VS_UNKNOWN) return "";
+    return VS_VERSIONS[index].name;
 }
 
 const QString RichHdr_translateProdId(WORD prodId)
 {
-    //list from: https://github.com/kirschju/richheader
-    switch (prodId) {
-        case 0x0000: return "Unknown";
-        case 0x0001: return "Import0";
-        case 0x0002: return "Linker510";
-        case 0x0003: return "Cvtomf510";
-        case 0x0004: return "Linker600";
-        case 0x0005: return "Cvtomf600";
-        case 0x0006: return "Cvtres500";
-        case 0x0007: return "Utc11_Basic";
-        case 0x0008: return "Utc11_C";
-        case 0x0009: return "Utc12_Basic";
-        case 0x000a: return "Utc12_C";
-        case 0x000b: return "Utc12_CPP";
-        case 0x000c: return "AliasObj60";
-        case 0x000d: return "VisualBasic60";
-        case 0x000e: return "Masm613";
-        case 0x000f: return "Masm710";
-        case 0x0010: return "Linker511";
-        case 0x0011: return "Cvtomf511";
-        case 0x0012: return "Masm614";
-        case 0x0013: return "Linker512";
-        case 0x0014: return "Cvtomf512";
-        case 0x0015: return "Utc12_C_Std";
-        case 0x0016: return "Utc12_CPP_Std";
-        case 0x0017: return "Utc12_C_Book";
-        case 0x0018: return "Utc12_CPP_Book";
-        case 0x0019: return "Implib700";
-        case 0x001a: return "Cvtomf700";
-        case 0x001b: return "Utc13_Basic";
-        case 0x001c: return "Utc13_C";
-        case 0x001d: return "Utc13_CPP";
-        case 0x001e: return "Linker610";
-        case 0x001f: return "Cvtomf610";
-        case 0x0020: return "Linker601";
-        case 0x0021: return "Cvtomf601";
-        case 0x0022: return "Utc12_1_Basic";
-        case 0x0023: return "Utc12_1_C";
-        case 0x0024: return "Utc12_1_CPP";
-        case 0x0025: return "Linker620";
-        case 0x0026: return "Cvtomf620";
-        case 0x0027: return "AliasObj70";
-        case 0x0028: return "Linker621";
-        case 0x0029: return "Cvtomf621";
-        case 0x002a: return "Masm615";
-        case 0x002b: return "Utc13_LTCG_C";
-        case 0x002c: return "Utc13_LTCG_CPP";
-        case 0x002d: return "Masm620";
-        case 0x002e: return "ILAsm100";
-        case 0x002f: return "Utc12_2_Basic";
-        case 0x0030: return "Utc12_2_C";
-        case 0x0031: return "Utc12_2_CPP";
-        case 0x0032: return "Utc12_2_C_Std";
-        case 0x0033: return "Utc12_2_CPP_Std";
-        case 0x0034: return "Utc12_2_C_Book";
-        case 0x0035: return "Utc12_2_CPP_Book";
-        case 0x0036: return "Implib622";
-        case 0x0037: return "Cvtomf622";
-        case 0x0038: return "Cvtres501";
-        case 0x0039: return "Utc13_C_Std";
-        case 0x003a: return "Utc13_CPP_Std";
-        case 0x003b: return "Cvtpgd1300";
-        case 0x003c: return "Linker622";
-        case 0x003d: return "Linker700";
-        case 0x003e: return "Export622";
-        case 0x003f: return "Export700";
-        case 0x0040: return "Masm700";
-        case 0x0041: return "Utc13_POGO_I_C";
-        case 0x0042: return "Utc13_POGO_I_CPP";
-        case 0x0043: return "Utc13_POGO_O_C";
-        case 0x0044: return "Utc13_POGO_O_CPP";
-        case 0x0045: return "Cvtres700";
-        case 0x0046: return "Cvtres710p";
-        case 0x0047: return "Linker710p";
-        case 0x0048: return "Cvtomf710p";
-        case 0x0049: return "Export710p";
-        case 0x004a: return "Implib710p";
-        case 0x004b: return "Masm710p";
-        case 0x004c: return "Utc1310p_C";
-        case 0x004d: return "Utc1310p_CPP";
-        case 0x004e: return "Utc1310p_C_Std";
-        case 0x004f: return "Utc1310p_CPP_Std";
-        case 0x0050: return "Utc1310p_LTCG_C";
-        case 0x0051: return "Utc1310p_LTCG_CPP";
-        case 0x0052: return "Utc1310p_POGO_I_C";
-        case 0x0053: return "Utc1310p_POGO_I_CPP";
-        case 0x0054: return "Utc1310p_POGO_O_C";
-        case 0x0055: return "Utc1310p_POGO_O_CPP";
-        case 0x0056: return "Linker624";
-        case 0x0057: return "Cvtomf624";
-        case 0x0058: return "Export624";
-        case 0x0059: return "Implib624";
-        case 0x005a: return "Linker710";
-        case 0x005b: return "Cvtomf710";
-        case 0x005c: return "Export710";
-        case 0x005d: return "Implib710";
-        case 0x005e: return "Cvtres710";
-        case 0x005f: return "Utc1310_C";
-        case 0x0060: return "Utc1310_CPP";
-        case 0x0061: return "Utc1310_C_Std";
-        case 0x0062: return "Utc1310_CPP_Std";
-        case 0x0063: return "Utc1310_LTCG_C";
-        case 0x0064: return "Utc1310_LTCG_CPP";
-        case 0x0065: return "Utc1310_POGO_I_C";
-        case 0x0066: return "Utc1310_POGO_I_CPP";
-        case 0x0067: return "Utc1310_POGO_O_C";
-        case 0x0068: return "Utc1310_POGO_O_CPP";
-        case 0x0069: return "AliasObj710";
-        case 0x006a: return "AliasObj710p";
-        case 0x006b: return "Cvtpgd1310";
-        case 0x006c: return "Cvtpgd1310p";
-        case 0x006d: return "Utc1400_C";
-        case 0x006e: return "Utc1400_CPP";
-        case 0x006f: return "Utc1400_C_Std";
-        case 0x0070: return "Utc1400_CPP_Std";
-        case 0x0071: return "Utc1400_LTCG_C";
-        case 0x0072: return "Utc1400_LTCG_CPP";
-        case 0x0073: return "Utc1400_POGO_I_C";
-        case 0x0074: return "Utc1400_POGO_I_CPP";
-        case 0x0075: return "Utc1400_POGO_O_C";
-        case 0x0076: return "Utc1400_POGO_O_CPP";
-        case 0x0077: return "Cvtpgd1400";
-        case 0x0078: return "Linker800";
-        case 0x0079: return "Cvtomf800";
-        case 0x007a: return "Export800";
-        case 0x007b: return "Implib800";
-        case 0x007c: return "Cvtres800";
-        case 0x007d: return "Masm800";
-        case 0x007e: return "AliasObj800";
-        case 0x007f: return "PhoenixPrerelease";
-        case 0x0080: return "Utc1400_CVTCIL_C";
-        case 0x0081: return "Utc1400_CVTCIL_CPP";
-        case 0x0082: return "Utc1400_LTCG_MSIL";
-        case 0x0083: return "Utc1500_C";
-        case 0x0084: return "Utc1500_CPP";
-        case 0x0085: return "Utc1500_C_Std";
-        case 0x0086: return "Utc1500_CPP_Std";
-        case 0x0087: return "Utc1500_CVTCIL_C";
-        case 0x0088: return "Utc1500_CVTCIL_CPP";
-        case 0x0089: return "Utc1500_LTCG_C";
-        case 0x008a: return "Utc1500_LTCG_CPP";
-        case 0x008b: return "Utc1500_LTCG_MSIL";
-        case 0x008c: return "Utc1500_POGO_I_C";
-        case 0x008d: return "Utc1500_POGO_I_CPP";
-        case 0x008e: return "Utc1500_POGO_O_C";
-        case 0x008f: return "Utc1500_POGO_O_CPP";
-        case 0x0090: return "Cvtpgd1500";
-        case 0x0091: return "Linker900";
-        case 0x0092: return "Export900";
-        case 0x0093: return "Implib900";
-        case 0x0094: return "Cvtres900";
-        case 0x0095: return "Masm900";
-        case 0x0096: return "AliasObj900";
-        case 0x0097: return "Resource";
-        case 0x0098: return "AliasObj1000";
-        case 0x0099: return "Cvtpgd1600";
-        case 0x009a: return "Cvtres1000";
-        case 0x009b: return "Export1000";
-        case 0x009c: return "Implib1000";
-        case 0x009d: return "Linker1000";
-        case 0x009e: return "Masm1000";
-        case 0x009f: return "Phx1600_C";
-        case 0x00a0: return "Phx1600_CPP";
-        case 0x00a1: return "Phx1600_CVTCIL_C";
-        case 0x00a2: return "Phx1600_CVTCIL_CPP";
-        case 0x00a3: return "Phx1600_LTCG_C";
-        case 0x00a4: return "Phx1600_LTCG_CPP";
-        case 0x00a5: return "Phx1600_LTCG_MSIL";
-        case 0x00a6: return "Phx1600_POGO_I_C";
-        case 0x00a7: return "Phx1600_POGO_I_CPP";
-        case 0x00a8: return "Phx1600_POGO_O_C";
-        case 0x00a9: return "Phx1600_POGO_O_CPP";
-        case 0x00aa: return "Utc1600_C";
-        case 0x00ab: return "Utc1600_CPP";
-        case 0x00ac: return "Utc1600_CVTCIL_C";
-        case 0x00ad: return "Utc1600_CVTCIL_CPP";
-        case 0x00ae: return "Utc1600_LTCG_C";
-        case 0x00af: return "Utc1600_LTCG_CPP";
-        case 0x00b0: return "Utc1600_LTCG_MSIL";
-        case 0x00b1: return "Utc1600_POGO_I_C";
-        case 0x00b2: return "Utc1600_POGO_I_CPP";
-        case 0x00b3: return "Utc1600_POGO_O_C";
-        case 0x00b4: return "Utc1600_POGO_O_CPP";
-        case 0x00b5: return "AliasObj1010";
-        case 0x00b6: return "Cvtpgd1610";
-        case 0x00b7: return "Cvtres1010";
-        case 0x00b8: return "Export1010";
-        case 0x00b9: return "Implib1010";
-        case 0x00ba: return "Linker1010";
-        case 0x00bb: return "Masm1010";
-        case 0x00bc: return "Utc1610_C";
-        case 0x00bd: return "Utc1610_CPP";
-        case 0x00be: return "Utc1610_CVTCIL_C";
-        case 0x00bf: return "Utc1610_CVTCIL_CPP";
-        case 0x00c0: return "Utc1610_LTCG_C";
-        case 0x00c1: return "Utc1610_LTCG_CPP";
-        case 0x00c2: return "Utc1610_LTCG_MSIL";
-        case 0x00c3: return "Utc1610_POGO_I_C";
-        case 0x00c4: return "Utc1610_POGO_I_CPP";
-        case 0x00c5: return "Utc1610_POGO_O_C";
-        case 0x00c6: return "Utc1610_POGO_O_CPP";
-        case 0x00c7: return "AliasObj1100";
-        case 0x00c8: return "Cvtpgd1700";
-        case 0x00c9: return "Cvtres1100";
-        case 0x00ca: return "Export1100";
-        case 0x00cb: return "Implib1100";
-        case 0x00cc: return "Linker1100";
-        case 0x00cd: return "Masm1100";
-        case 0x00ce: return "Utc1700_C";
-        case 0x00cf: return "Utc1700_CPP";
-        case 0x00d0: return "Utc1700_CVTCIL_C";
-        case 0x00d1: return "Utc1700_CVTCIL_CPP";
-        case 0x00d2: return "Utc1700_LTCG_C";
-        case 0x00d3: return "Utc1700_LTCG_CPP";
-        case 0x00d4: return "Utc1700_LTCG_MSIL";
-        case 0x00d5: return "Utc1700_POGO_I_C";
-        case 0x00d6: return "Utc1700_POGO_I_CPP";
-        case 0x00d7: return "Utc1700_POGO_O_C";
-        case 0x00d8: return "Utc1700_POGO_O_CPP";
-        case 0x00d9: return "AliasObj1200";
-        case 0x00da: return "Cvtpgd1800";
-        case 0x00db: return "Cvtres1200";
-        case 0x00dc: return "Export1200";
-        case 0x00dd: return "Implib1200";
-        case 0x00de: return "Linker1200";
-        case 0x00df: return "Masm1200";
-        case 0x00e0: return "Utc1800_C";
-        case 0x00e1: return "Utc1800_CPP";
-        case 0x00e2: return "Utc1800_CVTCIL_C";
-        case 0x00e3: return "Utc1800_CVTCIL_CPP";
-        case 0x00e4: return "Utc1800_LTCG_C";
-        case 0x00e5: return "Utc1800_LTCG_CPP";
-        case 0x00e6: return "Utc1800_LTCG_MSIL";
-        case 0x00e7: return "Utc1800_POGO_I_C";
-        case 0x00e8: return "Utc1800_POGO_I_CPP";
-        case 0x00e9: return "Utc1800_POGO_O_C";
-        case 0x00ea: return "Utc1800_POGO_O_CPP";
-        case 0x00eb: return "AliasObj1210";
-        case 0x00ec: return "Cvtpgd1810";
-        case 0x00ed: return "Cvtres1210";
-        case 0x00ee: return "Export1210";
-        case 0x00ef: return "Implib1210";
-        case 0x00f0: return "Linker1210";
-        case 0x00f1: return "Masm1210";
-        case 0x00f2: return "Utc1810_C";
-        case 0x00f3: return "Utc1810_CPP";
-        case 0x00f4: return "Utc1810_CVTCIL_C";
-        case 0x00f5: return "Utc1810_CVTCIL_CPP";
-        case 0x00f6: return "Utc1810_LTCG_C";
-        case 0x00f7: return "Utc1810_LTCG_CPP";
-        case 0x00f8: return "Utc1810_LTCG_MSIL";
-        case 0x00f9: return "Utc1810_POGO_I_C";
-        case 0x00fa: return "Utc1810_POGO_I_CPP";
-        case 0x00fb: return "Utc1810_POGO_O_C";
-        case 0x00fc: return "Utc1810_POGO_O_CPP";
-        case 0x00fd: return "AliasObj1400";
-        case 0x00fe: return "Cvtpgd1900";
-        case 0x00ff: return "Cvtres1400";
-        case 0x0100: return "Export1400";
-        case 0x0101: return "Implib1400";
-        case 0x0102: return "Linker1400";
-        case 0x0103: return "Masm1400";
-        case 0x0104: return "Utc1900_C";
-        case 0x0105: return "Utc1900_CPP";
-        case 0x0106: return "Utc1900_CVTCIL_C";
-        case 0x0107: return "Utc1900_CVTCIL_CPP";
-        case 0x0108: return "Utc1900_LTCG_C";
-        case 0x0109: return "Utc1900_LTCG_CPP";
-        case 0x010a: return "Utc1900_LTCG_MSIL";
-        case 0x010b: return ": 'Utc1900_POGO_I_C";
-        case 0x010c: return "Utc1900_POGO_I_CPP";
-        case 0x010d: return "Utc1900_POGO_O_C";
-        case 0x010e: return "Utc1900_POGO_O_CPP";
-    }
-    return "?";
+    if (prodId >= PROD_ID_NAMES_COUNT) return "?";
+    return PROD_ID_NAMES[prodId];
 }
@@ -1,5 +1,6 @@
 #include "pe/SecurityDirWrapper.h"
 #include "pe/PEFile.h"
+#include "pe/AuthenticodeHasher.h"
 
 pe::WIN_CERTIFICATE* SecurityDirWrapper::getCert()
 {
@@ -13,6 +14,7 @@ pe::WIN_CERTIFICATE* SecurityDirWrapper::getCert()
 
 bool SecurityDirWrapper::wrap()
 {
+    clear();
     this->sizeOk = false;
 
     pe::WIN_CERTIFICATE* cert = getCert();
@@ -22,13 +24,21 @@ bool SecurityDirWrapper::wrap()
     if (offset == INVALID_ADDR) return false;
     BYTE *ptr = NULL;
 
-    size_t fieldsSize = sizeof(cert->dwLength) + sizeof(cert->wRevision) + sizeof(cert->dwLength);
+    size_t fieldsSize = sizeof(cert->dwLength) + sizeof(cert->wRevision) + sizeof(cert->wCertificateType);
+    if (cert->dwLength < fieldsSize) return false;
     size_t certSize = cert->dwLength - fieldsSize;
     ptr = m_Exe->getContentAt(offset, Executable::RAW, static_cast<bufsize_t>(certSize));
 
     if (ptr == NULL) return false;
 
     this->sizeOk = true;
+
+    if (cert->wCertificateType == pe::WIN_CERT_TYPE_PKCS_SIGNED_DATA) {
+        DerNode contentInfo = DerNode::read(ptr, ptr + certSize);
+        if (contentInfo.isValid()) {
+            this->signedData = new SignedDataWrapper(m_Exe, this, 0, contentInfo);
+        }
+    }
     return true;
 }
 
@@ -103,3 +113,8 @@ QString SecurityDirWrapper::translateFieldContent(size_t fieldId)
 
     return translateType(cert->wCertificateType);
 }
+
+QByteArray SecurityDirWrapper::computeDigest(QCryptographicHash::Algorithm algo)
+{
+    return AuthenticodeHasher::computeDigest(m_PE, algo);
+}
@@ -0,0 +1,343 @@
+#include "pe/SignedDataWrapper.h"
+#include "pe/PEFile.h"
+
+DerElementWrapper::DerElementWrapper(Executable *exe, ExeNodeWrapper *parent, size_t entryNumber, const DerNode &v_node, size_t fieldsCount)
+    : ExeNodeWrapper(exe, parent, entryNumber), offset(INVALID_ADDR), size(0),
+    fieldOffsets(fieldsCount, INVALID_ADDR), fieldSizes(fieldsCount, 0)
+{
+    if (v_node.isValid()) {
+        this->offset = getOffset(const_cast<BYTE*>(v_node.getPtr()));
+        this->size = (this->offset != INVALID_ADDR) ? v_node.getSize() : 0;
+    }
+}
+
+void* DerElementWrapper::getPtr()
+{
+    if (offset == INVALID_ADDR || size == 0) return NULL;
+    return m_Exe->getContentAt(offset, Executable::RAW, size);
+}
+
+DerNode DerElementWrapper::getNode()
+{
+    const BYTE *ptr = static_cast<const BYTE*>(getPtr());
+    if (!ptr) return DerNode();
+    return DerNode::read(ptr, ptr + size);
+}
+
+void DerElementWrapper::setField(size_t fieldId, const DerNode &fieldNode)
+{
+    if (fieldId >= fieldOffsets.size() || !fieldNode.isValid()) return;
+
+    const offset_t fieldOffset = getOffset(const_cast<BYTE*>(fieldNode.getPtr()));
+    if (fieldOffset == INVALID_ADDR) return;
+
+    fieldOffsets[fieldId] = fieldOffset;
+    fieldSizes[fieldId] = fieldNode.getSize();
+}
+
+void* DerElementWrapper::getFieldPtr(size_t fieldId, size_t subField)
+{
+    if (fieldId >= fieldOffsets.size()) return getPtr();
+    if (fieldOffsets[fieldId] == INVALID_ADDR) return NULL;
+
+    return m_Exe->getContentAt(fieldOffsets[fieldId], Executable::RAW, fieldSizes[fieldId]);
+}
+
+bufsize_t DerElementWrapper::getFieldSize(size_t fieldId, size_t subField)
+{
+    if (fieldId >= fieldSizes.size()) return getSize();
+    return fieldSizes[fieldId];
+}
+
+DerNode DerElementWrapper::getFieldNode(size_t fieldId)
+{
+    const BYTE *ptr = static_cast<const BYTE*>(getFieldPtr(fieldId));
+    if (!ptr || fieldId >= fieldSizes.size()) return DerNode();
+    return DerNode::read(ptr, ptr + fieldSizes[fieldId]);
+}
+
+QString DerElementWrapper::translateFieldContent(size_t fieldId)
+{
+    return der_util::toText(getFieldNode(fieldId));
+}
+
+//----
+
+/*
+Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signature }
+TBSCertificate ::= SEQUENCE {
+    version [0] EXPLICIT INTEGER OPTIONAL,
+    serialNumber INTEGER, signature AlgorithmIdentifier, issuer Name,
+    validity SEQUENCE { notBefore Time, notAfter Time },
+    subject Name, subjectPublicKeyInfo SEQUENCE { algorithm, subjectPublicKey }, ...
+}
+*/
+bool CertificateWrapper::wrap()
+{
+    const DerNode tbs = getNode().firstChild();
+    if (tbs.getTag() != der::TAG_SEQUENCE) return false;
+
+    DerNode node = tbs.firstChild();
+    if (node.getTag() == der::TAG_CONTEXT_0) node = node.next(); // skip the version
+
+    setField(SERIAL, node);
+    node = node.next();
+    setField(SIGN_ALGO, node);
+    node = node.next();
+    setField(ISSUER, node);
+    node = node.next();
+
+    const DerNode validity = node;
+    setField(NOT_BEFORE, validity.child(0));
+    setField(NOT_AFTER, validity.child(1));
+
+    node = node.next();
+    setField(SUBJECT, node);
+    node = node.next();
+    setField(PUBKEY_ALGO, node.firstChild());
+    return true;
+}
+
+QString CertificateWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case SERIAL: return "Serial Number";
+        case SIGN_ALGO: return "Signature Algorithm";
+        case ISSUER: return "Issuer";
+        case NOT_BEFORE: return "Valid From";
+        case NOT_AFTER: return "Valid To";
+        case SUBJECT: return "Subject";
+        case PUBKEY_ALGO: return "Public Key Algorithm";
+    }
+    return getName();
+}
+
+QString CertificateWrapper::translateFieldContent(size_t fieldId)
+{
+    const DerNode node = getFieldNode(fieldId);
+    switch (fieldId) {
+        case SERIAL: return der_util::toHex(node);
+        case SIGN_ALGO:
+        case PUBKEY_ALGO:
+            return der_util::algorithmToString(node);
+        case ISSUER:
+        case SUBJECT:
+            return der_util::nameToText(node);
+    }
+    return der_util::toText(node);
+}
+
+//----
+
+/*
+SignerInfo ::= SEQUENCE {
+    version INTEGER,
+    issuerAndSerialNumber SEQUENCE { issuer Name, serialNumber INTEGER },
+    digestAlgorithm AlgorithmIdentifier,
+    authenticatedAttributes [0] IMPLICIT SET OF Attribute OPTIONAL,
+    digestEncryptionAlgorithm AlgorithmIdentifier,
+    encryptedDigest OCTET STRING,
+    unauthenticatedAttributes [1] IMPLICIT SET OF Attribute OPTIONAL
+}
+Attribute ::= SEQUENCE { type OID, values SET OF ANY }
+*/
+bool SignerInfoWrapper::wrap()
+{
+    DerNode node = getNode().firstChild();
+    if (node.getTag() != der::TAG_INTEGER) return false;
+
+    setField(VERSION, node);
+    node = node.next();
+
+    setField(ISSUER, node.child(0));
+    setField(SERIAL, node.child(1));
+    node = node.next();
+
+    setField(DIGEST_ALGO, node);
+    node = node.next();
+
+    if (node.getTag() == der::TAG_CONTEXT_0) {
+        setField(MESSAGE_DIGEST, getAttributeValue(node, der::OID_MESSAGE_DIGEST, sizeof(der::OID_MESSAGE_DIGEST)));
+        setField(SIGNING_TIME, getAttributeValue(node, der::OID_SIGNING_TIME, sizeof(der::OID_SIGNING_TIME)));
+        node = node.next();
+    }
+    setField(ENC_ALGO, node);
+    node = node.next();
+    setField(ENC_DIGEST, node);
+    return true;
+}
+
+DerNode SignerInfoWrapper::getAttributeValue(const DerNode &attributes, const BYTE *oid, bufsize_t oidSize)
+{
+    for (DerNode attr = attributes.firstChild(); attr.isValid(); attr = attr.next()) {
+        const DerNode type = attr.firstChild();
+        if (type.isOid(oid, oidSize)) {
+            return type.next().firstChild(); // the first of the values
+        }
+    }
+    return DerNode();
+}
+
+size_t SignerInfoWrapper::getNestedSignatures(std::vector<DerNode> &nestedNodes)
+{
+    const DerNode unauthAttributes = getNode().findChild(der::TAG_CONTEXT_1);
+
+    size_t count = 0;
+    for (DerNode attr = unauthAttributes.firstChild(); attr.isValid(); attr = attr.next()) {
+        const DerNode type = attr.firstChild();
+        if (!type.isOid(der::OID_SPC_NESTED_SIGNATURE)) continue;
+
+        for (DerNode value = type.next().firstChild(); value.isValid(); value = value.next()) {
+            nestedNodes.push_back(value);
+            count++;
+        }
+    }
+    return count;
+}
+
+QString SignerInfoWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case VERSION: return "Version";
+        case ISSUER: return "Issuer";
+        case SERIAL: return "Serial Number";
+        case DIGEST_ALGO: return "Digest Algorithm";
+        case MESSAGE_DIGEST: return "Message Digest";
+        case SIGNING_TIME: return "Signing Time";
+        case ENC_ALGO: return "Encryption Algorithm";
+        case ENC_DIGEST: return "Encrypted Digest";
+    }
+    return getName();
+}
+
+QString SignerInfoWrapper::translateFieldContent(size_t fieldId)
+{
+    const DerNode node = getFieldNode(fieldId);
+    switch (fieldId) {
+        case ISSUER: return der_util::nameToText(node);
+        case SERIAL:
+        case MESSAGE_DIGEST:
+        case ENC_DIGEST:
+            return der_util::toHex(node);
+        case DIGEST_ALGO:
+        case ENC_ALGO:
+            return der_util::algorithmToString(node);
+    }
+    return der_util::toText(node);
+}
+
+//----
+
+void SignedDataWrapper::clear()
+{
+    for (size_t i = 0; i < certificates.size(); i++) delete certificates[i];
+    for (size_t i = 0; i < signers.size(); i++) delete signers[i];
+    for (size_t i = 0; i < nested.size(); i++) delete nested[i];
+    certificates.clear();
+    signers.clear();
+    nested.clear();
+    ExeNodeWrapper::clear();
+}
+
+bool SignedDataWrapper::wrap()
+{
+    clear();
+
+    const DerNode contentInfo = getNode();
+    const DerNode contentType = contentInfo.firstChild();
+    if (!contentType.isOid(der::OID_SIGNED_DATA)) {
+        return false;
+    }
+    setField(CONTENT_TYPE, contentType);
+
+    const DerNode signedData = contentType.next().firstChild();
+    if (signedData.getTag() != der::TAG_SEQUENCE) return false;
+
+    DerNode node = signedData.firstChild();
+    setField(VERSION, node);
+    node = node.next();
+    setField(DIGEST_ALGOS, node);
+    node = node.next();
+
+    // the signed content: SpcIndirectDataContent in case of Authenticode
+    const DerNode signedContentType = node.firstChild();
+    setField(SIGNED_CONTENT_TYPE, signedContentType);
+    if (signedContentType.isOid(der::OID_SPC_INDIRECT_DATA)) {
+        DerNode indirectData = signedContentType.next().firstChild();
+        if (indirectData.getTag() == der::TAG_OCTET_STRING) {
+            // CMS style: the content wrapped into the OCTET STRING
+            indirectData = DerNode::read(indirectData.getContent(), indirectData.getContent() + indirectData.getContentSize());
+        }
+        const DerNode digestInfo = indirectData.child(1);
+        setField(IMAGE_DIGEST_ALGO, digestInfo.child(0));
+        setField(IMAGE_DIGEST, digestInfo.child(1));
+    }
+    node = node.next();
+
+    if (node.getTag() == der::TAG_CONTEXT_0) {
+        for (DerNode cert = node.firstChild(); cert.isValid(); cert = cert.next()) {
+            certificates.push_back(new CertificateWrapper(m_Exe, this, certificates.size(), cert));
+        }
+        node = node.next();
+    }
+    if (node.getTag() == der::TAG_CONTEXT_1) {
+        node = node.next(); // CRLs: not used by Authenticode
+    }
+    if (node.getTag() != der::TAG_SET) return false;
+
+    std::vector<DerNode> nestedNodes;
+    for (DerNode signer = node.firstChild(); signer.isValid(); signer = signer.next()) {
+        SignerInfoWrapper *signerWrapper = new SignerInfoWrapper(m_Exe, this, signers.size(), signer);
+        signers.push_back(signerWrapper);
+        signerWrapper->getNestedSignatures(nestedNodes);
+    }
+
+    if (nestingLevel >= MAX_NESTING) {
+        if (nestedNodes.size()) Logger::append(Logger::D_WARNING, "Too many nested signatures");
+        return true;
+    }
+    for (size_t i = 0; i < nestedNodes.size(); i++) {
+        nested.push_back(new SignedDataWrapper(m_Exe, this, nested.size(), nestedNodes[i], nestingLevel + 1));
+    }
+    return true;
+}
+
+QByteArray SignedDataWrapper::getImageDigest()
+{
+    const DerNode digest = getFieldNode(IMAGE_DIGEST);
+    if (digest.getTag() != der::TAG_OCTET_STRING) return QByteArray();
+
+    return QByteArray(reinterpret_cast<const char*>(digest.getContent()), static_cast<int>(digest.getContentSize()));
+}
+
+QString SignedDataWrapper::getFieldName(size_t fieldId)
+{
+    switch (fieldId) {
+        case CONTENT_TYPE: return "Content Type";
+        case VERSION: return "Version";
+        case DIGEST_ALGOS: return "Digest Algorithms";
+        case SIGNED_CONTENT_TYPE: return "Signed Content Type";
+        case IMAGE_DIGEST_ALGO: return "Image Digest Algorithm";
+        case IMAGE_DIGEST: return "Image Digest";
+    }
+    return getName();
+}
+
+QString SignedDataWrapper::translateFieldContent(size_t fieldId)
+{
+    const DerNode node = getFieldNode(fieldId);
+    switch (fieldId) {
+        case DIGEST_ALGOS:
+        {
+            QString algos;
+            for (DerNode algo = node.firstChild(); algo.isValid(); algo = algo.next()) {
+                if (algos.length()) algos += ", ";
+                algos += der_util::algorithmToString(algo);
+            }
+            return algos;
+        }
+        case IMAGE_DIGEST_ALGO:
+            return der_util::algorithmToString(node);
+    }
+    return der_util::toText(node);
+}
@@ -0,0 +1,119 @@
+#include "pe/StrongNameHasher.h"
+
+#include <algorithm>
+
+namespace {
+    // ALG_ID of wincrypt.h
+    const DWORD CALG_SHA1 = 0x8004;
+    const DWORD CALG_SHA_256 = 0x800C;
+    const DWORD CALG_SHA_384 = 0x800D;
+    const DWORD CALG_SHA_512 = 0x800E;
+
+    // PublicKeyBlob: { DWORD SigAlgID; DWORD HashAlgID; DWORD cbPublicKey; BYTE PublicKey[] }
+    const bufsize_t PUBKEY_BLOB_HDR_SIZE = 3 * sizeof(DWORD);
+    const offset_t PUBKEY_HASH_ALG_OFFSET = sizeof(DWORD);
+};
+
+bool StrongNameHasher::getSignatureRange(PEFile *pe, DigestRange &range)
+{
+    ClrDirWrapper *clrDir = pe ? pe->getClsDir() : NULL;
+    pe::IMAGE_COR20_HEADER *hdr = clrDir ? static_cast<pe::IMAGE_COR20_HEADER*>(clrDir->getPtr()) : NULL;
+    if (!hdr || hdr->StrongNameSignature.VirtualAddress == 0 || hdr->StrongNameSignature.Size == 0) {
+        return false;
+    }
+    const offset_t rva = hdr->StrongNameSignature.VirtualAddress;
+    const bufsize_t size = hdr->StrongNameSignature.Size;
+    if (!pe->getContentAt(rva, Executable::RVA, size)) {
+        Logger::append(Logger::D_WARNING, "The strong name signature is out of the image");
+        return false;
+    }
+    range = DigestRange(pe->rvaToRaw(rva), size);
+    return range.offset != INVALID_ADDR;
+}
+
+bool StrongNameHasher::getSignedRanges(PEFile *pe, std::vector<DigestRange> &ranges)
+{
+    if (!pe) return false;
+
+    DigestRange signature;
+    if (!getSignatureRange(pe, signature)) return false;
+
+    OptHdrWrapper *optHdr = dynamic_cast<OptHdrWrapper*>(pe->getWrapper(PEFile::WR_OPTIONAL_HDR));
+    DataDirWrapper *dataDir = dynamic_cast<DataDirWrapper*>(pe->getWrapper(PEFile::WR_DATADIR));
+    if (!optHdr || !dataDir) return false;
+
+    const offset_t checksumOffset = optHdr->getFieldOffset(OptHdrWrapper::CHECKSUM);
+    const offset_t secHdrsOffset = pe->secHdrsOffset();
+    if (checksumOffset == INVALID_ADDR || secHdrsOffset == INVALID_ADDR) return false;
+
+    const size_t secCount = pe->hdrSectionsNum();
+    const offset_t hdrsEnd = secHdrsOffset + secCount * sizeof(IMAGE_SECTION_HEADER);
+    if (hdrsEnd > pe->getRawSize()) return false;
+
+    // the headers, with the zeroed fields
+    std::vector<DigestRange> zeroed;
+    zeroed.push_back(DigestRange(checksumOffset, sizeof(DWORD), true));
+    if (dataDir->getDirsCount() > pe::DIR_SECURITY) {
+        const offset_t entryOffset = dataDir->getFieldOffset(pe::DIR_SECURITY, DataDirWrapper::ADDRESS);
+        if (entryOffset == INVALID_ADDR) return false;
+        zeroed.push_back(DigestRange(entryOffset, sizeof(IMAGE_DATA_DIRECTORY), true));
+    }
+    offset_t offset = 0;
+    for (size_t i = 0; i < zeroed.size(); i++) {
+        if (zeroed[i].offset < offset || zeroed[i].offset + zeroed[i].size > hdrsEnd) return false;
+        if (zeroed[i].offset > offset) {
+            ranges.push_back(DigestRange(offset, static_cast<bufsize_t>(zeroed[i].offset - offset)));
+        }
+        ranges.push_back(zeroed[i]);
+        offset = zeroed[i].offset + zeroed[i].size;
+    }
+    ranges.push_back(DigestRange(offset, static_cast<bufsize_t>(hdrsEnd - offset)));
+
+    // the sections, without the signature
+    const offset_t fileSize = pe->getRawSize();
+    const offset_t sigEnd = signature.offset + signature.size;
+    for (size_t i = 0; i < secCount; i++) {
+        const IMAGE_SECTION_HEADER *sec = (IMAGE_SECTION_HEADER*) pe->getContentAt(secHdrsOffset + i * sizeof(IMAGE_SECTION_HEADER), sizeof(IMAGE_SECTION_HEADER));
+        if (!sec) return false;
+
+        const offset_t start = sec->PointerToRawData;
+        const offset_t end = std::min<offset_t>(start + sec->SizeOfRawData, fileSize);
+        if (start >= end) continue;
+
+        if (signature.offset >= start && sigEnd <= end) {
+            ranges.push_back(DigestRange(start, static_cast<bufsize_t>(signature.offset - start)));
+            ranges.push_back(DigestRange(sigEnd, static_cast<bufsize_t>(end - sigEnd)));
+            continue;
+        }
+        ranges.push_back(DigestRange(start, static_cast<bufsize_t>(end - start)));
+    }
+    return true;
+}
+
+QCryptographicHash::Algorithm StrongNameHasher::getHashAlgo(PEFile *pe)
+{
+    ClrDirWrapper *clrDir = pe ? pe->getClsDir() : NULL;
+    ClrMetadata *metadata = clrDir ? clrDir->getMetadata() : NULL;
+    if (!metadata) return QCryptographicHash::Sha1;
+
+    const ClrBlob publicKey = metadata->getBlob(metadata->getTable(ClrMetadata::TABLE_ASSEMBLY).getValue(1, ClrMetadata::ASSEMBLY_PUBLIC_KEY));
+    if (!publicKey.data || publicKey.size < PUBKEY_BLOB_HDR_SIZE) return QCryptographicHash::Sha1;
+
+    const BYTE *algId = publicKey.data + PUBKEY_HASH_ALG_OFFSET;
+    switch (DWORD(algId[0]) | (DWORD(algId[1]) << 8) | (DWORD(algId[2]) << 16) | (DWORD(algId[3]) << 24)) {
+        case CALG_SHA_256: return QCryptographicHash::Sha256;
+        case CALG_SHA_384: return QCryptographicHash::Sha384;
+        case CALG_SHA_512: return QCryptographicHash::Sha512;
+        case CALG_SHA1:
+        default:
+            return QCryptographicHash::Sha1;
+    }
+}
+
+QByteArray StrongNameHasher::computeHash(PEFile *pe, QCryptographicHash::Algorithm algo)
+{
+    std::vector<DigestRange> ranges;
+    if (!getSignedRanges(pe, ranges)) return QByteArray();
+
+    return AuthenticodeHasher::hashRanges(pe, ranges, algo);
+}
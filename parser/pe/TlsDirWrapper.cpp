@@ -1,11 +1,15 @@
 #include "pe/TlsDirWrapper.h"
 #include "pe/PEFile.h"
 
+#include <algorithm>
+#include <cstring>
+#include <set>
+
 bool TlsDirWrapper::wrap()
 {
     clear();
     size_t entryId = 0;
-    while (true) {
+    while (entryId < MAX_CALLBACKS) {
         TlsEntryWrapper* entry = new TlsEntryWrapper(this->m_Exe, this, entryId++);
         if (!entry->getPtr()) {
             delete entry;
@@ -23,6 +27,63 @@ bool TlsDirWrapper::wrap()
     return true;
 }
 
+size_t TlsDirWrapper::getCallbacks(std::vector<TlsCallback> &callbacks, size_t maxCount)
+{
+    bool isOk = false;
+    const offset_t firstVA = static_cast<offset_t>(this->getNumValue(CALLBACKS_ADDR, &isOk));
+    if (!isOk || firstVA == 0) return 0;
+
+    const offset_t firstRaw = m_Exe->toRaw(firstVA, Executable::VA);
+    if (firstRaw == INVALID_ADDR) {
+        Logger::append(Logger::D_WARNING, "The TLS callbacks are out of the file");
+        return 0;
+    }
+    const bufsize_t addrSize = this->getFieldSize(CALLBACKS_ADDR);
+    if (addrSize != sizeof(DWORD) && addrSize != sizeof(ULONGLONG)) return 0;
+
+    // the entries that fit in the file, with the terminator
+    const size_t count = std::min<size_t>(m_Exe->getMaxSizeFromOffset(firstRaw) / addrSize, maxCount + 1);
+    const BYTE *ptr = m_Exe->getContentAt(firstRaw, static_cast<bufsize_t>(count * addrSize));
+    if (!ptr) return 0;
+
+    const offset_t imageBase = m_Exe->getImageBase();
+    const offset_t imageSize = m_Exe->getImageSize();
+    std::set<offset_t> listed;
+    size_t added = 0;
+    size_t i = 0;
+    for (; i < count; i++, ptr += addrSize) {
+        uint64_t va = 0;
+        if (addrSize == sizeof(DWORD)) {
+            DWORD va32 = 0;
+            ::memcpy(&va32, ptr, sizeof(DWORD));
+            va = va32;
+        } else {
+            ::memcpy(&va, ptr, sizeof(ULONGLONG));
+        }
+        if (va == 0) break;
+        if (i == maxCount) {
+            Logger::append(Logger::D_WARNING, "Too many TLS callbacks, listed only: %lu", static_cast<unsigned long>(maxCount));
+            break;
+        }
+        if (va < imageBase || (va - imageBase) >= imageSize) {
+            continue;
+        }
+        const offset_t rva = va - imageBase;
+        if (!listed.insert(rva).second) {
+            continue;
+        }
+        TlsCallback callback;
+        callback.rva = rva;
+        callback.slot = i;
+        callbacks.push_back(callback);
+        added++;
+    }
+    if (i == count && count <= maxCount) {
+        Logger::append(Logger::D_WARNING, "The TLS callbacks are not terminated");
+    }
+    return added;
+}
+
 void* TlsDirWrapper::getPtr()
 {
     if (m_Exe->getBitMode() == Executable::BITS_32) {